@@ -0,0 +1,570 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include "monitor.h"
+#include "cgroup.h"
+#include "namespace.h"
+#include "container.h"
+#include "capture.h"
+#include "export_delta.h"
+#include "self_stats.h"
+
+/**
+ * @file bench_collectors.c
+ * @brief Microbenchmark of the collectors and parsers of the library.
+ *        Every case runs a warmup, then repetitions of a batch sized to
+ *        about 2 ms; it reports the median and p99 ns/op across the
+ *        repetitions and the read/write syscalls per op (/proc/self/io).
+ *        "live" cases read /proc/self and the monitor's own cgroup, plus
+ *        the whole-host namespace scan and container view; with -r they
+ *        read a tree recorded by snapshot_host.sh instead ("snapshot"),
+ *        so a 10k-process host can be measured anywhere. "fixture" cases
+ *        read recorded cgroup files and generated exports. One
+ *        BENCH_RESULT line per case; -o saves a CSV that -c compares
+ *        against.
+ */
+
+#define BENCH_EXPORT_ROWS 256
+#define BENCH_MAX_REPS 1000
+
+typedef struct {
+    const char *name;
+    const char *source;         // "live" (ou "snapshot" com -r) ou "fixture"
+    int (*run)(void);           // 0 = ok
+} bench_case_t;
+
+typedef struct {
+    char name[64];
+    char source[16];
+    uint64_t batch;
+    int reps;
+    double median_ns;
+    double p99_ns;
+    double min_ns;
+    double syscalls_op;
+} bench_result_t;
+
+// Estado compartilhado pelos casos
+static pid_t self_pid;
+static pid_t target_pid;        // getpid(), ou um PID completo do snapshot
+static int snapshot;
+static container_view_t view;
+static int view_ready;
+static char cgroup_cpu_path[512];
+static char cgroup_mem_path[512];
+static char fixture_cgroup[512];
+static char export_csv[64], export_sparse[64], export_ndjson[64], export_capture[64];
+
+// ----------------------------------------------------------------------------
+// Casos
+// ----------------------------------------------------------------------------
+
+static int run_cpu(void) {
+    cpu_metrics_t m;
+    return collect_cpu_metrics(target_pid, &m);
+}
+
+static int run_memory(void) {
+    memory_metrics_t m;
+    return collect_memory_metrics(target_pid, &m);
+}
+
+static int run_io(void) {
+    io_metrics_t m;
+    return collect_io_metrics(target_pid, &m);
+}
+
+static int run_smaps(void) {
+    memory_smaps_t m;
+    return collect_smaps_rollup(target_pid, &m);
+}
+
+static int run_namespaces(void) {
+    process_namespaces_t ns;
+    return list_process_namespaces(target_pid, &ns);
+}
+
+static int run_process_name(void) {
+    char name[64];
+    return get_process_name(target_pid, name, sizeof(name));
+}
+
+static int run_cgroup_path(void) {
+    char path[512];
+    return get_process_cgroup_path(target_pid, detect_cgroup_version() == 1 ? "memory" : NULL,
+                                   path, sizeof(path));
+}
+
+static int run_live_cgroup_cpu(void) {
+    cgroup_cpu_metrics_t m;
+    return read_cgroup_cpu_metrics(cgroup_cpu_path, &m);
+}
+
+static int run_live_cgroup_memory(void) {
+    cgroup_memory_metrics_t m;
+    return read_cgroup_memory_metrics(cgroup_mem_path, &m);
+}
+
+static int run_namespace_scan(void) {
+    process_namespace_record_t *records = NULL;
+    long count = scan_process_namespaces(&records, 1);
+    free(records);
+    return count > 0 ? 0 : -1;
+}
+
+static int run_container_view(void) {
+    return view_ready && container_view_refresh(&view) >= 0 ? 0 : -1;
+}
+
+static int run_fixture_cgroup_cpu(void) {
+    cgroup_cpu_metrics_t m;
+    return read_cgroup_cpu_metrics(fixture_cgroup, &m);
+}
+
+static int run_fixture_cgroup_memory(void) {
+    cgroup_memory_metrics_t m;
+    return read_cgroup_memory_metrics(fixture_cgroup, &m);
+}
+
+static int run_fixture_cgroup_blkio(void) {
+    cgroup_blkio_metrics_t m;
+    return read_cgroup_blkio_metrics(fixture_cgroup, &m);
+}
+
+static int run_fixture_cgroup_pids(void) {
+    cgroup_pids_metrics_t m;
+    return read_cgroup_pids_metrics(fixture_cgroup, &m);
+}
+
+/**
+ * Lê a exportação inteira; falha se não vierem todas as linhas
+ */
+static int read_export(const char *path) {
+    export_reader_t reader;
+    if (export_reader_open(&reader, path) != 0) {
+        return -1;
+    }
+    export_record_t record;
+    int rows = 0, ret;
+    while ((ret = export_reader_next(&reader, &record)) == 1) rows++;
+    export_reader_close(&reader);
+    return ret == 0 && rows == BENCH_EXPORT_ROWS ? 0 : -1;
+}
+
+static int run_export_csv(void) { return read_export(export_csv); }
+static int run_export_sparse(void) { return read_export(export_sparse); }
+static int run_export_ndjson(void) { return read_export(export_ndjson); }
+
+static int run_capture(void) {
+    capture_reader_t reader;
+    if (capture_reader_open(&reader, export_capture) != 0) {
+        return -1;
+    }
+    export_record_t record;
+    int rows = 0, ret;
+    while ((ret = capture_reader_next(&reader, &record)) == 1) rows++;
+    capture_reader_close(&reader);
+    return ret == 0 && rows == BENCH_EXPORT_ROWS ? 0 : -1;
+}
+
+static const bench_case_t cases[] = {
+    { "cpu",                "live",    run_cpu },
+    { "memory",             "live",    run_memory },
+    { "io",                 "live",    run_io },
+    { "smaps_rollup",       "live",    run_smaps },
+    { "namespaces",         "live",    run_namespaces },
+    { "process_name",       "live",    run_process_name },
+    { "cgroup_path",        "live",    run_cgroup_path },
+    { "cgroup_cpu",         "live",    run_live_cgroup_cpu },
+    { "cgroup_memory",      "live",    run_live_cgroup_memory },
+    { "namespace_scan",     "live",    run_namespace_scan },
+    { "container_view",     "live",    run_container_view },
+    { "cgroup_cpu",         "fixture", run_fixture_cgroup_cpu },
+    { "cgroup_memory",      "fixture", run_fixture_cgroup_memory },
+    { "cgroup_blkio",       "fixture", run_fixture_cgroup_blkio },
+    { "cgroup_pids",        "fixture", run_fixture_cgroup_pids },
+    { "export_csv_256",     "fixture", run_export_csv },
+    { "export_sparse_256",  "fixture", run_export_sparse },
+    { "export_ndjson_256",  "fixture", run_export_ndjson },
+    { "capture_256",        "fixture", run_capture },
+};
+
+#define CASE_COUNT ((int)(sizeof(cases) / sizeof(cases[0])))
+
+// ----------------------------------------------------------------------------
+// Preparação
+// ----------------------------------------------------------------------------
+
+/**
+ * Série determinística de 4 PIDs, com CPU/memória/I/O variando devagar
+ */
+static void bench_record(export_record_t *r, int row) {
+    int target = row % 4, tick = row / 4;
+    memset(r, 0, sizeof(*r));
+    r->pid = 3000 + target;
+    r->flags = EXPORT_HAS_CPU | EXPORT_HAS_MEM | EXPORT_HAS_IO;
+    r->interval_ms = 1000;
+    r->monotonic_ns = 1000000000ULL * (uint64_t)(tick + 1);
+    r->realtime_ns = 1700000000000000000ULL + r->monotonic_ns;
+    r->cpu.user_time = 5000 + (uint64_t)tick * (target + 1) * 7;
+    r->cpu.system_time = 900 + (uint64_t)tick * 2;
+    r->cpu.total_time = r->cpu.user_time + r->cpu.system_time;
+    r->cpu.cpu_percent = 10.0 + (tick % 8) * 1.25;
+    r->cpu.num_threads = 8;
+    r->cpu.context_switches = 40000 + (uint64_t)tick * 31;
+    r->mem.rss = (256ULL << 20) + (uint64_t)(tick / 16) * 4096;
+    r->mem.vsz = 2ULL << 30;
+    r->mem.page_faults = 12000 + (uint64_t)tick;
+    r->io.bytes_read = (uint64_t)tick * 65536;
+    r->io.syscalls_read = (uint64_t)tick * 16;
+    r->io.read_rate = 65536.0;
+}
+
+static int write_export(const char *path, export_format_t format, int sparse) {
+    export_writer_config_t config;
+    export_writer_config_default(&config);
+    config.format = format;
+    config.sparse = sparse;
+    config.flush_interval_ms = 0;
+
+    export_writer_t writer;
+    if (export_writer_open(&writer, path, &config) != 0) {
+        return -1;
+    }
+    int ret = 0;
+    for (int row = 0; row < BENCH_EXPORT_ROWS && ret == 0; row++) {
+        export_record_t record;
+        bench_record(&record, row);
+        ret = export_writer_write_record(&writer, &record);
+    }
+    return export_writer_close(&writer) == 0 ? ret : -1;
+}
+
+/**
+ * Menor PID do snapshot com todos os arquivos que os coletores leem
+ */
+static pid_t snapshot_target(void) {
+    DIR *dir = opendir(proc_root());
+    if (dir == NULL) {
+        return -1;
+    }
+    pid_t best = -1;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        char *end;
+        long pid = strtol(entry->d_name, &end, 10);
+        if (*end != '\0' || pid <= 0 || (best > 0 && pid >= best)) continue;
+
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%ld/io", proc_root(), pid);
+        if (access(path, R_OK) != 0) continue;
+        snprintf(path, sizeof(path), "%s/%ld/smaps_rollup", proc_root(), pid);
+        if (access(path, R_OK) != 0) continue;
+        best = (pid_t)pid;
+    }
+    closedir(dir);
+    return best;
+}
+
+static const char* case_source(const bench_case_t *c) {
+    return snapshot && strcmp(c->source, "live") == 0 ? "snapshot" : c->source;
+}
+
+static int prepare(const char *fixtures, const char *root) {
+    self_pid = getpid();
+    target_pid = self_pid;
+    if (root != NULL) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/proc", root);
+        set_proc_root(path);
+        snprintf(path, sizeof(path), "%s/cgroup", root);
+        set_cgroup_root(path);
+        target_pid = snapshot_target();
+        if (target_pid <= 0 || detect_cgroup_version() < 0) {
+            fprintf(stderr, "Error: %s is not a snapshot (see snapshot_host.sh)\n", root);
+            return -1;
+        }
+        snapshot = 1;
+    }
+
+    int version = detect_cgroup_version();
+    snprintf(fixture_cgroup, sizeof(fixture_cgroup), "%s/cgroup-v%d", fixtures, version == 1 ? 1 : 2);
+    if (access(fixture_cgroup, R_OK) != 0) {
+        fprintf(stderr, "Error: fixtures not found at %s (use -d)\n", fixture_cgroup);
+        return -1;
+    }
+    get_process_cgroup_path(target_pid, version == 1 ? "cpu" : NULL, cgroup_cpu_path, sizeof(cgroup_cpu_path));
+    get_process_cgroup_path(target_pid, version == 1 ? "memory" : NULL, cgroup_mem_path, sizeof(cgroup_mem_path));
+    view_ready = container_view_init(&view) == 0;
+
+    const char *tmp = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+    snprintf(export_csv, sizeof(export_csv), "%.40s/bench_%d.csv", tmp, self_pid);
+    snprintf(export_sparse, sizeof(export_sparse), "%.40s/bench_%d_sparse.csv", tmp, self_pid);
+    snprintf(export_ndjson, sizeof(export_ndjson), "%.40s/bench_%d.ndjson", tmp, self_pid);
+    snprintf(export_capture, sizeof(export_capture), "%.40s/bench_%d.rmcap", tmp, self_pid);
+    if (write_export(export_csv, EXPORT_FORMAT_CSV, 0) != 0 ||
+        write_export(export_sparse, EXPORT_FORMAT_CSV, 1) != 0 ||
+        write_export(export_ndjson, EXPORT_FORMAT_NDJSON, 0) != 0 ||
+        write_export(export_capture, EXPORT_FORMAT_BINARY, 0) != 0) {
+        perror("Error writing export fixtures");
+        return -1;
+    }
+    return 0;
+}
+
+static void cleanup(void) {
+    if (view_ready) {
+        container_view_free(&view);
+        view_ready = 0;
+    }
+    unlink(export_csv);
+    unlink(export_sparse);
+    unlink(export_ndjson);
+    unlink(export_capture);
+}
+
+// ----------------------------------------------------------------------------
+// Medição
+// ----------------------------------------------------------------------------
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t rw_syscalls(void) {
+    self_usage_t usage;
+    self_usage_read(&usage);
+    return usage.syscr + usage.syscw;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @return 0 em sucesso, -1 se o caso falhar (indisponível neste host)
+ */
+static int run_case(const bench_case_t *c, int warmup, int reps, uint64_t batch,
+                    bench_result_t *result) {
+    memset(result, 0, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", c->name);
+    snprintf(result->source, sizeof(result->source), "%s", case_source(c));
+
+    // Aquecimento limitado a 0.5 s: varreduras de host inteiro são lentas
+    uint64_t warmup_end = now_ns() + 500000000ULL;
+    for (int i = 0; i < warmup || i == 0; i++) {
+        if (c->run() != 0) {
+            return -1;
+        }
+        if (now_ns() > warmup_end) break;
+    }
+
+    // Lote de ~2 ms: o custo de clock_gettime some no ruído
+    if (batch == 0) {
+        uint64_t start = now_ns();
+        batch = 0;
+        while (now_ns() - start < 2000000ULL) {
+            c->run();
+            batch++;
+        }
+    }
+
+    // Leitura de /proc/self/io sem nada no meio: custo da própria medição
+    uint64_t calibration = rw_syscalls();
+    calibration = rw_syscalls() - calibration;
+
+    static double per_op[BENCH_MAX_REPS];
+    uint64_t syscalls = 0;
+    for (int r = 0; r < reps; r++) {
+        uint64_t sys_start = rw_syscalls();
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) {
+            c->run();
+        }
+        per_op[r] = (double)(now_ns() - start) / (double)batch;
+        uint64_t used = rw_syscalls() - sys_start;
+        syscalls += used > calibration ? used - calibration : 0;
+    }
+
+    qsort(per_op, (size_t)reps, sizeof(double), compare_double);
+    int p99 = (int)((reps - 1) * 0.99 + 0.5);
+    result->batch = batch;
+    result->reps = reps;
+    result->median_ns = reps % 2 ? per_op[reps / 2] : (per_op[reps / 2 - 1] + per_op[reps / 2]) / 2.0;
+    result->p99_ns = per_op[p99];
+    result->min_ns = per_op[0];
+    result->syscalls_op = (double)syscalls / (double)(batch * (uint64_t)reps);
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Baseline
+// ----------------------------------------------------------------------------
+
+static int load_baseline(const char *path, bench_result_t *rows, int max) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    char line[512];
+    int count = 0;
+    while (fgets(line, sizeof(line), fp) != NULL && count < max) {
+        bench_result_t *r = &rows[count];
+        if (sscanf(line, "%63[^,],%15[^,],%lu,%d,%lf,%lf,%lf,%lf",
+                   r->name, r->source, &r->batch, &r->reps, &r->median_ns,
+                   &r->p99_ns, &r->min_ns, &r->syscalls_op) == 8) {
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+/**
+ * @return 1 se mediana e mínimo pioraram além de threshold (em %) ou se
+ *         o caso passou a fazer mais syscalls
+ */
+static int compare_result(const bench_result_t *r, const bench_result_t *baseline, int count,
+                          double threshold) {
+    for (int i = 0; i < count; i++) {
+        const bench_result_t *b = &baseline[i];
+        if (strcmp(b->name, r->name) != 0 || strcmp(b->source, r->source) != 0) continue;
+
+        double change = b->median_ns > 0 ? (r->median_ns / b->median_ns - 1.0) * 100.0 : 0.0;
+        double min_change = b->min_ns > 0 ? (r->min_ns / b->min_ns - 1.0) * 100.0 : 0.0;
+        // A mediana sozinha oscila com a carga do host; o mínimo precisa
+        // piorar junto. Syscalls a mais são regressão mesmo dentro do ruído
+        int regression = (change > threshold && min_change > threshold) ||
+                         r->syscalls_op > b->syscalls_op + 0.5;
+        printf("BENCH_COMPARE:name=%s,source=%s,baseline_ns=%.1f,median_ns=%.1f,change=%+.1f%%,"
+               "baseline_syscalls=%.2f,syscalls=%.2f,status=%s\n",
+               r->name, r->source, b->median_ns, r->median_ns, change, b->syscalls_op,
+               r->syscalls_op, regression ? "REGRESSION" : change < -threshold ? "improved" : "ok");
+        return regression;
+    }
+    printf("BENCH_COMPARE:name=%s,source=%s,status=new\n", r->name, r->source);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-n reps] [-w warmup] [-b batch] [-f name,...] [-s live|snapshot|fixture]\n"
+            "          [-d fixtures_dir] [-r snapshot_dir] [-o results.csv] [-c baseline.csv]\n"
+            "          [-t threshold_pct]\n"
+            "  -b 0 sizes each batch to ~2 ms (default); -c exits 1 on a regression\n",
+            prog);
+}
+
+static int name_selected(const char *filter, const char *name) {
+    if (filter == NULL) return 1;
+    size_t len = strlen(name);
+    for (const char *p = filter; (p = strstr(p, name)) != NULL; p += len) {
+        if ((p == filter || p[-1] == ',') && (p[len] == '\0' || p[len] == ',')) return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int reps = 31;
+    int warmup = 200;
+    long batch = 0;
+    const char *filter = NULL;
+    const char *source = NULL;
+    const char *fixtures = "experimentos/fixtures";
+    const char *root = NULL;
+    const char *csv_path = NULL;
+    const char *baseline_path = NULL;
+    double threshold = 25.0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:w:b:f:s:d:r:o:c:t:h")) != -1) {
+        switch (opt) {
+            case 'n': reps = atoi(optarg); break;
+            case 'w': warmup = atoi(optarg); break;
+            case 'b': batch = atol(optarg); break;
+            case 'f': filter = optarg; break;
+            case 's': source = optarg; break;
+            case 'd': fixtures = optarg; break;
+            case 'r': root = optarg; break;
+            case 'o': csv_path = optarg; break;
+            case 'c': baseline_path = optarg; break;
+            case 't': threshold = atof(optarg); break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (reps <= 0 || reps > BENCH_MAX_REPS || warmup < 0 || batch < 0 || threshold < 0) {
+        fprintf(stderr, "Error: reps must be 1..%d; warmup, batch and threshold >= 0.\n", BENCH_MAX_REPS);
+        return EXIT_FAILURE;
+    }
+
+    static bench_result_t baseline[128];
+    int baseline_count = 0;
+    if (baseline_path != NULL && (baseline_count = load_baseline(baseline_path, baseline, 128)) < 0) {
+        fprintf(stderr, "Error reading baseline %s: %s\n", baseline_path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    if (prepare(fixtures, root) != 0) {
+        cleanup();
+        return EXIT_FAILURE;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path != NULL) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            perror("fopen");
+            cleanup();
+            return EXIT_FAILURE;
+        }
+        fprintf(csv, "name,source,batch,reps,median_ns,p99_ns,min_ns,syscalls_per_op\n");
+    }
+
+    printf("reps:%d\nwarmup:%d\ncgroup_version:%d\n", reps, warmup, detect_cgroup_version());
+    int regressions = 0;
+    for (int i = 0; i < CASE_COUNT; i++) {
+        const bench_case_t *c = &cases[i];
+        if (!name_selected(filter, c->name) || (source != NULL && strcmp(source, case_source(c)) != 0)) {
+            continue;
+        }
+
+        bench_result_t result;
+        if (run_case(c, warmup, reps, (uint64_t)batch, &result) != 0) {
+            printf("BENCH_RESULT:name=%s,source=%s,status=unavailable(%s)\n",
+                   c->name, case_source(c), strerror(errno));
+            continue;
+        }
+        printf("BENCH_RESULT:name=%s,source=%s,batch=%lu,reps=%d,median_ns=%.1f,p99_ns=%.1f,"
+               "min_ns=%.1f,syscalls_per_op=%.2f\n",
+               result.name, result.source, result.batch, result.reps, result.median_ns,
+               result.p99_ns, result.min_ns, result.syscalls_op);
+        fflush(stdout);
+        if (csv != NULL) {
+            fprintf(csv, "%s,%s,%lu,%d,%.1f,%.1f,%.1f,%.2f\n", result.name, result.source,
+                    result.batch, result.reps, result.median_ns, result.p99_ns, result.min_ns,
+                    result.syscalls_op);
+        }
+        if (baseline_path != NULL) {
+            regressions += compare_result(&result, baseline, baseline_count, threshold);
+        }
+    }
+
+    if (csv != NULL) {
+        fclose(csv);
+    }
+    cleanup();
+    if (baseline_path != NULL) {
+        printf("regressions:%d (threshold %.1f%%)\n", regressions, threshold);
+    }
+    return regressions > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
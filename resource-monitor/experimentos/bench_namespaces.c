@@ -0,0 +1,160 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include "namespace.h"
+
+/**
+ * @file bench_namespaces.c
+ * @brief Namespace operation latency benchmark.
+ *        For each namespace type it measures unshare (in a fresh child),
+ *        clone3 with CLONE_NEW* and setns into an existing namespace,
+ *        scaling from 1 to N concurrent creators, and prints one
+ *        NSBENCH_RESULT line per run (optionally also a CSV file).
+ */
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-n iterations] [-j max_concurrency] [-t types] [-m methods] [-o file.csv]\n"
+            "  types:   comma list of cgroup,ipc,mnt,net,pid,time,user,uts (default: all)\n"
+            "  methods: comma list of unshare,clone,setns (default: all)\n",
+            prog);
+}
+
+/**
+ * Converte uma lista separada por vírgulas em máscara de bits de índices
+ */
+static int parse_list(const char *list, const char *(*name_of)(int), int count, unsigned *mask) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", list);
+    *mask = 0;
+
+    char *saveptr = NULL;
+    for (char *tok = strtok_r(buf, ",", &saveptr); tok != NULL; tok = strtok_r(NULL, ",", &saveptr)) {
+        int found = 0;
+        for (int i = 0; i < count; i++) {
+            if (strcmp(tok, name_of(i)) == 0) {
+                *mask |= 1u << i;
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "Error: unknown name '%s'\n", tok);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static const char* type_name(int i) {
+    return namespace_type_to_string((namespace_type_t)i);
+}
+
+static const char* method_name(int i) {
+    return namespace_bench_method_to_string((namespace_bench_method_t)i);
+}
+
+static void write_csv_row(FILE *csv, const namespace_bench_result_t *r) {
+    fprintf(csv, "%s,%s,%d,%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f\n",
+            r->method == NS_BENCH_FORK ? "none" : namespace_type_to_string(r->type),
+            namespace_bench_method_to_string(r->method), r->concurrency,
+            r->iterations, r->failures, r->mean_us, r->p50_us, r->p90_us,
+            r->p99_us, r->max_us, r->ops_per_sec);
+}
+
+static void run_one(namespace_type_t type, namespace_bench_method_t method,
+                    int iterations, int concurrency, FILE *csv) {
+    namespace_bench_result_t result;
+
+    if (run_namespace_benchmark(type, method, iterations, concurrency, &result) != 0) {
+        printf("NSBENCH_RESULT:type=%s,method=%s,concurrency=%d,n=0,status=unavailable(%s)\n",
+               method == NS_BENCH_FORK ? "none" : namespace_type_to_string(type),
+               namespace_bench_method_to_string(method), concurrency, strerror(errno));
+        return;
+    }
+
+    print_namespace_bench_result(&result);
+    fflush(stdout);
+    if (csv != NULL) {
+        write_csv_row(csv, &result);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = 2000;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_concurrency = cpus > 0 ? (int)cpus : 1;
+    unsigned type_mask = (1u << MAX_NAMESPACES) - 1;
+    unsigned method_mask = (1u << NS_BENCH_UNSHARE) | (1u << NS_BENCH_CLONE) | (1u << NS_BENCH_SETNS);
+    const char *csv_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:j:t:m:o:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = atoi(optarg);
+                break;
+            case 'j':
+                max_concurrency = atoi(optarg);
+                break;
+            case 't':
+                if (parse_list(optarg, type_name, MAX_NAMESPACES, &type_mask) != 0) return EXIT_FAILURE;
+                break;
+            case 'm':
+                if (parse_list(optarg, method_name, NS_BENCH_FORK, &method_mask) != 0) return EXIT_FAILURE;
+                break;
+            case 'o':
+                csv_path = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (iterations <= 0 || max_concurrency <= 0) {
+        fprintf(stderr, "Error: iterations and concurrency must be positive.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (geteuid() != 0) {
+        fprintf(stderr, "Warning: not running as root; only user namespaces can be created.\n");
+    }
+
+    FILE *csv = NULL;
+    if (csv_path != NULL) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            perror("fopen");
+            return EXIT_FAILURE;
+        }
+        fprintf(csv, "type,method,concurrency,n,failures,mean_us,p50_us,p90_us,p99_us,max_us,ops_per_sec\n");
+    }
+
+    printf("iterations_per_run:%d\n", iterations);
+    printf("max_concurrency:%d\n", max_concurrency);
+
+    // Concorrência dobra até o máximo (que sempre é incluído)
+    for (int c = 1; ; c = (c * 2 > max_concurrency && c < max_concurrency) ? max_concurrency : c * 2) {
+        // Linha de base: clone3 sem namespaces, a subtrair do método clone
+        if (method_mask & (1u << NS_BENCH_CLONE)) {
+            run_one(NS_NET, NS_BENCH_FORK, iterations, c, csv);
+        }
+
+        for (int t = 0; t < MAX_NAMESPACES; t++) {
+            if (!(type_mask & (1u << t))) continue;
+            for (int m = 0; m < NS_BENCH_FORK; m++) {
+                if (!(method_mask & (1u << m))) continue;
+                run_one((namespace_type_t)t, (namespace_bench_method_t)m, iterations, c, csv);
+            }
+        }
+
+        if (c >= max_concurrency) break;
+    }
+
+    if (csv != NULL) {
+        fclose(csv);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,671 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include "monitor.h"
+#include "cgroup.h"
+#include "monitor_daemon.h"
+
+/**
+ * @file bench_scale.c
+ * @brief Monitoring cost versus number of targets and cgroup depth.
+ *        For every combination of process count (1..10k), kind (idle
+ *        processes blocked in pause(), or busy ones spinning a duty cycle)
+ *        and cgroup depth (0 = left where they are, 1..8 = moved into the
+ *        leaf of a nested chain whose levels are also added as cgroup
+ *        targets), it starts the real daemon (--daemon) on all of them and,
+ *        after a warmup, measures over a window of ticks:
+ *          - sweep time: collection-round time per tick, from "stats";
+ *          - the daemon's CPU per tick, read/write syscalls per tick and
+ *            RSS, read from its /proc files with the library collectors.
+ *        One SCALE_RESULT line per run, an optional CSV, and a scaling
+ *        report per (kind, depth) series with the least-squares marginal
+ *        cost per target and the log-log growth exponent.
+ */
+
+#define SCALE_MAX_RUNS 128
+#define SCALE_MAX_DEPTH 8
+#define SCALE_BUSY_PERIOD_NS 10000000ULL       // Ciclo de trabalho dos processos busy
+
+typedef struct {
+    int procs;
+    const char *kind;           // "idle" ou "busy"
+    int depth;
+    int ok;
+    char error[96];
+    int targets;                // PIDs + cgroups
+    double ticks;
+    double sweep_ms;            // Tempo de rodadas por tick
+    double round_ms;            // Duração média de uma rodada
+    double max_round_ms;        // Desde o início do daemon
+    double cpu_ms_tick;
+    double cpu_percent;
+    double syscalls_tick;
+    double rss_mb;
+    uint64_t overruns;
+} scale_result_t;
+
+typedef struct {
+    uint64_t rounds;
+    double avg_round_ms;
+    double max_round_ms;
+    uint64_t overruns;
+} daemon_stats_t;
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    interrupted = 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_ms(long ms) {
+    uint64_t end = now_ns() + (uint64_t)ms * 1000000ULL;
+    while (!interrupted) {
+        uint64_t now = now_ns();
+        if (now >= end) break;
+        uint64_t left = end - now;
+        struct timespec ts = { (time_t)(left / 1000000000ULL), (long)(left % 1000000000ULL) };
+        nanosleep(&ts, NULL);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Processos alvo
+// ----------------------------------------------------------------------------
+
+/**
+ * Corpo do filho: bloqueado (idle) ou duty% de cada 10 ms em laço (busy).
+ * Os busy só começam no EOF de gate: milhares girando enquanto o pai ainda
+ * cria os demais deixariam o fork e a montagem da cadeia sem CPU.
+ */
+static void run_child(int busy, int duty, int gate) {
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    if (!busy) {
+        for (;;) pause();
+    }
+    char byte;
+    while (read(gate, &byte, 1) < 0 && errno == EINTR) {}
+    uint64_t spin = SCALE_BUSY_PERIOD_NS * (uint64_t)duty / 100;
+    struct timespec rest = { 0, (long)(SCALE_BUSY_PERIOD_NS - spin) };
+    volatile uint64_t sink = 0;
+    for (;;) {
+        uint64_t start = now_ns();
+        while (now_ns() - start < spin) sink++;
+        nanosleep(&rest, NULL);
+    }
+}
+
+static int spawn_children(pid_t *pids, int count, int busy, int duty, const int gate[2]) {
+    for (int i = 0; i < count; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            return i;
+        }
+        if (pid == 0) {
+            close(gate[1]);
+            run_child(busy, duty, gate[0]);
+            _exit(0);
+        }
+        pids[i] = pid;
+    }
+    return count;
+}
+
+static void kill_children(pid_t *pids, int count) {
+    for (int i = 0; i < count; i++) kill(pids[i], SIGKILL);
+    for (int i = 0; i < count; i++) waitpid(pids[i], NULL, 0);
+}
+
+// ----------------------------------------------------------------------------
+// Cadeia de cgroups
+// ----------------------------------------------------------------------------
+
+/**
+ * Nome relativo do nível (1..depth): rm_scale_<pid>/l2/.../l<level>
+ */
+static void level_name(int level, char *out, size_t size) {
+    int len = snprintf(out, size, "rm_scale_%d", getpid());
+    for (int l = 2; l <= level && len > 0 && (size_t)len < size; l++) {
+        len += snprintf(out + len, size - (size_t)len, "/l%d", l);
+    }
+}
+
+static void level_paths(int version, int level, char *cpu, char *mem, size_t size) {
+    char name[256];
+    level_name(level, name, sizeof(name));
+    if (version == 2) {
+        snprintf(cpu, size, "%s/%s", cgroup_root(), name);
+        snprintf(mem, size, "%s", cpu);
+    } else {
+        snprintf(cpu, size, "%s/cpu/%s", cgroup_root(), name);
+        snprintf(mem, size, "%s/memory/%s", cgroup_root(), name);
+    }
+}
+
+static void enable_v2_controllers(const char *dir) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/cgroup.subtree_control", dir);
+    FILE *fp = fopen(path, "w");
+    if (fp != NULL) {
+        fputs("+cpu +memory", fp);
+        fclose(fp);
+    }
+}
+
+static void remove_chain(int version, int depth) {
+    for (int level = depth; level >= 1; level--) {
+        char cpu[4096], mem[4096];
+        level_paths(version, level, cpu, mem, sizeof(cpu));
+        remove_cgroup(cpu);
+        if (version == 1) remove_cgroup(mem);
+    }
+}
+
+/**
+ * Cria a cadeia e move os filhos para a folha
+ */
+static int build_chain(int version, int depth, const pid_t *pids, int count) {
+    if (version == 2) enable_v2_controllers(cgroup_root());
+    for (int level = 1; level <= depth; level++) {
+        char name[256];
+        level_name(level, name, sizeof(name));
+        if (create_cgroup(name, CGROUP_CPU) != 0 ||
+            (version == 1 && create_cgroup(name, CGROUP_MEMORY) != 0)) {
+            remove_chain(version, level);
+            return -1;
+        }
+        if (version == 2 && level < depth) {
+            char cpu[4096], mem[4096];
+            level_paths(version, level, cpu, mem, sizeof(cpu));
+            enable_v2_controllers(cpu);
+        }
+    }
+
+    char cpu[4096], mem[4096];
+    level_paths(version, depth, cpu, mem, sizeof(cpu));
+    for (int i = 0; i < count; i++) {
+        if (move_process_to_cgroup(pids[i], cpu) != 0 ||
+            (version == 1 && move_process_to_cgroup(pids[i], mem) != 0)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Daemon
+// ----------------------------------------------------------------------------
+
+/**
+ * Envia um comando; com stats != NULL interpreta a resposta de "stats"
+ * @return 0 em OK, 1 em ERR, -1 sem conexão
+ */
+static int daemon_command(const char *socket_path, const char *command, daemon_stats_t *stats) {
+    char *reply = NULL;
+    size_t reply_size = 0;
+    FILE *out = open_memstream(&reply, &reply_size);
+    if (out == NULL) {
+        return -1;
+    }
+    int ret = monitor_daemon_control(socket_path, command, out);
+    fclose(out);
+
+    if (ret == 0 && stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+        for (char *line = strtok(reply, "\n"); line != NULL; line = strtok(NULL, "\n")) {
+            sscanf(line, "rounds=%lu", &stats->rounds);
+            sscanf(line, "avg_round_ms=%lf", &stats->avg_round_ms);
+            sscanf(line, "max_round_ms=%lf", &stats->max_round_ms);
+            sscanf(line, "overruns=%lu", &stats->overruns);
+        }
+    }
+    free(reply);
+    return ret;
+}
+
+static pid_t start_daemon(const char *monitor_bin, const char *socket_path, int interval,
+                          int workers, const pid_t *pids, int count) {
+    char **argv = calloc((size_t)count + 16, sizeof(char *));
+    char (*pid_args)[16] = calloc((size_t)count, sizeof(*pid_args));
+    char interval_arg[16], workers_arg[16];
+    if (argv == NULL || pid_args == NULL) {
+        free(argv);
+        free(pid_args);
+        return -1;
+    }
+
+    int argc = 0;
+    argv[argc++] = (char *)monitor_bin;
+    argv[argc++] = "--daemon";
+    argv[argc++] = (char *)socket_path;
+    argv[argc++] = "-q";
+    argv[argc++] = "-i";
+    snprintf(interval_arg, sizeof(interval_arg), "%d", interval);
+    argv[argc++] = interval_arg;
+    if (workers >= 0) {
+        argv[argc++] = "--workers";
+        snprintf(workers_arg, sizeof(workers_arg), "%d", workers);
+        argv[argc++] = workers_arg;
+    }
+    for (int i = 0; i < count; i++) {
+        snprintf(pid_args[i], sizeof(pid_args[i]), "%d", pids[i]);
+        argv[argc++] = pid_args[i];
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        execv(monitor_bin, argv);
+        _exit(127);
+    }
+    free(argv);
+    free(pid_args);
+    return pid;
+}
+
+static void stop_daemon(pid_t daemon, const char *socket_path) {
+    daemon_command(socket_path, "shutdown", NULL);
+    for (int i = 0; i < 50; i++) {
+        if (waitpid(daemon, NULL, WNOHANG) == daemon) return;
+        sleep_ms(100);
+    }
+    kill(daemon, SIGKILL);
+    waitpid(daemon, NULL, 0);
+}
+
+/**
+ * CPU do daemon em ns: soma do schedstat de cada thread (loop de eventos e
+ * workers). O utime/stime do stat tem a resolução do tick (10 ms), grossa
+ * demais para poucos alvos.
+ */
+static int daemon_cpu_ns(pid_t daemon, uint64_t *cpu_ns) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%d/task", proc_root(), daemon);
+    DIR *dir = opendir(path);
+    if (dir == NULL) {
+        return -1;
+    }
+    *cpu_ns = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%d/task/%s/schedstat", proc_root(), daemon, entry->d_name);
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL) continue;
+        unsigned long long run_ns;
+        if (fscanf(fp, "%llu", &run_ns) == 1) *cpu_ns += run_ns;
+        fclose(fp);
+    }
+    closedir(dir);
+    return 0;
+}
+
+/**
+ * Consumo acumulado do daemon; memória e syscalls pelos coletores da biblioteca
+ */
+static int daemon_usage(pid_t daemon, double *cpu_ms, uint64_t *syscalls, double *rss_mb) {
+    memory_metrics_t mem;
+    io_metrics_t io;
+    uint64_t cpu_ns;
+    if (daemon_cpu_ns(daemon, &cpu_ns) != 0 || collect_memory_metrics(daemon, &mem) != 0) {
+        return -1;
+    }
+    *cpu_ms = cpu_ns / 1e6;
+    *rss_mb = mem.rss / (1024.0 * 1024.0);
+    *syscalls = collect_io_metrics(daemon, &io) == 0 ? io.syscalls_read + io.syscalls_write : 0;
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Execução
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    const char *monitor_bin;
+    int interval;               // s
+    int window_ticks;
+    int workers;                // -1 = padrão do daemon
+    int duty;
+} scale_options_t;
+
+static void run_scale(const scale_options_t *opts, scale_result_t *r) {
+    int version = detect_cgroup_version();
+    pid_t *pids = calloc((size_t)r->procs, sizeof(pid_t));
+    if (pids == NULL) {
+        snprintf(r->error, sizeof(r->error), "out of memory");
+        return;
+    }
+
+    int gate[2];
+    if (pipe(gate) != 0) {
+        snprintf(r->error, sizeof(r->error), "pipe: %s", strerror(errno));
+        free(pids);
+        return;
+    }
+    int spawned = spawn_children(pids, r->procs, strcmp(r->kind, "busy") == 0, opts->duty, gate);
+    close(gate[0]);
+    if (spawned < r->procs) {
+        close(gate[1]);
+        snprintf(r->error, sizeof(r->error), "fork failed after %d: %s", spawned, strerror(errno));
+        kill_children(pids, spawned);
+        free(pids);
+        return;
+    }
+    if (r->depth > 0 && build_chain(version, r->depth, pids, spawned) != 0) {
+        snprintf(r->error, sizeof(r->error), "cgroup chain: %s", strerror(errno));
+        close(gate[1]);
+        kill_children(pids, spawned);
+        remove_chain(version, r->depth);
+        free(pids);
+        return;
+    }
+
+    close(gate[1]);
+
+    char socket_path[108];
+    snprintf(socket_path, sizeof(socket_path), "/tmp/bench_scale.%d.sock", getpid());
+    pid_t daemon = start_daemon(opts->monitor_bin, socket_path, opts->interval, opts->workers,
+                                pids, spawned);
+
+    // Pronto quando o socket responde; 10k alvos levam alguns segundos
+    daemon_stats_t before, after;
+    int ready = 0;
+    for (int i = 0; i < 600 && daemon > 0 && !interrupted; i++) {
+        if (waitpid(daemon, NULL, WNOHANG) == daemon) {
+            daemon = -1;
+            break;
+        }
+        if (daemon_command(socket_path, "stats", &before) == 0) {
+            ready = 1;
+            break;
+        }
+        sleep_ms(100);
+    }
+    if (!ready) {
+        snprintf(r->error, sizeof(r->error), "daemon did not start (see its stderr)");
+    }
+
+    // Cada nível da cadeia vira um alvo cgroup
+    r->targets = spawned;
+    for (int level = 1; ready && level <= r->depth; level++) {
+        char cpu[4096], mem[4096], command[8400];
+        level_paths(version, level, cpu, mem, sizeof(cpu));
+        snprintf(command, sizeof(command), "add cgroup %s mem=%s interval=%d",
+                 cpu, mem, opts->interval * 1000);
+        if (daemon_command(socket_path, command, NULL) == 0) r->targets++;
+    }
+
+    double cpu0 = 0, cpu1 = 0, rss = 0;
+    uint64_t sys0 = 0, sys1 = 0;
+    if (ready) {
+        sleep_ms(2000L * opts->interval);
+        uint64_t t0 = now_ns();
+        if (daemon_command(socket_path, "stats", &before) != 0 ||
+            daemon_usage(daemon, &cpu0, &sys0, &rss) != 0) {
+            ready = 0;
+        }
+        sleep_ms(1000L * opts->interval * opts->window_ticks);
+        uint64_t t1 = now_ns();
+        if (ready && daemon_command(socket_path, "stats", &after) == 0 &&
+            daemon_usage(daemon, &cpu1, &sys1, &rss) == 0 && !interrupted) {
+            double window_s = (t1 - t0) / 1e9;
+            uint64_t rounds = after.rounds - before.rounds;
+            double round_total = after.avg_round_ms * after.rounds - before.avg_round_ms * before.rounds;
+            r->ticks = window_s / opts->interval;
+            r->sweep_ms = round_total / r->ticks;
+            r->round_ms = rounds ? round_total / rounds : 0.0;
+            r->max_round_ms = after.max_round_ms;
+            r->cpu_ms_tick = (cpu1 - cpu0) / r->ticks;
+            r->cpu_percent = (cpu1 - cpu0) / 10.0 / window_s;
+            r->syscalls_tick = (double)(sys1 - sys0) / r->ticks;
+            r->rss_mb = rss;
+            r->overruns = after.overruns - before.overruns;
+            r->ok = 1;
+        } else if (r->error[0] == '\0') {
+            snprintf(r->error, sizeof(r->error), interrupted ? "interrupted" : "daemon stopped");
+        }
+    }
+
+    if (daemon > 0) stop_daemon(daemon, socket_path);
+    unlink(socket_path);
+    kill_children(pids, spawned);
+    if (r->depth > 0) remove_chain(version, r->depth);
+    free(pids);
+}
+
+// ----------------------------------------------------------------------------
+// Relatório
+// ----------------------------------------------------------------------------
+
+/**
+ * Mínimos quadrados: y = a + b*x
+ */
+static double fit_slope(const double *x, const double *y, int n) {
+    double mx = 0, my = 0, sxx = 0, sxy = 0;
+    for (int i = 0; i < n; i++) { mx += x[i]; my += y[i]; }
+    mx /= n;
+    my /= n;
+    for (int i = 0; i < n; i++) {
+        sxx += (x[i] - mx) * (x[i] - mx);
+        sxy += (x[i] - mx) * (y[i] - my);
+    }
+    return sxx > 0 ? sxy / sxx : 0.0;
+}
+
+/**
+ * Expoente de crescimento (inclinação log-log), ignorando pontos <= 0
+ */
+static double fit_exponent(const double *x, const double *y, int n) {
+    double lx[SCALE_MAX_RUNS], ly[SCALE_MAX_RUNS];
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        if (x[i] > 0 && y[i] > 0) {
+            lx[m] = log(x[i]);
+            ly[m] = log(y[i]);
+            m++;
+        }
+    }
+    return m >= 2 ? fit_slope(lx, ly, m) : NAN;
+}
+
+static void print_report(const scale_result_t *results, int count) {
+    for (int i = 0; i < count; i++) {
+        // Uma série por (tipo, profundidade), na primeira vez que aparece
+        int first = 1;
+        for (int j = 0; j < i; j++) {
+            if (strcmp(results[j].kind, results[i].kind) == 0 && results[j].depth == results[i].depth) {
+                first = 0;
+            }
+        }
+        if (!first) continue;
+
+        printf("\n--- Scaling: %s processes, cgroup depth %d ---\n", results[i].kind, results[i].depth);
+        printf("%8s %8s %10s %10s %12s %8s %14s %8s %9s\n", "Procs", "Targets", "Sweep ms",
+               "Round ms", "CPU ms/tick", "CPU %", "Syscalls/tick", "RSS MB", "Overruns");
+
+        double n[SCALE_MAX_RUNS], sweep[SCALE_MAX_RUNS], cpu[SCALE_MAX_RUNS], rss[SCALE_MAX_RUNS];
+        int points = 0;
+        for (int j = i; j < count; j++) {
+            const scale_result_t *r = &results[j];
+            if (strcmp(r->kind, results[i].kind) != 0 || r->depth != results[i].depth) continue;
+            if (!r->ok) {
+                printf("%8d   failed: %s\n", r->procs, r->error);
+                continue;
+            }
+            printf("%8d %8d %10.2f %10.2f %12.2f %8.2f %14.1f %8.1f %9lu\n", r->procs, r->targets,
+                   r->sweep_ms, r->round_ms, r->cpu_ms_tick, r->cpu_percent, r->syscalls_tick,
+                   r->rss_mb, r->overruns);
+            n[points] = r->targets;
+            sweep[points] = r->sweep_ms;
+            cpu[points] = r->cpu_ms_tick;
+            rss[points] = r->rss_mb;
+            points++;
+        }
+        if (points >= 2) {
+            printf("Marginal cost per target: %.1f us CPU/tick, %.1f us sweep/tick, %.1f KB RSS\n",
+                   fit_slope(n, cpu, points) * 1000.0, fit_slope(n, sweep, points) * 1000.0,
+                   fit_slope(n, rss, points) * 1024.0);
+            double cpu_exp = fit_exponent(n, cpu, points);
+            double sweep_exp = fit_exponent(n, sweep, points);
+            if (!isnan(cpu_exp) && !isnan(sweep_exp)) {
+                printf("Growth exponent (log-log): CPU ~ N^%.2f, sweep ~ N^%.2f\n", cpu_exp, sweep_exp);
+            }
+        }
+        for (int j = i; j < count; j++) {
+            // Rodadas atrasadas: o host saturou, não o custo do monitor
+            if (results[j].ok && results[j].overruns > 0 && strcmp(results[j].kind, results[i].kind) == 0 &&
+                results[j].depth == results[i].depth) {
+                printf("Note: overruns mean rounds missed their tick; with busy targets this usually\n"
+                       "      means the host CPU is saturated (lower -u) rather than monitor cost.\n");
+                break;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// main
+// ----------------------------------------------------------------------------
+
+static int parse_int_list(const char *list, int *values, int max, int lo, int hi) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", list);
+    int count = 0;
+    char *saveptr = NULL;
+    for (char *tok = strtok_r(buf, ",", &saveptr); tok != NULL; tok = strtok_r(NULL, ",", &saveptr)) {
+        int v = atoi(tok);
+        if (count == max || v < lo || v > hi) {
+            fprintf(stderr, "Error: '%s' must be %d..%d (at most %d values)\n", tok, lo, hi, max);
+            return -1;
+        }
+        values[count++] = v;
+    }
+    return count;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-n counts] [-k idle,busy] [-d depths] [-u duty_pct] [-i interval_s]\n"
+            "          [-t window_ticks] [-w workers] [-m monitor_bin] [-o file.csv]\n"
+            "  counts: comma list of process counts (default: 1,10,100,1000,10000)\n"
+            "  depths: comma list of cgroup depths, 0 = no cgroups (default: 0)\n"
+            "  duty:   CPU %% each busy process spins per 10 ms (default: 1)\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    int counts[16], depths[SCALE_MAX_DEPTH + 1];
+    int count_n = parse_int_list("1,10,100,1000,10000", counts, 16, 1, 100000);
+    int depth_n = 1;
+    depths[0] = 0;
+    int kinds = 1;              // Bit 0 = idle, bit 1 = busy
+    const char *csv_path = NULL;
+    scale_options_t opts = { "bin/resource-monitor", 1, 5, -1, 1 };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:k:d:u:i:t:w:m:o:h")) != -1) {
+        switch (opt) {
+            case 'n': count_n = parse_int_list(optarg, counts, 16, 1, 100000); break;
+            case 'd': depth_n = parse_int_list(optarg, depths, SCALE_MAX_DEPTH + 1, 0, SCALE_MAX_DEPTH); break;
+            case 'k':
+                kinds = (strstr(optarg, "idle") ? 1 : 0) | (strstr(optarg, "busy") ? 2 : 0);
+                break;
+            case 'u': opts.duty = atoi(optarg); break;
+            case 'i': opts.interval = atoi(optarg); break;
+            case 't': opts.window_ticks = atoi(optarg); break;
+            case 'w': opts.workers = atoi(optarg); break;
+            case 'm': opts.monitor_bin = optarg; break;
+            case 'o': csv_path = optarg; break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (count_n <= 0 || depth_n <= 0 || kinds == 0 || opts.duty < 1 || opts.duty > 100 ||
+        opts.interval < 1 || opts.window_ticks < 1) {
+        fprintf(stderr, "Error: invalid counts, depths, kinds, duty (1..100), interval or window.\n");
+        return EXIT_FAILURE;
+    }
+    if (access(opts.monitor_bin, X_OK) != 0) {
+        fprintf(stderr, "Error: monitor binary %s not found (run make first or use -m)\n", opts.monitor_bin);
+        return EXIT_FAILURE;
+    }
+    int has_depth = 0;
+    for (int i = 0; i < depth_n; i++) has_depth |= depths[i] > 0;
+    if (has_depth && detect_cgroup_version() < 0) {
+        fprintf(stderr, "Error: cgroup depths need a cgroup hierarchy at %s\n", cgroup_root());
+        return EXIT_FAILURE;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path != NULL) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            perror("fopen");
+            return EXIT_FAILURE;
+        }
+        fprintf(csv, "procs,kind,depth,targets,ticks,sweep_ms,round_ms,max_round_ms,cpu_ms_tick,"
+                     "cpu_percent,syscalls_tick,rss_mb,overruns\n");
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    static scale_result_t results[SCALE_MAX_RUNS];
+    int run_count = 0;
+    static const char *kind_names[] = { "idle", "busy" };
+    for (int k = 0; k < 2; k++) {
+        if (!(kinds & (1 << k))) continue;
+        for (int d = 0; d < depth_n; d++) {
+            for (int c = 0; c < count_n && run_count < SCALE_MAX_RUNS && !interrupted; c++) {
+                scale_result_t *r = &results[run_count++];
+                r->procs = counts[c];
+                r->kind = kind_names[k];
+                r->depth = depths[d];
+                run_scale(&opts, r);
+
+                if (!r->ok) {
+                    printf("SCALE_RESULT:procs=%d,kind=%s,depth=%d,status=failed(%s)\n",
+                           r->procs, r->kind, r->depth, r->error);
+                    continue;
+                }
+                printf("SCALE_RESULT:procs=%d,kind=%s,depth=%d,targets=%d,sweep_ms=%.3f,round_ms=%.3f,"
+                       "cpu_ms_tick=%.3f,cpu_percent=%.2f,syscalls_tick=%.1f,rss_mb=%.2f,overruns=%lu\n",
+                       r->procs, r->kind, r->depth, r->targets, r->sweep_ms, r->round_ms,
+                       r->cpu_ms_tick, r->cpu_percent, r->syscalls_tick, r->rss_mb, r->overruns);
+                fflush(stdout);
+                if (csv != NULL) {
+                    fprintf(csv, "%d,%s,%d,%d,%.2f,%.3f,%.3f,%.3f,%.3f,%.2f,%.1f,%.2f,%lu\n",
+                            r->procs, r->kind, r->depth, r->targets, r->ticks, r->sweep_ms,
+                            r->round_ms, r->max_round_ms, r->cpu_ms_tick, r->cpu_percent,
+                            r->syscalls_tick, r->rss_mb, r->overruns);
+                    fflush(csv);
+                }
+            }
+        }
+    }
+
+    if (csv != NULL) {
+        fclose(csv);
+    }
+    print_report(results, run_count);
+    return interrupted ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/wait.h>
+#include "cgroup.h"
+
+/**
+ * @file bench_spawn.c
+ * @brief Launch-latency benchmark: fork + cgroup.procs vs clone3(CLONE_INTO_CGROUP).
+ *        Spawns the same short command many times into one cgroup with each
+ *        method and reports the spawn-to-reap latency distribution.
+ */
+
+static double elapsed_us(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e6 + (end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+static double percentile(const double *sorted, int n, double p) {
+    int idx = (int)(p / 100.0 * (n - 1) + 0.5);
+    return sorted[idx];
+}
+
+/**
+ * Roda n lançamentos com um método e imprime a distribuição de latências
+ */
+static int run_method(cgroup_spawn_method_t method, int n, char *const argv[],
+                      const char *cpu_path, const char *mem_path) {
+    double *samples = malloc(sizeof(double) * n);
+    if (samples == NULL) {
+        perror("malloc");
+        return -1;
+    }
+
+    int done = 0;
+    for (int i = 0; i < n; i++) {
+        struct timespec start, end;
+        cgroup_spawn_method_t used;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pid_t pid = spawn_process_in_cgroup(argv, cpu_path, mem_path, method, &used);
+        if (pid < 0) {
+            fprintf(stderr, "%s: spawn failed: %s\n",
+                    cgroup_spawn_method_to_string(method), strerror(errno));
+            break;
+        }
+        int status;
+        waitpid(pid, &status, 0);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        samples[done++] = elapsed_us(&start, &end);
+    }
+
+    if (done == 0) {
+        printf("SPAWN_RESULT:method=%s,n=0,status=unavailable\n",
+               cgroup_spawn_method_to_string(method));
+        free(samples);
+        return -1;
+    }
+
+    double sum = 0;
+    for (int i = 0; i < done; i++) sum += samples[i];
+    qsort(samples, done, sizeof(double), compare_doubles);
+
+    printf("SPAWN_RESULT:method=%s,n=%d,mean_us=%.2f,p50_us=%.2f,p90_us=%.2f,p99_us=%.2f,max_us=%.2f\n",
+           cgroup_spawn_method_to_string(method), done, sum / done,
+           percentile(samples, done, 50), percentile(samples, done, 90),
+           percentile(samples, done, 99), samples[done - 1]);
+
+    free(samples);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int n = 1000;
+    int cmd_index = argc;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            n = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--") == 0) {
+            cmd_index = i + 1;
+            break;
+        } else {
+            fprintf(stderr, "Usage: %s [-n spawns] [-- command [args...]]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (n <= 0) {
+        fprintf(stderr, "Error: number of spawns must be positive.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (geteuid() != 0) {
+        fprintf(stderr, "This benchmark requires root privileges to create cgroups.\n");
+        return EXIT_FAILURE;
+    }
+
+    char *default_cmd[] = { "/bin/true", NULL };
+    char **cmd = (cmd_index < argc) ? &argv[cmd_index] : default_cmd;
+
+    char name[64];
+    snprintf(name, sizeof(name), "bench_spawn_%d", getpid());
+
+    char cpu_path[PATH_MAX], mem_path[PATH_MAX];
+    if (create_cgroup_for_controllers(name, cpu_path, sizeof(cpu_path),
+                                      mem_path, sizeof(mem_path)) != 0) {
+        fprintf(stderr, "Error creating cgroup: %s\n", strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    printf("cgroup_version:%d\n", detect_cgroup_version());
+    printf("spawns_per_method:%d\n", n);
+
+    run_method(CGROUP_SPAWN_FORK, n, cmd, cpu_path, mem_path);
+    run_method(CGROUP_SPAWN_CLONE3, n, cmd, cpu_path, mem_path);
+
+    cleanup_cgroup(name);
+    return EXIT_SUCCESS;
+}
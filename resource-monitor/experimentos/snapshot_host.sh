@@ -0,0 +1,247 @@
+#!/bin/bash
+
+# ==============================================================================
+# Snapshot do host: grava /proc e /sys/fs/cgroup numa árvore de fixtures
+# ==============================================================================
+#
+# A árvore gravada é lida pelo monitor com --proc-root <dir>/proc e
+# --cgroup-root <dir>/cgroup (e pelas funções set_proc_root/set_cgroup_root
+# da biblioteca), de modo que coletores, varreduras de namespaces e a visão
+# de contêineres rodam sobre o mesmo conteúdo em qualquer máquina.
+#
+# Só os arquivos que a biblioteca lê são copiados. Os links de namespace
+# (/proc/<pid>/ns/*) viram links simbólicos para arquivos vazios em
+# <dir>/nsfs, um por namespace: processos no mesmo namespace apontam para o
+# mesmo arquivo e stat() devolve o mesmo inode, como no nsfs real.
+#
+# Para testes de carga, -p e -g multiplicam o que foi gravado: processos
+# sintéticos (cópias dos gravados, com PIDs novos) distribuídos entre
+# cgroups de contêineres docker sintéticos, cada um com namespaces próprios.
+#
+# Uso: experimentos/snapshot_host.sh -o <dir> [-p processos] [-g contêineres]
+#                                    [-d profundidade] [-t fixtures]
+# Ex.: experimentos/snapshot_host.sh -o /tmp/host10k -p 10000 -g 500
+
+# Cores para a saída
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[0;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+# Configurações
+OUT_DIR=""
+TARGET_PROCS=0          # 0 = só os processos gravados
+TARGET_CGROUPS=0        # Contêineres sintéticos
+MAX_DEPTH=8             # Profundidade máxima da árvore de cgroups copiada
+TEMPLATE_DIR="experimentos/fixtures"
+PROC_SRC="/proc"
+CGROUP_SRC="/sys/fs/cgroup"
+
+PROC_FILES="stat status io comm cgroup statm smaps_rollup"
+PROC_GLOBAL_FILES="meminfo uptime stat loadavg"
+NS_TYPES="cgroup ipc mnt net pid time user uts"
+# Arquivos lidos pelos leitores de cgroup v1 e v2 e pela visão de contêineres
+CGROUP_FILES="cgroup.controllers cgroup.procs cgroup.subtree_control
+    cpu.stat cpu.max cpu.weight cpu.cfs_quota_us cpu.cfs_period_us cpu.shares
+    cpuacct.usage cpuacct.usage_user cpuacct.usage_sys cpuacct.stat
+    memory.current memory.max memory.high memory.peak memory.stat memory.events
+    memory.swap.current memory.swap.max memory.usage_in_bytes memory.limit_in_bytes
+    memory.max_usage_in_bytes memory.failcnt memory.memsw.usage_in_bytes
+    memory.memsw.limit_in_bytes memory.memsw.max_usage_in_bytes
+    io.stat io.max blkio.throttle.io_service_bytes blkio.throttle.io_serviced
+    blkio.throttle.read_bps_device blkio.throttle.write_bps_device
+    pids.current pids.max cpuset.cpus cpuset.mems cpuset.cpus.effective"
+
+usage() {
+    echo "Uso: $0 -o <dir> [-p processos] [-g contêineres] [-d profundidade] [-t fixtures]"
+    echo "  -o  Diretório de saída (criado; não pode existir com conteúdo)"
+    echo "  -p  Completa a árvore até N processos com cópias dos gravados"
+    echo "  -g  Cria N cgroups de contêiner (docker) e distribui os processos sintéticos"
+    echo "  -d  Profundidade máxima da árvore de cgroups (padrão: $MAX_DEPTH)"
+    echo "  -t  Fixtures de cgroup usadas pelos contêineres sintéticos (padrão: $TEMPLATE_DIR)"
+}
+
+while getopts "o:p:g:d:t:h" opt; do
+    case $opt in
+        o) OUT_DIR="$OPTARG" ;;
+        p) TARGET_PROCS="$OPTARG" ;;
+        g) TARGET_CGROUPS="$OPTARG" ;;
+        d) MAX_DEPTH="$OPTARG" ;;
+        t) TEMPLATE_DIR="$OPTARG" ;;
+        h) usage; exit 0 ;;
+        *) usage; exit 1 ;;
+    esac
+done
+
+if [ -z "$OUT_DIR" ]; then
+    usage
+    exit 1
+fi
+if [ -d "$OUT_DIR" ] && [ -n "$(ls -A "$OUT_DIR")" ]; then
+    echo -e "${RED}$OUT_DIR já existe e não está vazio.${NC}"
+    exit 1
+fi
+
+# Versão de cgroup do host, pelo mesmo critério de detect_cgroup_version()
+if [ -e "$CGROUP_SRC/cgroup.controllers" ]; then
+    CGROUP_VERSION=2
+elif [ -e "$CGROUP_SRC/cpu" ]; then
+    CGROUP_VERSION=1
+else
+    echo -e "${RED}Nenhuma hierarquia de cgroup encontrada em $CGROUP_SRC.${NC}"
+    exit 1
+fi
+
+echo -e "${BLUE}╔════════════════════════════════════════════════════════════╗"
+echo -e "║            Snapshot do Host para Fixtures                  ║"
+echo -e "╚════════════════════════════════════════════════════════════╝${NC}"
+echo ""
+
+mkdir -p "$OUT_DIR/proc" "$OUT_DIR/cgroup" "$OUT_DIR/nsfs" || exit 1
+
+# Link de namespace: <pid>/ns/<tipo> -> ../../../nsfs/<tipo>:[<inode>]
+link_namespace() {
+    local ns_dir="$1" type="$2" target="$3"
+    : > "$OUT_DIR/nsfs/$target"
+    ln -sf "../../../nsfs/$target" "$ns_dir/$type"
+}
+
+# --- Passo 1: /proc ---
+echo "Gravando $PROC_SRC..."
+for f in $PROC_GLOBAL_FILES; do
+    cat "$PROC_SRC/$f" > "$OUT_DIR/proc/$f" 2>/dev/null || rm -f "$OUT_DIR/proc/$f"
+done
+
+recorded=0
+for src in "$PROC_SRC"/[0-9]*; do
+    pid="${src##*/}"
+    dest="$OUT_DIR/proc/$pid"
+    mkdir -p "$dest/ns"
+    for f in $PROC_FILES; do
+        cat "$src/$f" > "$dest/$f" 2>/dev/null || rm -f "$dest/$f"
+    done
+    # Processo terminou durante a gravação
+    if [ ! -s "$dest/stat" ]; then
+        rm -rf "$dest"
+        continue
+    fi
+    for type in $NS_TYPES; do
+        target=$(readlink "$src/ns/$type" 2>/dev/null) && link_namespace "$dest/ns" "$type" "$target"
+    done
+    recorded=$((recorded + 1))
+done
+echo -e "${GREEN}✓ $recorded processos gravados.${NC}"
+
+# --- Passo 2: cgroups ---
+echo "Gravando $CGROUP_SRC (cgroup v$CGROUP_VERSION, profundidade $MAX_DEPTH)..."
+cgroups=0
+# Controladores montados juntos (v1) aparecem como links: cpu -> cpu,cpuacct
+for link in "$CGROUP_SRC"/*; do
+    [ -L "$link" ] && ln -s "$(readlink "$link")" "$OUT_DIR/cgroup/${link##*/}"
+done
+while IFS= read -r dir; do
+    rel="${dir#$CGROUP_SRC}"
+    mkdir -p "$OUT_DIR/cgroup$rel"
+    for f in $CGROUP_FILES; do
+        [ -r "$dir/$f" ] || continue
+        cat "$dir/$f" > "$OUT_DIR/cgroup$rel/$f" 2>/dev/null || rm -f "$OUT_DIR/cgroup$rel/$f"
+    done
+    cgroups=$((cgroups + 1))
+done < <(find "$CGROUP_SRC" -maxdepth "$MAX_DEPTH" -type d 2>/dev/null)
+echo -e "${GREEN}✓ $cgroups cgroups gravados.${NC}"
+
+# --- Passo 3: contêineres sintéticos ---
+# Caminho relativo de cada contêiner; IDs de 64 hex como os do docker
+CONTAINER_REL=()
+for k in $(seq 1 "$TARGET_CGROUPS"); do
+    id=$(printf 'container-%d' "$k" | sha256sum | cut -c1-64)
+    if [ "$CGROUP_VERSION" -eq 2 ]; then
+        CONTAINER_REL[$k]="/system.slice/docker-$id.scope"
+    else
+        CONTAINER_REL[$k]="/docker/$id"
+    fi
+done
+
+if [ "$TARGET_CGROUPS" -gt 0 ]; then
+    template="$TEMPLATE_DIR/cgroup-v$CGROUP_VERSION"
+    if [ ! -d "$template" ]; then
+        echo -e "${RED}Fixtures de cgroup não encontradas em $template (use -t).${NC}"
+        exit 1
+    fi
+    echo "Criando $TARGET_CGROUPS cgroups de contêiner a partir de $template..."
+    for k in $(seq 1 "$TARGET_CGROUPS"); do
+        rel="${CONTAINER_REL[$k]}"
+        if [ "$CGROUP_VERSION" -eq 2 ]; then
+            dirs="$OUT_DIR/cgroup$rel"
+        else
+            # Em v1 cada controlador tem a própria árvore
+            dirs=""
+            for controller in cpu cpuacct memory blkio pids; do
+                [ -L "$OUT_DIR/cgroup/$controller" ] && continue
+                dirs="$dirs $OUT_DIR/cgroup/$controller$rel"
+            done
+        fi
+        for d in $dirs; do
+            mkdir -p "$d"
+            cp "$template"/* "$d"/
+            : > "$d/cgroup.procs"
+        done
+    done
+    echo -e "${GREEN}✓ $TARGET_CGROUPS contêineres criados.${NC}"
+fi
+
+# --- Passo 4: processos sintéticos ---
+if [ "$TARGET_PROCS" -gt "$recorded" ]; then
+    templates=( $(ls "$OUT_DIR/proc" | grep -E '^[0-9]+$' | sort -n) )
+    if [ ${#templates[@]} -eq 0 ]; then
+        echo -e "${RED}Nenhum processo gravado para usar como modelo.${NC}"
+        exit 1
+    fi
+    # PIDs sintéticos acima de todos os gravados
+    next_pid=$(( ${templates[${#templates[@]} - 1]} + 1 ))
+    missing=$((TARGET_PROCS - recorded))
+    echo "Criando $missing processos sintéticos..."
+
+    for i in $(seq 0 $((missing - 1))); do
+        tpl="$OUT_DIR/proc/${templates[$((i % ${#templates[@]}))]}"
+        pid=$((next_pid + i))
+        dest="$OUT_DIR/proc/$pid"
+        mkdir -p "$dest"
+        cp -P "$tpl"/* "$dest"/ 2>/dev/null
+        cp -RP "$tpl/ns" "$dest"/
+        sed -i "1s/^[0-9]*/$pid/" "$dest/stat"
+        [ -f "$dest/status" ] && sed -i "s/^\(Pid\|Tgid\):\t[0-9]*/\1:\t$pid/" "$dest/status"
+
+        if [ "$TARGET_CGROUPS" -gt 0 ]; then
+            k=$((i % TARGET_CGROUPS + 1))
+            rel="${CONTAINER_REL[$k]}"
+            # Todas as hierarquias apontam para o contêiner
+            awk -F: -v OFS=: -v rel="$rel" '{ $3 = rel; print }' "$tpl/cgroup" > "$dest/cgroup"
+            if [ "$CGROUP_VERSION" -eq 2 ]; then
+                echo "$pid" >> "$OUT_DIR/cgroup$rel/cgroup.procs"
+            else
+                echo "$pid" >> "$OUT_DIR/cgroup/memory$rel/cgroup.procs"
+            fi
+            # Namespaces próprios do contêiner; user e time continuam os do host
+            for type in cgroup ipc mnt net pid uts; do
+                link_namespace "$dest/ns" "$type" "$type:[$((4100000000 + k))]"
+            done
+        fi
+    done
+    echo -e "${GREEN}✓ Árvore com $TARGET_PROCS processos.${NC}"
+fi
+
+# --- Passo 5: Resumo ---
+echo ""
+echo -e "${BLUE}╔════════════════════════════════════════════════════════════╗"
+echo -e "║                      Snapshot Gravado                      ║"
+echo -e "╚════════════════════════════════════════════════════════════╝${NC}"
+echo "  Diretório:  $OUT_DIR"
+echo "  Processos:  $(ls "$OUT_DIR/proc" | grep -cE '^[0-9]+$')"
+echo "  Cgroups:    $(find "$OUT_DIR/cgroup" -type d | wc -l) (v$CGROUP_VERSION)"
+echo "  Namespaces: $(ls "$OUT_DIR/nsfs" | wc -l)"
+echo ""
+echo -e "${YELLOW}Para usar:${NC}"
+echo "  ./bin/resource-monitor --proc-root $OUT_DIR/proc --cgroup-root $OUT_DIR/cgroup --containers"
+echo "  ./bin/bench_collectors -r $OUT_DIR"
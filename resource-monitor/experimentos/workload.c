@@ -0,0 +1,742 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+/**
+ * @file workload.c
+ * @brief Phased workload generator with known ground truth.
+ *        Runs a script of phases, one per line (or per argument, or split
+ *        by ';'). Components joined by '&' on the same line run together:
+ *
+ *          cpu   [threads=N] [duty=%] [iterations=N] [duration=T]
+ *          alloc [threads=N] [rate=B/s] [chunk=B] [hold=B] [size=B] [duration=T]
+ *          leak  [rate=B/s] [chunk=B] [size=B] [duration=T]
+ *          forks [threads=N] [rate=N/s] [count=N] [duration=T]
+ *          io    [threads=N] op=write|read [mode=direct|buffered] [rate=B/s]
+ *                [size=B] [span=B] [block=B] [file=path] [duration=T]
+ *          sleep T
+ *
+ *        cpu spins sin*cos (duty% of every 10 ms), alloc allocates and
+ *        touches at the given rate keeping only `hold` bytes alive, leak
+ *        never frees (until size, duration or allocation failure), forks
+ *        forks children that exit at once, io reads or writes `size` bytes
+ *        cycling over a `span`-byte file. Sizes take K/M/G (binary), times
+ *        ms/s/m/h (bare = s). Every phase boundary is logged:
+ *
+ *          PHASE:index=I,kind=K,event=start|end,t=<s since start>,ts=<epoch s>,...
+ *
+ *        with the phase's ground truth on the end line (iterations and CPU
+ *        seconds, MB allocated or leaked, forks, MB transferred and MB/s).
+ *        -p <ms> adds periodic PROGRESS lines with the running counters;
+ *        the run ends with a WORKLOAD_RESULT line.
+ */
+
+#define MAX_COMPONENTS 8
+#define MAX_PHASES 64
+#define MAX_THREADS 256
+#define BUSY_PERIOD_NS 10000000ULL
+#define CPU_BATCH 10000
+#define DEFAULT_CHUNK (1024 * 1024)
+#define DEFAULT_SPAN (256ULL * 1024 * 1024)
+#define DEFAULT_BLOCK (4 * 1024)
+#define DEFAULT_FILE "/tmp/workload_io"
+
+typedef enum { PHASE_CPU, PHASE_ALLOC, PHASE_LEAK, PHASE_FORKS, PHASE_IO, PHASE_SLEEP } phase_kind_t;
+
+static const char *const kind_names[] = { "cpu", "alloc", "leak", "forks", "io", "sleep" };
+
+typedef struct {
+    phase_kind_t kind;
+    int threads;
+    double duration_s;          // 0 = até completar total
+    double rate;                // Bytes/s ou forks/s; 0 = sem limite
+    uint64_t total;             // Iterações, bytes ou forks; 0 = sem limite
+    int duty;                   // cpu: % de cada 10 ms
+    size_t chunk;               // alloc/leak
+    size_t hold;                // alloc: bytes mantidos vivos
+    size_t block;               // io
+    uint64_t span;              // io: tamanho do arquivo percorrido
+    int direct;
+    int write;
+    char file[256];
+
+    // Estado da execução
+    _Atomic uint64_t done;      // Unidades concluídas (iterações, bytes, forks)
+    _Atomic uint64_t cpu_ns;    // cpu: tempo de CPU das threads
+    _Atomic int failed;
+    char error[128];
+    uint64_t start_ns;
+    uint64_t end_ns;
+} component_t;
+
+typedef struct {
+    component_t components[MAX_COMPONENTS];
+    int count;
+} phase_t;
+
+typedef struct {
+    component_t *component;
+    int index;                  // Thread dentro do componente
+} worker_arg_t;
+
+static volatile sig_atomic_t interrupted = 0;
+static uint64_t origin_ns;
+static _Atomic int running_workers;
+
+// Arquivos criados pelos componentes io, removidos na saída
+static char created_files[MAX_PHASES * MAX_COMPONENTS][300];
+static int created_count = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    interrupted = 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static double epoch_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sleep_ns(uint64_t ns) {
+    struct timespec ts = { (time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL) };
+    nanosleep(&ts, NULL);
+}
+
+static void remove_created_files(void) {
+    for (int i = 0; i < created_count; i++) unlink(created_files[i]);
+}
+
+// ----------------------------------------------------------------------------
+// Parsing
+// ----------------------------------------------------------------------------
+
+/**
+ * "4K", "256MB", "1GiB", "10MB/s" (o "/s" é ignorado aqui); base 1024
+ */
+static int parse_size(const char *text, double *out) {
+    char *end;
+    double v = strtod(text, &end);
+    if (end == text || v < 0) return -1;
+    double mult = 1;
+    switch (*end) {
+        case 'k': case 'K': mult = 1024.0; end++; break;
+        case 'm': case 'M': mult = 1024.0 * 1024; end++; break;
+        case 'g': case 'G': mult = 1024.0 * 1024 * 1024; end++; break;
+        default: break;
+    }
+    if (mult > 1 && *end == 'i') end++;
+    if (*end == 'B' || *end == 'b') end++;
+    if (strcmp(end, "/s") == 0) end += 2;
+    if (*end != '\0') return -1;
+    *out = v * mult;
+    return 0;
+}
+
+static int parse_duration(const char *text, double *out) {
+    char *end;
+    double v = strtod(text, &end);
+    if (end == text || v < 0) return -1;
+    if (strcmp(end, "ms") == 0) v /= 1000.0;
+    else if (strcmp(end, "m") == 0) v *= 60.0;
+    else if (strcmp(end, "h") == 0) v *= 3600.0;
+    else if (*end != '\0' && strcmp(end, "s") != 0) return -1;
+    *out = v;
+    return 0;
+}
+
+static int set_option(component_t *c, const char *key, const char *value) {
+    double v;
+    if (strcmp(key, "duration") == 0) return parse_duration(value, &c->duration_s);
+    if (strcmp(key, "threads") == 0) {
+        c->threads = atoi(value);
+        return c->threads >= 1 && c->threads <= MAX_THREADS ? 0 : -1;
+    }
+    switch (c->kind) {
+        case PHASE_CPU:
+            if (strcmp(key, "duty") == 0) {
+                c->duty = atoi(value);
+                return c->duty >= 1 && c->duty <= 100 ? 0 : -1;
+            }
+            if (strcmp(key, "iterations") == 0 && parse_size(value, &v) == 0) {
+                c->total = (uint64_t)v;
+                return 0;
+            }
+            break;
+        case PHASE_ALLOC:
+        case PHASE_LEAK:
+            if (parse_size(value, &v) != 0) return -1;
+            if (strcmp(key, "rate") == 0) { c->rate = v; return 0; }
+            if (strcmp(key, "size") == 0) { c->total = (uint64_t)v; return 0; }
+            if (strcmp(key, "chunk") == 0 && v >= 1) { c->chunk = (size_t)v; return 0; }
+            if (c->kind == PHASE_ALLOC && strcmp(key, "hold") == 0) { c->hold = (size_t)v; return 0; }
+            break;
+        case PHASE_FORKS:
+            if (parse_size(value, &v) != 0) return -1;
+            if (strcmp(key, "rate") == 0) { c->rate = v; return 0; }
+            if (strcmp(key, "count") == 0) { c->total = (uint64_t)v; return 0; }
+            break;
+        case PHASE_IO:
+            if (strcmp(key, "op") == 0) {
+                if (strcmp(value, "write") != 0 && strcmp(value, "read") != 0) return -1;
+                c->write = strcmp(value, "write") == 0;
+                return 0;
+            }
+            if (strcmp(key, "mode") == 0) {
+                if (strcmp(value, "direct") != 0 && strcmp(value, "buffered") != 0) return -1;
+                c->direct = strcmp(value, "direct") == 0;
+                return 0;
+            }
+            if (strcmp(key, "file") == 0) {
+                snprintf(c->file, sizeof(c->file), "%s", value);
+                return 0;
+            }
+            if (parse_size(value, &v) != 0) return -1;
+            if (strcmp(key, "rate") == 0) { c->rate = v; return 0; }
+            if (strcmp(key, "size") == 0) { c->total = (uint64_t)v; return 0; }
+            if (strcmp(key, "span") == 0 && v >= 1) { c->span = (uint64_t)v; return 0; }
+            if (strcmp(key, "block") == 0 && v >= 512) { c->block = (size_t)v; return 0; }
+            break;
+        case PHASE_SLEEP:
+            break;
+    }
+    return -1;
+}
+
+/**
+ * Um componente: "<tipo> chave=valor ..." (sleep aceita a duração solta)
+ */
+static int parse_component(char *text, component_t *c) {
+    char *saveptr = NULL;
+    char *kind = strtok_r(text, " \t", &saveptr);
+    if (kind == NULL) return -1;
+
+    memset(c, 0, sizeof(*c));
+    int k;
+    for (k = 0; k <= PHASE_SLEEP && strcmp(kind, kind_names[k]) != 0; k++) {}
+    if (k > PHASE_SLEEP) {
+        fprintf(stderr, "Error: unknown phase '%s'\n", kind);
+        return -1;
+    }
+    c->kind = (phase_kind_t)k;
+    c->threads = 1;
+    c->duty = 100;
+    c->chunk = DEFAULT_CHUNK;
+    c->block = DEFAULT_BLOCK;
+    c->span = DEFAULT_SPAN;
+    c->write = 1;
+    snprintf(c->file, sizeof(c->file), "%s", DEFAULT_FILE);
+
+    for (char *tok = strtok_r(NULL, " \t", &saveptr); tok != NULL; tok = strtok_r(NULL, " \t", &saveptr)) {
+        char *eq = strchr(tok, '=');
+        int ok;
+        if (eq == NULL) {
+            ok = c->kind == PHASE_SLEEP && parse_duration(tok, &c->duration_s) == 0;
+        } else {
+            *eq = '\0';
+            ok = set_option(c, tok, eq + 1) == 0;
+            *eq = '=';
+        }
+        if (!ok) {
+            fprintf(stderr, "Error: invalid option '%s' for %s\n", tok, kind);
+            return -1;
+        }
+    }
+
+    // Sem fim definido só o leak (até a alocação falhar)
+    if (c->duration_s <= 0 && c->total == 0 && c->kind != PHASE_LEAK) {
+        fprintf(stderr, "Error: %s needs a duration or an amount\n", kind);
+        return -1;
+    }
+    if (c->kind == PHASE_LEAK) c->threads = 1;
+    // Não há por que percorrer (nem preparar) mais que o total pedido
+    if (c->kind == PHASE_IO && c->total > 0 && c->total / c->threads < c->span) {
+        c->span = c->total / c->threads > c->block ? c->total / c->threads : c->block;
+    }
+    if (c->kind == PHASE_IO && c->direct && (c->block % 512) != 0) {
+        fprintf(stderr, "Error: direct I/O needs a block multiple of 512\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int parse_phase(const char *line, phase_t *phase) {
+    char copy[1024];
+    snprintf(copy, sizeof(copy), "%s", line);
+    phase->count = 0;
+    char *saveptr = NULL;
+    for (char *part = strtok_r(copy, "&", &saveptr); part != NULL; part = strtok_r(NULL, "&", &saveptr)) {
+        if (phase->count == MAX_COMPONENTS) {
+            fprintf(stderr, "Error: at most %d components per phase\n", MAX_COMPONENTS);
+            return -1;
+        }
+        if (parse_component(part, &phase->components[phase->count]) != 0) return -1;
+        phase->count++;
+    }
+    return phase->count > 0 ? 0 : -1;
+}
+
+/**
+ * Acrescenta as fases de um texto (linhas ou ';'), ignorando vazios e '#'
+ */
+static int add_phases(char *text, phase_t *phases, int *count) {
+    char *line_save = NULL;
+    for (char *line = strtok_r(text, "\n", &line_save); line != NULL; line = strtok_r(NULL, "\n", &line_save)) {
+        line[strcspn(line, "#\r")] = '\0';
+        char *phase_save = NULL;
+        for (char *text_phase = strtok_r(line, ";", &phase_save); text_phase != NULL;
+             text_phase = strtok_r(NULL, ";", &phase_save)) {
+            if (strspn(text_phase, " \t") == strlen(text_phase)) continue;
+            if (*count == MAX_PHASES) {
+                fprintf(stderr, "Error: at most %d phases\n", MAX_PHASES);
+                return -1;
+            }
+            if (parse_phase(text_phase, &phases[*count]) != 0) {
+                fprintf(stderr, "  in phase: %s\n", text_phase);
+                return -1;
+            }
+            (*count)++;
+        }
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Workers
+// ----------------------------------------------------------------------------
+
+/**
+ * Fim do componente: duração vencida, quantidade atingida, falha ou sinal
+ */
+static int component_finished(component_t *c) {
+    if (interrupted || atomic_load(&c->failed)) return 1;
+    if (c->total > 0 && atomic_load(&c->done) >= c->total) return 1;
+    return c->duration_s > 0 && now_ns() - c->start_ns >= (uint64_t)(c->duration_s * 1e9);
+}
+
+/**
+ * Taxa por thread: dorme até done/rate, sem passar do fim da duração
+ */
+static void pace(const component_t *c, uint64_t thread_done) {
+    if (c->rate <= 0) return;
+    double per_thread = c->rate / c->threads;
+    uint64_t target = c->start_ns + (uint64_t)(thread_done / per_thread * 1e9);
+    if (c->duration_s > 0) {
+        uint64_t end = c->start_ns + (uint64_t)(c->duration_s * 1e9);
+        if (target > end) target = end;
+    }
+    uint64_t now = now_ns();
+    if (target > now) sleep_ns(target - now);
+}
+
+/**
+ * Reserva até `want` unidades do total compartilhado; 0 quando esgotado
+ */
+static uint64_t claim(component_t *c, uint64_t want) {
+    if (c->total == 0) {
+        atomic_fetch_add(&c->done, want);
+        return want;
+    }
+    uint64_t before = atomic_fetch_add(&c->done, want);
+    if (before >= c->total) {
+        atomic_fetch_sub(&c->done, want);
+        return 0;
+    }
+    if (before + want > c->total) {
+        atomic_fetch_sub(&c->done, before + want - c->total);
+        return c->total - before;
+    }
+    return want;
+}
+
+static void fail(component_t *c, const char *what) {
+    int expected = 0;
+    if (atomic_compare_exchange_strong(&c->failed, &expected, 1)) {
+        snprintf(c->error, sizeof(c->error), "%s: %s", what, strerror(errno));
+    }
+}
+
+static void run_cpu(component_t *c) {
+    volatile double result = 0.0;
+    uint64_t spin = BUSY_PERIOD_NS * (uint64_t)c->duty / 100;
+    uint64_t base = 0;
+    while (!component_finished(c)) {
+        uint64_t period_start = now_ns();
+        do {
+            uint64_t n = claim(c, CPU_BATCH);
+            for (uint64_t i = 0; i < n; i++, base++) {
+                result += sin((double)base) * cos((double)base);
+            }
+            if (n == 0) return;
+        } while (now_ns() - period_start < spin);
+        if (c->duty < 100) sleep_ns(BUSY_PERIOD_NS - spin);
+    }
+}
+
+static void run_alloc(component_t *c) {
+    // alloc: anel de blocos vivos (hold); leak: nunca libera
+    size_t slots = c->kind == PHASE_ALLOC ? c->hold / c->threads / c->chunk : 0;
+    char **ring = slots > 0 ? calloc(slots, sizeof(char *)) : NULL;
+    size_t next = 0;
+    uint64_t mine = 0;
+
+    while (!component_finished(c)) {
+        uint64_t n = claim(c, c->chunk);
+        if (n == 0) break;
+        char *mem = malloc(n);
+        if (mem == NULL) {
+            atomic_fetch_sub(&c->done, n);
+            fail(c, "malloc");
+            break;
+        }
+        memset(mem, (int)(mine & 0xff) | 1, n);
+        mine += n;
+        if (c->kind == PHASE_ALLOC) {
+            if (ring == NULL) {
+                free(mem);
+            } else {
+                free(ring[next]);
+                ring[next] = mem;
+                next = (next + 1) % slots;
+            }
+        }
+        pace(c, mine);
+    }
+
+    if (ring != NULL) {
+        for (size_t i = 0; i < slots; i++) free(ring[i]);
+        free(ring);
+    }
+}
+
+static void run_forks(component_t *c) {
+    uint64_t mine = 0;
+    while (!component_finished(c)) {
+        if (claim(c, 1) == 0) break;
+        pid_t pid = fork();
+        if (pid < 0) {
+            atomic_fetch_sub(&c->done, 1);
+            fail(c, "fork");
+            break;
+        }
+        if (pid == 0) {
+            _exit(0);
+        }
+        waitpid(pid, NULL, 0);
+        pace(c, ++mine);
+    }
+}
+
+static void io_path(const component_t *c, int index, char *path, size_t size) {
+    if (c->threads > 1) {
+        snprintf(path, size, "%s.%d", c->file, index);
+    } else {
+        snprintf(path, size, "%s", c->file);
+    }
+}
+
+/**
+ * Antes da fase (fora da medição): registra os arquivos novos para remoção
+ * e, na leitura, completa cada um até `span` bytes
+ */
+static int prepare_io(component_t *c) {
+    char block[DEFAULT_BLOCK];
+    memset(block, 'A', sizeof(block));
+    for (int t = 0; t < c->threads; t++) {
+        char path[300];
+        io_path(c, t, path, sizeof(path));
+        if (access(path, F_OK) != 0 && created_count < MAX_PHASES * MAX_COMPONENTS) {
+            snprintf(created_files[created_count++], sizeof(created_files[0]), "%s", path);
+        }
+        if (c->write) continue;
+
+        int fd = open(path, O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) {
+            fail(c, "prefill");
+            return -1;
+        }
+        off_t size = lseek(fd, 0, SEEK_END);
+        while (size >= 0 && (uint64_t)size < c->span) {
+            if (write(fd, block, sizeof(block)) != (ssize_t)sizeof(block)) {
+                fail(c, "prefill");
+                close(fd);
+                return -1;
+            }
+            size += (off_t)sizeof(block);
+        }
+        fsync(fd);
+        close(fd);
+    }
+    return 0;
+}
+
+static void run_io(component_t *c, int index) {
+    if (atomic_load(&c->failed)) return;
+    char path[300];
+    io_path(c, index, path, sizeof(path));
+
+    void *buffer = NULL;
+    if (posix_memalign(&buffer, 4096, c->block) != 0) {
+        fail(c, "posix_memalign");
+        return;
+    }
+    memset(buffer, 'A', c->block);
+
+    int flags = (c->write ? O_WRONLY | O_CREAT : O_RDONLY) | (c->direct ? O_DIRECT : 0);
+    int fd = open(path, flags, 0644);
+    if (fd < 0) {
+        fail(c, "open");
+        free(buffer);
+        return;
+    }
+
+    uint64_t offset = 0, mine = 0;
+    uint64_t span = c->span - c->span % c->block;
+    if (span == 0) span = c->block;
+    while (!component_finished(c)) {
+        if (claim(c, c->block) == 0) break;
+        if (offset >= span) offset = 0;
+        ssize_t n = c->write ? pwrite(fd, buffer, c->block, (off_t)offset)
+                             : pread(fd, buffer, c->block, (off_t)offset);
+        if (n != (ssize_t)c->block) {
+            atomic_fetch_sub(&c->done, c->block);
+            if (n >= 0) errno = EIO;
+            fail(c, c->write ? "write" : "read");
+            break;
+        }
+        offset += c->block;
+        mine += c->block;
+        pace(c, mine);
+    }
+    // A escrita só conta quando chega ao dispositivo
+    if (c->write) fsync(fd);
+    close(fd);
+    free(buffer);
+}
+
+static void *worker_main(void *arg) {
+    worker_arg_t *w = arg;
+    component_t *c = w->component;
+    struct timespec cpu_start, cpu_end;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+
+    switch (c->kind) {
+        case PHASE_CPU: run_cpu(c); break;
+        case PHASE_ALLOC:
+        case PHASE_LEAK: run_alloc(c); break;
+        case PHASE_FORKS: run_forks(c); break;
+        case PHASE_IO: run_io(c, w->index); break;
+        case PHASE_SLEEP:
+            while (!component_finished(c)) sleep_ns(10000000ULL);
+            break;
+    }
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+    atomic_fetch_add(&c->cpu_ns, (uint64_t)((cpu_end.tv_sec - cpu_start.tv_sec) * 1000000000LL +
+                                            (cpu_end.tv_nsec - cpu_start.tv_nsec)));
+    atomic_fetch_sub(&running_workers, 1);
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+// Log
+// ----------------------------------------------------------------------------
+
+static void print_stamp(int index, const component_t *c, const char *event, uint64_t at_ns) {
+    printf("%s:index=%d,kind=%s,event=%s,t=%.6f,ts=%.6f", strcmp(event, "progress") == 0 ? "PROGRESS" : "PHASE",
+           index, kind_names[c->kind], event, (at_ns - origin_ns) / 1e9, epoch_s());
+}
+
+/**
+ * Contadores do componente; o tempo de CPU das threads só existe no fim
+ */
+static void print_counters(const component_t *c, double elapsed, int final) {
+    double done = (double)atomic_load(&c->done);
+    double mb = done / (1024.0 * 1024.0);
+    switch (c->kind) {
+        case PHASE_CPU:
+            printf(",threads=%d,iterations=%.0f", c->threads, done);
+            if (final) printf(",cpu_sec=%.4f", atomic_load(&c->cpu_ns) / 1e9);
+            break;
+        case PHASE_ALLOC:
+            printf(",threads=%d,allocated_mb=%.2f,rate_mbps=%.2f", c->threads, mb, elapsed > 0 ? mb / elapsed : 0.0);
+            break;
+        case PHASE_LEAK:
+            printf(",leaked_mb=%.2f,rate_mbps=%.2f", mb, elapsed > 0 ? mb / elapsed : 0.0);
+            break;
+        case PHASE_FORKS:
+            printf(",threads=%d,forks=%.0f,rate=%.1f", c->threads, done, elapsed > 0 ? done / elapsed : 0.0);
+            break;
+        case PHASE_IO:
+            printf(",threads=%d,op=%s,mode=%s,mb=%.2f,mbps=%.2f", c->threads, c->write ? "write" : "read",
+                   c->direct ? "direct" : "buffered", mb, elapsed > 0 ? mb / elapsed : 0.0);
+            break;
+        case PHASE_SLEEP:
+            break;
+    }
+}
+
+/**
+ * Roda uma fase (todos os componentes juntos) e registra as fronteiras
+ */
+static int run_phase(phase_t *phase, int index, int progress_ms) {
+    pthread_t threads[MAX_COMPONENTS * MAX_THREADS];
+    worker_arg_t args[MAX_COMPONENTS * MAX_THREADS];
+    int spawned = 0;
+
+    for (int i = 0; i < phase->count; i++) {
+        if (phase->components[i].kind == PHASE_IO) prepare_io(&phase->components[i]);
+    }
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < phase->count; i++) {
+        component_t *c = &phase->components[i];
+        c->start_ns = start;
+        print_stamp(index, c, "start", start);
+        printf("\n");
+    }
+
+    for (int i = 0; i < phase->count; i++) {
+        component_t *c = &phase->components[i];
+        for (int t = 0; t < c->threads; t++) {
+            args[spawned].component = c;
+            args[spawned].index = t;
+            atomic_fetch_add(&running_workers, 1);
+            if (pthread_create(&threads[spawned], NULL, worker_main, &args[spawned]) != 0) {
+                atomic_fetch_sub(&running_workers, 1);
+                fail(c, "pthread_create");
+                break;
+            }
+            spawned++;
+        }
+    }
+
+    uint64_t next_progress = start + (uint64_t)progress_ms * 1000000ULL;
+    while (atomic_load(&running_workers) > 0) {
+        sleep_ns(5000000ULL);
+        uint64_t now = now_ns();
+        if (progress_ms > 0 && now >= next_progress) {
+            for (int i = 0; i < phase->count; i++) {
+                print_stamp(index, &phase->components[i], "progress", now);
+                print_counters(&phase->components[i], (now - start) / 1e9, 0);
+                printf("\n");
+            }
+            next_progress += (uint64_t)progress_ms * 1000000ULL;
+        }
+    }
+    for (int i = 0; i < spawned; i++) pthread_join(threads[i], NULL);
+
+    int failed = 0;
+    uint64_t end = now_ns();
+    for (int i = 0; i < phase->count; i++) {
+        component_t *c = &phase->components[i];
+        c->end_ns = end;
+        double elapsed = (end - start) / 1e9;
+        print_stamp(index, c, "end", end);
+        printf(",elapsed=%.4f", elapsed);
+        print_counters(c, elapsed, 1);
+        if (atomic_load(&c->failed)) {
+            printf(",status=failed(%s)", c->error);
+            failed = 1;
+        }
+        printf("\n");
+    }
+    return failed ? -1 : 0;
+}
+
+// ----------------------------------------------------------------------------
+// main
+// ----------------------------------------------------------------------------
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-f script] [-p progress_ms] [phase ...]\n"
+            "  Each phase is one line of the script, one argument, or text split by ';'.\n"
+            "  Components joined by '&' run at the same time. Phases:\n"
+            "    cpu   [threads=N] [duty=%%] [iterations=N] [duration=T]\n"
+            "    alloc [threads=N] [rate=B/s] [chunk=B] [hold=B] [size=B] [duration=T]\n"
+            "    leak  [rate=B/s] [chunk=B] [size=B] [duration=T]\n"
+            "    forks [threads=N] [rate=N/s] [count=N] [duration=T]\n"
+            "    io    [threads=N] [op=write|read] [mode=direct|buffered] [rate=B/s]\n"
+            "          [size=B] [span=B] [block=B] [file=path] [duration=T]\n"
+            "    sleep T\n"
+            "  Example: %s 'cpu threads=2 duration=5s' 'sleep 2s' 'leak rate=20MB/s & io op=write rate=10MB/s duration=10s'\n",
+            prog, prog);
+}
+
+int main(int argc, char *argv[]) {
+    static phase_t phases[MAX_PHASES];
+    int phase_count = 0;
+    int progress_ms = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:p:h")) != -1) {
+        switch (opt) {
+            case 'f': {
+                FILE *fp = fopen(optarg, "r");
+                if (fp == NULL) {
+                    perror(optarg);
+                    return EXIT_FAILURE;
+                }
+                char line[1024];
+                while (fgets(line, sizeof(line), fp) != NULL) {
+                    if (add_phases(line, phases, &phase_count) != 0) {
+                        fclose(fp);
+                        return EXIT_FAILURE;
+                    }
+                }
+                fclose(fp);
+                break;
+            }
+            case 'p': progress_ms = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        char text[4096];
+        snprintf(text, sizeof(text), "%s", argv[i]);
+        if (add_phases(text, phases, &phase_count) != 0) return EXIT_FAILURE;
+    }
+    if (phase_count == 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Linhas inteiras mesmo em pipe: o script de experimento lê ao vivo
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    atexit(remove_created_files);
+
+    origin_ns = now_ns();
+    printf("WORKLOAD_START:pid=%d,phases=%d,ts=%.6f\n", getpid(), phase_count, epoch_s());
+
+    int failed = 0, ran = 0;
+    for (int i = 0; i < phase_count && !interrupted; i++) {
+        failed |= run_phase(&phases[i], i + 1, progress_ms) != 0;
+        ran++;
+    }
+
+    printf("WORKLOAD_RESULT:phases=%d,time_sec=%.4f,status=%s\n", ran, (now_ns() - origin_ns) / 1e9,
+           interrupted ? "interrupted" : (failed ? "failed" : "ok"));
+    return failed || interrupted ? EXIT_FAILURE : EXIT_SUCCESS;
+}
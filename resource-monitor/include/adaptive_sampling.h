@@ -0,0 +1,95 @@
+#ifndef ADAPTIVE_SAMPLING_H
+#define ADAPTIVE_SAMPLING_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Amostragem Adaptativa
+// ============================================================================
+//
+// O intervalo de cada alvo acompanha o próprio sinal: uma oscilação de CPU%,
+// um salto de RSS ou o início de estrangulamento (nr_throttled subindo)
+// encolhem o intervalo de uma vez; amostras calmas seguidas o alongam aos
+// poucos até o teto. Um alvo ocioso custa quase nada de coleta e de
+// armazenamento, e um incidente volta a ser visto na resolução mínima.
+
+#define ADAPTIVE_TRIGGER_CPU      0x1u
+#define ADAPTIVE_TRIGGER_RSS      0x2u
+#define ADAPTIVE_TRIGGER_THROTTLE 0x4u
+
+typedef struct {
+    uint64_t min_ms;            // Piso durante mudanças
+    uint64_t max_ms;            // Teto para alvos ociosos/estáveis
+    double cpu_delta;           // Pontos percentuais de CPU entre amostras (0 = ignora)
+    double rss_growth;          // Crescimento relativo do RSS (0.05 = 5%; 0 = ignora)
+    uint64_t throttle;          // Novos períodos estrangulados (0 = ignora)
+    double shrink;              // Fator aplicado numa mudança (0 = direto ao piso)
+    double grow;                // Fator aplicado após steady_samples calmas
+    int steady_samples;
+} adaptive_config_t;
+
+/**
+ * Sinais de uma amostra; só os campos marcados em have são comparados
+ */
+typedef struct {
+    uint32_t have;              // ADAPTIVE_TRIGGER_* presentes
+    double cpu_percent;
+    uint64_t rss;
+    uint64_t nr_throttled;
+} adaptive_signal_t;
+
+typedef struct {
+    adaptive_config_t config;
+    uint64_t interval_ms;       // Intervalo atual
+    adaptive_signal_t last;     // Base de comparação (último valor de cada sinal)
+    int steady;                 // Amostras calmas seguidas
+
+    uint32_t last_trigger;      // ADAPTIVE_TRIGGER_* da última amostra
+    uint64_t samples;
+    uint64_t shrinks;
+    uint64_t grows;
+    uint64_t triggers[3];       // Por sinal: cpu, rss, throttle
+    uint64_t min_seen_ms;
+    uint64_t max_seen_ms;
+} adaptive_state_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Padrões: 0.1 s a 60 s, CPU 5 pontos, RSS 5%, 1 período estrangulado,
+ * encolhe 4x, cresce 1.5x a cada 3 amostras calmas
+ */
+void adaptive_config_default(adaptive_config_t *config);
+
+/**
+ * Faixa "min:max" em segundos (ex.: "0.25:30")
+ * @return 0 em sucesso, -1 se inválida
+ */
+int adaptive_parse_range(adaptive_config_t *config, const char *spec);
+
+/**
+ * Limiares "nome=valor,...": cpu=<pontos>, rss=<%>, throttle=<períodos>,
+ * shrink=<fator>, grow=<fator>, steady=<amostras>
+ * @return 0 em sucesso, -1 se algum nome ou valor for inválido
+ */
+int adaptive_parse_thresholds(adaptive_config_t *config, const char *spec);
+
+/**
+ * @param initial_ms Intervalo inicial (limitado à faixa da configuração)
+ */
+void adaptive_init(adaptive_state_t *state, const adaptive_config_t *config, uint64_t initial_ms);
+
+/**
+ * Compara a amostra com a anterior e ajusta o intervalo
+ * @return Intervalo para a próxima coleta
+ */
+uint64_t adaptive_update(adaptive_state_t *state, const adaptive_signal_t *signal);
+
+/**
+ * Quanto o intervalo mudou e quais sinais o encolheram
+ */
+void print_adaptive_report(const adaptive_state_t *state);
+
+#endif // ADAPTIVE_SAMPLING_H
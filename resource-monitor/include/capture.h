@@ -0,0 +1,153 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "monitor.h"
+
+// ============================================================================
+// Formato Binário Colunar de Captura
+// ============================================================================
+//
+// Arquivo = cabeçalho com o esquema + blocos. Cada bloco guarda até N
+// amostras de um único PID, coluna por coluna, para que os deltas sejam
+// calculados dentro da mesma série:
+//
+//   cabeçalho: "RMCAP\0" u16 versão, u16 campos, {u8 codificação, u8 tipo,
+//              u8 tamanho do nome, nome} por campo
+//   bloco:     u32 "RBLK", i32 pid, u32 amostras, u32 bytes do payload,
+//              {varint tamanho, bytes} por coluna na ordem do esquema
+//
+// Inteiros são little-endian; varint é LEB128 e deltas com sinal usam zigzag.
+// Cada coluna vira uma sequência de resíduos; um resíduo zero é seguido de
+// um varint com quantos zeros a mais vêm em seguida, então um alvo ocioso
+// (contadores parados, RSS constante) custa poucos bytes por bloco.
+
+#define CAPTURE_VERSION 1
+#define CAPTURE_DEFAULT_BLOCK 256       // Amostras por bloco
+
+/**
+ * Codificação de uma coluna
+ */
+typedef enum {
+    CAPTURE_ENC_TIMESTAMP = 1,  // Delta-of-delta (varint zigzag)
+    CAPTURE_ENC_COUNTER = 2,    // Delta do valor anterior (varint zigzag)
+    CAPTURE_ENC_GAUGE = 3,      // XOR com o anterior, só os bytes significativos
+    CAPTURE_ENC_RAW = 4,        // Varint do próprio valor
+    CAPTURE_ENC_OFFSET = 5      // Diferença para a coluna 0 da mesma amostra, em delta
+} capture_encoding_t;
+
+/**
+ * Tipo do campo em export_record_t (como os 64 bits são interpretados)
+ */
+typedef enum {
+    CAPTURE_TYPE_U64 = 1,
+    CAPTURE_TYPE_U32 = 2,
+    CAPTURE_TYPE_F64 = 3,       // Bits IEEE-754 do double
+    CAPTURE_TYPE_I32 = 4
+} capture_type_t;
+
+/**
+ * Destino dos bytes produzidos pelo codificador
+ * @return 0 em sucesso, -1 em erro
+ */
+typedef int (*capture_emit_fn)(void *ctx, const void *data, size_t len);
+
+/**
+ * Amostras pendentes de um PID até o bloco encher
+ */
+typedef struct {
+    pid_t pid;
+    size_t count;
+    export_record_t *records;   // block_records posições
+} capture_series_t;
+
+typedef struct capture_encoder {
+    capture_series_t *series;   // Hash aberto por PID (pid 0 = vazio)
+    size_t capacity;
+    size_t count;
+    size_t block_records;
+
+    capture_emit_fn emit;
+    void *ctx;
+
+    uint8_t *scratch;           // Bloco codificado antes de ser emitido
+    size_t scratch_size;
+
+    uint64_t blocks;
+    uint64_t records;
+    uint64_t encoded_bytes;
+} capture_encoder_t;
+
+/**
+ * Leitor sequencial: decodifica um bloco por vez
+ */
+typedef struct {
+    FILE *fp;
+    int field_count;
+    int field_map[64];          // Coluna do arquivo -> campo conhecido (-1 = ignorar)
+    uint8_t encodings[64];
+
+    pid_t block_pid;
+    uint32_t block_count;
+    uint32_t block_pos;
+    uint64_t *columns;          // field_count x block_count valores decodificados
+    size_t columns_size;
+    uint8_t *payload;
+    size_t payload_size;
+
+    uint64_t blocks;
+} capture_reader_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Escreve o cabeçalho com o esquema em out
+ * @return Bytes escritos, ou 0 se size não comporta
+ */
+size_t capture_format_header(uint8_t *out, size_t size);
+
+/**
+ * @param block_records Amostras por bloco (0 = CAPTURE_DEFAULT_BLOCK)
+ * @return 0 em sucesso, -1 em erro
+ */
+int capture_encoder_init(capture_encoder_t *encoder, size_t block_records,
+                         capture_emit_fn emit, void *ctx);
+
+/**
+ * Acrescenta uma amostra; emite o bloco do PID quando ele enche
+ * @return 0 em sucesso, -1 em erro de emissão
+ */
+int capture_encoder_append(capture_encoder_t *encoder, const export_record_t *record);
+
+/**
+ * Emite todos os blocos parciais (antes de fechar ou rotacionar o arquivo)
+ */
+int capture_encoder_seal(capture_encoder_t *encoder);
+
+void capture_encoder_free(capture_encoder_t *encoder);
+
+/**
+ * Abre uma captura e valida o cabeçalho
+ * @return 0 em sucesso, -1 em erro
+ */
+int capture_reader_open(capture_reader_t *reader, const char *path);
+
+/**
+ * Próxima amostra (na ordem dos blocos: agrupadas por PID dentro de cada bloco)
+ * @return 1 se leu, 0 no fim do arquivo, -1 se o arquivo está corrompido
+ */
+int capture_reader_next(capture_reader_t *reader, export_record_t *record);
+
+void capture_reader_close(capture_reader_t *reader);
+
+/**
+ * Converte uma captura para CSV, JSON ou NDJSON
+ * @return Número de amostras convertidas, ou -1 em erro
+ */
+long capture_convert(const char *input, const char *output, export_format_t format);
+
+#endif // CAPTURE_H
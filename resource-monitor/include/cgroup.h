@@ -2,7 +2,9 @@
 #define CGROUP_H
 
 #include <stdint.h>
+#include <time.h>
 #include <sys/types.h>
+#include <sys/resource.h>
 
 // ============================================================================
 // Tipos de Controladores de Cgroup
@@ -226,6 +228,40 @@ int read_cgroup_metrics_from_path(const char *cpu_path, const char *mem_path, cg
 
 void cleanup_cgroup(const char *name);
 
+// ============================================================================
+// Funções de Execução em Cgroup
+// ============================================================================
+
+/**
+ * Forma de colocar o processo filho dentro do cgroup
+ */
+typedef enum {
+    CGROUP_SPAWN_AUTO = 0,      // clone3 em v2, fork como fallback
+    CGROUP_SPAWN_CLONE3,        // clone3(CLONE_INTO_CGROUP), apenas v2
+    CGROUP_SPAWN_FORK           // fork + escrita em cgroup.procs + exec
+} cgroup_spawn_method_t;
+
+/**
+ * Cria um processo executando argv já dentro do cgroup
+ *
+ * Em cgroup v2 usa clone3(CLONE_INTO_CGROUP), de modo que o filho nasce
+ * sob os limites e sem migração. Se o kernel não suportar, cai para
+ * fork + cgroup.procs (sempre usado em v1).
+ *
+ * @param argv Comando e argumentos (terminado em NULL)
+ * @param cpu_path Caminho do cgroup de CPU (em v2, o cgroup unificado)
+ * @param mem_path Caminho do cgroup de memória (igual a cpu_path em v2)
+ * @param method Método desejado
+ * @param used Recebe o método efetivamente usado (pode ser NULL)
+ * @return PID do filho, ou -1 em erro
+ */
+pid_t spawn_process_in_cgroup(char *const argv[],
+                              const char *cpu_path, const char *mem_path,
+                              cgroup_spawn_method_t method,
+                              cgroup_spawn_method_t *used);
+
+const char* cgroup_spawn_method_to_string(cgroup_spawn_method_t method);
+
 // ============================================================================
 // Funções de Impressão
 // ============================================================================
@@ -242,11 +278,20 @@ void print_cgroup_metrics(const cgroup_metrics_t *metrics);
  */
 const char* cgroup_controller_to_string(cgroup_controller_t controller);
 
-#endif // CGROUP_H
 // ============================================================================
 // Funções de Relatório
 // ============================================================================
 
+/**
+ * Linha da tabela comparativa de utilização
+ */
+typedef struct {
+    char label[32];             // Nome da carga ou PID
+    cgroup_metrics_t metrics;   // Contadores finais do cgroup
+    uint64_t peak_memory;       // Pico de memória em bytes
+    double elapsed_sec;         // Tempo de parede usado para as taxas
+} cgroup_utilization_row_t;
+
 /**
  * Gera relatório de utilização vs limites de um processo
  */
@@ -257,3 +302,93 @@ int generate_cgroup_utilization_report(pid_t pid, const char *output_file);
  */
 int compare_cgroup_utilization(pid_t *pids, int count, const char *output_file);
 
+/**
+ * Imprime a tabela comparativa (CPU, memória, I/O, pico de memória,
+ * razão de throttling e throughput) para linhas já coletadas
+ */
+int print_cgroup_utilization_table(const cgroup_utilization_row_t *rows, int count,
+                                   const char *output_file);
+
+// ============================================================================
+// Execução Paralela de Múltiplas Cargas
+// ============================================================================
+
+#define MAX_WORKLOADS 64
+#define MAX_WORKLOAD_ARGS 32
+
+/**
+ * Uma carga do manifesto: comando, limites e estado de execução
+ */
+typedef struct {
+    // Definição (lida do manifesto)
+    char name[32];
+    double cpu_limit;           // Cores (0 = sem limite)
+    uint64_t mem_limit_mb;      // MB (0 = sem limite)
+    char io_device[32];         // "major:minor" (vazio = sem limite de I/O)
+    uint64_t io_rbps;           // Bytes/s de leitura
+    uint64_t io_wbps;           // Bytes/s de escrita
+    char cpus[64];              // Lista de CPUs do cpuset (vazio = herdada)
+    char cmdline[1024];         // Armazena as strings de argv
+    char *argv[MAX_WORKLOAD_ARGS + 1];
+
+    // Execução
+    char cgroup_name[128];
+    char cpu_path[512];
+    char mem_path[512];
+    pid_t pid;
+    int pidfd;
+    int exited;
+    int status;
+    struct rusage rusage;       // wait4 ao terminar
+    double elapsed_sec;
+    uint64_t peak_memory;
+    cgroup_metrics_t final_metrics;
+} workload_t;
+
+/**
+ * Lê um manifesto de cargas
+ *
+ * Uma carga por linha ('#' inicia comentário, aspas agrupam argumentos):
+ *   <nome> [cpu=<cores>] [mem=<MB>] [io=<maj:min:rbps:wbps>] [cpus=<lista>] -- <comando> [args...]
+ *
+ * @return 0 em sucesso, -1 em erro (mensagem em stderr)
+ */
+int load_workload_manifest(const char *path, workload_t *workloads, int max, int *count);
+
+/**
+ * Interpreta uma linha no formato do manifesto (path e lineno só para mensagens)
+ * @return 1 se uma carga foi lida, 0 para linha vazia/comentário, -1 em erro
+ */
+int parse_workload_line(char *line, workload_t *w, const char *path, int lineno);
+
+/**
+ * Etapas de run_workloads para quem roda uma carga por vez (experiment.h):
+ * cria o cgroup com os limites, lança dentro dele, coleta o término com
+ * wait4 e as métricas finais (block = 0 não espera), e remove o cgroup.
+ * version é o retorno de detect_cgroup_version().
+ */
+int setup_workload_cgroup(workload_t *w, int version);
+int launch_workload(workload_t *w, int version);
+int reap_workload(workload_t *w, int version, const struct timespec *start, int block);
+int read_workload_metrics(const workload_t *w, int version, cgroup_metrics_t *m);
+void cleanup_workload_cgroup(const workload_t *w, int version);
+
+/**
+ * Lança todas as cargas simultaneamente, cada uma em seu cgroup, amostra
+ * todos os cgroups no mesmo timer e imprime a tabela comparativa ao final
+ *
+ * @param keep_running Flag de parada (SIGINT); as cargas restantes são terminadas
+ * @return 0 em sucesso, -1 em erro
+ */
+int run_workloads(workload_t *workloads, int count, int interval, int quiet,
+                  const char *output_file, volatile int *keep_running);
+
+/**
+ * Define o conjunto de CPUs de um cgroup (cpuset.cpus)
+ * @param cgroup_path Caminho do cgroup (hierarquia cpuset em v1)
+ * @param cpus Lista de CPUs (ex: "0-1,4")
+ * @return 0 em sucesso, -1 em erro
+ */
+int set_cgroup_cpuset(const char *cgroup_path, const char *cpus);
+
+#endif // CGROUP_H
@@ -0,0 +1,168 @@
+#ifndef COLLECTOR_POOL_H
+#define COLLECTOR_POOL_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// ============================================================================
+// Pool de Coleta com Roubo de Trabalho
+// ============================================================================
+//
+// Cada rodada (um lote de alvos vencidos) entra numa fila de submissão; um
+// worker ocioso passa uma fatia dela para a própria deque, que consome pelo
+// fundo, e quem fica sem trabalho rouba do topo das outras (deque de
+// Chase-Lev). Um alvo lento (smaps grande, processo em estado D) prende só
+// um worker: o restante da deque dele é roubado pelos outros.
+//
+// A conclusão é por job: cada job terminado entra na lista de concluídos e
+// done_fd (eventfd), que o laço de eventos observa como qualquer outro
+// descritor, fica legível. Várias rodadas podem estar em voo: um job travado
+// segura só a própria rodada, e as seguintes passam pelos workers livres.
+// Submissão e conclusão são feitas pela mesma thread; um job só pode ser
+// submetido de novo depois de concluído.
+
+/**
+ * Deque de Chase-Lev com capacidade fixa (potência de 2)
+ */
+typedef struct {
+    _Alignas(64) _Atomic int64_t top;       // Ladrões
+    _Alignas(64) _Atomic int64_t bottom;    // Dono
+    void **slots;
+    int64_t mask;
+} work_deque_t;
+
+struct collector_pool;
+
+/**
+ * Job submetido e a rodada a que pertence
+ */
+typedef struct {
+    void *job;
+    int round;                      // Índice em collector_pool_t.rounds
+    int busy;                       // Submetido e ainda não colhido
+    uint64_t finished_ns;
+} collector_task_t;
+
+typedef struct {
+    uint64_t submitted_ns;
+    uint64_t finished_ns;           // Último job concluído até agora
+    int jobs;
+    int remaining;                  // Jobs ainda não colhidos
+} collector_round_t;
+
+typedef struct collector_worker {
+    struct collector_pool *pool;
+    int index;
+    pthread_t thread;
+    work_deque_t deque;
+    unsigned int seed;              // Escolha da vítima
+
+    _Atomic uint64_t jobs;          // Executados por este worker
+    _Atomic uint64_t steals;        // Dos quais roubados de outra deque
+    _Atomic uint64_t busy_ns;       // Tempo dentro de jobs
+} collector_worker_t;
+
+/**
+ * Executa um job; roda em uma thread do pool (ou na chamadora sem workers)
+ */
+typedef void (*collector_job_fn)(void *job, collector_worker_t *worker);
+
+typedef struct {
+    uint64_t rounds;
+    uint64_t jobs;
+    uint64_t steals;
+    uint64_t last_round_ns;         // Submissão até o último job da rodada (rodadas concluídas)
+    uint64_t max_round_ns;
+    uint64_t total_round_ns;
+    int last_round_jobs;
+} collector_pool_stats_t;
+
+typedef struct collector_pool {
+    int worker_count;               // 0 = jobs executados na thread que submete
+    int capacity;                   // Jobs em voo (somando as rodadas)
+    collector_worker_t *workers;
+    int context_count;              // Contextos alocados (1 sem workers)
+    collector_job_fn fn;
+
+    // Só a thread que submete
+    collector_task_t *tasks;        // capacity entradas
+    int *free_tasks;
+    int free_task_count;
+    collector_round_t *rounds;      // capacity entradas (toda rodada tem um job)
+    int *free_rounds;
+    int free_round_count;
+    collector_task_t **harvest;     // Cópia dos concluídos fora do lock
+    int outstanding;                // Submetidos e ainda não colhidos
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;            // Workers: há submissão ou trabalho para roubar
+    pthread_cond_t finished;        // collector_pool_wait
+    uint64_t generation;            // Incrementado a cada mudança que vale acordar
+    int shutdown;
+    collector_task_t **queued;      // Fila de submissão (anel de capacity)
+    int queued_head;
+    int queued_count;
+    collector_task_t **done;        // Concluídos aguardando collector_pool_complete
+    int done_count;
+    int done_fd;                    // eventfd: legível quando há concluídos
+
+    collector_pool_stats_t stats;
+} collector_pool_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * @param workers Número de threads (0 = sem threads)
+ * @param capacity Máximo de jobs por rodada
+ * @return 0 em sucesso, -1 em erro
+ */
+int collector_pool_create(collector_pool_t *pool, int workers, int capacity, collector_job_fn fn);
+
+/**
+ * Submete uma rodada, mesmo com outras em voo; sem workers os jobs rodam
+ * antes de retornar
+ * @return 0 em sucesso, -1 com E2BIG (jobs em voo + count > capacity)
+ */
+int collector_pool_submit(collector_pool_t *pool, void **jobs, int count);
+
+/**
+ * Colhe os jobs concluídos (chamar quando done_fd fica legível) e fecha as
+ * rodadas cujos jobs todos foram colhidos
+ *
+ * @param jobs Recebe os jobs concluídos, na ordem de conclusão
+ * @param max Tamanho de jobs (o que sobrar fica para a próxima chamada)
+ * @return Número de jobs colhidos (0 se nenhum terminou)
+ */
+int collector_pool_complete(collector_pool_t *pool, void **jobs, int max);
+
+/**
+ * Bloqueia até todos os jobs em voo terminarem (colher com complete)
+ */
+void collector_pool_wait(collector_pool_t *pool);
+
+/**
+ * collector_pool_wait com prazo
+ * @param timeout_ms Espera máxima (negativo = sem limite)
+ * @return 0 se todos terminaram, -1 com ETIMEDOUT
+ */
+int collector_pool_wait_timeout(collector_pool_t *pool, int timeout_ms);
+
+/**
+ * Desiste de jobs travados: para os workers ociosos e solta as threads
+ * (detach) sem liberar nada. Um job preso ainda escreve no pool quando
+ * terminar, então o pool precisa estar na heap e ser vazado: depois desta
+ * chamada ele não pode ser usado nem destruído.
+ *
+ * @param jobs Recebe os jobs ainda não colhidos (colher antes com complete)
+ * @return Número de jobs abandonados; continuam em uso pelos workers
+ */
+int collector_pool_abandon(collector_pool_t *pool, void **jobs, int max);
+
+void collector_pool_get_stats(const collector_pool_t *pool, collector_pool_stats_t *stats);
+
+void collector_pool_destroy(collector_pool_t *pool);
+
+#endif // COLLECTOR_POOL_H
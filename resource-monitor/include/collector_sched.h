@@ -0,0 +1,119 @@
+#ifndef COLLECTOR_SCHED_H
+#define COLLECTOR_SCHED_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Agendamento Multi-Taxa de Coletores com Orçamento de CPU
+// ============================================================================
+//
+// Cada fonte de dados é uma unidade com intervalo próprio e custo medido
+// (tempo de CPU da thread por execução, média móvel). Com um orçamento,
+// por exemplo 1% de um núcleo, rebalance() alonga os intervalos das
+// unidades mais caras primeiro até a soma custo/intervalo caber nele; as
+// baratas só são tocadas se as caras já chegaram ao limite de alongamento.
+// As taxas pedida, planejada e alcançada ficam no relatório.
+
+typedef enum {
+    COLLECTOR_UNIT_STAT = 0,        // /proc/<pid>/stat: CPU
+    COLLECTOR_UNIT_STATUS,          // /proc/<pid>/status: RSS, VSZ, swap
+    COLLECTOR_UNIT_IO,              // /proc/<pid>/io
+    COLLECTOR_UNIT_SMAPS,           // /proc/<pid>/smaps_rollup: PSS, USS
+    COLLECTOR_UNIT_CGROUP,          // memory.stat do cgroup do processo
+    COLLECTOR_UNIT_NAMESPACES,      // /proc/<pid>/ns
+    COLLECTOR_UNIT_COUNT
+} collector_unit_id_t;
+
+#define COLLECTOR_UNIT_BIT(id) (1u << (id))
+#define COLLECTOR_SCHED_MAX_STRETCH 100     // Intervalo efetivo até 100x o pedido
+#define COLLECTOR_SCHED_COST_WEIGHT 0.2     // Peso da nova medida na média de custo
+
+typedef struct {
+    const char *name;
+    uint64_t requested_ms;          // 0 = desligada
+    uint64_t interval_ms;           // Efetivo, depois do orçamento
+    double cost_us;                 // CPU por execução (estimativa até a 1a medida)
+    uint64_t next_due_ms;
+
+    uint64_t runs;
+    uint64_t cpu_ns;                // Soma do custo medido
+    uint64_t first_run_ms;
+    uint64_t last_run_ms;
+} collector_unit_t;
+
+typedef struct {
+    collector_unit_t units[COLLECTOR_UNIT_COUNT];
+    double budget;                  // Fração de um núcleo (0 = sem limite)
+    double planned_us_per_s;        // CPU das coletas com os intervalos efetivos
+    int over_budget;                // Nem o alongamento máximo cabe no orçamento
+    uint64_t rebalances;            // Vezes em que algum intervalo mudou
+    uint64_t start_ms;
+} collector_sched_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Todas as unidades desligadas, custos com as estimativas iniciais
+ * @param now_ms Relógio monotônico em ms (início das taxas alcançadas)
+ */
+void collector_sched_init(collector_sched_t *sched, uint64_t now_ms);
+
+/**
+ * @return Unidade com esse nome ("stat", "status", "io", "smaps", "cgroup", "ns"), ou -1
+ */
+int collector_sched_unit_from_name(const char *name);
+
+/**
+ * Liga (interval_ms > 0) ou desliga uma unidade; ela vence imediatamente
+ */
+void collector_sched_set_interval(collector_sched_t *sched, collector_unit_id_t unit,
+                                  uint64_t interval_ms);
+
+/**
+ * Liga as unidades de uma lista "nome[=seg],..." (ex.: "stat,status,smaps=10")
+ * @param default_ms Intervalo das unidades sem "=seg"
+ * @return 0 em sucesso, -1 se algum nome ou intervalo for inválido
+ */
+int collector_sched_parse(collector_sched_t *sched, const char *spec, uint64_t default_ms);
+
+/**
+ * @param fraction Fração de um núcleo (0.01 = 1%); 0 remove o limite
+ */
+void collector_sched_set_budget(collector_sched_t *sched, double fraction);
+
+/**
+ * @return Máscara COLLECTOR_UNIT_BIT das unidades vencidas em now_ms
+ */
+uint32_t collector_sched_due(const collector_sched_t *sched, uint64_t now_ms);
+
+/**
+ * @return Instante (ms) da próxima unidade a vencer, UINT64_MAX se nenhuma ligada
+ */
+uint64_t collector_sched_next_due(const collector_sched_t *sched);
+
+/**
+ * Registra uma execução e agenda a próxima (sem deriva; atrasos não acumulam)
+ * @param cpu_ns Tempo de CPU da thread gasto pela unidade
+ */
+void collector_sched_record(collector_sched_t *sched, collector_unit_id_t unit,
+                            uint64_t now_ms, uint64_t cpu_ns);
+
+/**
+ * Recalcula os intervalos efetivos a partir dos custos atuais
+ * @return 1 se algum intervalo mudou, 0 caso contrário
+ */
+int collector_sched_rebalance(collector_sched_t *sched);
+
+/**
+ * @return Execuções por segundo alcançadas (0 antes da segunda execução)
+ */
+double collector_unit_achieved_hz(const collector_unit_t *unit);
+
+/**
+ * Tabela pedido x planejado x alcançado e o CPU gasto nas coletas
+ */
+void print_collector_sched_report(const collector_sched_t *sched, uint64_t now_ms);
+
+#endif // COLLECTOR_SCHED_H
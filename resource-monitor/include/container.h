@@ -0,0 +1,174 @@
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <time.h>
+#include "cgroup.h"
+#include "namespace.h"
+
+// ============================================================================
+// Tipos de Contêiner
+// ============================================================================
+
+/**
+ * Runtime reconhecido a partir do layout do caminho do cgroup
+ */
+typedef enum {
+    CONTAINER_RUNTIME_HOST = 0,     // Nenhum layout de contêiner reconhecido
+    CONTAINER_RUNTIME_DOCKER,       // docker-<id>.scope ou /docker/<id>
+    CONTAINER_RUNTIME_CONTAINERD,   // cri-containerd-<id>.scope ou /kubepods/...
+    CONTAINER_RUNTIME_CRIO,         // crio-<id>.scope
+    CONTAINER_RUNTIME_PODMAN,       // libpod-<id>.scope ou /libpod_parent/libpod-<id>
+    CONTAINER_RUNTIME_SYSTEMD,      // <unit>.service / <unit>.scope
+    CONTAINER_RUNTIME_COUNT
+} container_runtime_t;
+
+/**
+ * Contadores brutos somados dos processos de um contêiner
+ */
+typedef struct {
+    uint64_t cpu_ticks;         // utime + stime em clock ticks
+    uint64_t rss_bytes;         // Soma dos RSS
+    uint64_t read_bytes;        // Bytes lidos do armazenamento
+    uint64_t write_bytes;       // Bytes escritos no armazenamento
+} container_usage_t;
+
+/**
+ * Um contêiner: processos com o mesmo cgroup raiz e o mesmo conjunto de
+ * namespaces (pid, mnt, net)
+ */
+typedef struct {
+    container_runtime_t runtime;
+    char id[72];                // ID do contêiner ou nome da unit
+    char cgroup_path[512];      // Cgroup raiz do contêiner (relativo à hierarquia)
+    char cpu_root[512];         // Caminho absoluto do cgroup raiz (CPU / v2)
+    char mem_root[512];         // Caminho absoluto do cgroup raiz (memória)
+    ino_t cgroup_inode;         // Inode do cgroup raiz (identidade estável)
+    ino_t ns_pid;
+    ino_t ns_mnt;
+    ino_t ns_net;
+    int process_count;
+
+    container_usage_t usage;    // Soma por processo na última atualização
+    double cpu_percent;         // Taxa da soma por processo (100% = 1 core)
+    double read_rate;           // Bytes/s
+    double write_rate;          // Bytes/s
+
+    cgroup_metrics_t cgroup;    // Contadores do próprio cgroup
+    int has_cgroup;
+    double cgroup_cpu_percent;  // Taxa de usage_usec do cgroup
+
+    // Estado de taxa entre atualizações
+    container_usage_t prev_usage;
+    uint64_t prev_cgroup_usec;
+    int has_prev;
+    int seen;
+} container_t;
+
+/**
+ * Resolução de um cgroup folha para o contêiner que o contém, chaveada pelo
+ * inode do cgroup folha. Classificar o caminho e obter o inode do cgroup
+ * raiz só acontece na primeira vez que o cgroup aparece
+ */
+typedef struct {
+    uint64_t key;               // Hash de cpu_leaf e mem_leaf (0 = slot vazio)
+    uint64_t cpu_leaf;          // Inode do cgroup folha (hash do caminho se não montado)
+    uint64_t mem_leaf;
+    char cpu_root[512];         // Caminho absoluto do cgroup raiz (CPU / v2)
+    char mem_root[512];         // Caminho absoluto do cgroup raiz (memória)
+    char root_path[512];        // Cgroup raiz relativo
+    ino_t root_inode;
+    container_runtime_t runtime;
+    char id[72];
+    int seen;
+} container_cgroup_cache_t;
+
+/**
+ * Pertinência de um PID já resolvida, chaveada por PID e instante de início
+ * (PIDs reutilizados não herdam a entrada). O hash do conteúdo de
+ * /proc/<pid>/cgroup revalida a entrada a cada atualização: um processo
+ * movido via cgroup.procs muda o arquivo sem fork/exec/exit
+ */
+typedef struct {
+    pid_t pid;                  // 0 = slot vazio
+    uint64_t start_time;        // Campo 22 de /proc/<pid>/stat
+    uint64_t cgroup_hash;       // Hash do conteúdo de /proc/<pid>/cgroup
+    uint64_t cpu_leaf;          // Cgroup folha resolvido (chave do cache acima)
+    uint64_t mem_leaf;
+    int seen;
+} container_pid_cache_t;
+
+/**
+ * Visão de contêineres do host, atualizada incrementalmente
+ */
+typedef struct {
+    container_t *containers;    // Vetor denso
+    size_t count;
+    size_t capacity;
+    size_t *slots;              // Hash (inode, namespaces) -> índice + 1
+    size_t slot_capacity;
+
+    container_cgroup_cache_t *cache;
+    size_t cache_capacity;
+    size_t cache_count;
+    unsigned long cache_hits;
+    unsigned long cache_misses;
+
+    container_pid_cache_t *pids;
+    size_t pid_capacity;
+    size_t pid_count;
+    unsigned long pid_resolves; // PIDs novos ou movidos (caminhos reinterpretados)
+
+    namespace_index_t index;    // Fonte dos PIDs e de seus namespaces
+    int proc_fd;
+    int cgroup_version;
+    long ticks_per_sec;
+    struct timespec last_refresh;
+    int refreshes;
+} container_view_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Inicializa a visão (constrói o índice de namespaces e assina eventos)
+ * @return 0 em sucesso, -1 em erro
+ */
+int container_view_init(container_view_t *view);
+
+/**
+ * Reagrupa os processos e atualiza contadores e taxas de cada contêiner
+ * @return Número de contêineres, ou -1 em erro
+ */
+int container_view_refresh(container_view_t *view);
+
+void container_view_free(container_view_t *view);
+
+/**
+ * Contêiner ao qual o processo pertence na última atualização
+ * @return Ponteiro interno (válido até a próxima atualização), ou NULL
+ */
+const container_t* container_view_find_pid(container_view_t *view, pid_t pid);
+
+/**
+ * Identifica o runtime pelo caminho do cgroup
+ * @param path Caminho relativo (ex: "/system.slice/docker-<id>.scope")
+ * @param id Recebe o ID do contêiner ou nome da unit
+ * @param root_len Recebe o comprimento do prefixo que é o cgroup raiz
+ * @return Runtime reconhecido
+ */
+container_runtime_t classify_container_cgroup(const char *path, char *id, size_t id_size,
+                                              size_t *root_len);
+
+const char* container_runtime_to_string(container_runtime_t runtime);
+
+/**
+ * Imprime a tabela de contêineres
+ * @param include_host Se zero, omite cgroups sem runtime reconhecido
+ */
+void print_container_view(const container_view_t *view, int include_host);
+
+#endif // CONTAINER_H
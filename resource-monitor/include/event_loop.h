@@ -0,0 +1,160 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// ============================================================================
+// Laço de Eventos (epoll)
+// ============================================================================
+//
+// Tudo que o monitor espera vira um descritor no mesmo epoll: timers de
+// coleta (timerfd), término de alvos (pidfd), gatilhos PSI, eventos de OOM
+// (inotify em memory.events) e sockets. Sem eventos o processo fica
+// bloqueado em epoll_wait, sem acordar periodicamente.
+//
+// Fontes removidas durante o despacho só são liberadas depois do lote, então
+// um callback pode remover qualquer fonte (inclusive a própria).
+
+typedef enum {
+    EVENT_SOURCE_FD = 0,        // Descritor qualquer (socket, eventfd, ...)
+    EVENT_SOURCE_TIMER,         // timerfd; expirations recebe o número de disparos
+    EVENT_SOURCE_PIDFD,         // Dispara uma vez quando o processo termina
+    EVENT_SOURCE_PSI,           // Gatilho de pressão (EPOLLPRI)
+    EVENT_SOURCE_INOTIFY        // Eventos lidos e descartados antes do callback
+} event_source_kind_t;
+
+typedef struct event_loop event_loop_t;
+typedef struct event_source event_source_t;
+
+/**
+ * @param events Máscara EPOLL* recebida
+ */
+typedef void (*event_callback_t)(event_source_t *source, uint32_t events, void *data);
+
+/**
+ * Chamado uma vez depois de cada lote despachado
+ */
+typedef void (*event_batch_hook_t)(event_loop_t *loop, void *data);
+
+struct event_source {
+    event_loop_t *loop;
+    event_source_kind_t kind;
+    int fd;
+    int owns_fd;                // Fecha fd ao remover
+    event_callback_t callback;
+    void *data;
+    uint64_t expirations;       // TIMER: disparos desde o último callback (>1 = atraso)
+    int removed;
+    event_source_t *next_garbage;
+};
+
+struct event_loop {
+    int epoll_fd;
+    int stop;                   // event_loop_stop(): run() retorna após o lote
+    event_source_t *garbage;    // Removidas no lote atual
+    int source_count;
+    event_batch_hook_t batch_hook;
+    void *batch_data;
+
+    uint64_t wakeups;           // Retornos de epoll_wait com eventos
+    uint64_t dispatched;        // Callbacks executados
+};
+
+#define EVENT_LOOP_MAX_BATCH 64
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * @return 0 em sucesso, -1 em erro
+ */
+int event_loop_init(event_loop_t *loop);
+
+/**
+ * Fecha o epoll; fontes ainda registradas devem ser removidas antes por
+ * quem as criou
+ */
+void event_loop_free(event_loop_t *loop);
+
+/**
+ * @param events EPOLLIN, EPOLLOUT, ...
+ * @param owns_fd Não zero: o descritor é fechado ao remover a fonte
+ * @return Fonte, ou NULL em erro
+ */
+event_source_t* event_loop_add_fd(event_loop_t *loop, int fd, uint32_t events, int owns_fd,
+                                  event_callback_t callback, void *data);
+
+/**
+ * Timer periódico em CLOCK_MONOTONIC
+ * @param first_ms Atraso do primeiro disparo (0 = imediato)
+ * @param interval_ms Período (0 = disparo único)
+ */
+event_source_t* event_loop_add_timer(event_loop_t *loop, uint64_t first_ms, uint64_t interval_ms,
+                                     event_callback_t callback, void *data);
+
+/**
+ * Reprograma um timer existente
+ * @return 0 em sucesso, -1 em erro
+ */
+int event_loop_set_timer(event_source_t *timer, uint64_t first_ms, uint64_t interval_ms);
+
+/**
+ * Notifica o término de pid (pidfd_open)
+ * @return Fonte, ou NULL se o processo não existe ou o kernel não tem pidfd
+ */
+event_source_t* event_loop_add_pidfd(event_loop_t *loop, pid_t pid,
+                                     event_callback_t callback, void *data);
+
+/**
+ * Gatilho PSI: dispara quando as tarefas ficam paradas por stall_us dentro
+ * de uma janela de window_us
+ * @param pressure_file /proc/pressure/<recurso> ou <cgroup v2>/<recurso>.pressure
+ * @param full Não zero: "full" (todas as tarefas paradas) em vez de "some"
+ */
+event_source_t* event_loop_add_psi(event_loop_t *loop, const char *pressure_file, int full,
+                                   uint64_t stall_us, uint64_t window_us,
+                                   event_callback_t callback, void *data);
+
+/**
+ * Observa um arquivo com inotify
+ * @param mask IN_MODIFY, ...
+ */
+event_source_t* event_loop_add_inotify(event_loop_t *loop, const char *path, uint32_t mask,
+                                       event_callback_t callback, void *data);
+
+/**
+ * Troca a máscara EPOLL* de uma fonte (ex.: esperar EPOLLOUT com saída pendente)
+ * @return 0 em sucesso, -1 em erro
+ */
+int event_loop_modify(event_source_t *source, uint32_t events);
+
+/**
+ * Remove e (se for dona) fecha a fonte; pode ser chamada dentro de callbacks
+ */
+void event_loop_remove(event_source_t *source);
+
+/**
+ * Espera um lote de eventos e despacha os callbacks
+ * @param timeout_ms -1 = sem limite
+ * @return Eventos despachados, 0 em timeout, -1 em erro (EINTR inclusive)
+ */
+int event_loop_run_once(event_loop_t *loop, int timeout_ms);
+
+/**
+ * Despacha até event_loop_stop() ou *keep_running zerar (sinais
+ * interrompem epoll_wait)
+ * @return 0 em parada normal, -1 em erro
+ */
+int event_loop_run(event_loop_t *loop, volatile int *keep_running);
+
+void event_loop_stop(event_loop_t *loop);
+
+/**
+ * Registra o gancho de fim de lote (NULL remove): agrupa trabalho gerado
+ * por vários eventos do mesmo lote
+ */
+void event_loop_set_batch_hook(event_loop_t *loop, event_batch_hook_t hook, void *data);
+
+#endif // EVENT_LOOP_H
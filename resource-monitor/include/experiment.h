@@ -0,0 +1,140 @@
+#ifndef EXPERIMENT_H
+#define EXPERIMENT_H
+
+#include "cgroup.h"
+
+// ============================================================================
+// Executor de Experimentos
+// ============================================================================
+//
+// Uma especificação declarativa descreve as condições de um experimento
+// (carga, limites, monitor) e como repeti-las; o executor roda cada
+// tentativa no próprio processo, sem shell, time, bc ou awk no caminho da
+// medição: a duração vem do relógio monotônico entre o spawn e o pidfd;
+// CPU, estrangulamento, pico de memória e I/O dos contadores do cgroup
+// (novo a cada tentativa); tempos user/sys e RSS máximo do wait4.
+//
+// Formato (um item por linha, '#' inicia comentário):
+//   set repetitions=<n> warmup=<n> cpus=<lista> confidence=<%> timeout=<s>
+//   setup -- <comando>       roda uma vez antes (fora de cgroup e medição)
+//   teardown -- <comando>    roda uma vez no fim
+//   <nome> [monitor=<s>] [cpu=C] [mem=MB] [io=maj:min:rbps:wbps] [cpus=LISTA] -- <comando>
+//
+// As condições seguem a gramática do --manifest. io=@<caminho>:rbps:wbps
+// usa o dispositivo do sistema de arquivos de <caminho>; cpus= do set fixa
+// as condições que não têm o próprio; monitor=<s> acompanha a carga com o
+// resource-monitor nesse intervalo (o custo de monitorar entra na medição,
+// e a CPU do monitor vira uma métrica). Cada aquecimento e repetição roda
+// todas as condições em sequência (A B C A B C ...), para que deriva de
+// frequência ou de cache não recaia numa única condição.
+
+#define EXPERIMENT_MAX_REPETITIONS 1000
+
+typedef enum {
+    EXP_METRIC_WALL = 0,        // s
+    EXP_METRIC_CPU,             // s, cpu.stat/cpuacct do cgroup
+    EXP_METRIC_USER,            // s, wait4
+    EXP_METRIC_SYS,             // s, wait4
+    EXP_METRIC_CPU_PERCENT,     // CPU do cgroup / duração
+    EXP_METRIC_THROTTLED_PCT,   // Períodos estrangulados / períodos
+    EXP_METRIC_THROTTLED_SEC,
+    EXP_METRIC_PEAK_MB,         // Pico de memória do cgroup
+    EXP_METRIC_MAXRSS_MB,       // wait4
+    EXP_METRIC_READ_MB,         // blkio/io.stat
+    EXP_METRIC_WRITE_MB,
+    EXP_METRIC_READ_MBPS,       // Sobre a duração da tentativa
+    EXP_METRIC_WRITE_MBPS,
+    EXP_METRIC_MONITOR_CPU,     // s, wait4 do monitor (monitor=)
+    EXP_METRIC_COUNT
+} experiment_metric_t;
+
+typedef struct {
+    double values[EXP_METRIC_COUNT];    // NAN quando indisponível
+    int exit_code;                      // 128 + sinal se morto (137 = SIGKILL/OOM)
+} experiment_trial_t;
+
+/**
+ * Resumo de uma amostra; o intervalo é o de confiança da média (t de Student)
+ */
+typedef struct {
+    int n;
+    double mean;
+    double stddev;                      // Desvio padrão amostral
+    double ci_low;
+    double ci_high;
+    double min;
+    double median;
+    double max;
+} sample_summary_t;
+
+typedef struct {
+    workload_t workload;                // Definição (gramática do manifesto)
+    int monitor_interval;               // s (0 = sem monitor)
+    experiment_trial_t *trials;         // repetitions entradas
+    int trial_count;
+    int failures;                       // Tentativas com exit_code != 0
+    sample_summary_t summary[EXP_METRIC_COUNT];
+} experiment_condition_t;
+
+typedef struct {
+    char path[256];
+    int repetitions;
+    int warmup;
+    double confidence;                  // % (ex.: 95)
+    int timeout_sec;                    // 0 = sem limite; senão SIGKILL
+    char cpus[64];
+    workload_t setup;                   // argv[0] == NULL se ausente
+    workload_t teardown;
+    experiment_condition_t conditions[MAX_WORKLOADS];
+    int condition_count;
+} experiment_spec_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Lê uma especificação (padrões: 5 repetições, 1 aquecimento, 95%)
+ * @return 0 em sucesso, -1 em erro (mensagem em stderr)
+ */
+int load_experiment_spec(const char *path, experiment_spec_t *spec);
+
+/**
+ * Roda aquecimentos e repetições e resume cada métrica por condição
+ *
+ * @param monitor_bin Executável usado pelas condições com monitor=
+ * @param keep_running Flag de parada (SIGINT): a tentativa em curso é morta
+ * @return 0 em sucesso, -1 em erro ou interrupção
+ */
+int run_experiment(experiment_spec_t *spec, const char *monitor_bin, int quiet,
+                   volatile int *keep_running);
+
+/**
+ * Tabela por condição: média ± meia largura do intervalo, desvio, min,
+ * mediana, max, e a duração relativa à primeira condição (linha de base)
+ */
+void print_experiment_summary(const experiment_spec_t *spec);
+
+/**
+ * Grava os resumos: "csv" (uma linha por condição e métrica) ou "json"
+ * (resumos e todas as tentativas)
+ * @return 0 em sucesso, -1 em erro
+ */
+int write_experiment_results(const experiment_spec_t *spec, const char *path, const char *format);
+
+void free_experiment_spec(experiment_spec_t *spec);
+
+const char* experiment_metric_name(experiment_metric_t metric);
+
+/**
+ * Quantil p (0.5 < p < 1) da distribuição t de Student com df graus de liberdade
+ */
+double student_t_quantile(double p, int df);
+
+/**
+ * Resume os valores finitos (NAN é ignorado) com intervalo de confiança da
+ * média em confidence% (n < 2: intervalo degenerado na média)
+ */
+void summarize_samples(const double *values, int count, double confidence, sample_summary_t *out);
+
+#endif // EXPERIMENT_H
@@ -0,0 +1,139 @@
+#ifndef EXPORT_DELTA_H
+#define EXPORT_DELTA_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "monitor.h"
+
+// ============================================================================
+// Exportação Só de Mudanças e Linhas Esparsas
+// ============================================================================
+//
+// Cada PID guarda a última amostra emitida. Com change_only, uma amostra só
+// vira linha se algum campo variou mais que epsilon (relativo, com piso 1
+// para valores próximos de zero) ou se o heartbeat venceu. Gauges (RSS,
+// VSZ, taxas) comparam o valor; contadores acumulados comparam a taxa
+// desde a última linha com a taxa que ela registrou, já que o valor só
+// cresce e um epsilon relativo a ele ficaria cada vez mais cego. Um
+// contador em ritmo constante não gera linhas, e entre duas linhas ele
+// se reconstrói pela taxa com erro limitado.
+//
+// Com sparse, dentro da linha os campos iguais aos da última linha do PID
+// no mesmo arquivo saem como "same as previous":
+//
+//   CSV     "=" no lugar do valor; vazio continua sendo "não coletado"
+//   NDJSON  chave omitida; seção inteira omitida se nada mudou nela;
+//           null continua sendo "não coletado"
+//
+// A primeira linha de cada PID em cada arquivo (inclusive após rotação) é
+// densa, então cada arquivo se reconstrói sozinho. export_reader_t lê CSV
+// e NDJSON, densos ou esparsos, e devolve registros densos.
+
+#define EXPORT_DELTA_FIELDS 16   // Colunas numéricas de um registro
+
+/**
+ * Última amostra emitida de um PID
+ */
+typedef struct {
+    pid_t pid;                  // 0 = vazio
+    uint32_t generation;        // Arquivo em que last foi escrito
+    uint64_t emitted_ns;        // monotonic_ns da última emissão
+    uint32_t flags;             // Seções da última linha emitida
+    export_record_t last;       // Seções acumuladas: o valor mais recente de cada uma
+    double rates[EXPORT_DELTA_FIELDS];  // Contadores: taxa por segundo até last (0 = parado)
+} export_delta_entry_t;
+
+typedef struct export_delta {
+    export_delta_entry_t *entries;  // Hash aberto por PID
+    size_t capacity;
+    size_t count;
+
+    int change_only;
+    double epsilon;
+    uint64_t heartbeat_ns;      // 0 = sem heartbeat
+    uint32_t generation;        // Incrementado a cada arquivo novo
+
+    uint64_t emitted;
+    uint64_t suppressed;
+} export_delta_t;
+
+/**
+ * Leitor de exportações de texto (CSV ou NDJSON, densas ou esparsas)
+ */
+typedef struct {
+    FILE *fp;
+    int ndjson;
+    char *line;
+    size_t line_size;
+    uint64_t line_number;
+    export_delta_t state;       // Última linha reconstruída de cada PID
+} export_reader_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * @param change_only Não zero: suprime amostras sem mudança além de epsilon
+ * @param epsilon Variação relativa que conta como mudança, do valor em gauges e
+ *                da taxa em contadores (0 = qualquer diferença)
+ * @param heartbeat_ms Emite mesmo sem mudança após esse tempo (0 = nunca)
+ * @return 0 em sucesso, -1 em erro
+ */
+int export_delta_init(export_delta_t *delta, int change_only, double epsilon, int heartbeat_ms);
+
+void export_delta_free(export_delta_t *delta);
+
+/**
+ * @return Entrada do PID (criada vazia se create), ou NULL
+ */
+export_delta_entry_t* export_delta_lookup(export_delta_t *delta, pid_t pid, int create);
+
+/**
+ * Decide se o registro vira linha e, nesse caso, atualiza a entrada
+ * @param prev Recebe a linha anterior do PID no arquivo atual (NULL se a
+ *             linha deve ser densa); pode ser NULL
+ * @return 1 para emitir, 0 para suprimir, -1 em erro de memória
+ */
+int export_delta_admit(export_delta_t *delta, const export_record_t *record,
+                       export_record_t *prev, int *have_prev);
+
+/**
+ * Arquivo novo (abertura ou rotação): a próxima linha de cada PID é densa
+ */
+void export_delta_new_file(export_delta_t *delta);
+
+/**
+ * Linha CSV esparsa: "=" nos campos iguais aos de prev
+ * @return Bytes escritos (como snprintf)
+ */
+int export_delta_format_csv(char *out, size_t size, const char *timestamp,
+                            const export_record_t *r, const export_record_t *prev);
+
+/**
+ * Linha NDJSON esparsa: só as chaves que diferem de prev
+ * @return Bytes escritos (como snprintf)
+ */
+int export_delta_format_ndjson(char *out, size_t size, const export_record_t *r,
+                               const export_record_t *prev);
+
+/**
+ * @return 0 em sucesso, -1 se o arquivo não abre ou não é CSV/NDJSON
+ */
+int export_reader_open(export_reader_t *reader, const char *path);
+
+/**
+ * Próxima linha, com os campos "iguais ao anterior" preenchidos
+ * @return 1 com um registro, 0 no fim, -1 em linha inválida (errno = EINVAL)
+ */
+int export_reader_next(export_reader_t *reader, export_record_t *record);
+
+void export_reader_close(export_reader_t *reader);
+
+/**
+ * Reescreve uma exportação de texto (esparsa ou não) em formato denso
+ * @return Registros escritos, ou -1 em erro
+ */
+long export_densify(const char *input, const char *output, export_format_t format);
+
+#endif // EXPORT_DELTA_H
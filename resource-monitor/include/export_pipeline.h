@@ -0,0 +1,110 @@
+#ifndef EXPORT_PIPELINE_H
+#define EXPORT_PIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "monitor.h"
+
+// ============================================================================
+// Exportação Assíncrona
+// ============================================================================
+
+/**
+ * O que o coletor faz quando a fila está cheia
+ */
+typedef enum {
+    EXPORT_OVERFLOW_BLOCK = 0,      // Espera o escritor liberar espaço
+    EXPORT_OVERFLOW_DROP_OLDEST,    // Descarta o registro mais antigo da fila
+    EXPORT_OVERFLOW_DROP_NEWEST     // Descarta o registro novo e só conta
+} export_overflow_t;
+
+// Evita que head e tail dividam a mesma linha de cache
+#define EXPORT_CACHE_LINE 64
+
+/**
+ * Slot da fila com número de sequência (esquema de Vyukov): seq == posição
+ * quando o slot está livre para o produtor da posição, posição + 1 quando o
+ * registro foi publicado. Quem avança tail (consumidor, ou o produtor ao
+ * descartar em DROP_OLDEST) é o único dono do slot até liberá-lo
+ */
+typedef struct {
+    _Atomic uint64_t seq;
+    export_record_t record;
+} export_ring_slot_t;
+
+/**
+ * Fila circular lock-free de um produtor (laço de coleta) e um consumidor
+ * (thread escritora). head e tail só crescem; o slot é índice & mask
+ */
+typedef struct {
+    _Alignas(EXPORT_CACHE_LINE) _Atomic uint64_t head;  // Próximo slot a escrever (produtor)
+    _Alignas(EXPORT_CACHE_LINE) _Atomic uint64_t tail;  // Próximo slot a ler (consumidor)
+    _Alignas(EXPORT_CACHE_LINE) export_ring_slot_t *slots;
+    uint64_t mask;                  // Capacidade - 1 (potência de 2)
+} export_ring_t;
+
+typedef struct {
+    uint64_t pushed;                // Registros aceitos na fila
+    uint64_t written;               // Registros entregues ao escritor
+    uint64_t dropped;               // Descartados por fila cheia
+    uint64_t blocked;               // Vezes que o produtor esperou (BLOCK)
+    uint64_t max_depth;             // Maior ocupação observada
+} export_pipeline_stats_t;
+
+/**
+ * Pipeline: o produtor só copia o registro para a fila; formatação e I/O
+ * acontecem na thread escritora
+ */
+typedef struct {
+    export_ring_t ring;
+    export_overflow_t overflow;
+    export_writer_t *writer;
+
+    pthread_t thread;
+    pthread_mutex_t lock;           // Só para dormir/acordar o consumidor
+    pthread_cond_t wakeup;
+    _Atomic int consumer_waiting;
+    _Atomic int stopping;
+    int running;
+
+    _Atomic uint64_t pushed;
+    _Atomic uint64_t written;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t blocked;
+    uint64_t max_depth;             // Atualizado apenas pelo produtor
+} export_pipeline_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Inicia a thread escritora sobre um escritor já aberto
+ * @param capacity Registros na fila (arredondado para potência de 2)
+ * @return 0 em sucesso, -1 em erro
+ */
+int export_pipeline_start(export_pipeline_t *pipeline, export_writer_t *writer,
+                          size_t capacity, export_overflow_t overflow);
+
+/**
+ * Enfileira um registro (chamado apenas pelo produtor)
+ * @return 0 se enfileirado, 1 se algum registro foi descartado
+ */
+int export_pipeline_push(export_pipeline_t *pipeline, const export_record_t *record);
+
+/**
+ * Esvazia a fila, encerra a thread escritora e descarrega o escritor
+ * (o escritor continua aberto; fechá-lo é responsabilidade de quem o abriu)
+ */
+void export_pipeline_stop(export_pipeline_t *pipeline);
+
+void export_pipeline_get_stats(const export_pipeline_t *pipeline, export_pipeline_stats_t *stats);
+
+/**
+ * @return 0 em sucesso, -1 se o nome não for reconhecido
+ */
+int export_overflow_from_string(const char *name, export_overflow_t *overflow);
+
+#endif // EXPORT_PIPELINE_H
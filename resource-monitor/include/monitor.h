@@ -2,7 +2,9 @@
 #define MONITOR_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <sys/types.h>
+#include <time.h>
 
 // ============================================================================
 // CPU MONITORING
@@ -17,7 +19,22 @@ typedef struct {
     double cpu_percent;
 } cpu_metrics_t;
 
+/**
+ * Estado para calcular cpu_percent entre duas coletas do mesmo alvo
+ */
+typedef struct {
+    pid_t pid;
+    uint64_t last_total_time;
+    struct timespec last_timestamp;
+    int initialized;
+} cpu_rate_state_t;
+
 int collect_cpu_metrics(pid_t pid, cpu_metrics_t *metrics);
+
+/**
+ * Versão reentrante: o estado da taxa fica com quem chama, um por alvo
+ */
+int collect_cpu_metrics_r(pid_t pid, cpu_metrics_t *metrics, cpu_rate_state_t *state);
 void reset_cpu_monitor(void);
 uint64_t ticks_to_microseconds(uint64_t ticks);
 void print_cpu_metrics(const cpu_metrics_t *metrics);
@@ -39,6 +56,20 @@ double detect_memory_leak(const memory_metrics_t *metrics);
 void reset_memory_leak_detector(void);
 void print_memory_metrics(const memory_metrics_t *metrics);
 
+// Totais de /proc/[pid]/smaps_rollup (percorre todas as VMAs: bem mais caro
+// que status, por isso tem unidade de coleta própria)
+typedef struct {
+    uint64_t rss;
+    uint64_t pss;               // Páginas compartilhadas divididas entre os donos
+    uint64_t shared;            // Shared_Clean + Shared_Dirty
+    uint64_t private_bytes;     // Private_Clean + Private_Dirty (USS)
+    uint64_t swap;
+    uint64_t swap_pss;
+} memory_smaps_t;
+
+int collect_smaps_rollup(pid_t pid, memory_smaps_t *smaps);
+void print_smaps_rollup(const memory_smaps_t *smaps);
+
 // ============================================================================
 // I/O MONITORING
 // ============================================================================
@@ -52,7 +83,22 @@ typedef struct {
     double write_rate;
 } io_metrics_t;
 
+/**
+ * Estado para calcular read_rate/write_rate entre duas coletas do mesmo alvo
+ */
+typedef struct {
+    uint64_t last_bytes_read;
+    uint64_t last_bytes_written;
+    struct timespec last_timestamp;
+    int initialized;
+} io_rate_state_t;
+
 int collect_io_metrics(pid_t pid, io_metrics_t *metrics);
+
+/**
+ * Versão reentrante: o estado da taxa fica com quem chama, um por alvo
+ */
+int collect_io_metrics_r(pid_t pid, io_metrics_t *metrics, io_rate_state_t *state);
 void reset_io_monitor(void);
 void print_io_metrics(const io_metrics_t *metrics);
 double get_total_io_throughput(const io_metrics_t *metrics);
@@ -77,6 +123,146 @@ void print_network_metrics(const network_metrics_t *metrics);
 // EXPORT
 // ============================================================================
 
+// Campos presentes em export_record_t
+#define EXPORT_HAS_CPU  0x1u
+#define EXPORT_HAS_MEM  0x2u
+#define EXPORT_HAS_IO   0x4u
+
+/**
+ * Amostra de tamanho fixo, capturada no momento da coleta; é o que trafega
+ * entre os coletores e o escritor
+ */
+typedef struct {
+    uint64_t realtime_ns;       // CLOCK_REALTIME da coleta
+    uint64_t monotonic_ns;      // CLOCK_MONOTONIC da coleta
+    pid_t pid;
+    uint32_t flags;             // EXPORT_HAS_*
+    uint32_t interval_ms;       // Intervalo de coleta em vigor (0 = desconhecido)
+    cpu_metrics_t cpu;
+    memory_metrics_t mem;
+    io_metrics_t io;
+} export_record_t;
+
+/**
+ * Preenche um registro com as métricas (NULL = não coletada) e o instante atual
+ */
+void export_record_fill(export_record_t *record, pid_t pid,
+                        const cpu_metrics_t *cpu,
+                        const memory_metrics_t *mem,
+                        const io_metrics_t *io);
+
+typedef enum {
+    EXPORT_FORMAT_CSV = 0,
+    EXPORT_FORMAT_JSON,         // Objetos indentados (legado)
+    EXPORT_FORMAT_NDJSON,       // Um objeto compacto por linha, timestamps em ns
+    EXPORT_FORMAT_BINARY        // Captura colunar compactada (capture.h)
+} export_format_t;
+
+// Quando chamar fdatasync no arquivo exportado
+typedef enum {
+    EXPORT_SYNC_NONE = 0,       // Deixa a cargo do kernel
+    EXPORT_SYNC_FLUSH,          // Após cada descarga do buffer
+    EXPORT_SYNC_CLOSE           // Só ao rotacionar e ao fechar
+} export_sync_t;
+
+typedef struct {
+    export_format_t format;
+    size_t buffer_size;         // Bytes acumulados antes de escrever (padrão 64 KiB)
+    int flush_interval_ms;      // Descarga por tempo (0 = só por tamanho)
+    export_sync_t sync;
+    uint64_t rotate_bytes;      // Rotaciona ao atingir o tamanho (0 = desligado)
+    int rotate_seconds;         // Rotaciona por idade do arquivo (0 = desligado)
+    int keep_files;             // Arquivos rotacionados mantidos (<arquivo>.1 .. .N)
+    int change_only;            // Suprime amostras sem mudança além de change_epsilon
+    double change_epsilon;      // Variação relativa que conta como mudança (export_delta.h)
+    int heartbeat_ms;           // change_only: linha mesmo sem mudança após esse tempo (0 = nunca)
+    int sparse;                 // CSV/NDJSON: campos iguais à linha anterior do PID omitidos
+} export_writer_config_t;
+
+/**
+ * Escritor persistente: abre o arquivo uma vez e formata as linhas em um
+ * buffer, escrito com um único write() por descarga
+ */
+typedef struct export_writer {
+    char path[4096];
+    int fd;
+    export_writer_config_t config;
+
+    char *buffer;
+    size_t length;
+
+    struct capture_encoder *capture;    // Só no formato binário
+    struct export_delta *delta;         // Com change_only ou sparse
+
+    uint64_t file_bytes;        // Tamanho do arquivo atual, incluindo o buffer
+    uint64_t opened_ns;         // Abertura do arquivo atual (CLOCK_MONOTONIC)
+    uint64_t last_flush_ns;
+
+    time_t cached_second;       // Timestamp formatado só quando o segundo muda
+    char cached_timestamp[32];
+
+    uint64_t records;
+    uint64_t flushes;
+    uint64_t rotations;
+    uint64_t bytes_written;
+
+    struct export_writer *next; // Lista de escritores abertos (descarga no exit)
+} export_writer_t;
+
+void export_writer_config_default(export_writer_config_t *config);
+
+/**
+ * Abre (ou continua) o arquivo de exportação
+ * @param config NULL usa a configuração padrão (CSV)
+ * @return 0 em sucesso, -1 em erro
+ */
+int export_writer_open(export_writer_t *writer, const char *path,
+                       const export_writer_config_t *config);
+
+/**
+ * Formata uma amostra no buffer; descarrega/rotaciona conforme a política
+ * @return 0 em sucesso, -1 em erro de escrita
+ */
+int export_writer_write(export_writer_t *writer,
+                        pid_t pid,
+                        const cpu_metrics_t *cpu,
+                        const memory_metrics_t *mem,
+                        const io_metrics_t *io);
+
+/**
+ * Formata um registro já capturado (timestamps do próprio registro)
+ * @return 0 em sucesso, -1 em erro de escrita
+ */
+int export_writer_write_record(export_writer_t *writer, const export_record_t *record);
+
+/**
+ * Descarrega o buffer se o intervalo de descarga já passou (escritor ocioso)
+ */
+int export_writer_tick(export_writer_t *writer);
+
+/**
+ * Escreve o conteúdo do buffer no arquivo
+ * @return 0 em sucesso, -1 em erro
+ */
+int export_writer_flush(export_writer_t *writer);
+
+/**
+ * Descarrega, sincroniza conforme a política e fecha o arquivo
+ * @return 0 em sucesso, -1 se a última descarga falhou
+ */
+int export_writer_close(export_writer_t *writer);
+
+/**
+ * Descarrega todos os escritores abertos (usado no exit e em sinais de término)
+ */
+void export_writer_flush_all(void);
+
+/**
+ * @return 0 em sucesso, -1 se o nome não for reconhecido
+ */
+int export_format_from_string(const char *name, export_format_t *format);
+int export_sync_from_string(const char *name, export_sync_t *sync);
+
 int export_metrics_csv(const char *filename,
                        pid_t pid,
                        const cpu_metrics_t *cpu,
@@ -101,4 +287,23 @@ void print_metrics_summary(pid_t pid,
 int process_exists(pid_t pid);
 int get_process_name(pid_t pid, char *name, size_t size);
 
+/**
+ * Raízes de procfs e cgroupfs ("/proc" e "/sys/fs/cgroup" por padrão).
+ * Apontadas para uma árvore gravada (experimentos/snapshot_host.sh),
+ * coletores, varreduras e relatórios leem a árvore em vez do host.
+ * Devem ser configuradas antes de iniciar as threads de coleta.
+ *
+ * @param root Diretório existente; NULL ou "" restaura o padrão
+ * @return 0 em sucesso, -1 se o caminho for longo demais
+ */
+int set_proc_root(const char *root);
+int set_cgroup_root(const char *root);
+const char* proc_root(void);
+const char* cgroup_root(void);
+
+/**
+ * Incrementado a cada troca de raiz: invalida caches derivados do host
+ */
+unsigned host_root_generation(void);
+
 #endif // MONITOR_H
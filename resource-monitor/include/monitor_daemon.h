@@ -0,0 +1,287 @@
+#ifndef MONITOR_DAEMON_H
+#define MONITOR_DAEMON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include "monitor.h"
+#include "cgroup.h"
+#include "export_pipeline.h"
+#include "shm_metrics.h"
+#include "openmetrics.h"
+#include "event_loop.h"
+#include "collector_pool.h"
+#include "adaptive_sampling.h"
+
+// ============================================================================
+// Daemon com Socket de Controle
+// ============================================================================
+//
+// Um processo residente amostra vários alvos (PIDs ou cgroups), cada um com
+// seu intervalo e conjunto de coletores, e os mantém entre comandos. O
+// estado das taxas é por alvo, então um alvo recém-consultado já tem
+// cpu_percent e taxas de I/O válidos.
+//
+// Tudo roda em um único epoll (event_loop.h): cada grupo de coletores de
+// um alvo tem seu timerfd, o fim de um PID chega pelo pidfd, pressão pelos
+// gatilhos PSI e OOM pelo memory.events (v2) ou memory.oom_control (v1).
+// Sem alvos vencidos nem comandos o daemon não acorda.
+//
+// As leituras de /proc e do cgroup saem do laço: os alvos que vencem em um
+// lote de eventos formam uma rodada no pool de coleta (collector_pool.h), e
+// o laço aplica cada coleta assim que ela termina. Um alvo lento (ou preso em
+// estado D) atrasa só a própria coleta, não os outros alvos, os comandos nem
+// a página; se vencer de novo com a coleta ainda em voo, conta um overrun e
+// sai na rodada seguinte à conclusão.
+//
+// Protocolo do socket Unix (uma linha por comando; a resposta termina com
+// uma linha "OK [...]" ou "ERR <motivo>"):
+//
+//   add pid <PID> [opções]
+//   add cgroup <caminho> [mem=<caminho v1>] [stall=<ms>] [opções]
+//   remove <id>
+//   set <id> [opções]
+//   get <id>                 valores mais recentes, "chave=valor" por linha
+//   list                     um alvo por linha
+//   stats                    rodadas do pool de coleta e workers
+//   shutdown
+//
+// Opções: interval=<ms> (todos os coletores), cpu_interval=, mem_interval=,
+// io_interval= (cadência própria de um coletor; 0 volta a usar interval) e
+// collect=cpu,mem,io. stall=<ms> arma gatilhos PSI "some" de cpu, memory e
+// io do cgroup (v2) com janela de 2 s. adaptive=<min>:<max> (ms; 0 desliga)
+// escala todas as cadências do alvo pelo sinal (adaptive_sampling.h): CPU%,
+// RSS ou memory.current e, em cgroups, nr_throttled.
+
+#define MONITOR_DAEMON_MAX_CLIENTS 16
+#define MONITOR_DAEMON_MAX_TARGETS 16384
+#define MONITOR_DAEMON_DEFAULT_INTERVAL_MS 1000
+#define MONITOR_DAEMON_MIN_INTERVAL_MS 10
+#define MONITOR_DAEMON_LINE_MAX 1024
+#define MONITOR_DAEMON_CONTROL_TIMEOUT_MS 5000  // Cliente desiste sem resposta por esse tempo
+#define MONITOR_DAEMON_DRAIN_TIMEOUT_MS 2000    // free espera as coletas em voo por até esse tempo
+#define MONITOR_DAEMON_PSI_WINDOW_MS 2000    // Sem CAP_SYS_RESOURCE o kernel só aceita múltiplos de 2 s
+
+#define DAEMON_COLLECTORS 3     // cpu, mem, io: o coletor i é o bit (1 << i) de EXPORT_HAS_*
+
+typedef enum {
+    DAEMON_TARGET_PID = 0,
+    DAEMON_TARGET_CGROUP
+} daemon_target_kind_t;
+
+struct monitor_daemon;
+struct daemon_target;
+
+/**
+ * Coleta de um alvo em uma rodada: preenchida por um worker, aplicada pelo
+ * laço quando a rodada termina
+ */
+typedef struct {
+    struct daemon_target *target;
+    uint32_t mask;              // EXPORT_HAS_* pedidos
+    int want_view;              // Preencher view (o worker não lê o monitor)
+    uint64_t now_ns;
+    int gone;                   // PID terminou
+    uint64_t errors;
+    export_record_t fresh;      // PID: só os coletores de mask
+    cgroup_metrics_t cgroup;    // cgroup: só os grupos de mask (has_*)
+    metrics_target_t view;      // comm e namespaces para a página (com metrics)
+} daemon_job_t;
+
+/**
+ * Timer de um grupo de coletores com a mesma cadência
+ */
+typedef struct {
+    event_source_t *source;
+    uint32_t mask;              // EXPORT_HAS_* coletados a cada disparo
+    int interval_ms;
+    int effective_ms;           // interval_ms escalado pela amostragem adaptativa
+    struct daemon_target *target;
+} daemon_timer_t;
+
+/**
+ * Alvo residente: configuração, estado das taxas e a última amostra
+ */
+typedef struct daemon_target {
+    int id;
+    int index;                  // Posição em targets e views
+    struct monitor_daemon *monitor;
+    daemon_target_kind_t kind;
+    pid_t pid;
+    char cpu_path[512];         // cgroup: caminho do controlador cpu (v2: o cgroup)
+    char mem_path[512];         // cgroup: caminho do controlador memory
+    uint32_t collect;           // EXPORT_HAS_* a coletar
+    int interval_ms;
+    int collector_interval_ms[DAEMON_COLLECTORS];   // 0 = interval_ms
+    int exited;                 // PID terminou; o alvo fica até ser removido
+
+    daemon_timer_t timers[DAEMON_COLLECTORS];
+    int timer_count;
+    event_source_t *exit_source;                    // pidfd
+    event_source_t *psi_sources[DAEMON_COLLECTORS];
+    event_source_t *oom_source;
+    int stall_ms;               // 0 = sem gatilhos PSI
+    int adaptive;               // Cadências seguem adapt.interval_ms / interval_ms
+    adaptive_state_t adapt;
+
+    uint64_t samples;
+    uint64_t errors;
+    uint64_t last_sample_ns;
+    uint64_t stall_events;
+    uint64_t oom_events;
+
+    cpu_rate_state_t cpu_rate;
+    io_rate_state_t io_rate;
+    export_record_t last;       // PID: última amostra de cada coletor
+    cgroup_metrics_t cgroup;    // cgroup: última amostra
+    double cgroup_cpu_percent;
+    uint64_t cgroup_last_usage_usec;
+    uint64_t cgroup_last_cpu_ns;
+
+    uint32_t queued_mask;       // Coletores vencidos aguardando rodada
+    int in_flight;              // job está com o pool
+    int detached;               // Removido com a coleta em voo: liberado no fim da rodada
+    daemon_job_t job;
+} daemon_target_t;
+
+typedef struct {
+    int fd;                     // -1 = livre
+    event_source_t *source;
+    struct monitor_daemon *monitor;
+    size_t length;
+    char buffer[MONITOR_DAEMON_LINE_MAX];
+    char *out;                  // Respostas ainda não enviadas (cresce com list/stats)
+    size_t out_capacity;
+    size_t out_length;
+    size_t out_sent;
+} daemon_client_t;
+
+typedef struct monitor_daemon {
+    char socket_path[108];
+    int listen_fd;
+    event_loop_t loop;
+    event_source_t *listen_source;
+    daemon_client_t clients[MONITOR_DAEMON_MAX_CLIENTS];
+
+    daemon_target_t **targets;  // Compacto: remoção move o último para o buraco
+    metrics_target_t *views;    // Mesma indexação de targets (exposição OpenMetrics)
+    int target_count;
+    int target_capacity;
+    int next_id;
+
+    // Saídas opcionais, de quem iniciou o daemon (NULL = desligada)
+    export_pipeline_t *pipeline;
+    shm_metrics_t *live;
+    metrics_server_t *metrics;
+    size_t page_size;
+    int dirty;                  // Houve coleta desde a última página
+
+    collector_pool_t *pool;     // Sem workers as rodadas rodam no laço; na heap para
+                                // poder ser abandonado com uma coleta travada
+    event_source_t *pool_source;                    // pool->done_fd
+    daemon_target_t **pending;  // Vencidos para a próxima rodada
+    int pending_count;
+    void **round;               // daemon_job_t a submeter ou recém-concluídos
+    uint64_t overruns;          // Alvo venceu com a coleta anterior ainda em voo
+    adaptive_config_t adaptive; // Limiares da opção adaptive= (padrões de adaptive_config_default)
+
+    int stop_requested;         // Comando shutdown
+} monitor_daemon_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Cria o socket de controle (substitui um socket antigo no mesmo caminho)
+ * @return 0 em sucesso, -1 em erro
+ */
+int monitor_daemon_init(monitor_daemon_t *monitor, const char *socket_path);
+
+/**
+ * Troca o pool de coleta (antes de monitor_daemon_run ou sem coletas em voo)
+ * @param workers Threads de coleta (0 = coleta no próprio laço)
+ * @return 0 em sucesso, -1 em erro (EBUSY com coleta em voo)
+ */
+int monitor_daemon_set_workers(monitor_daemon_t *monitor, int workers);
+
+/**
+ * @param interval_ms 0 = MONITOR_DAEMON_DEFAULT_INTERVAL_MS
+ * @param collect EXPORT_HAS_* (0 = todos)
+ * @return id do alvo, ou -1 em erro
+ */
+int monitor_daemon_add_pid(monitor_daemon_t *monitor, pid_t pid, int interval_ms, uint32_t collect);
+
+/**
+ * @param mem_path Caminho do controlador memory em v1 (NULL = o mesmo de cpu_path)
+ * @return id do alvo, ou -1 em erro
+ */
+int monitor_daemon_add_cgroup(monitor_daemon_t *monitor, const char *cpu_path,
+                              const char *mem_path, int interval_ms, uint32_t collect);
+
+int monitor_daemon_remove(monitor_daemon_t *monitor, int id);
+
+/**
+ * Muda a cadência de alguns coletores de um alvo
+ * @param collectors EXPORT_HAS_* afetados; todos = muda o intervalo padrão
+ * @param interval_ms 0 com um subconjunto = volta ao intervalo padrão
+ * @return 0 em sucesso, -1 em erro
+ */
+int monitor_daemon_set_interval(monitor_daemon_t *monitor, int id, uint32_t collectors,
+                                int interval_ms);
+
+/**
+ * Liga a amostragem adaptativa de um alvo com os limiares de monitor->adaptive
+ * @param min_ms Piso do intervalo principal (0 desliga e volta às cadências fixas)
+ * @param max_ms Teto do intervalo principal
+ * @return 0 em sucesso, -1 em erro
+ */
+int monitor_daemon_set_adaptive(monitor_daemon_t *monitor, int id, int min_ms, int max_ms);
+
+/**
+ * Arma gatilhos PSI de cpu, memory e io em um alvo cgroup v2
+ * @return 0 em sucesso, -1 em erro (ENOTSUP sem arquivos *.pressure)
+ */
+int monitor_daemon_watch_stall(monitor_daemon_t *monitor, int id, int stall_ms);
+
+/**
+ * Executa um comando do protocolo e copia a resposta para reply
+ * @return Tamanho da resposta completa; >= size indica que reply foi truncada
+ */
+size_t monitor_daemon_command(monitor_daemon_t *monitor, const char *line, char *reply, size_t size);
+
+/**
+ * Despacha timers, eventos e comandos até *keep_running zerar ou chegar um
+ * shutdown
+ */
+int monitor_daemon_run(monitor_daemon_t *monitor, volatile int *keep_running);
+
+/**
+ * Estatísticas das rodadas do pool de coleta
+ */
+void monitor_daemon_get_pool_stats(const monitor_daemon_t *monitor, collector_pool_stats_t *stats);
+
+/**
+ * Fecha clientes e socket e libera os alvos (as saídas são de quem as abriu)
+ *
+ * Coletas ainda presas depois de MONITOR_DAEMON_DRAIN_TIMEOUT_MS são
+ * listadas em stderr e abandonadas: os alvos delas e o pool vazam em vez de
+ * serem liberados sob um worker que ainda os usa.
+ */
+void monitor_daemon_free(monitor_daemon_t *monitor);
+
+/**
+ * Cliente: envia um comando ao daemon e copia a resposta para out
+ * @return 0 se a resposta terminou em OK, 1 se em ERR, -1 em erro de conexão
+ *         (ETIMEDOUT se o daemon ficar MONITOR_DAEMON_CONTROL_TIMEOUT_MS calado)
+ */
+int monitor_daemon_control(const char *socket_path, const char *command, FILE *out);
+
+/**
+ * Converte "cpu,mem,io" em EXPORT_HAS_*
+ * @return 0 em sucesso, -1 se algum nome não for reconhecido
+ */
+int monitor_daemon_parse_collect(const char *list, uint32_t *collect);
+
+#endif // MONITOR_DAEMON_H
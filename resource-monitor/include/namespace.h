@@ -3,6 +3,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stddef.h>
 
 // Número máximo de tipos de namespaces no Linux
 #define MAX_NAMESPACES 8
@@ -24,7 +25,7 @@ typedef struct {
     namespace_type_t type;
     ino_t inode;
     char type_name[16];
-    char path[256];
+    char path[512];
     int available;
 } namespace_info_t;
 
@@ -46,7 +47,8 @@ typedef struct {
 
 // Estatísticas de namespaces no sistema
 typedef struct {
-    int total_processes_analyzed;
+    int total_processes_analyzed;      // PIDs cujos namespaces foram lidos
+    int skipped_processes;             // PIDs que sumiram ou sem acesso a /proc/<pid>/ns
     int unique_pid_namespaces;
     int unique_net_namespaces;
     int unique_mnt_namespaces;
@@ -57,6 +59,84 @@ typedef struct {
     int unique_time_namespaces;
 } namespace_statistics_t;
 
+// Namespace único e quantos processos o usam (chave: dispositivo + inode do nsfs)
+typedef struct {
+    dev_t dev;
+    ino_t inode;
+    int members;
+} namespace_member_count_t;
+
+// Conjunto de namespaces de um tipo: hash com endereçamento aberto
+// (sondagem linear, capacidade potência de 2; slot vazio tem members == 0)
+typedef struct {
+    namespace_member_count_t *slots;
+    size_t capacity;
+    size_t count;
+} namespace_set_t;
+
+// Inodes de todos os namespaces de um PID, como lidos numa varredura de /proc
+typedef struct {
+    pid_t pid;
+    uint8_t present;                // bit i: tipo i disponível
+    dev_t dev[MAX_NAMESPACES];
+    ino_t inode[MAX_NAMESPACES];
+} process_namespace_record_t;
+
+// Processos de um namespace no índice (slot vazio tem count == 0)
+typedef struct {
+    dev_t dev;
+    ino_t inode;
+    pid_t *pids;
+    int count;
+    int capacity;
+} namespace_index_entry_t;
+
+// Namespaces de um PID no índice e sua posição em cada lista de membros
+typedef struct {
+    process_namespace_record_t ns;  // ns.pid == 0: slot vazio
+    int position[MAX_NAMESPACES];
+} namespace_index_process_t;
+
+// Índice de pertinência: inode -> PIDs por tipo e PID -> namespaces,
+// ambos hash com endereçamento aberto, atualizados por eventos fork/exec/exit
+typedef struct {
+    namespace_index_entry_t *entries[MAX_NAMESPACES];
+    size_t entry_capacity[MAX_NAMESPACES];
+    size_t entry_count[MAX_NAMESPACES];
+    namespace_index_process_t *processes;
+    size_t process_capacity;
+    size_t process_count;
+    int events_fd;                  // netlink proc connector, -1 se indisponível
+    int needs_rescan;               // eventos perdidos desde a última varredura
+    unsigned long full_scans;
+    unsigned long events_applied;
+} namespace_index_t;
+
+// Forma de criar/entrar no namespace medida pelo benchmark
+typedef enum {
+    NS_BENCH_UNSHARE = 0,       // unshare() num filho já criado
+    NS_BENCH_CLONE,             // clone3() com CLONE_NEW* (inclui a cópia do processo)
+    NS_BENCH_SETNS,             // setns() num namespace existente
+    NS_BENCH_FORK,              // clone3() sem flags: linha de base do método clone
+    NS_BENCH_METHOD_COUNT
+} namespace_bench_method_t;
+
+// Distribuição de latências de uma rodada do benchmark
+typedef struct {
+    namespace_type_t type;
+    namespace_bench_method_t method;
+    int concurrency;            // Processos criando namespaces ao mesmo tempo
+    int iterations;
+    int failures;
+    double mean_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double max_us;
+    double wall_seconds;
+    double ops_per_sec;         // Vazão agregada de todos os processos
+} namespace_bench_result_t;
+
 // ============================================================================
 // Funções principais
 // ============================================================================
@@ -75,8 +155,98 @@ int find_processes_in_namespace(ino_t ns_inode,
 
 int get_namespace_statistics(namespace_statistics_t *stats);
 
+/**
+ * Lê os namespaces de um PID (um dirfd ns/ e um fstatat por tipo)
+ * @return 0 em sucesso, -1 se o processo não existir ou não for acessível
+ */
+int read_process_namespace_record(pid_t pid, process_namespace_record_t *record);
+
+/**
+ * Varre /proc em paralelo lendo os namespaces de todos os processos
+ * @param records_out Vetor alocado com um registro por PID (liberar com free)
+ * @param threads Número de threads (<= 0 para automático)
+ * @return Número de registros, ou -1 em erro
+ */
+long scan_process_namespaces(process_namespace_record_t **records_out, int threads);
+
+/**
+ * Varre /proc em paralelo contando namespaces únicos e membros por namespace
+ * @param stats Estatísticas agregadas (saída)
+ * @param sets Um conjunto por tipo (saída, opcional; liberar com free_namespace_sets)
+ * @param threads Número de threads da varredura (<= 0 para automático)
+ * @return 0 em sucesso, -1 em erro
+ */
+int get_namespace_statistics_detailed(namespace_statistics_t *stats,
+                                      namespace_set_t sets[MAX_NAMESPACES],
+                                      int threads);
+
+/**
+ * Retorna quantos processos pertencem ao namespace (0 se desconhecido)
+ */
+int namespace_set_members(const namespace_set_t *set, dev_t dev, ino_t inode);
+
+/**
+ * Libera os conjuntos preenchidos por get_namespace_statistics_detailed
+ */
+void free_namespace_sets(namespace_set_t sets[MAX_NAMESPACES]);
+
 int is_process_isolated(pid_t pid, namespace_type_t ns_type);
 
+// ============================================================================
+// Índice de namespaces
+// ============================================================================
+
+/**
+ * Constrói o índice com uma varredura de /proc
+ * @param follow_events Se não-zero, assina eventos de processo do kernel
+ *        para atualizações incrementais (requer CAP_NET_ADMIN; sem eles,
+ *        cada refresh refaz a varredura)
+ * @return 0 em sucesso, -1 em erro
+ */
+int namespace_index_init(namespace_index_t *index, int follow_events);
+
+/**
+ * Aplica os eventos fork/exec/exit pendentes, ou refaz a varredura se
+ * não houver eventos ou se algum tiver sido perdido
+ *
+ * unshare()/setns() sem exec não geram eventos; chame
+ * namespace_index_rescan() periodicamente se isso importar
+ */
+int namespace_index_refresh(namespace_index_t *index);
+
+/**
+ * Descarta o índice e refaz a varredura completa
+ */
+int namespace_index_rescan(namespace_index_t *index);
+
+void namespace_index_free(namespace_index_t *index);
+
+/**
+ * PIDs de um namespace em O(1)
+ * @param count Número de PIDs (saída)
+ * @return Vetor interno do índice (válido até a próxima atualização), ou NULL
+ */
+const pid_t* namespace_index_find(const namespace_index_t *index,
+                                  namespace_type_t ns_type, ino_t ns_inode,
+                                  int *count);
+
+/**
+ * Namespaces de um PID a partir do índice
+ * @return 0 em sucesso, -1 se o PID não estiver indexado
+ */
+int namespace_index_lookup(const namespace_index_t *index, pid_t pid,
+                           process_namespaces_t *ns_info);
+
+/**
+ * Verifica se o processo está isolado do init, sem novos stat()
+ * @return 1 se isolado, 0 se não, -1 se desconhecido
+ */
+int namespace_index_is_isolated(const namespace_index_t *index, pid_t pid,
+                                namespace_type_t ns_type);
+
+int namespace_index_compare(const namespace_index_t *index, pid_t pid1, pid_t pid2,
+                            namespace_comparison_t *comparisons, int *count);
+
 // ============================================================================
 // Funções de impressão
 // ============================================================================
@@ -89,8 +259,54 @@ void print_namespace_comparison(pid_t pid1, pid_t pid2,
 
 void print_namespace_statistics(const namespace_statistics_t *stats);
 
+/**
+ * Imprime os namespaces de um tipo com mais membros (limit <= 0 imprime todos)
+ */
+void print_namespace_member_counts(const namespace_set_t *set,
+                                   namespace_type_t type, int limit);
+
+/**
+ * Imprime, por tipo, quantos processos compartilham cada namespace do PID
+ */
+void print_namespace_membership(const namespace_index_t *index, pid_t pid);
+
 const char* namespace_type_to_string(namespace_type_t type);
 
 long measure_namespace_creation_time(namespace_type_t ns_type);
 
+/**
+ * Converte tipo de namespace para a flag CLONE_NEW* correspondente
+ * @return Flag, ou -1 se o tipo for inválido
+ */
+int namespace_type_to_clone_flag(namespace_type_t type);
+
+// ============================================================================
+// Benchmark de operações de namespace
+// ============================================================================
+
+/**
+ * Mede a latência de uma operação de namespace
+ *
+ * As iterações são divididas entre `concurrency` processos que começam
+ * juntos, o que expõe a contenção de travas do kernel na criação.
+ * Requer root (exceto para user namespaces).
+ *
+ * @param type Tipo de namespace (ignorado por NS_BENCH_FORK)
+ * @param method Operação medida
+ * @param iterations Total de iterações
+ * @param concurrency Número de processos simultâneos
+ * @param result Distribuição das latências (saída)
+ * @return 0 em sucesso, -1 se nenhuma iteração teve sucesso
+ */
+int run_namespace_benchmark(namespace_type_t type, namespace_bench_method_t method,
+                            int iterations, int concurrency,
+                            namespace_bench_result_t *result);
+
+const char* namespace_bench_method_to_string(namespace_bench_method_t method);
+
+/**
+ * Imprime o resultado numa linha chave=valor (NSBENCH_RESULT:...)
+ */
+void print_namespace_bench_result(const namespace_bench_result_t *result);
+
 #endif // NAMESPACE_H
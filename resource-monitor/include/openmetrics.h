@@ -0,0 +1,100 @@
+#ifndef OPENMETRICS_H
+#define OPENMETRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "monitor.h"
+#include "cgroup.h"
+#include "namespace.h"
+
+// ============================================================================
+// Exposição OpenMetrics (Prometheus) por HTTP
+// ============================================================================
+//
+// O laço de coleta renderiza a página uma vez por tick; a thread do servidor
+// só envia a página pronta, então o custo de um scrape não depende de
+// quantos coletores existem nem de quantos alvos são monitorados.
+
+#define OPENMETRICS_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+#define OPENMETRICS_DEFAULT_PORT 9105
+
+/**
+ * Tudo que se sabe de um alvo no tick (has_* = 0: família omitida)
+ */
+typedef struct {
+    pid_t pid;
+    char name[64];              // comm do processo (label "comm")
+    uint32_t flags;             // EXPORT_HAS_* de cpu, mem e io
+    cpu_metrics_t cpu;
+    memory_metrics_t mem;
+    io_metrics_t io;
+    int has_cgroup;
+    cgroup_metrics_t cgroup;
+    int has_namespaces;
+    process_namespaces_t namespaces;
+} metrics_target_t;
+
+/**
+ * Página renderizada; contada por referência para que um scrape em curso
+ * continue enviando a página antiga enquanto o tick publica a nova
+ */
+typedef struct {
+    _Atomic int refs;
+    size_t length;
+    size_t capacity;
+    char data[];
+} metrics_page_t;
+
+typedef struct {
+    int listen_fd;
+    int stop_pipe[2];
+    char unix_path[108];        // Removido ao parar (vazio para TCP)
+
+    pthread_t thread;
+    pthread_mutex_t lock;       // Protege apenas a troca de page
+    metrics_page_t *page;
+    int running;
+
+    _Atomic uint64_t scrapes;
+    _Atomic uint64_t errors;    // Requisições inválidas ou envio interrompido
+} metrics_server_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+/**
+ * Renderiza as famílias por processo, por cgroup e por namespace
+ * @param previous_size Tamanho da página anterior (dimensiona o buffer); 0 se não houver
+ * @return Página com uma referência, ou NULL em erro de alocação
+ */
+metrics_page_t* openmetrics_render(const metrics_target_t *targets, int count,
+                                   size_t previous_size);
+
+void metrics_page_release(metrics_page_t *page);
+
+/**
+ * Escuta em endereço local e inicia a thread do servidor
+ * @param listen "PORTA", "HOST:PORTA" (IPv4) ou "unix:/caminho"
+ * @return 0 em sucesso, -1 em erro
+ */
+int metrics_server_start(metrics_server_t *server, const char *listen);
+
+/**
+ * Troca a página servida (o servidor assume a referência de page)
+ */
+void metrics_server_publish(metrics_server_t *server, metrics_page_t *page);
+
+void metrics_server_stop(metrics_server_t *server);
+
+/**
+ * Preenche comm, cgroup e namespaces de um alvo já com cpu/mem/io
+ * @param cpu_cgroup, mem_cgroup Caminhos conhecidos do cgroup (NULL = descobrir pelo PID)
+ */
+void metrics_target_collect(metrics_target_t *target, const char *cpu_cgroup,
+                            const char *mem_cgroup);
+
+#endif // OPENMETRICS_H
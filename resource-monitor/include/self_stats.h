@@ -0,0 +1,107 @@
+#ifndef SELF_STATS_H
+#define SELF_STATS_H
+
+#include <stdint.h>
+#include "monitor.h"
+#include "collector_sched.h"
+
+// ============================================================================
+// Auto-Instrumentação do Monitor
+// ============================================================================
+//
+// O monitor mede o próprio custo: latência (tempo de parede) de cada
+// coletor e do tick inteiro, atraso de cada despertar em relação ao
+// agendado, e o consumo do processo entre ticks (getrusage, syscalls de
+// leitura/escrita de /proc/self/io, heap em uso). As latências vão para
+// histogramas no estilo HDR: 8 sub-faixas lineares por potência de dois,
+// erro relativo de no máximo 12.5% em qualquer escala, memória fixa.
+
+#define LATENCY_SUB_BITS 3
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_EXPONENT 40                     // ~18 minutos em ns
+#define LATENCY_BUCKETS (2 * LATENCY_SUB_COUNT + \
+                         (LATENCY_MAX_EXPONENT - LATENCY_SUB_BITS) * LATENCY_SUB_COUNT)
+
+typedef struct {
+    uint64_t buckets[LATENCY_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} latency_histogram_t;
+
+/**
+ * Consumo acumulado do próprio processo
+ */
+typedef struct {
+    uint64_t wall_ns;           // CLOCK_MONOTONIC da leitura
+    uint64_t utime_us;
+    uint64_t stime_us;
+    uint64_t minflt;
+    uint64_t majflt;
+    uint64_t nvcsw;
+    uint64_t nivcsw;
+    uint64_t maxrss_kb;
+    int has_io;                 // /proc/self/io legível
+    uint64_t rchar;
+    uint64_t wchar;
+    uint64_t syscr;
+    uint64_t syscw;
+    uint64_t rss_bytes;         // /proc/self/statm
+    uint64_t vsz_bytes;
+    uint64_t heap_bytes;        // mallinfo2: em uso (arenas + mmap)
+} self_usage_t;
+
+typedef struct {
+    latency_histogram_t collect[COLLECTOR_UNIT_COUNT];  // Por unidade de coleta
+    latency_histogram_t tick;       // Do despertar até a amostra entregue
+    latency_histogram_t jitter;     // Atraso do despertar sobre o agendado
+
+    uint64_t ticks;
+    self_usage_t start;
+    self_usage_t last;              // Leitura do fim do último tick
+    self_usage_t previous;          // Leitura anterior a last (taxas da linha exportada)
+    uint64_t max_syscalls_tick;
+    uint64_t heap_peak_bytes;
+} self_stats_t;
+
+// ============================================================================
+// Funções
+// ============================================================================
+
+void latency_histogram_init(latency_histogram_t *histogram);
+
+void latency_histogram_record(latency_histogram_t *histogram, uint64_t ns);
+
+/**
+ * @param percentile 0..100
+ * @return Limite superior da faixa que contém o percentil (limitado a max), 0 se vazio
+ */
+uint64_t latency_histogram_percentile(const latency_histogram_t *histogram, double percentile);
+
+/**
+ * Lê getrusage(RUSAGE_SELF), /proc/self/io, /proc/self/statm e o heap
+ * @return 0 em sucesso, -1 se getrusage falhar
+ */
+int self_usage_read(self_usage_t *usage);
+
+void self_stats_init(self_stats_t *stats);
+
+/**
+ * Fim de um tick: registra a duração e lê o consumo acumulado
+ */
+void self_stats_tick_end(self_stats_t *stats, uint64_t tick_ns);
+
+/**
+ * Linha do próprio monitor para a exportação (pid = getpid()): CPU em
+ * ticks de clock e % desde o tick anterior, trocas de contexto, RSS/VSZ,
+ * faltas de página, e bytes/syscalls de leitura e escrita
+ */
+void self_stats_fill_record(const self_stats_t *stats, export_record_t *record);
+
+/**
+ * Histogramas por coletor, jitter, CPU própria, syscalls por tick e heap
+ */
+void print_self_stats_report(const self_stats_t *stats, const collector_sched_t *sched);
+
+#endif // SELF_STATS_H
@@ -0,0 +1,134 @@
+#ifndef SHM_METRICS_H
+#define SHM_METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+#include "monitor.h"
+
+// ============================================================================
+// Segmento de Métricas ao Vivo (memória compartilhada POSIX)
+// ============================================================================
+//
+// O monitor publica a última amostra de cada alvo em /dev/shm/<nome>.
+// Outros processos mapeiam o segmento só para leitura e leem os valores sem
+// syscalls nem parsing. Cada slot tem um seqlock: o escritor deixa seq ímpar
+// durante a cópia, e o leitor repete a leitura se seq mudou ou estava ímpar.
+//
+//   cabeçalho (64 bytes) | slot 0 | slot 1 | ... | slot N-1
+//
+// O slot de um PID é achado por sondagem linear a partir do hash do PID,
+// então o leitor encontra um alvo sem percorrer o segmento inteiro. Slots
+// removidos ficam marcados para não interromper a sondagem; quando passam de
+// um quarto do segmento, o escritor reinsere os alvos vivos sob o seqlock
+// layout do cabeçalho, e as buscas repetem se ele mudou durante a leitura.
+
+#define SHM_METRICS_MAGIC 0x564c4d52u          // "RMLV"
+#define SHM_METRICS_VERSION 2
+#define SHM_METRICS_DEFAULT_SLOTS 1024
+#define SHM_METRICS_READ_RETRIES 1000           // Escritor morto no meio da escrita
+#define SHM_RECORD_WORDS ((sizeof(export_record_t) + 7) / 8)
+
+typedef struct {
+    _Alignas(64) uint32_t magic;    // Escrito por último: segmento pronto
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t record_size;
+    _Atomic int32_t writer_pid;     // 0 depois que o monitor encerrou
+    _Atomic uint32_t layout;        // Ímpar = slots sendo reorganizados
+    _Atomic uint64_t generation;    // Incrementado a cada publicação
+    uint64_t created_ns;            // CLOCK_REALTIME da criação
+} shm_metrics_header_t;
+
+/**
+ * Slot de um alvo; cada um ocupa linhas de cache próprias
+ */
+typedef struct {
+    _Alignas(64) _Atomic uint32_t seq;              // Ímpar = escrita em andamento
+    _Atomic int32_t pid;                            // 0 = nunca usado, -1 = removido
+    _Atomic uint64_t words[SHM_RECORD_WORDS];       // export_record_t copiado por palavras
+} shm_metrics_slot_t;
+
+/**
+ * Segmento mapeado (pelo monitor em leitura e escrita, pelos consumidores
+ * só para leitura)
+ */
+typedef struct {
+    shm_metrics_header_t *header;
+    shm_metrics_slot_t *slots;
+    size_t map_size;
+    char name[256];
+    int owner;                      // Criou o segmento: remove-o ao destruir
+    uint32_t removed;               // Slots marcados como removidos (escritor)
+} shm_metrics_t;
+
+// ============================================================================
+// Funções do escritor (monitor)
+// ============================================================================
+
+/**
+ * Cria o segmento
+ *
+ * Um segmento com o mesmo nome só é substituído se o monitor que o criou
+ * não existe mais (writer_pid zerado ou morto); leitores antigos continuam
+ * com o mapeamento velho até reabrirem
+ *
+ * @param name Nome POSIX ("/" é acrescentado se faltar)
+ * @param slots Alvos suportados (0 = SHM_METRICS_DEFAULT_SLOTS)
+ * @return 0 em sucesso, -1 em erro (EEXIST se outro monitor vivo o publica)
+ */
+int shm_metrics_create(shm_metrics_t *segment, const char *name, uint32_t slots);
+
+/**
+ * Publica a amostra mais recente do alvo record->pid
+ * @return 0 em sucesso, -1 se não há slot livre (errno = ENOSPC)
+ */
+int shm_metrics_publish(shm_metrics_t *segment, const export_record_t *record);
+
+/**
+ * Libera o slot de um alvo que terminou (reorganiza o segmento quando os
+ * slots removidos passam de um quarto do total)
+ * @return 0 em sucesso, -1 se o PID não está no segmento
+ */
+int shm_metrics_remove(shm_metrics_t *segment, pid_t pid);
+
+/**
+ * Desmapeia e, se o segmento foi criado por este processo, remove o nome
+ */
+void shm_metrics_destroy(shm_metrics_t *segment);
+
+// ============================================================================
+// Funções do leitor (consumidores)
+// ============================================================================
+
+/**
+ * Mapeia um segmento existente só para leitura e valida o cabeçalho
+ * @return 0 em sucesso, -1 em erro
+ */
+int shm_metrics_open(shm_metrics_t *segment, const char *name);
+
+/**
+ * Cópia consistente da última amostra de um PID
+ * @return 0 em sucesso, -1 se o PID não está publicado (ENOENT) ou o slot
+ *         ficou preso em escrita (EAGAIN)
+ */
+int shm_metrics_read(const shm_metrics_t *segment, pid_t pid, export_record_t *record);
+
+/**
+ * Cópia consistente do slot index, para percorrer todos os alvos (uma
+ * reorganização durante o percurso também incrementa a geração)
+ * @return 1 se o slot tem um alvo, 0 se está livre, -1 em erro
+ */
+int shm_metrics_read_slot(const shm_metrics_t *segment, uint32_t index, export_record_t *record);
+
+/**
+ * Contador de publicações: um consumidor compara com o valor anterior para
+ * saber se algo mudou sem ler os slots
+ */
+uint64_t shm_metrics_generation(const shm_metrics_t *segment);
+
+void shm_metrics_close(shm_metrics_t *segment);
+
+#endif // SHM_METRICS_H
@@ -0,0 +1,189 @@
+#define _POSIX_C_SOURCE 200809L
+#include "adaptive_sampling.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+void adaptive_config_default(adaptive_config_t *config) {
+    memset(config, 0, sizeof(*config));
+    config->min_ms = 100;
+    config->max_ms = 60000;
+    config->cpu_delta = 5.0;
+    config->rss_growth = 0.05;
+    config->throttle = 1;
+    config->shrink = 0.25;
+    config->grow = 1.5;
+    config->steady_samples = 3;
+}
+
+/**
+ * Segundos em texto para ms (1 ms .. 1 dia)
+ */
+static int parse_seconds(const char *text, uint64_t *ms) {
+    char *end;
+    double seconds = strtod(text, &end);
+    if (*text == '\0' || *end != '\0' || !(seconds >= 0.001) || seconds > 86400.0) {
+        return -1;
+    }
+    *ms = (uint64_t)llround(seconds * 1000.0);
+    return 0;
+}
+
+int adaptive_parse_range(adaptive_config_t *config, const char *spec) {
+    char copy[64];
+    if (spec == NULL || strlen(spec) >= sizeof(copy)) {
+        return -1;
+    }
+    strcpy(copy, spec);
+
+    char *colon = strchr(copy, ':');
+    if (colon == NULL) {
+        return -1;
+    }
+    *colon = '\0';
+    uint64_t min_ms, max_ms;
+    if (parse_seconds(copy, &min_ms) != 0 || parse_seconds(colon + 1, &max_ms) != 0 ||
+        min_ms > max_ms) {
+        return -1;
+    }
+    config->min_ms = min_ms;
+    config->max_ms = max_ms;
+    return 0;
+}
+
+int adaptive_parse_thresholds(adaptive_config_t *config, const char *spec) {
+    char copy[256];
+    if (spec == NULL || strlen(spec) >= sizeof(copy)) {
+        return -1;
+    }
+    strcpy(copy, spec);
+
+    // Só aplica se a lista inteira for válida
+    adaptive_config_t parsed = *config;
+    char *saveptr = NULL;
+    for (char *item = strtok_r(copy, ",", &saveptr); item != NULL; item = strtok_r(NULL, ",", &saveptr)) {
+        char *value = strchr(item, '=');
+        if (value == NULL) {
+            return -1;
+        }
+        *value++ = '\0';
+        char *end;
+        double v = strtod(value, &end);
+        if (*value == '\0' || *end != '\0' || !(v >= 0) || v > 1e9) {
+            return -1;
+        }
+
+        if (strcmp(item, "cpu") == 0) {
+            parsed.cpu_delta = v;
+        } else if (strcmp(item, "rss") == 0) {
+            parsed.rss_growth = v / 100.0;
+        } else if (strcmp(item, "throttle") == 0 && v == floor(v)) {
+            parsed.throttle = (uint64_t)v;
+        } else if (strcmp(item, "shrink") == 0 && v < 1.0) {
+            parsed.shrink = v;
+        } else if (strcmp(item, "grow") == 0 && v >= 1.0) {
+            parsed.grow = v;
+        } else if (strcmp(item, "steady") == 0 && v >= 1 && v <= 1000 && v == floor(v)) {
+            parsed.steady_samples = (int)v;
+        } else {
+            return -1;
+        }
+    }
+    *config = parsed;
+    return 0;
+}
+
+static uint64_t clamp_interval(const adaptive_config_t *config, uint64_t interval_ms) {
+    if (interval_ms < config->min_ms) return config->min_ms;
+    if (interval_ms > config->max_ms) return config->max_ms;
+    return interval_ms;
+}
+
+void adaptive_init(adaptive_state_t *state, const adaptive_config_t *config, uint64_t initial_ms) {
+    memset(state, 0, sizeof(*state));
+    state->config = *config;
+    state->interval_ms = clamp_interval(config, initial_ms);
+    state->min_seen_ms = state->interval_ms;
+    state->max_seen_ms = state->interval_ms;
+}
+
+/**
+ * @return ADAPTIVE_TRIGGER_* dos sinais que passaram do limiar
+ */
+static uint32_t detect_change(const adaptive_state_t *state, const adaptive_signal_t *signal,
+                              int *compared) {
+    const adaptive_config_t *config = &state->config;
+    const adaptive_signal_t *last = &state->last;
+    uint32_t both = signal->have & last->have;
+    uint32_t trigger = 0;
+
+    *compared = both != 0;
+    if ((both & ADAPTIVE_TRIGGER_CPU) && config->cpu_delta > 0 &&
+        fabs(signal->cpu_percent - last->cpu_percent) >= config->cpu_delta) {
+        trigger |= ADAPTIVE_TRIGGER_CPU;
+    }
+    // Só crescimento: RSS caindo é o alvo liberando memória
+    if ((both & ADAPTIVE_TRIGGER_RSS) && config->rss_growth > 0 && last->rss > 0 &&
+        signal->rss > last->rss &&
+        (double)(signal->rss - last->rss) / (double)last->rss >= config->rss_growth) {
+        trigger |= ADAPTIVE_TRIGGER_RSS;
+    }
+    // Contador menor = cgroup recriado; vira só a nova base
+    if ((both & ADAPTIVE_TRIGGER_THROTTLE) && config->throttle > 0 &&
+        signal->nr_throttled >= last->nr_throttled &&
+        signal->nr_throttled - last->nr_throttled >= config->throttle) {
+        trigger |= ADAPTIVE_TRIGGER_THROTTLE;
+    }
+    return trigger;
+}
+
+uint64_t adaptive_update(adaptive_state_t *state, const adaptive_signal_t *signal) {
+    const adaptive_config_t *config = &state->config;
+    int compared;
+    uint32_t trigger = detect_change(state, signal, &compared);
+
+    // A base de cada sinal é sempre o último valor visto
+    if (signal->have & ADAPTIVE_TRIGGER_CPU) state->last.cpu_percent = signal->cpu_percent;
+    if (signal->have & ADAPTIVE_TRIGGER_RSS) state->last.rss = signal->rss;
+    if (signal->have & ADAPTIVE_TRIGGER_THROTTLE) state->last.nr_throttled = signal->nr_throttled;
+    state->last.have |= signal->have;
+    state->last_trigger = trigger;
+    if (!compared) {
+        return state->interval_ms;
+    }
+    state->samples++;
+
+    uint64_t next = state->interval_ms;
+    if (trigger) {
+        for (int i = 0; i < 3; i++) {
+            if (trigger & (1u << i)) state->triggers[i]++;
+        }
+        state->steady = 0;
+        next = config->shrink > 0 ? clamp_interval(config, (uint64_t)(state->interval_ms * config->shrink))
+                                  : config->min_ms;
+        if (next < state->interval_ms) state->shrinks++;
+    } else if (++state->steady >= config->steady_samples) {
+        // Crescimento gradual: uma mudança logo depois ainda pega resolução boa
+        state->steady = 0;
+        next = clamp_interval(config, (uint64_t)ceil(state->interval_ms * config->grow));
+        if (next > state->interval_ms) state->grows++;
+    }
+
+    state->interval_ms = next;
+    if (next < state->min_seen_ms) state->min_seen_ms = next;
+    if (next > state->max_seen_ms) state->max_seen_ms = next;
+    return next;
+}
+
+void print_adaptive_report(const adaptive_state_t *state) {
+    const adaptive_config_t *config = &state->config;
+    printf("\n--- Adaptive Sampling (%.3f s .. %.3f s) ---\n",
+           config->min_ms / 1000.0, config->max_ms / 1000.0);
+    printf("Current interval:   %.3f s (ranged %.3f s .. %.3f s)\n",
+           state->interval_ms / 1000.0, state->min_seen_ms / 1000.0, state->max_seen_ms / 1000.0);
+    printf("Samples compared:   %lu (%lu shrinks, %lu grows)\n",
+           state->samples, state->shrinks, state->grows);
+    printf("Triggers:           cpu %lu | rss %lu | throttle %lu\n",
+           state->triggers[0], state->triggers[1], state->triggers[2]);
+}
@@ -0,0 +1,675 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "capture.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+static const uint8_t file_magic[6] = { 'R', 'M', 'C', 'A', 'P', 0 };
+static const uint8_t block_magic[4] = { 'R', 'B', 'L', 'K' };
+
+#define BLOCK_HEADER_SIZE 16
+#define MAX_VARINT 10
+#define MAX_FIELDS 64
+
+/**
+ * Campo do esquema: nome gravado no cabeçalho e posição em export_record_t
+ */
+typedef struct {
+    const char *name;
+    uint8_t encoding;
+    uint8_t type;
+    size_t offset;
+} capture_field_t;
+
+#define FIELD(name, enc, type, member) \
+    { name, CAPTURE_ENC_##enc, CAPTURE_TYPE_##type, offsetof(export_record_t, member) }
+
+// O PID fica no cabeçalho do bloco; todo o resto é coluna
+static const capture_field_t schema[] = {
+    FIELD("monotonic_ns",        TIMESTAMP, U64, monotonic_ns),
+    FIELD("realtime_ns",         OFFSET,    U64, realtime_ns),
+    FIELD("flags",               GAUGE,     U32, flags),
+    FIELD("cpu_user_time",       COUNTER,   U64, cpu.user_time),
+    FIELD("cpu_system_time",     COUNTER,   U64, cpu.system_time),
+    FIELD("cpu_total_time",      COUNTER,   U64, cpu.total_time),
+    FIELD("cpu_context_switches", COUNTER,  U64, cpu.context_switches),
+    FIELD("cpu_num_threads",     GAUGE,     U32, cpu.num_threads),
+    FIELD("cpu_percent",         GAUGE,     F64, cpu.cpu_percent),
+    FIELD("mem_rss",             GAUGE,     U64, mem.rss),
+    FIELD("mem_vsz",             GAUGE,     U64, mem.vsz),
+    FIELD("mem_swap",            GAUGE,     U64, mem.swap),
+    FIELD("mem_page_faults",     COUNTER,   U64, mem.page_faults),
+    FIELD("io_bytes_read",       COUNTER,   U64, io.bytes_read),
+    FIELD("io_bytes_written",    COUNTER,   U64, io.bytes_written),
+    FIELD("io_syscalls_read",    COUNTER,   U64, io.syscalls_read),
+    FIELD("io_syscalls_write",   COUNTER,   U64, io.syscalls_write),
+    FIELD("io_read_rate",        GAUGE,     F64, io.read_rate),
+    FIELD("io_write_rate",       GAUGE,     F64, io.write_rate),
+    FIELD("interval_ms",         GAUGE,     U32, interval_ms),
+};
+
+#define SCHEMA_FIELDS ((int)(sizeof(schema) / sizeof(schema[0])))
+
+// ----------------------------------------------------------------------------
+// Acesso aos campos e primitivas de codificação
+// ----------------------------------------------------------------------------
+
+static uint64_t field_get(const export_record_t *record, const capture_field_t *field) {
+    const char *p = (const char *)record + field->offset;
+    uint64_t v64;
+    uint32_t v32;
+
+    switch (field->type) {
+        case CAPTURE_TYPE_U32:
+        case CAPTURE_TYPE_I32:
+            memcpy(&v32, p, sizeof(v32));
+            return v32;
+        default:
+            memcpy(&v64, p, sizeof(v64));
+            return v64;
+    }
+}
+
+static void field_set(export_record_t *record, const capture_field_t *field, uint64_t value) {
+    char *p = (char *)record + field->offset;
+    uint32_t v32 = (uint32_t)value;
+
+    switch (field->type) {
+        case CAPTURE_TYPE_U32:
+        case CAPTURE_TYPE_I32:
+            memcpy(p, &v32, sizeof(v32));
+            break;
+        default:
+            memcpy(p, &value, sizeof(value));
+            break;
+    }
+}
+
+static uint8_t* put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        *p++ = (uint8_t)(v >> (8 * i));
+    }
+    return p;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint8_t* put_varint(uint8_t *p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+/**
+ * @return Ponteiro após o varint, ou NULL se os bytes acabaram
+ */
+static const uint8_t* get_varint(const uint8_t *p, const uint8_t *end, uint64_t *v) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            *v = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/**
+ * XOR com o valor anterior: byte de controle (bytes zero à esquerda << 4 |
+ * bytes zero à direita) seguido só dos bytes do meio. Valor repetido custa
+ * um byte (0x80)
+ */
+static uint8_t* put_xor(uint8_t *p, uint64_t x) {
+    if (x == 0) {
+        *p++ = 0x80;
+        return p;
+    }
+
+    int lead = 0, trail = 0;
+    while (((x >> (56 - 8 * lead)) & 0xff) == 0) lead++;
+    while (((x >> (8 * trail)) & 0xff) == 0) trail++;
+
+    *p++ = (uint8_t)(lead << 4 | trail);
+    for (int byte = 7 - lead; byte >= trail; byte--) {
+        *p++ = (uint8_t)(x >> (8 * byte));
+    }
+    return p;
+}
+
+static const uint8_t* get_xor(const uint8_t *p, const uint8_t *end, uint64_t *x) {
+    if (p >= end) return NULL;
+
+    uint8_t control = *p++;
+    if (control == 0x80) {
+        *x = 0;
+        return p;
+    }
+    int lead = control >> 4, trail = control & 0x0f;
+    if (lead + trail >= 8) return NULL;
+
+    uint64_t value = 0;
+    for (int byte = 7 - lead; byte >= trail; byte--) {
+        if (p >= end) return NULL;
+        value |= (uint64_t)*p++ << (8 * byte);
+    }
+    *x = value;
+    return p;
+}
+
+/**
+ * Transforma os valores em resíduos (in place). O estado (anterior, delta
+ * anterior) começa zerado em cada bloco, então blocos decodificam de forma
+ * independente. Em OFFSET, reference é a coluna 0 do mesmo bloco
+ */
+static void column_residuals(uint64_t *values, size_t n, uint8_t encoding,
+                             const uint64_t *reference) {
+    uint64_t prev = 0, prev_delta = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = values[i];
+        if (encoding == CAPTURE_ENC_OFFSET) {
+            v -= reference[i];
+        }
+        switch (encoding) {
+            case CAPTURE_ENC_TIMESTAMP: {
+                uint64_t delta = v - prev;
+                values[i] = (i == 0) ? v : zigzag((int64_t)(delta - prev_delta));
+                prev_delta = (i == 0) ? 0 : delta;
+                break;
+            }
+            case CAPTURE_ENC_COUNTER:
+            case CAPTURE_ENC_OFFSET:
+                values[i] = zigzag((int64_t)(v - prev));
+                break;
+            case CAPTURE_ENC_GAUGE:
+                values[i] = v ^ prev;
+                break;
+            default:
+                break;
+        }
+        prev = v;
+    }
+}
+
+static int column_restore(uint64_t *values, size_t n, uint8_t encoding,
+                          const uint64_t *reference) {
+    uint64_t prev = 0, prev_delta = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t raw = values[i], v;
+        switch (encoding) {
+            case CAPTURE_ENC_TIMESTAMP:
+                if (i == 0) {
+                    v = raw;
+                } else {
+                    uint64_t delta = prev_delta + (uint64_t)unzigzag(raw);
+                    v = prev + delta;
+                    prev_delta = delta;
+                }
+                break;
+            case CAPTURE_ENC_COUNTER:
+            case CAPTURE_ENC_OFFSET:
+                v = prev + (uint64_t)unzigzag(raw);
+                break;
+            case CAPTURE_ENC_GAUGE:
+                v = prev ^ raw;
+                break;
+            case CAPTURE_ENC_RAW:
+                v = raw;
+                break;
+            default:
+                return -1;
+        }
+        prev = v;
+        values[i] = (encoding == CAPTURE_ENC_OFFSET) ? v + reference[i] : v;
+    }
+    return 0;
+}
+
+/**
+ * Grava os resíduos; uma sequência de resíduos zero (valor que não mudou,
+ * ritmo constante) vira um único resíduo zero seguido do varint de quantos
+ * zeros a mais vêm depois
+ */
+static uint8_t* encode_column(uint8_t *p, uint8_t encoding, const uint64_t *residuals, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint64_t r = residuals[i];
+        p = (encoding == CAPTURE_ENC_GAUGE) ? put_xor(p, r) : put_varint(p, r);
+        if (r == 0) {
+            size_t run = 0;
+            while (i + 1 < n && residuals[i + 1] == 0) {
+                run++;
+                i++;
+            }
+            p = put_varint(p, run);
+        }
+    }
+    return p;
+}
+
+/**
+ * @return 0 se exatamente n resíduos ocupam [p, end), -1 caso contrário
+ */
+static int decode_column(const uint8_t *p, const uint8_t *end, uint8_t encoding,
+                         uint64_t *residuals, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint64_t r, run;
+        p = (encoding == CAPTURE_ENC_GAUGE) ? get_xor(p, end, &r) : get_varint(p, end, &r);
+        if (p == NULL) return -1;
+        residuals[i] = r;
+        if (r == 0) {
+            p = get_varint(p, end, &run);
+            if (p == NULL || run > n - 1 - i) return -1;
+            for (; run > 0; run--) {
+                residuals[++i] = 0;
+            }
+        }
+    }
+    return p == end ? 0 : -1;
+}
+
+// ----------------------------------------------------------------------------
+// Codificador
+// ----------------------------------------------------------------------------
+
+size_t capture_format_header(uint8_t *out, size_t size) {
+    size_t needed = sizeof(file_magic) + 4;
+    for (int i = 0; i < SCHEMA_FIELDS; i++) {
+        needed += 3 + strlen(schema[i].name);
+    }
+    if (needed > size) {
+        return 0;
+    }
+
+    uint8_t *p = out;
+    memcpy(p, file_magic, sizeof(file_magic));
+    p += sizeof(file_magic);
+    *p++ = (uint8_t)(CAPTURE_VERSION & 0xff);
+    *p++ = (uint8_t)(CAPTURE_VERSION >> 8);
+    *p++ = (uint8_t)(SCHEMA_FIELDS & 0xff);
+    *p++ = (uint8_t)(SCHEMA_FIELDS >> 8);
+
+    for (int i = 0; i < SCHEMA_FIELDS; i++) {
+        size_t len = strlen(schema[i].name);
+        *p++ = schema[i].encoding;
+        *p++ = schema[i].type;
+        *p++ = (uint8_t)len;
+        memcpy(p, schema[i].name, len);
+        p += len;
+    }
+    return (size_t)(p - out);
+}
+
+int capture_encoder_init(capture_encoder_t *encoder, size_t block_records,
+                         capture_emit_fn emit, void *ctx) {
+    if (encoder == NULL || emit == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(encoder, 0, sizeof(*encoder));
+    encoder->block_records = block_records > 0 ? block_records : CAPTURE_DEFAULT_BLOCK;
+    encoder->emit = emit;
+    encoder->ctx = ctx;
+
+    // Pior caso: todos os valores com varint de 10 bytes
+    // (arredondado para 8: os vetores de valores e da coluna 0 vêm logo depois)
+    encoder->scratch_size = BLOCK_HEADER_SIZE +
+                            (size_t)SCHEMA_FIELDS * (MAX_VARINT + encoder->block_records * MAX_VARINT);
+    encoder->scratch_size = (encoder->scratch_size + 7) & ~(size_t)7;
+    encoder->scratch = malloc(encoder->scratch_size + 2 * encoder->block_records * sizeof(uint64_t));
+    if (encoder->scratch == NULL) {
+        return -1;
+    }
+    return 0;
+}
+
+static size_t series_slot(pid_t pid, size_t capacity) {
+    uint64_t h = (uint64_t)(uint32_t)pid * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h >> 32) & (capacity - 1);
+}
+
+static capture_series_t* find_series(capture_encoder_t *encoder, pid_t pid) {
+    if (encoder->count * 4 >= encoder->capacity * 3) {
+        size_t new_capacity = encoder->capacity ? encoder->capacity * 2 : 64;
+        capture_series_t *table = calloc(new_capacity, sizeof(capture_series_t));
+        if (table == NULL) {
+            return NULL;
+        }
+        for (size_t i = 0; i < encoder->capacity; i++) {
+            if (encoder->series[i].pid == 0) continue;
+            size_t slot = series_slot(encoder->series[i].pid, new_capacity);
+            while (table[slot].pid != 0) {
+                slot = (slot + 1) & (new_capacity - 1);
+            }
+            table[slot] = encoder->series[i];
+        }
+        free(encoder->series);
+        encoder->series = table;
+        encoder->capacity = new_capacity;
+    }
+
+    size_t slot = series_slot(pid, encoder->capacity);
+    while (encoder->series[slot].pid != 0 && encoder->series[slot].pid != pid) {
+        slot = (slot + 1) & (encoder->capacity - 1);
+    }
+
+    capture_series_t *series = &encoder->series[slot];
+    if (series->pid == 0) {
+        series->records = malloc(encoder->block_records * sizeof(export_record_t));
+        if (series->records == NULL) {
+            return NULL;
+        }
+        series->pid = pid;
+        series->count = 0;
+        encoder->count++;
+    }
+    return series;
+}
+
+/**
+ * Codifica as amostras pendentes de uma série como um bloco e o emite
+ */
+static int emit_block(capture_encoder_t *encoder, capture_series_t *series) {
+    if (series->count == 0) {
+        return 0;
+    }
+
+    uint8_t *block = encoder->scratch;
+    uint64_t *values = (uint64_t *)(encoder->scratch + encoder->scratch_size);
+    uint64_t *reference = values + encoder->block_records;
+    uint8_t *p = block + BLOCK_HEADER_SIZE;
+
+    for (size_t i = 0; i < series->count; i++) {
+        reference[i] = field_get(&series->records[i], &schema[0]);
+    }
+
+    // Coluna codificada logo após o espaço do seu prefixo de tamanho e
+    // depois movida para junto dele
+    for (int f = 0; f < SCHEMA_FIELDS; f++) {
+        for (size_t i = 0; i < series->count; i++) {
+            values[i] = field_get(&series->records[i], &schema[f]);
+        }
+        column_residuals(values, series->count, schema[f].encoding, reference);
+        uint8_t *column = p + MAX_VARINT;
+        size_t len = (size_t)(encode_column(column, schema[f].encoding, values, series->count) - column);
+        uint8_t *after_len = put_varint(p, len);
+        memmove(after_len, column, len);
+        p = after_len + len;
+    }
+
+    size_t payload = (size_t)(p - block) - BLOCK_HEADER_SIZE;
+    memcpy(block, block_magic, sizeof(block_magic));
+    put_u32(block + 4, (uint32_t)series->pid);
+    put_u32(block + 8, (uint32_t)series->count);
+    put_u32(block + 12, (uint32_t)payload);
+
+    size_t total = BLOCK_HEADER_SIZE + payload;
+    series->count = 0;
+    encoder->blocks++;
+    encoder->encoded_bytes += total;
+    return encoder->emit(encoder->ctx, block, total);
+}
+
+int capture_encoder_append(capture_encoder_t *encoder, const export_record_t *record) {
+    capture_series_t *series = find_series(encoder, record->pid);
+    if (series == NULL) {
+        return -1;
+    }
+
+    series->records[series->count++] = *record;
+    encoder->records++;
+    if (series->count == encoder->block_records) {
+        return emit_block(encoder, series);
+    }
+    return 0;
+}
+
+int capture_encoder_seal(capture_encoder_t *encoder) {
+    if (encoder == NULL) {
+        return 0;
+    }
+
+    int ret = 0;
+    for (size_t i = 0; i < encoder->capacity; i++) {
+        capture_series_t *series = &encoder->series[i];
+        if (series->pid == 0) continue;
+        if (emit_block(encoder, series) != 0) {
+            ret = -1;
+        }
+        // Séries recomeçam do zero; PIDs que não voltam não ocupam memória
+        free(series->records);
+        series->records = NULL;
+        series->pid = 0;
+    }
+    encoder->count = 0;
+    return ret;
+}
+
+void capture_encoder_free(capture_encoder_t *encoder) {
+    if (encoder == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < encoder->capacity; i++) {
+        free(encoder->series[i].records);
+    }
+    free(encoder->series);
+    free(encoder->scratch);
+    memset(encoder, 0, sizeof(*encoder));
+}
+
+// ----------------------------------------------------------------------------
+// Leitor
+// ----------------------------------------------------------------------------
+
+int capture_reader_open(capture_reader_t *reader, const char *path) {
+    if (reader == NULL || path == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    reader->fp = fopen(path, "rb");
+    if (reader->fp == NULL) {
+        return -1;
+    }
+
+    uint8_t header[sizeof(file_magic) + 4];
+    if (fread(header, 1, sizeof(header), reader->fp) != sizeof(header) ||
+        memcmp(header, file_magic, sizeof(file_magic)) != 0) {
+        fclose(reader->fp);
+        reader->fp = NULL;
+        errno = EINVAL;
+        return -1;
+    }
+
+    int version = header[6] | header[7] << 8;
+    reader->field_count = header[8] | header[9] << 8;
+    if (version != CAPTURE_VERSION || reader->field_count > MAX_FIELDS) {
+        fclose(reader->fp);
+        reader->fp = NULL;
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // Colunas são casadas pelo nome; as desconhecidas são decodificadas e ignoradas
+    for (int f = 0; f < reader->field_count; f++) {
+        uint8_t desc[3];
+        char name[256];
+        if (fread(desc, 1, 3, reader->fp) != 3 ||
+            fread(name, 1, desc[2], reader->fp) != desc[2]) {
+            fclose(reader->fp);
+            reader->fp = NULL;
+            errno = EINVAL;
+            return -1;
+        }
+        name[desc[2]] = '\0';
+        reader->encodings[f] = desc[0];
+        reader->field_map[f] = -1;
+        for (int i = 0; i < SCHEMA_FIELDS; i++) {
+            if (strcmp(schema[i].name, name) == 0 && schema[i].type == desc[1]) {
+                reader->field_map[f] = i;
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Lê e decodifica o próximo bloco
+ * @return 1 se leu, 0 no fim do arquivo, -1 em erro
+ */
+static int read_block(capture_reader_t *reader) {
+    uint8_t header[BLOCK_HEADER_SIZE];
+    size_t got = fread(header, 1, sizeof(header), reader->fp);
+    if (got == 0 && feof(reader->fp)) {
+        return 0;
+    }
+    if (got != sizeof(header) || memcmp(header, block_magic, sizeof(block_magic)) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint32_t count = get_u32(header + 8);
+    uint32_t payload = get_u32(header + 12);
+    if (count == 0 || count > (1u << 24)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (payload > reader->payload_size) {
+        uint8_t *buf = realloc(reader->payload, payload);
+        if (buf == NULL) return -1;
+        reader->payload = buf;
+        reader->payload_size = payload;
+    }
+    size_t needed = (size_t)reader->field_count * count;
+    if (needed > reader->columns_size) {
+        uint64_t *cols = realloc(reader->columns, needed * sizeof(uint64_t));
+        if (cols == NULL) return -1;
+        reader->columns = cols;
+        reader->columns_size = needed;
+    }
+    if (fread(reader->payload, 1, payload, reader->fp) != payload) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const uint8_t *p = reader->payload;
+    const uint8_t *end = reader->payload + payload;
+    for (int f = 0; f < reader->field_count; f++) {
+        uint64_t len;
+        p = get_varint(p, end, &len);
+        uint64_t *column = reader->columns + (size_t)f * count;
+        if (p == NULL || len > (uint64_t)(end - p) ||
+            (reader->encodings[f] == CAPTURE_ENC_OFFSET && f == 0) ||
+            decode_column(p, p + len, reader->encodings[f], column, count) != 0 ||
+            column_restore(column, count, reader->encodings[f], reader->columns) != 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        p += len;
+    }
+
+    reader->block_pid = (pid_t)get_u32(header + 4);
+    reader->block_count = count;
+    reader->block_pos = 0;
+    reader->blocks++;
+    return 1;
+}
+
+int capture_reader_next(capture_reader_t *reader, export_record_t *record) {
+    if (reader == NULL || reader->fp == NULL || record == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (reader->block_pos >= reader->block_count) {
+        int ret = read_block(reader);
+        if (ret <= 0) {
+            return ret;
+        }
+    }
+
+    memset(record, 0, sizeof(*record));
+    record->pid = reader->block_pid;
+    for (int f = 0; f < reader->field_count; f++) {
+        if (reader->field_map[f] < 0) continue;
+        field_set(record, &schema[reader->field_map[f]],
+                  reader->columns[(size_t)f * reader->block_count + reader->block_pos]);
+    }
+    reader->block_pos++;
+    return 1;
+}
+
+void capture_reader_close(capture_reader_t *reader) {
+    if (reader == NULL) {
+        return;
+    }
+    if (reader->fp != NULL) {
+        fclose(reader->fp);
+    }
+    free(reader->payload);
+    free(reader->columns);
+    memset(reader, 0, sizeof(*reader));
+}
+
+long capture_convert(const char *input, const char *output, export_format_t format) {
+    if (format == EXPORT_FORMAT_BINARY) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    capture_reader_t reader;
+    if (capture_reader_open(&reader, input) != 0) {
+        fprintf(stderr, "Error opening capture %s: %s\n", input, strerror(errno));
+        return -1;
+    }
+
+    export_writer_t writer;
+    export_writer_config_t config;
+    export_writer_config_default(&config);
+    config.format = format;
+    config.flush_interval_ms = 0;
+    if (export_writer_open(&writer, output, &config) != 0) {
+        capture_reader_close(&reader);
+        return -1;
+    }
+
+    export_record_t record;
+    long converted = 0;
+    int ret;
+    while ((ret = capture_reader_next(&reader, &record)) == 1) {
+        if (export_writer_write_record(&writer, &record) != 0) {
+            ret = -1;
+            break;
+        }
+        converted++;
+    }
+    if (ret < 0) {
+        fprintf(stderr, "Error: capture %s is corrupted after %ld samples\n", input, converted);
+    }
+
+    if (export_writer_close(&writer) != 0) {
+        ret = -1;
+    }
+    capture_reader_close(&reader);
+    return ret < 0 ? -1 : converted;
+}
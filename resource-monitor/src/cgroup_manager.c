@@ -1,5 +1,6 @@
 #define _GNU_SOURCE
 #include "cgroup.h"
+#include "monitor.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,6 +10,7 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <stdatomic.h>
 
 // Nomes dos controladores
 static const char* controller_names[CGROUP_CONTROLLER_COUNT] = {
@@ -32,21 +34,39 @@ const char* cgroup_controller_to_string(cgroup_controller_t controller) {
 
 /**
  * Detecta versão de cgroup
+ *
+ * A hierarquia não muda enquanto o processo vive; o resultado é guardado
+ * para que cada leitura de métrica não repita os stat()
  */
 int detect_cgroup_version(void) {
-    struct stat st;
-    
-    // Se /sys/fs/cgroup/cgroup.controllers existe, é v2
-    if (stat("/sys/fs/cgroup/cgroup.controllers", &st) == 0) {
-        return 2;
+    // Versão nos 2 bits baixos, geração da raiz no resto: trocar a raiz
+    // invalida o cache
+    static _Atomic unsigned cached = 0;
+    unsigned generation = host_root_generation();
+    unsigned entry = atomic_load_explicit(&cached, memory_order_relaxed);
+    if (entry != 0 && entry >> 2 == generation) {
+        return (int)(entry & 3);
     }
-    
-    // Se /sys/fs/cgroup/cpu existe, é v1
-    if (stat("/sys/fs/cgroup/cpu", &st) == 0) {
-        return 1;
+
+    struct stat st;
+    char path[PATH_MAX];
+    int version;
+
+    // Se <raiz>/cgroup.controllers existe, é v2
+    snprintf(path, sizeof(path), "%s/cgroup.controllers", cgroup_root());
+    if (stat(path, &st) == 0) {
+        version = 2;
+    } else {
+        // Se <raiz>/cpu existe, é v1
+        snprintf(path, sizeof(path), "%s/cpu", cgroup_root());
+        if (stat(path, &st) != 0) {
+            return -1;
+        }
+        version = 1;
     }
-    
-    return -1;
+
+    atomic_store_explicit(&cached, generation << 2 | (unsigned)version, memory_order_relaxed);
+    return version;
 }
 
 /**
@@ -89,8 +109,8 @@ int get_process_cgroup_path(pid_t pid, const char *controller,
         return -1;
     }
     
-    char proc_path[256];
-    snprintf(proc_path, sizeof(proc_path), "/proc/%d/cgroup", pid);
+    char proc_path[PATH_MAX];
+    snprintf(proc_path, sizeof(proc_path), "%s/%d/cgroup", proc_root(), pid);
     
     FILE *fp = fopen(proc_path, "r");
     if (fp == NULL) {
@@ -114,9 +134,9 @@ int get_process_cgroup_path(pid_t pid, const char *controller,
         
         if (controller == NULL && hierarchy == 0) {
             if (strlen(cgroup_relative_path) == 0 || strcmp(cgroup_relative_path, "/") == 0) {
-                snprintf(path, size, "/sys/fs/cgroup");
+                snprintf(path, size, "%s", cgroup_root());
             } else {
-                snprintf(path, size, "/sys/fs/cgroup%s", cgroup_relative_path);
+                snprintf(path, size, "%s%s", cgroup_root(), cgroup_relative_path);
             }
             found = 1;
             break;
@@ -130,7 +150,7 @@ int get_process_cgroup_path(pid_t pid, const char *controller,
             controllers[len] = '\0';
             
             if (strstr(controllers, controller) != NULL) {
-                snprintf(path, size, "/sys/fs/cgroup/%s%s", controller, cgroup_relative_path);
+                snprintf(path, size, "%s/%s%s", cgroup_root(), controller, cgroup_relative_path);
                 found = 1;
                 break;
             }
@@ -526,9 +546,9 @@ return -1;
 char path[PATH_MAX];
 
 if (version == 2) {
-    snprintf(path, sizeof(path), "/sys/fs/cgroup/%s", name);
+    snprintf(path, sizeof(path), "%s/%s", cgroup_root(), name);
 } else if (version == 1) {
-    snprintf(path, sizeof(path), "/sys/fs/cgroup/%s/%s",
+    snprintf(path, sizeof(path), "%s/%s/%s", cgroup_root(),
             cgroup_controller_to_string(controller), name);
 } else {
     return -1;
@@ -806,18 +826,18 @@ int create_cgroup_for_controllers(const char *name,
     int version = detect_cgroup_version();
     if (version == 2) {
         // v2: Unified hierarchy
-        snprintf(cpu_path_out, cpu_path_size, "/sys/fs/cgroup/%s", name);
+        snprintf(cpu_path_out, cpu_path_size, "%s/%s", cgroup_root(), name);
         strncpy(mem_path_out, cpu_path_out, mem_path_size);
         if (mkdir(cpu_path_out, 0755) != 0 && errno != EEXIST) {
             return -1;
         }
     } else if (version == 1) {
         // v1: Separate hierarchies
-        snprintf(cpu_path_out, cpu_path_size, "/sys/fs/cgroup/cpu/%s", name);
+        snprintf(cpu_path_out, cpu_path_size, "%s/cpu/%s", cgroup_root(), name);
         if (mkdir(cpu_path_out, 0755) != 0 && errno != EEXIST) {
             return -1;
         }
-        snprintf(mem_path_out, mem_path_size, "/sys/fs/cgroup/memory/%s", name);
+        snprintf(mem_path_out, mem_path_size, "%s/memory/%s", cgroup_root(), name);
         if (mkdir(mem_path_out, 0755) != 0 && errno != EEXIST) {
             // Se a criação da memória falhar, tente remover o de cpu para limpar
             rmdir(cpu_path_out);
@@ -855,12 +875,68 @@ void cleanup_cgroup(const char *name) {
     char path[PATH_MAX];
 
     if (version == 2) {
-        snprintf(path, sizeof(path), "/sys/fs/cgroup/%s", name);
+        snprintf(path, sizeof(path), "%s/%s", cgroup_root(), name);
         rmdir(path);
     } else if (version == 1) {
-        snprintf(path, sizeof(path), "/sys/fs/cgroup/cpu/%s", name);
+        snprintf(path, sizeof(path), "%s/cpu/%s", cgroup_root(), name);
         rmdir(path);
-        snprintf(path, sizeof(path), "/sys/fs/cgroup/memory/%s", name);
+        snprintf(path, sizeof(path), "%s/memory/%s", cgroup_root(), name);
         rmdir(path);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Restringe um cgroup a um conjunto de CPUs (cpuset.cpus)
+ *
+ * Em v1 o cpuset.mems do cgroup vem do pai, que o kernel exige antes de
+ * aceitar tarefas.
+ *
+ * @param cgroup_path Caminho do cgroup (hierarquia cpuset em v1)
+ * @param cpus Lista de CPUs (ex: "0-1,4")
+ * @return 0 em sucesso, -1 em erro
+ */
+int set_cgroup_cpuset(const char *cgroup_path, const char *cpus) {
+    if (cgroup_path == NULL || cpus == NULL || cpus[0] == '\0') {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int version = detect_cgroup_version();
+    char file_path[PATH_MAX];
+    FILE *fp;
+
+    if (version == 1) {
+        // v1 exige cpuset.mems antes de aceitar tarefas: herdar do pai
+        char mems[256] = "";
+        snprintf(file_path, sizeof(file_path), "%s/../cpuset.mems", cgroup_path);
+        fp = fopen(file_path, "r");
+        if (fp != NULL) {
+            if (fgets(mems, sizeof(mems), fp) != NULL) {
+                mems[strcspn(mems, "\n")] = '\0';
+            }
+            fclose(fp);
+        }
+        snprintf(file_path, sizeof(file_path), "%s/cpuset.mems", cgroup_path);
+        fp = fopen(file_path, "w");
+        if (fp == NULL) {
+            return -1;
+        }
+        fprintf(fp, "%s", mems[0] ? mems : "0");
+        fclose(fp);
+    } else if (version != 2) {
+        return -1;
+    }
+
+    snprintf(file_path, sizeof(file_path), "%s/cpuset.cpus", cgroup_path);
+    fp = fopen(file_path, "w");
+    if (fp == NULL) {
+        return -1;
+    }
+    fprintf(fp, "%s", cpus);
+    // O erro de escrita (ex: CPU inexistente) só aparece no fclose
+    if (fclose(fp) != 0) {
+        return -1;
+    }
+
+    return 0;
+}
@@ -1,8 +1,12 @@
 #define _GNU_SOURCE
 #include "cgroup.h"
+#include "monitor.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
 #include <time.h>
 
 /**
@@ -156,9 +160,64 @@ int generate_cgroup_utilization_report(pid_t pid, const char *output_file) {
 }
 
 /**
- * Compara utilização de múltiplos processos
+ * Tempo de vida de um processo em segundos (de starttime até agora)
  */
-int compare_cgroup_utilization(pid_t *pids, int count, const char *output_file) {
+static double process_elapsed_seconds(pid_t pid) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%d/stat", proc_root(), pid);
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return 0.0;
+    }
+    char line[1024];
+    char *ok = fgets(line, sizeof(line), fp);
+    fclose(fp);
+    if (ok == NULL) {
+        return 0.0;
+    }
+
+    // starttime é o campo 22; contar a partir do fim do comm
+    char *p = strrchr(line, ')');
+    if (p == NULL) {
+        return 0.0;
+    }
+    unsigned long long starttime = 0;
+    int field = 2;
+    for (p++; *p != '\0' && field < 22; p++) {
+        if (*p == ' ') {
+            field++;
+        }
+    }
+    if (sscanf(p, "%llu", &starttime) != 1) {
+        return 0.0;
+    }
+
+    double uptime = 0.0;
+    snprintf(path, sizeof(path), "%s/uptime", proc_root());
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        return 0.0;
+    }
+    if (fscanf(fp, "%lf", &uptime) != 1) {
+        uptime = 0.0;
+    }
+    fclose(fp);
+
+    long ticks = sysconf(_SC_CLK_TCK);
+    double elapsed = uptime - (double)starttime / (ticks > 0 ? ticks : 100);
+    return elapsed > 0 ? elapsed : 0.0;
+}
+
+/**
+ * Imprime a tabela comparativa de utilização
+ *
+ * Além de CPU, memória e I/O acumulados, mostra o pico de memória, a
+ * razão de throttling (períodos limitados / períodos) e o throughput
+ * médio (cores de CPU efetivos e MB/s de I/O) no tempo decorrido.
+ */
+int print_cgroup_utilization_table(const cgroup_utilization_row_t *rows, int count,
+                                   const char *output_file) {
     FILE *fp = stdout;
     
     if (output_file != NULL) {
@@ -175,32 +234,39 @@ int compare_cgroup_utilization(pid_t *pids, int count, const char *output_file)
     fprintf(fp, "Comparing %d processes:\n\n", count);
     
     // Table header
-    fprintf(fp, "┌─────────┬──────────────┬──────────────┬──────────────┐\n");
-    fprintf(fp, "│   PID   │  CPU (sec)   │  Memory (MB) │   I/O (MB)   │\n");
-    fprintf(fp, "├─────────┼──────────────┼──────────────┼──────────────┤\n");
+    fprintf(fp, "┌──────────────┬────────────┬────────────┬────────────┬────────────┬───────────┬──────────┬────────────┐\n");
+    fprintf(fp, "│ Workload/PID │ CPU (sec)  │ Memory(MB) │  I/O (MB)  │  Peak (MB) │ Throttle%% │ CPU cores│ I/O (MB/s) │\n");
+    fprintf(fp, "├──────────────┼────────────┼────────────┼────────────┼────────────┼───────────┼──────────┼────────────┤\n");
     
-    double total_cpu = 0, total_mem = 0, total_io = 0;
+    double total_cpu = 0, total_mem = 0, total_io = 0, total_peak = 0;
+    double total_cores = 0, total_io_rate = 0;
     
     for (int i = 0; i < count; i++) {
-        cgroup_metrics_t m;
-        if (read_cgroup_metrics(pids[i], &m) == 0) {
-            double cpu = m.has_cpu ? m.cpu.usage_usec / 1000000.0 : 0;
-            double mem = m.has_memory ? m.memory.current / (1024.0 * 1024.0) : 0;
-            double io = m.has_blkio ? (m.blkio.rbytes + m.blkio.wbytes) / (1024.0 * 1024.0) : 0;
-            
-            fprintf(fp, "│ %7d │ %12.2f │ %12.2f │ %12.2f │\n",
-                    pids[i], cpu, mem, io);
-            
-            total_cpu += cpu;
-            total_mem += mem;
-            total_io += io;
-        }
+        const cgroup_metrics_t *m = &rows[i].metrics;
+        double cpu = m->has_cpu ? m->cpu.usage_usec / 1000000.0 : 0;
+        double mem = m->has_memory ? m->memory.current / (1024.0 * 1024.0) : 0;
+        double io = m->has_blkio ? (m->blkio.rbytes + m->blkio.wbytes) / (1024.0 * 1024.0) : 0;
+        double peak = rows[i].peak_memory / (1024.0 * 1024.0);
+        double throttle = (m->has_cpu && m->cpu.nr_periods > 0)
+                          ? (m->cpu.nr_throttled * 100.0) / m->cpu.nr_periods : 0;
+        double cores = rows[i].elapsed_sec > 0 ? cpu / rows[i].elapsed_sec : 0;
+        double io_rate = rows[i].elapsed_sec > 0 ? io / rows[i].elapsed_sec : 0;
+        
+        fprintf(fp, "│ %-12.12s │ %10.2f │ %10.2f │ %10.2f │ %10.2f │ %9.2f │ %8.2f │ %10.2f │\n",
+                rows[i].label, cpu, mem, io, peak, throttle, cores, io_rate);
+        
+        total_cpu += cpu;
+        total_mem += mem;
+        total_io += io;
+        total_peak += peak;
+        total_cores += cores;
+        total_io_rate += io_rate;
     }
     
-    fprintf(fp, "├─────────┼──────────────┼──────────────┼──────────────┤\n");
-    fprintf(fp, "│  TOTAL  │ %12.2f │ %12.2f │ %12.2f │\n",
-            total_cpu, total_mem, total_io);
-    fprintf(fp, "└─────────┴──────────────┴──────────────┴──────────────┘\n\n");
+    fprintf(fp, "├──────────────┼────────────┼────────────┼────────────┼────────────┼───────────┼──────────┼────────────┤\n");
+    fprintf(fp, "│    TOTAL     │ %10.2f │ %10.2f │ %10.2f │ %10.2f │ %9s │ %8.2f │ %10.2f │\n",
+            total_cpu, total_mem, total_io, total_peak, "-", total_cores, total_io_rate);
+    fprintf(fp, "└──────────────┴────────────┴────────────┴────────────┴────────────┴───────────┴──────────┴────────────┘\n\n");
     
     if (output_file != NULL) {
         fclose(fp);
@@ -208,3 +274,33 @@ int compare_cgroup_utilization(pid_t *pids, int count, const char *output_file)
     
     return 0;
 }
+
+/**
+ * Compara utilização de múltiplos processos
+ */
+int compare_cgroup_utilization(pid_t *pids, int count, const char *output_file) {
+    if (pids == NULL || count <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    cgroup_utilization_row_t *rows = calloc(count, sizeof(cgroup_utilization_row_t));
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int filled = 0;
+    for (int i = 0; i < count; i++) {
+        cgroup_utilization_row_t *row = &rows[filled];
+        if (read_cgroup_metrics(pids[i], &row->metrics) == 0) {
+            snprintf(row->label, sizeof(row->label), "%d", pids[i]);
+            row->peak_memory = row->metrics.memory.peak;
+            row->elapsed_sec = process_elapsed_seconds(pids[i]);
+            filled++;
+        }
+    }
+
+    int ret = print_cgroup_utilization_table(rows, filled, output_file);
+    free(rows);
+    return ret;
+}
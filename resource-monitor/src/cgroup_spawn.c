@@ -0,0 +1,133 @@
+#define _GNU_SOURCE
+#include "cgroup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sched.h>
+#include <linux/sched.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+
+/**
+ * Converte método de criação para string
+ */
+const char* cgroup_spawn_method_to_string(cgroup_spawn_method_t method) {
+    switch (method) {
+        case CGROUP_SPAWN_AUTO:   return "auto";
+        case CGROUP_SPAWN_CLONE3: return "clone3";
+        case CGROUP_SPAWN_FORK:   return "fork";
+        default:                  return "unknown";
+    }
+}
+
+/**
+ * Executa o comando no processo filho (nunca retorna)
+ *
+ * Usa _exit() para não descarregar buffers stdio herdados do pai.
+ */
+static void exec_child(char *const argv[]) {
+    execvp(argv[0], argv);
+    // execvp só retorna em erro
+    fprintf(stderr, "Error executing command '%s': %s\n", argv[0], strerror(errno));
+    _exit(127);
+}
+
+/**
+ * Cria o filho já dentro do cgroup v2 via clone3(CLONE_INTO_CGROUP)
+ *
+ * @return PID do filho, ou -1 com errno definido se clone3 não puder ser usado
+ */
+static pid_t spawn_clone3(char *const argv[], const char *cgroup_path) {
+#if defined(SYS_clone3) && defined(CLONE_INTO_CGROUP)
+    int cgroup_fd = open(cgroup_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (cgroup_fd < 0) {
+        return -1;
+    }
+
+    struct clone_args args;
+    memset(&args, 0, sizeof(args));
+    args.flags = CLONE_INTO_CGROUP;
+    args.exit_signal = SIGCHLD;
+    args.cgroup = (uint64_t)cgroup_fd;
+
+    long ret = syscall(SYS_clone3, &args, sizeof(args));
+    if (ret == 0) {
+        exec_child(argv);
+    }
+
+    int saved_errno = errno;
+    close(cgroup_fd);
+    errno = saved_errno;
+    return (pid_t)ret;
+#else
+    (void)argv;
+    (void)cgroup_path;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * Caminho antigo: fork e o filho se move para o(s) cgroup(s) antes do exec
+ */
+static pid_t spawn_fork(char *const argv[], const char *cpu_path, const char *mem_path) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    if (move_process_to_cgroup(getpid(), cpu_path) != 0) {
+        perror("Failed to move child to cgroup");
+        _exit(127);
+    }
+    // Em v2 os caminhos são iguais; em v1 é preciso entrar também no de memória
+    if (strcmp(cpu_path, mem_path) != 0 && move_process_to_cgroup(getpid(), mem_path) != 0) {
+        perror("Failed to move child to cgroup");
+        _exit(127);
+    }
+    exec_child(argv);
+    return -1;
+}
+
+/**
+ * Cria um processo executando argv dentro do cgroup
+ */
+pid_t spawn_process_in_cgroup(char *const argv[],
+                              const char *cpu_path, const char *mem_path,
+                              cgroup_spawn_method_t method,
+                              cgroup_spawn_method_t *used) {
+    if (argv == NULL || argv[0] == NULL || cpu_path == NULL || mem_path == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Evita que o filho herde (e duplique) saída ainda não descarregada
+    fflush(stdout);
+    fflush(stderr);
+
+    if (method != CGROUP_SPAWN_FORK && detect_cgroup_version() == 2) {
+        pid_t pid = spawn_clone3(argv, cpu_path);
+        if (pid > 0) {
+            if (used != NULL) *used = CGROUP_SPAWN_CLONE3;
+            return pid;
+        }
+        // Kernel antigo (ENOSYS/E2BIG/EINVAL) ou sem permissão: cair para fork,
+        // a menos que clone3 tenha sido pedido explicitamente
+        if (method == CGROUP_SPAWN_CLONE3) {
+            return -1;
+        }
+    } else if (method == CGROUP_SPAWN_CLONE3) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    pid_t pid = spawn_fork(argv, cpu_path, mem_path);
+    if (pid > 0 && used != NULL) {
+        *used = CGROUP_SPAWN_FORK;
+    }
+    return pid;
+}
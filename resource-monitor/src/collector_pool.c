@@ -0,0 +1,453 @@
+#define _GNU_SOURCE
+#include "collector_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ----------------------------------------------------------------------------
+// Deque de Chase-Lev
+// ----------------------------------------------------------------------------
+
+static int deque_init(work_deque_t *deque, int capacity) {
+    int64_t size = 1;
+    while (size < capacity) size <<= 1;
+    deque->slots = calloc((size_t)size, sizeof(void *));
+    if (deque->slots == NULL) {
+        return -1;
+    }
+    deque->mask = size - 1;
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    return 0;
+}
+
+/**
+ * Só o dono (ou a thread que submete, sem workers)
+ */
+static void deque_push(work_deque_t *deque, void *job) {
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    deque->slots[b & deque->mask] = job;
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_release);
+}
+
+static void* deque_pop(work_deque_t *deque) {
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+    void *job = deque->slots[b & deque->mask];
+    if (t == b) {
+        // Último item: disputa com os ladrões
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            job = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+/**
+ * @param contended Marcado quando outro ladrão levou o item
+ */
+static void* deque_steal(work_deque_t *deque, int *contended) {
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if (t >= b) {
+        return NULL;
+    }
+    void *job = deque->slots[t & deque->mask];
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        *contended = 1;
+        return NULL;
+    }
+    return job;
+}
+
+// ----------------------------------------------------------------------------
+// Workers
+// ----------------------------------------------------------------------------
+
+static void* steal_any(collector_worker_t *worker) {
+    collector_pool_t *pool = worker->pool;
+    int contended;
+
+    // Todas vazias sem disputa: não há o que roubar agora
+    do {
+        contended = 0;
+        int start = (int)(rand_r(&worker->seed) % (unsigned)pool->worker_count);
+        for (int i = 0; i < pool->worker_count; i++) {
+            collector_worker_t *victim = &pool->workers[(start + i) % pool->worker_count];
+            if (victim == worker) continue;
+            void *task = deque_steal(&victim->deque, &contended);
+            if (task != NULL) {
+                atomic_fetch_add_explicit(&worker->steals, 1, memory_order_relaxed);
+                return task;
+            }
+        }
+    } while (contended);
+    return NULL;
+}
+
+/**
+ * Passa uma fatia da fila de submissão para a deque do worker
+ *
+ * A fatia é 1/N do que está na fila, para que os outros workers peguem a
+ * sua; o que sobrar na deque pode ser roubado
+ */
+static void* take_submitted(collector_worker_t *worker) {
+    collector_pool_t *pool = worker->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->queued_count == 0 || pool->shutdown) {
+        pthread_mutex_unlock(&pool->lock);
+        return NULL;
+    }
+    int share = (pool->queued_count + pool->worker_count - 1) / pool->worker_count;
+    for (int i = 0; i < share; i++) {
+        deque_push(&worker->deque, pool->queued[pool->queued_head]);
+        pool->queued_head = (pool->queued_head + 1) % pool->capacity;
+    }
+    pool->queued_count -= share;
+    if (share > 1) {
+        // Há o que roubar desta deque
+        pool->generation++;
+        pthread_cond_broadcast(&pool->wake);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return deque_pop(&worker->deque);
+}
+
+static void run_task(collector_worker_t *worker, collector_task_t *task) {
+    collector_pool_t *pool = worker->pool;
+    uint64_t start = monotonic_ns();
+    pool->fn(task->job, worker);
+    uint64_t end = monotonic_ns();
+
+    atomic_fetch_add_explicit(&worker->jobs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&worker->busy_ns, end - start, memory_order_relaxed);
+    task->finished_ns = end;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->done[pool->done_count++] = task;
+    int first = (pool->done_count == 1);
+    pthread_cond_signal(&pool->finished);
+    pthread_mutex_unlock(&pool->lock);
+
+    // complete() esvazia a lista inteira: basta sinalizar quando ela deixa de estar vazia
+    if (first) {
+        uint64_t one = 1;
+        ssize_t ignored = write(pool->done_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+static void* worker_thread(void *arg) {
+    collector_worker_t *worker = arg;
+    collector_pool_t *pool = worker->pool;
+    uint64_t seen = 0;
+
+    for (;;) {
+        // Dorme só se nada mudou desde que as filas foram olhadas
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        void *task;
+        while ((task = deque_pop(&worker->deque)) != NULL ||
+               (task = steal_any(worker)) != NULL ||
+               (task = take_submitted(worker)) != NULL) {
+            run_task(worker, task);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Pool
+// ----------------------------------------------------------------------------
+
+int collector_pool_create(collector_pool_t *pool, int workers, int capacity, collector_job_fn fn) {
+    if (pool == NULL || workers < 0 || capacity <= 0 || fn == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    pool->capacity = capacity;
+    pool->fn = fn;
+    pool->done_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (pool->done_fd < 0) {
+        return -1;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    // Prazos de collector_pool_wait_timeout não andam com o relógio de parede
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&pool->finished, &attr);
+    pthread_condattr_destroy(&attr);
+
+    size_t n = (size_t)capacity;
+    pool->tasks = calloc(n, sizeof(*pool->tasks));
+    pool->free_tasks = calloc(n, sizeof(int));
+    pool->rounds = calloc(n, sizeof(*pool->rounds));
+    pool->free_rounds = calloc(n, sizeof(int));
+    pool->harvest = calloc(n, sizeof(*pool->harvest));
+    pool->queued = calloc(n, sizeof(*pool->queued));
+    pool->done = calloc(n, sizeof(*pool->done));
+    if (pool->tasks == NULL || pool->free_tasks == NULL || pool->rounds == NULL ||
+        pool->free_rounds == NULL || pool->harvest == NULL || pool->queued == NULL ||
+        pool->done == NULL) {
+        collector_pool_destroy(pool);
+        errno = ENOMEM;
+        return -1;
+    }
+    for (int i = 0; i < capacity; i++) {
+        pool->free_tasks[i] = capacity - 1 - i;
+        pool->free_rounds[i] = capacity - 1 - i;
+    }
+    pool->free_task_count = capacity;
+    pool->free_round_count = capacity;
+
+    // Sem workers, um "worker" virtual executa os jobs na thread chamadora
+    int contexts = workers > 0 ? workers : 1;
+    pool->workers = calloc((size_t)contexts, sizeof(*pool->workers));
+    if (pool->workers == NULL) {
+        collector_pool_destroy(pool);
+        return -1;
+    }
+    pool->context_count = contexts;
+    for (int i = 0; i < contexts; i++) {
+        collector_worker_t *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        worker->seed = (unsigned int)(i * 2654435761u + 1);
+        if (workers > 0 && deque_init(&worker->deque, capacity) != 0) {
+            collector_pool_destroy(pool);
+            return -1;
+        }
+    }
+
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_thread, &pool->workers[i]) != 0) {
+            collector_pool_destroy(pool);
+            errno = EAGAIN;
+            return -1;
+        }
+        pool->worker_count++;
+    }
+    return 0;
+}
+
+int collector_pool_submit(collector_pool_t *pool, void **jobs, int count) {
+    // Toda rodada tem um job, então tarefas livres bastam para rodadas livres
+    if (count > pool->free_task_count) {
+        errno = E2BIG;
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    int r = pool->free_rounds[--pool->free_round_count];
+    collector_round_t *round = &pool->rounds[r];
+    round->submitted_ns = monotonic_ns();
+    round->finished_ns = round->submitted_ns;
+    round->jobs = count;
+    round->remaining = count;
+    pool->outstanding += count;
+
+    if (pool->worker_count == 0) {
+        for (int i = 0; i < count; i++) {
+            collector_task_t *task = &pool->tasks[pool->free_tasks[--pool->free_task_count]];
+            task->job = jobs[i];
+            task->round = r;
+            task->busy = 1;
+            run_task(&pool->workers[0], task);
+        }
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    for (int i = 0; i < count; i++) {
+        collector_task_t *task = &pool->tasks[pool->free_tasks[--pool->free_task_count]];
+        task->job = jobs[i];
+        task->round = r;
+        task->busy = 1;
+        pool->queued[(pool->queued_head + pool->queued_count) % pool->capacity] = task;
+        pool->queued_count++;
+    }
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+int collector_pool_complete(collector_pool_t *pool, void **jobs, int max) {
+    uint64_t value;
+    ssize_t ignored = read(pool->done_fd, &value, sizeof(value));
+    (void)ignored;
+
+    pthread_mutex_lock(&pool->lock);
+    int count = pool->done_count < max ? pool->done_count : max;
+    memcpy(pool->harvest, pool->done, (size_t)count * sizeof(*pool->done));
+    pool->done_count -= count;
+    memmove(pool->done, pool->done + count, (size_t)pool->done_count * sizeof(*pool->done));
+    int left = pool->done_count;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (left > 0) {
+        // O eventfd já foi consumido: o resto precisa de outro aviso
+        uint64_t one = 1;
+        ignored = write(pool->done_fd, &one, sizeof(one));
+    }
+
+    for (int i = 0; i < count; i++) {
+        collector_task_t *task = pool->harvest[i];
+        collector_round_t *round = &pool->rounds[task->round];
+        jobs[i] = task->job;
+        if (task->finished_ns > round->finished_ns) {
+            round->finished_ns = task->finished_ns;
+        }
+        if (--round->remaining == 0) {
+            uint64_t elapsed = round->finished_ns - round->submitted_ns;
+            pool->stats.rounds++;
+            pool->stats.last_round_jobs = round->jobs;
+            pool->stats.last_round_ns = elapsed;
+            pool->stats.total_round_ns += elapsed;
+            if (elapsed > pool->stats.max_round_ns) {
+                pool->stats.max_round_ns = elapsed;
+            }
+            pool->free_rounds[pool->free_round_count++] = task->round;
+        }
+        task->busy = 0;
+        pool->free_tasks[pool->free_task_count++] = (int)(task - pool->tasks);
+    }
+    pool->stats.jobs += (uint64_t)count;
+    pool->outstanding -= count;
+    return count;
+}
+
+void collector_pool_wait(collector_pool_t *pool) {
+    collector_pool_wait_timeout(pool, -1);
+}
+
+int collector_pool_wait_timeout(collector_pool_t *pool, int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout_ms >= 0) {
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    int timed_out = 0;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->done_count < pool->outstanding && !timed_out) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&pool->finished, &pool->lock);
+        } else if (pthread_cond_timedwait(&pool->finished, &pool->lock, &deadline) == ETIMEDOUT) {
+            timed_out = pool->done_count < pool->outstanding;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (timed_out) {
+        errno = ETIMEDOUT;
+        return -1;
+    }
+    return 0;
+}
+
+int collector_pool_abandon(collector_pool_t *pool, void **jobs, int max) {
+    int count = 0;
+    for (int i = 0; i < pool->capacity && count < max; i++) {
+        if (pool->tasks[i].busy) {
+            jobs[count++] = pool->tasks[i].job;
+        }
+    }
+
+    // Os ociosos saem agora; os presos, quando o job retornar
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->worker_count; i++) {
+        pthread_detach(pool->workers[i].thread);
+    }
+    return count;
+}
+
+void collector_pool_get_stats(const collector_pool_t *pool, collector_pool_stats_t *stats) {
+    *stats = pool->stats;
+    stats->steals = 0;
+    for (int i = 0; i < pool->worker_count; i++) {
+        stats->steals += atomic_load_explicit(&pool->workers[i].steals, memory_order_relaxed);
+    }
+}
+
+void collector_pool_destroy(collector_pool_t *pool) {
+    if (pool == NULL || pool->done_fd < 0) {
+        return;
+    }
+    // Jobs em voo ainda usam as tarefas e as deques
+    collector_pool_wait(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->worker_count; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    if (pool->workers != NULL) {
+        for (int i = 0; i < pool->context_count; i++) {
+            free(pool->workers[i].deque.slots);
+        }
+        free(pool->workers);
+    }
+    free(pool->tasks);
+    free(pool->free_tasks);
+    free(pool->rounds);
+    free(pool->free_rounds);
+    free(pool->harvest);
+    free(pool->queued);
+    free(pool->done);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->finished);
+    close(pool->done_fd);
+    pool->done_fd = -1;
+    pool->workers = NULL;
+    pool->worker_count = 0;
+}
@@ -0,0 +1,219 @@
+#define _POSIX_C_SOURCE 200809L
+#include "collector_sched.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * Custo inicial de cada unidade (µs de CPU por execução), até a primeira
+ * medida: smaps_rollup percorre todas as VMAs e é de longe a mais cara
+ */
+static const struct {
+    const char *name;
+    double cost_us;
+} unit_defaults[COLLECTOR_UNIT_COUNT] = {
+    [COLLECTOR_UNIT_STAT]       = { "stat",   20.0 },
+    [COLLECTOR_UNIT_STATUS]     = { "status", 40.0 },
+    [COLLECTOR_UNIT_IO]         = { "io",     15.0 },
+    [COLLECTOR_UNIT_SMAPS]      = { "smaps",  400.0 },
+    [COLLECTOR_UNIT_CGROUP]     = { "cgroup", 80.0 },
+    [COLLECTOR_UNIT_NAMESPACES] = { "ns",     40.0 },
+};
+
+void collector_sched_init(collector_sched_t *sched, uint64_t now_ms) {
+    memset(sched, 0, sizeof(*sched));
+    sched->start_ms = now_ms;
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        sched->units[i].name = unit_defaults[i].name;
+        sched->units[i].cost_us = unit_defaults[i].cost_us;
+    }
+}
+
+int collector_sched_unit_from_name(const char *name) {
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        if (strcmp(name, unit_defaults[i].name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void collector_sched_set_interval(collector_sched_t *sched, collector_unit_id_t unit,
+                                  uint64_t interval_ms) {
+    collector_unit_t *u = &sched->units[unit];
+    u->requested_ms = interval_ms;
+    u->interval_ms = interval_ms;
+    u->next_due_ms = u->runs ? u->last_run_ms + interval_ms : sched->start_ms;
+}
+
+int collector_sched_parse(collector_sched_t *sched, const char *spec, uint64_t default_ms) {
+    char copy[256];
+    if (spec == NULL || strlen(spec) >= sizeof(copy)) {
+        return -1;
+    }
+    strcpy(copy, spec);
+
+    char *saveptr = NULL;
+    for (char *item = strtok_r(copy, ",", &saveptr); item != NULL; item = strtok_r(NULL, ",", &saveptr)) {
+        uint64_t interval = default_ms;
+        char *value = strchr(item, '=');
+        if (value != NULL) {
+            *value++ = '\0';
+            char *end;
+            double seconds = strtod(value, &end);
+            if (*value == '\0' || *end != '\0' || !(seconds >= 0.001) || seconds > 86400.0) {
+                return -1;
+            }
+            interval = (uint64_t)llround(seconds * 1000.0);
+        }
+        int unit = collector_sched_unit_from_name(item);
+        if (unit < 0 || interval == 0) {
+            return -1;
+        }
+        collector_sched_set_interval(sched, (collector_unit_id_t)unit, interval);
+    }
+    return 0;
+}
+
+void collector_sched_set_budget(collector_sched_t *sched, double fraction) {
+    sched->budget = fraction > 0 ? fraction : 0;
+    collector_sched_rebalance(sched);
+}
+
+uint32_t collector_sched_due(const collector_sched_t *sched, uint64_t now_ms) {
+    uint32_t due = 0;
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        const collector_unit_t *u = &sched->units[i];
+        if (u->requested_ms != 0 && u->next_due_ms <= now_ms) {
+            due |= COLLECTOR_UNIT_BIT(i);
+        }
+    }
+    return due;
+}
+
+uint64_t collector_sched_next_due(const collector_sched_t *sched) {
+    uint64_t next = UINT64_MAX;
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        const collector_unit_t *u = &sched->units[i];
+        if (u->requested_ms != 0 && u->next_due_ms < next) {
+            next = u->next_due_ms;
+        }
+    }
+    return next;
+}
+
+void collector_sched_record(collector_sched_t *sched, collector_unit_id_t unit,
+                            uint64_t now_ms, uint64_t cpu_ns) {
+    collector_unit_t *u = &sched->units[unit];
+    double cost = cpu_ns / 1000.0;
+    u->cost_us = u->runs ? u->cost_us + COLLECTOR_SCHED_COST_WEIGHT * (cost - u->cost_us) : cost;
+    if (u->runs == 0) {
+        u->first_run_ms = now_ms;
+    }
+    u->runs++;
+    u->cpu_ns += cpu_ns;
+    u->last_run_ms = now_ms;
+
+    // Alinhado à grade original; um atraso maior que o intervalo pula ticks
+    u->next_due_ms += u->interval_ms;
+    if (u->next_due_ms <= now_ms) {
+        u->next_due_ms = now_ms + u->interval_ms;
+    }
+}
+
+/**
+ * µs de CPU por segundo que a unidade gasta com o intervalo dado
+ */
+static double unit_load(const collector_unit_t *u, uint64_t interval_ms) {
+    return u->cost_us * 1000.0 / (double)interval_ms;
+}
+
+int collector_sched_rebalance(collector_sched_t *sched) {
+    uint64_t target[COLLECTOR_UNIT_COUNT] = { 0 };
+    double total = 0;
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        const collector_unit_t *u = &sched->units[i];
+        if (u->requested_ms == 0) continue;
+        target[i] = u->requested_ms;
+        total += unit_load(u, u->requested_ms);
+    }
+
+    // Da unidade mais cara por execução para a mais barata, alonga só o
+    // necessário para cobrir o excesso
+    double limit = sched->budget * 1e6;
+    int done[COLLECTOR_UNIT_COUNT] = { 0 };
+    while (sched->budget > 0 && total > limit) {
+        int pick = -1;
+        for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+            if (target[i] == 0 || done[i]) continue;
+            if (pick < 0 || sched->units[i].cost_us > sched->units[pick].cost_us) pick = i;
+        }
+        if (pick < 0) {
+            break;
+        }
+        done[pick] = 1;
+
+        const collector_unit_t *u = &sched->units[pick];
+        double current = unit_load(u, target[pick]);
+        double floor_load = unit_load(u, u->requested_ms * COLLECTOR_SCHED_MAX_STRETCH);
+        double wanted = current - (total - limit);
+        if (wanted < floor_load) wanted = floor_load;
+        target[pick] = (uint64_t)ceil(u->cost_us * 1000.0 / wanted);
+        total -= current - unit_load(u, target[pick]);
+    }
+    sched->planned_us_per_s = total;
+    sched->over_budget = sched->budget > 0 && total > limit * 1.001;
+
+    // Mudanças de até 10% são ignoradas: o custo médio oscila e um intervalo
+    // que muda a cada tick só desalinha a grade
+    int changed = 0;
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        collector_unit_t *u = &sched->units[i];
+        if (target[i] == 0 || target[i] == u->interval_ms) continue;
+        double ratio = (double)target[i] / (double)u->interval_ms;
+        if (ratio > 0.9 && ratio < 1.1 && target[i] != u->requested_ms) continue;
+        u->interval_ms = target[i];
+        if (u->runs) u->next_due_ms = u->last_run_ms + u->interval_ms;
+        changed = 1;
+    }
+    if (changed) {
+        sched->rebalances++;
+    }
+    return changed;
+}
+
+double collector_unit_achieved_hz(const collector_unit_t *unit) {
+    if (unit->runs < 2 || unit->last_run_ms <= unit->first_run_ms) {
+        return 0.0;
+    }
+    return (unit->runs - 1) * 1000.0 / (double)(unit->last_run_ms - unit->first_run_ms);
+}
+
+void print_collector_sched_report(const collector_sched_t *sched, uint64_t now_ms) {
+    double elapsed_s = now_ms > sched->start_ms ? (now_ms - sched->start_ms) / 1000.0 : 0.0;
+    uint64_t cpu_ns = 0;
+
+    printf("\n--- Collector Schedule ");
+    if (sched->budget > 0) {
+        printf("(budget %.3f%% of one core) ", sched->budget * 100.0);
+    }
+    printf("---\n");
+    printf("%-8s %12s %12s %12s %12s %10s %10s\n",
+           "Unit", "Requested", "Effective", "Req. Hz", "Achieved Hz", "Cost/run", "CPU");
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        const collector_unit_t *u = &sched->units[i];
+        if (u->requested_ms == 0) continue;
+        cpu_ns += u->cpu_ns;
+        printf("%-8s %10.3f s %10.3f s %12.3f %12.3f %7.1f us %9.4f%%\n",
+               u->name, u->requested_ms / 1000.0, u->interval_ms / 1000.0,
+               1000.0 / (double)u->requested_ms, collector_unit_achieved_hz(u), u->cost_us,
+               elapsed_s > 0 ? u->cpu_ns / 1e7 / elapsed_s : 0.0);
+    }
+    printf("Collectors used %.4f%% of one core (planned %.4f%%)",
+           elapsed_s > 0 ? cpu_ns / 1e7 / elapsed_s : 0.0, sched->planned_us_per_s / 1e4);
+    if (sched->over_budget) {
+        printf(" - over budget even at %dx the requested intervals", COLLECTOR_SCHED_MAX_STRETCH);
+    }
+    printf("\n");
+}
@@ -0,0 +1,932 @@
+#define _GNU_SOURCE
+#include "container.h"
+#include "monitor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// Capacidades iniciais (potências de 2)
+#define VIEW_INITIAL_CONTAINERS 64
+#define VIEW_INITIAL_CACHE 256
+#define VIEW_INITIAL_PIDS 1024
+// Máximo de componentes analisados em um caminho de cgroup
+#define MAX_PATH_COMPONENTS 64
+
+// Nomes dos runtimes
+static const char* runtime_names[CONTAINER_RUNTIME_COUNT] = {
+    "host",
+    "docker",
+    "containerd",
+    "cri-o",
+    "podman",
+    "systemd"
+};
+
+/**
+ * Converte runtime para string
+ */
+const char* container_runtime_to_string(container_runtime_t runtime) {
+    if (runtime >= 0 && runtime < CONTAINER_RUNTIME_COUNT) {
+        return runtime_names[runtime];
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Classificação de caminhos de cgroup
+// ============================================================================
+
+/**
+ * Verifica se o trecho parece um ID de contêiner (hexadecimal, >= 12 dígitos)
+ */
+static int is_hex_id(const char *s, size_t len) {
+    if (len < 12) {
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!isxdigit((unsigned char)s[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Se o componente for <prefix><id><suffix>, copia o id e retorna 1
+ */
+static int match_wrapped(const char *comp, size_t len, const char *prefix,
+                         const char *suffix, char *id, size_t id_size) {
+    size_t plen = strlen(prefix), slen = strlen(suffix);
+    if (len <= plen + slen || strncmp(comp, prefix, plen) != 0 ||
+        strncmp(comp + len - slen, suffix, slen) != 0) {
+        return 0;
+    }
+
+    size_t id_len = len - plen - slen;
+    if (id_len >= id_size) id_len = id_size - 1;
+    memcpy(id, comp + plen, id_len);
+    id[id_len] = '\0';
+    return 1;
+}
+
+static void copy_component(const char *comp, size_t len, char *id, size_t id_size) {
+    if (len >= id_size) len = id_size - 1;
+    memcpy(id, comp, len);
+    id[len] = '\0';
+}
+
+/**
+ * Identifica o contêiner de um caminho de cgroup
+ *
+ * Os componentes são examinados do mais profundo para o mais raso, de modo
+ * que sub-cgroups criados dentro do contêiner (ex: systemd no contêiner)
+ * sejam atribuídos a ele. Layouts de runtime têm prioridade sobre units.
+ */
+container_runtime_t classify_container_cgroup(const char *path, char *id, size_t id_size,
+                                              size_t *root_len) {
+    const char *start[MAX_PATH_COMPONENTS];
+    size_t len[MAX_PATH_COMPONENTS];
+    int n = 0;
+    int under_kubepods = 0;
+
+    for (const char *p = path; *p != '\0' && n < MAX_PATH_COMPONENTS; ) {
+        while (*p == '/') p++;
+        if (*p == '\0') break;
+        const char *end = strchr(p, '/');
+        if (end == NULL) end = p + strlen(p);
+        start[n] = p;
+        len[n] = (size_t)(end - p);
+        n++;
+        p = end;
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        const char *comp = start[i];
+        size_t clen = len[i];
+        container_runtime_t runtime = CONTAINER_RUNTIME_HOST;
+
+        if (match_wrapped(comp, clen, "docker-", ".scope", id, id_size)) {
+            runtime = CONTAINER_RUNTIME_DOCKER;
+        } else if (match_wrapped(comp, clen, "cri-containerd-", ".scope", id, id_size)) {
+            runtime = CONTAINER_RUNTIME_CONTAINERD;
+        } else if (strncmp(comp, "crio-conmon-", 12) != 0 &&
+                   match_wrapped(comp, clen, "crio-", ".scope", id, id_size)) {
+            runtime = CONTAINER_RUNTIME_CRIO;
+        } else if (strncmp(comp, "libpod-conmon-", 14) != 0 &&
+                   (match_wrapped(comp, clen, "libpod-", ".scope", id, id_size) ||
+                    match_wrapped(comp, clen, "libpod-", "", id, id_size))) {
+            runtime = CONTAINER_RUNTIME_PODMAN;
+        } else if (i > 0 && is_hex_id(comp, clen) &&
+                   len[i - 1] == 6 && strncmp(start[i - 1], "docker", 6) == 0) {
+            // Driver cgroupfs do docker: /docker/<id>
+            runtime = CONTAINER_RUNTIME_DOCKER;
+            copy_component(comp, clen, id, id_size);
+        } else if (is_hex_id(comp, clen)) {
+            // Driver cgroupfs do kubelet: /kubepods/<qos>/pod<uid>/<id>
+            for (int j = 0; j < i; j++) {
+                if (len[j] >= 8 && strncmp(start[j], "kubepods", 8) == 0) {
+                    under_kubepods = 1;
+                    break;
+                }
+            }
+            if (under_kubepods) {
+                runtime = CONTAINER_RUNTIME_CONTAINERD;
+                copy_component(comp, clen, id, id_size);
+            }
+        }
+
+        if (runtime != CONTAINER_RUNTIME_HOST) {
+            if (root_len != NULL) *root_len = (size_t)(comp + clen - path);
+            return runtime;
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        const char *comp = start[i];
+        size_t clen = len[i];
+        if ((clen > 8 && strncmp(comp + clen - 8, ".service", 8) == 0) ||
+            (clen > 6 && strncmp(comp + clen - 6, ".scope", 6) == 0)) {
+            copy_component(comp, clen, id, id_size);
+            if (root_len != NULL) *root_len = (size_t)(comp + clen - path);
+            return CONTAINER_RUNTIME_SYSTEMD;
+        }
+    }
+
+    snprintf(id, id_size, "%s", (path[0] != '\0') ? path : "/");
+    if (root_len != NULL) *root_len = strlen(path);
+    return CONTAINER_RUNTIME_HOST;
+}
+
+// ============================================================================
+// Leitura de /proc por processo
+// ============================================================================
+
+/**
+ * Lê um arquivo pequeno relativo a /proc (uma chamada read)
+ * @return Bytes lidos, ou -1 em erro
+ */
+static ssize_t read_proc_file(int proc_fd, const char *rel, char *buf, size_t size) {
+    int fd = openat(proc_fd, rel, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t n = read(fd, buf, size - 1);
+    close(fd);
+    if (n < 0) {
+        return -1;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+/**
+ * Verifica se o controlador aparece na lista separada por vírgulas
+ */
+static int has_controller(const char *list, size_t list_len, const char *controller) {
+    size_t clen = strlen(controller);
+    const char *p = list, *end = list + list_len;
+    while (p < end) {
+        const char *comma = memchr(p, ',', (size_t)(end - p));
+        size_t len = comma ? (size_t)(comma - p) : (size_t)(end - p);
+        if (len == clen && strncmp(p, controller, clen) == 0) {
+            return 1;
+        }
+        p += len + 1;
+    }
+    return 0;
+}
+
+/**
+ * Extrai os caminhos relativos de cgroup do conteúdo de /proc/<pid>/cgroup
+ * (o buffer é modificado)
+ *
+ * Em v2 os dois recebem a linha "0::"; em v1 usa os controladores cpu e
+ * memory (comparando nomes exatos, pois "cpu" é prefixo de "cpuset")
+ */
+static void parse_pid_cgroup(char *buf, int version, char *cpu_rel, char *mem_rel, size_t size) {
+    cpu_rel[0] = mem_rel[0] = '\0';
+    int found_cpu = 0, found_mem = 0;
+    char unified[512] = "";
+
+    for (char *line = buf, *next; line != NULL && *line != '\0'; line = next) {
+        next = strchr(line, '\n');
+        if (next != NULL) *next++ = '\0';
+
+        char *colon1 = strchr(line, ':');
+        char *colon2 = colon1 ? strchr(colon1 + 1, ':') : NULL;
+        if (colon2 == NULL) continue;
+
+        const char *path = colon2 + 1;
+        if (colon2 == colon1 + 1) {
+            snprintf(unified, sizeof(unified), "%s", path);
+            continue;
+        }
+        size_t list_len = (size_t)(colon2 - colon1 - 1);
+        if (!found_cpu && has_controller(colon1 + 1, list_len, "cpu")) {
+            snprintf(cpu_rel, size, "%s", path);
+            found_cpu = 1;
+        }
+        if (!found_mem && has_controller(colon1 + 1, list_len, "memory")) {
+            snprintf(mem_rel, size, "%s", path);
+            found_mem = 1;
+        }
+    }
+
+    if (version != 1 || !found_cpu) {
+        snprintf(cpu_rel, size, "%s", unified);
+    }
+    if (version != 1 || !found_mem) {
+        snprintf(mem_rel, size, "%s", unified);
+    }
+}
+
+/**
+ * Lê CPU e RSS de /proc/<pid>/stat e bytes de /proc/<pid>/io
+ *
+ * Não usa collect_*_metrics: aqueles mantêm estado de taxa de um único alvo
+ * e abrem mais arquivos por processo
+ *
+ * @param start_time Recebe o instante de início do processo (identidade do PID)
+ */
+static int read_pid_usage(int proc_fd, pid_t pid, long page_size, container_usage_t *usage,
+                          uint64_t *start_time) {
+    char rel[32], buf[1024];
+
+    snprintf(rel, sizeof(rel), "%d/stat", pid);
+    if (read_proc_file(proc_fd, rel, buf, sizeof(buf)) < 0) {
+        return -1;
+    }
+
+    // Campos após o último ')': 3=state ... 14=utime 15=stime ... 22=starttime 24=rss
+    char *p = strrchr(buf, ')');
+    if (p == NULL) {
+        return -1;
+    }
+    p++;
+    unsigned long long utime = 0, stime = 0, start = 0;
+    long long rss = 0;
+    for (int field = 3; field <= 24 && *p != '\0'; field++) {
+        while (*p == ' ') p++;
+        char *end;
+        if (field == 14) utime = strtoull(p, &end, 10);
+        else if (field == 15) stime = strtoull(p, &end, 10);
+        else if (field == 22) start = strtoull(p, &end, 10);
+        else if (field == 24) rss = strtoll(p, &end, 10);
+        else end = strchr(p, ' ');
+        if (end == NULL) break;
+        p = end;
+    }
+    *start_time = start;
+    usage->cpu_ticks += utime + stime;
+    if (rss > 0) usage->rss_bytes += (uint64_t)rss * (uint64_t)page_size;
+
+    // /proc/<pid>/io exige permissão de ptrace; sem ela, só CPU e memória
+    snprintf(rel, sizeof(rel), "%d/io", pid);
+    if (read_proc_file(proc_fd, rel, buf, sizeof(buf)) >= 0) {
+        char *line = strstr(buf, "\nread_bytes:");
+        if (line != NULL) usage->read_bytes += strtoull(line + 12, NULL, 10);
+        line = strstr(buf, "\nwrite_bytes:");
+        if (line != NULL) usage->write_bytes += strtoull(line + 13, NULL, 10);
+    }
+    return 0;
+}
+
+// ============================================================================
+// Cache de resolução de cgroups
+// ============================================================================
+
+static uint64_t hash_string(const char *s) {
+    // FNV-1a 64 bits
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (; *s != '\0'; s++) {
+        h ^= (unsigned char)*s;
+        h *= 0x100000001b3ULL;
+    }
+    return h ? h : 1;
+}
+
+static int cache_grow(container_view_t *view) {
+    size_t new_capacity = view->cache_capacity ? view->cache_capacity * 2 : VIEW_INITIAL_CACHE;
+    container_cgroup_cache_t *slots = calloc(new_capacity, sizeof(*slots));
+    if (slots == NULL) {
+        return -1;
+    }
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < view->cache_capacity; i++) {
+        if (view->cache[i].key == 0) continue;
+        size_t j = view->cache[i].key & mask;
+        while (slots[j].key != 0) j = (j + 1) & mask;
+        slots[j] = view->cache[i];
+    }
+
+    free(view->cache);
+    view->cache = slots;
+    view->cache_capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * Monta o caminho absoluto do cgroup raiz para um controlador
+ */
+static void build_root_path(int version, const char *controller, const char *rel,
+                            size_t root_len, char *out, size_t size) {
+    if (version == 1) {
+        snprintf(out, size, "%s/%s%.*s", cgroup_root(), controller, (int)root_len, rel);
+    } else {
+        snprintf(out, size, "%s%.*s", cgroup_root(), (int)root_len, rel);
+    }
+}
+
+/**
+ * Identifica um cgroup folha pelo inode do seu diretório; se a hierarquia
+ * não estiver montada, pelo hash do caminho
+ */
+static uint64_t cgroup_leaf_identity(int version, const char *controller, const char *rel) {
+    char path[1024];
+    struct stat st;
+    build_root_path(version, controller, rel, strlen(rel), path, sizeof(path));
+    if (stat(path, &st) == 0 && st.st_ino != 0) {
+        return (uint64_t)st.st_ino;
+    }
+    return hash_string(rel);
+}
+
+static uint64_t cgroup_leaf_key(uint64_t cpu_leaf, uint64_t mem_leaf) {
+    uint64_t h = cpu_leaf * 0x9e3779b97f4a7c15ULL;
+    h ^= mem_leaf + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h ? h : 1;
+}
+
+/**
+ * Procura o cgroup folha já resolvido
+ */
+static container_cgroup_cache_t* find_cgroup(container_view_t *view, uint64_t cpu_leaf,
+                                             uint64_t mem_leaf) {
+    if (view->cache_capacity == 0) {
+        return NULL;
+    }
+    uint64_t key = cgroup_leaf_key(cpu_leaf, mem_leaf);
+    size_t mask = view->cache_capacity - 1;
+    for (size_t i = key & mask; view->cache[i].key != 0; i = (i + 1) & mask) {
+        container_cgroup_cache_t *cg = &view->cache[i];
+        if (cg->key == key && cg->cpu_leaf == cpu_leaf && cg->mem_leaf == mem_leaf) {
+            cg->seen = 1;
+            view->cache_hits++;
+            return cg;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Resolve o cgroup folha para o contêiner, classificando-o na primeira vez
+ */
+static const container_cgroup_cache_t* resolve_cgroup(container_view_t *view,
+                                                      const char *cpu_rel,
+                                                      const char *mem_rel) {
+    uint64_t cpu_leaf = cgroup_leaf_identity(view->cgroup_version, "cpu", cpu_rel);
+    uint64_t mem_leaf = (view->cgroup_version == 1)
+                      ? cgroup_leaf_identity(view->cgroup_version, "memory", mem_rel)
+                      : cpu_leaf;
+
+    const container_cgroup_cache_t *cached = find_cgroup(view, cpu_leaf, mem_leaf);
+    if (cached != NULL) {
+        return cached;
+    }
+
+    if ((view->cache_count + 1) * 4 > view->cache_capacity * 3 && cache_grow(view) != 0) {
+        return NULL;
+    }
+
+    container_cgroup_cache_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.key = cgroup_leaf_key(cpu_leaf, mem_leaf);
+    entry.cpu_leaf = cpu_leaf;
+    entry.mem_leaf = mem_leaf;
+    entry.seen = 1;
+
+    size_t cpu_root_len = 0, mem_root_len = 0;
+    char mem_id[72];
+    entry.runtime = classify_container_cgroup(cpu_rel, entry.id, sizeof(entry.id), &cpu_root_len);
+    container_runtime_t mem_runtime = classify_container_cgroup(mem_rel, mem_id, sizeof(mem_id),
+                                                                &mem_root_len);
+
+    build_root_path(view->cgroup_version, "cpu", cpu_rel, cpu_root_len,
+                    entry.cpu_root, sizeof(entry.cpu_root));
+    build_root_path(view->cgroup_version, "memory", mem_rel, mem_root_len,
+                    entry.mem_root, sizeof(entry.mem_root));
+
+    // Em v1 o contêiner pode estar só em alguns controladores
+    const char *root_abs = entry.cpu_root;
+    const char *root_rel = cpu_rel;
+    size_t root_len = cpu_root_len;
+    if (entry.runtime == CONTAINER_RUNTIME_HOST && mem_runtime != CONTAINER_RUNTIME_HOST) {
+        entry.runtime = mem_runtime;
+        snprintf(entry.id, sizeof(entry.id), "%s", mem_id);
+        root_abs = entry.mem_root;
+        root_rel = mem_rel;
+        root_len = mem_root_len;
+    }
+    snprintf(entry.root_path, sizeof(entry.root_path), "%.*s", (int)root_len, root_rel);
+    if (entry.root_path[0] == '\0') {
+        snprintf(entry.root_path, sizeof(entry.root_path), "/");
+    }
+
+    struct stat st;
+    entry.root_inode = (stat(root_abs, &st) == 0) ? st.st_ino : 0;
+
+    size_t mask = view->cache_capacity - 1;
+    size_t i = entry.key & mask;
+    while (view->cache[i].key != 0) i = (i + 1) & mask;
+    view->cache[i] = entry;
+    view->cache_count++;
+    view->cache_misses++;
+    return &view->cache[i];
+}
+
+/**
+ * Descarta do cache os cgroups que não apareceram nesta atualização
+ */
+static void cache_purge_unseen(container_view_t *view) {
+    size_t live = 0;
+    for (size_t i = 0; i < view->cache_capacity; i++) {
+        if (view->cache[i].key != 0 && view->cache[i].seen) live++;
+    }
+    if (live == view->cache_count) {
+        for (size_t i = 0; i < view->cache_capacity; i++) view->cache[i].seen = 0;
+        return;
+    }
+
+    container_cgroup_cache_t *old = view->cache;
+    size_t old_capacity = view->cache_capacity;
+    container_cgroup_cache_t *slots = calloc(old_capacity, sizeof(*slots));
+    if (slots == NULL) {
+        return;
+    }
+
+    size_t mask = old_capacity - 1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].key == 0 || !old[i].seen) continue;
+        size_t j = old[i].key & mask;
+        while (slots[j].key != 0) j = (j + 1) & mask;
+        slots[j] = old[i];
+        slots[j].seen = 0;
+    }
+
+    free(old);
+    view->cache = slots;
+    view->cache_count = live;
+}
+
+// ============================================================================
+// Cache de pertinência por PID
+// ============================================================================
+
+static size_t pid_slot(pid_t pid, size_t mask) {
+    return (size_t)(((uint64_t)pid * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+}
+
+static container_pid_cache_t* pid_cache_find(container_view_t *view, pid_t pid) {
+    if (view->pid_capacity == 0) {
+        return NULL;
+    }
+    size_t mask = view->pid_capacity - 1;
+    for (size_t i = pid_slot(pid, mask); view->pids[i].pid != 0; i = (i + 1) & mask) {
+        if (view->pids[i].pid == pid) {
+            return &view->pids[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Reconstrói a tabela com a capacidade dada, mantendo só as entradas vistas
+ * nesta atualização (keep_unseen para um crescimento no meio dela)
+ */
+static int pid_cache_rehash(container_view_t *view, size_t capacity, int keep_unseen) {
+    container_pid_cache_t *slots = calloc(capacity, sizeof(*slots));
+    if (slots == NULL) {
+        return -1;
+    }
+
+    size_t mask = capacity - 1, live = 0;
+    for (size_t i = 0; i < view->pid_capacity; i++) {
+        const container_pid_cache_t *entry = &view->pids[i];
+        if (entry->pid == 0 || (!keep_unseen && !entry->seen)) continue;
+        size_t j = pid_slot(entry->pid, mask);
+        while (slots[j].pid != 0) j = (j + 1) & mask;
+        slots[j] = *entry;
+        if (!keep_unseen) slots[j].seen = 0;
+        live++;
+    }
+
+    free(view->pids);
+    view->pids = slots;
+    view->pid_capacity = capacity;
+    view->pid_count = live;
+    return 0;
+}
+
+static void pid_cache_store(container_view_t *view, pid_t pid, uint64_t start_time,
+                            uint64_t cgroup_hash, const container_cgroup_cache_t *cg) {
+    container_pid_cache_t *entry = pid_cache_find(view, pid);
+    if (entry == NULL) {
+        if ((view->pid_count + 1) * 4 > view->pid_capacity * 3 &&
+            pid_cache_rehash(view, view->pid_capacity ? view->pid_capacity * 2 : VIEW_INITIAL_PIDS,
+                             1) != 0) {
+            return; // sem memória: o PID é resolvido de novo na próxima vez
+        }
+        size_t mask = view->pid_capacity - 1;
+        size_t i = pid_slot(pid, mask);
+        while (view->pids[i].pid != 0) i = (i + 1) & mask;
+        entry = &view->pids[i];
+        entry->pid = pid;
+        view->pid_count++;
+    }
+    entry->start_time = start_time;
+    entry->cgroup_hash = cgroup_hash;
+    entry->cpu_leaf = cg->cpu_leaf;
+    entry->mem_leaf = cg->mem_leaf;
+    entry->seen = 1;
+}
+
+/**
+ * Descarta os PIDs que não apareceram nesta atualização
+ */
+static void pid_cache_purge_unseen(container_view_t *view) {
+    size_t live = 0;
+    for (size_t i = 0; i < view->pid_capacity; i++) {
+        if (view->pids[i].pid != 0 && view->pids[i].seen) live++;
+    }
+    if (live == view->pid_count) {
+        for (size_t i = 0; i < view->pid_capacity; i++) view->pids[i].seen = 0;
+        return;
+    }
+    pid_cache_rehash(view, view->pid_capacity, 0);
+}
+
+// ============================================================================
+// Tabela de contêineres
+// ============================================================================
+
+static uint64_t container_key_hash(ino_t inode, ino_t ns_pid, ino_t ns_mnt, ino_t ns_net) {
+    uint64_t h = (uint64_t)inode * 0x9e3779b97f4a7c15ULL;
+    h ^= (uint64_t)ns_pid + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= (uint64_t)ns_mnt + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= (uint64_t)ns_net + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+static int rebuild_slots(container_view_t *view) {
+    size_t needed = VIEW_INITIAL_CONTAINERS;
+    while (needed < view->count * 2) needed *= 2;
+
+    if (needed != view->slot_capacity) {
+        size_t *slots = calloc(needed, sizeof(size_t));
+        if (slots == NULL) {
+            return -1;
+        }
+        free(view->slots);
+        view->slots = slots;
+        view->slot_capacity = needed;
+    } else {
+        memset(view->slots, 0, needed * sizeof(size_t));
+    }
+
+    size_t mask = view->slot_capacity - 1;
+    for (size_t c = 0; c < view->count; c++) {
+        const container_t *ct = &view->containers[c];
+        size_t i = container_key_hash(ct->cgroup_inode, ct->ns_pid, ct->ns_mnt, ct->ns_net) & mask;
+        while (view->slots[i] != 0) i = (i + 1) & mask;
+        view->slots[i] = c + 1;
+    }
+    return 0;
+}
+
+static container_t* find_container(const container_view_t *view, ino_t inode,
+                                   ino_t ns_pid, ino_t ns_mnt, ino_t ns_net) {
+    if (view->slot_capacity == 0) {
+        return NULL;
+    }
+    size_t mask = view->slot_capacity - 1;
+    for (size_t i = container_key_hash(inode, ns_pid, ns_mnt, ns_net) & mask;
+         view->slots[i] != 0; i = (i + 1) & mask) {
+        container_t *ct = &view->containers[view->slots[i] - 1];
+        if (ct->cgroup_inode == inode && ct->ns_pid == ns_pid &&
+            ct->ns_mnt == ns_mnt && ct->ns_net == ns_net) {
+            return ct;
+        }
+    }
+    return NULL;
+}
+
+static container_t* add_container(container_view_t *view, const container_cgroup_cache_t *cg,
+                                  ino_t ns_pid, ino_t ns_mnt, ino_t ns_net) {
+    if (view->count == view->capacity) {
+        size_t new_capacity = view->capacity ? view->capacity * 2 : VIEW_INITIAL_CONTAINERS;
+        container_t *grown = realloc(view->containers, new_capacity * sizeof(container_t));
+        if (grown == NULL) {
+            return NULL;
+        }
+        view->containers = grown;
+        view->capacity = new_capacity;
+    }
+
+    container_t *ct = &view->containers[view->count++];
+    memset(ct, 0, sizeof(*ct));
+    ct->runtime = cg->runtime;
+    snprintf(ct->id, sizeof(ct->id), "%s", cg->id);
+    snprintf(ct->cgroup_path, sizeof(ct->cgroup_path), "%s", cg->root_path);
+    snprintf(ct->cpu_root, sizeof(ct->cpu_root), "%s", cg->cpu_root);
+    snprintf(ct->mem_root, sizeof(ct->mem_root), "%s", cg->mem_root);
+    ct->cgroup_inode = cg->root_inode;
+    ct->ns_pid = ns_pid;
+    ct->ns_mnt = ns_mnt;
+    ct->ns_net = ns_net;
+
+    // Mantém a tabela com fator de carga <= 1/2
+    if (view->count * 2 > view->slot_capacity) {
+        if (rebuild_slots(view) != 0) {
+            view->count--;
+            return NULL;
+        }
+        return &view->containers[view->count - 1];
+    }
+
+    size_t mask = view->slot_capacity - 1;
+    size_t i = container_key_hash(ct->cgroup_inode, ns_pid, ns_mnt, ns_net) & mask;
+    while (view->slots[i] != 0) i = (i + 1) & mask;
+    view->slots[i] = view->count;
+    return ct;
+}
+
+/**
+ * Contêiner do PID, criando-o se necessário
+ *
+ * /proc/<pid>/cgroup é lido sempre, mas só reinterpretado quando o PID é
+ * novo ou o conteúdo mudou desde a última atualização
+ *
+ * @param start_time Instante de início do PID (usado só com create)
+ */
+static container_t* container_for_process(container_view_t *view,
+                                          const process_namespace_record_t *ns,
+                                          uint64_t start_time, int create) {
+    char rel[32], buf[4096];
+    snprintf(rel, sizeof(rel), "%d/cgroup", ns->pid);
+    if (read_proc_file(view->proc_fd, rel, buf, sizeof(buf)) < 0) {
+        return NULL;
+    }
+    uint64_t cgroup_hash = hash_string(buf);
+
+    const container_cgroup_cache_t *cg = NULL;
+    container_pid_cache_t *known = create ? pid_cache_find(view, ns->pid) : NULL;
+    if (known != NULL && known->start_time == start_time && known->cgroup_hash == cgroup_hash) {
+        cg = find_cgroup(view, known->cpu_leaf, known->mem_leaf);
+        known->seen = 1;
+    }
+
+    if (cg == NULL) {
+        char cpu_rel[512], mem_rel[512];
+        parse_pid_cgroup(buf, view->cgroup_version, cpu_rel, mem_rel, sizeof(cpu_rel));
+        cg = resolve_cgroup(view, cpu_rel, mem_rel);
+        if (cg == NULL) {
+            return NULL;
+        }
+        view->pid_resolves++;
+        if (create) {
+            pid_cache_store(view, ns->pid, start_time, cgroup_hash, cg);
+        }
+    }
+
+    ino_t ns_pid = (ns->present & (1u << NS_PID)) ? ns->inode[NS_PID] : 0;
+    ino_t ns_mnt = (ns->present & (1u << NS_MNT)) ? ns->inode[NS_MNT] : 0;
+    ino_t ns_net = (ns->present & (1u << NS_NET)) ? ns->inode[NS_NET] : 0;
+
+    container_t *ct = find_container(view, cg->root_inode, ns_pid, ns_mnt, ns_net);
+    if (ct == NULL && create) {
+        ct = add_container(view, cg, ns_pid, ns_mnt, ns_net);
+    }
+    return ct;
+}
+
+// ============================================================================
+// API pública
+// ============================================================================
+
+int container_view_init(container_view_t *view) {
+    if (view == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(view, 0, sizeof(*view));
+    view->proc_fd = open(proc_root(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (view->proc_fd < 0) {
+        return -1;
+    }
+    view->cgroup_version = detect_cgroup_version();
+    view->ticks_per_sec = sysconf(_SC_CLK_TCK);
+    if (view->ticks_per_sec <= 0) view->ticks_per_sec = 100;
+
+    // Eventos de processo só descrevem o /proc real, não uma árvore gravada
+    if (namespace_index_init(&view->index, strcmp(proc_root(), "/proc") == 0) != 0) {
+        close(view->proc_fd);
+        view->proc_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int container_view_refresh(container_view_t *view) {
+    if (view == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Só o primeiro refresh usa a varredura de init; depois, eventos
+    if (view->refreshes > 0 && namespace_index_refresh(&view->index) != 0) {
+        return -1;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = (now.tv_sec - view->last_refresh.tv_sec) +
+                     (now.tv_nsec - view->last_refresh.tv_nsec) / 1e9;
+
+    for (size_t c = 0; c < view->count; c++) {
+        container_t *ct = &view->containers[c];
+        ct->seen = 0;
+        ct->process_count = 0;
+        memset(&ct->usage, 0, sizeof(ct->usage));
+    }
+
+    // Por processo: stat, io e cgroup; este só é reinterpretado se mudou
+    long page_size = sysconf(_SC_PAGESIZE);
+    namespace_index_t *index = &view->index;
+    for (size_t i = 0; i < index->process_capacity; i++) {
+        const process_namespace_record_t *ns = &index->processes[i].ns;
+        if (ns->pid == 0) {
+            continue;
+        }
+
+        container_usage_t usage;
+        uint64_t start_time = 0;
+        memset(&usage, 0, sizeof(usage));
+        if (read_pid_usage(view->proc_fd, ns->pid, page_size, &usage, &start_time) != 0) {
+            continue;
+        }
+
+        container_t *ct = container_for_process(view, ns, start_time, 1);
+        if (ct == NULL) {
+            // Processo terminou entre o evento e a leitura
+            continue;
+        }
+        ct->usage.cpu_ticks += usage.cpu_ticks;
+        ct->usage.rss_bytes += usage.rss_bytes;
+        ct->usage.read_bytes += usage.read_bytes;
+        ct->usage.write_bytes += usage.write_bytes;
+        ct->process_count++;
+        ct->seen = 1;
+    }
+
+    // Remove contêineres sem processos e recalcula as taxas dos demais
+    size_t kept = 0;
+    for (size_t c = 0; c < view->count; c++) {
+        container_t *ct = &view->containers[c];
+        if (!ct->seen) {
+            continue;
+        }
+
+        ct->has_cgroup = (read_cgroup_metrics_from_path(ct->cpu_root, ct->mem_root,
+                                                        &ct->cgroup) == 0);
+
+        // Somas por processo caem quando processos terminam: não gerar taxa negativa
+        if (ct->has_prev && elapsed > 0) {
+            uint64_t dcpu = ct->usage.cpu_ticks > ct->prev_usage.cpu_ticks
+                          ? ct->usage.cpu_ticks - ct->prev_usage.cpu_ticks : 0;
+            uint64_t dread = ct->usage.read_bytes > ct->prev_usage.read_bytes
+                           ? ct->usage.read_bytes - ct->prev_usage.read_bytes : 0;
+            uint64_t dwrite = ct->usage.write_bytes > ct->prev_usage.write_bytes
+                            ? ct->usage.write_bytes - ct->prev_usage.write_bytes : 0;
+            ct->cpu_percent = dcpu / (double)view->ticks_per_sec / elapsed * 100.0;
+            ct->read_rate = dread / elapsed;
+            ct->write_rate = dwrite / elapsed;
+
+            if (ct->has_cgroup && ct->cgroup.has_cpu && ct->cgroup.cpu.usage_usec >= ct->prev_cgroup_usec) {
+                ct->cgroup_cpu_percent = (ct->cgroup.cpu.usage_usec - ct->prev_cgroup_usec)
+                                         / 1e6 / elapsed * 100.0;
+            }
+        }
+        ct->prev_usage = ct->usage;
+        ct->prev_cgroup_usec = (ct->has_cgroup && ct->cgroup.has_cpu) ? ct->cgroup.cpu.usage_usec : 0;
+        ct->has_prev = 1;
+
+        if (kept != c) {
+            view->containers[kept] = *ct;
+        }
+        kept++;
+    }
+    if (kept != view->count) {
+        view->count = kept;
+        rebuild_slots(view);
+    }
+
+    cache_purge_unseen(view);
+    pid_cache_purge_unseen(view);
+
+    view->last_refresh = now;
+    view->refreshes++;
+    return (int)view->count;
+}
+
+void container_view_free(container_view_t *view) {
+    if (view == NULL) {
+        return;
+    }
+    namespace_index_free(&view->index);
+    if (view->proc_fd >= 0) {
+        close(view->proc_fd);
+    }
+    free(view->containers);
+    free(view->slots);
+    free(view->cache);
+    free(view->pids);
+    memset(view, 0, sizeof(*view));
+    view->proc_fd = -1;
+}
+
+const container_t* container_view_find_pid(container_view_t *view, pid_t pid) {
+    if (view == NULL) {
+        return NULL;
+    }
+
+    process_namespace_record_t ns;
+    if (read_process_namespace_record(pid, &ns) != 0) {
+        return NULL;
+    }
+    return container_for_process(view, &ns, 0, 0);
+}
+
+static int compare_containers(const void *a, const void *b) {
+    const container_t *ca = a, *cb = b;
+    if (ca->runtime != cb->runtime) {
+        // Contêineres antes de units e do host
+        int ra = ca->runtime == CONTAINER_RUNTIME_HOST ? CONTAINER_RUNTIME_COUNT : (int)ca->runtime;
+        int rb = cb->runtime == CONTAINER_RUNTIME_HOST ? CONTAINER_RUNTIME_COUNT : (int)cb->runtime;
+        return ra - rb;
+    }
+    return (cb->cpu_percent > ca->cpu_percent) - (cb->cpu_percent < ca->cpu_percent);
+}
+
+void print_container_view(const container_view_t *view, int include_host) {
+    if (view == NULL) {
+        return;
+    }
+
+    container_t *sorted = malloc((view->count ? view->count : 1) * sizeof(container_t));
+    if (sorted == NULL) {
+        return;
+    }
+    memcpy(sorted, view->containers, view->count * sizeof(container_t));
+    qsort(sorted, view->count, sizeof(container_t), compare_containers);
+
+    printf("%-10s %-14s %6s %8s %8s %10s %10s %10s %10s\n",
+           "Runtime", "ID", "Procs", "CPU%", "CG CPU%", "RSS(MB)", "CG Mem(MB)",
+           "Read KB/s", "Write KB/s");
+    printf("──────────────────────────────────────────────────────────────────────────────────────────────\n");
+
+    int shown = 0;
+    for (size_t c = 0; c < view->count; c++) {
+        const container_t *ct = &sorted[c];
+        if (!include_host && ct->runtime == CONTAINER_RUNTIME_HOST) {
+            continue;
+        }
+
+        char cg_cpu[16] = "N/A", cg_mem[16] = "N/A";
+        if (ct->has_cgroup && ct->cgroup.has_cpu && view->refreshes > 1) {
+            snprintf(cg_cpu, sizeof(cg_cpu), "%.1f", ct->cgroup_cpu_percent);
+        }
+        if (ct->has_cgroup && ct->cgroup.has_memory) {
+            snprintf(cg_mem, sizeof(cg_mem), "%.1f", ct->cgroup.memory.current / (1024.0 * 1024.0));
+        }
+
+        printf("%-10s %-14.14s %6d %8.1f %8s %10.1f %10s %10.1f %10.1f\n",
+               container_runtime_to_string(ct->runtime), ct->id, ct->process_count,
+               ct->cpu_percent, cg_cpu, ct->usage.rss_bytes / (1024.0 * 1024.0), cg_mem,
+               ct->read_rate / 1024.0, ct->write_rate / 1024.0);
+        shown++;
+    }
+
+    printf("──────────────────────────────────────────────────────────────────────────────────────────────\n");
+    printf("Groups: %d shown / %zu total | Processes indexed: %zu | Cgroup cache: %lu hits, %lu misses, "
+           "%lu PID resolves\n", shown, view->count, view->index.process_count, view->cache_hits,
+           view->cache_misses, view->pid_resolves);
+
+    free(sorted);
+}
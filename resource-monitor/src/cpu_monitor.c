@@ -1,4 +1,4 @@
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200112L
 
 #include "monitor.h"
 #include <stdio.h>
@@ -6,27 +6,25 @@
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <limits.h>
 #include <time.h>
 
-typedef struct {
-    uint64_t last_utime;
-    uint64_t last_stime;
-    uint64_t last_total_time;
-    struct timespec last_timestamp;
-    int initialized;
-} cpu_state_t;
-
-static cpu_state_t cpu_state = {0};
+// Estado do modo de alvo único (collect_cpu_metrics)
+static cpu_rate_state_t cpu_state = {0};
 
 int collect_cpu_metrics(pid_t pid, cpu_metrics_t *metrics) {
-    if (metrics == NULL) {
+    return collect_cpu_metrics_r(pid, metrics, &cpu_state);
+}
+
+int collect_cpu_metrics_r(pid_t pid, cpu_metrics_t *metrics, cpu_rate_state_t *rate) {
+    if (metrics == NULL || rate == NULL) {
         fprintf(stderr, "Error: metrics pointer is NULL\n");
         errno = EINVAL;
         return -1;
     }
 
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%d/stat", proc_root(), pid);
 
     FILE *fp = fopen(path, "r");
     if (fp == NULL) {
@@ -98,7 +96,21 @@ int collect_cpu_metrics(pid_t pid, cpu_metrics_t *metrics) {
     metrics->total_time = utime + stime;
     metrics->num_threads = (uint32_t)num_threads;
 
-    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    // utime/stime truncam para ticks: um processo que rodou menos de um tick
+    // aparece com zero. O relógio de CPU do processo (ns) diferencia "rodou
+    // pouco" de "não rodou"; a fração conta como um tick, o que mantém
+    // total_time monotônico quando stat passar a 1
+    if (metrics->total_time == 0 && strcmp(proc_root(), "/proc") == 0) {
+        clockid_t cpu_clock;
+        struct timespec cpu_used;
+        if (clock_getcpuclockid(pid, &cpu_clock) == 0 &&
+            clock_gettime(cpu_clock, &cpu_used) == 0 &&
+            (cpu_used.tv_sec > 0 || cpu_used.tv_nsec > 0)) {
+            metrics->total_time = 1;
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s/%d/status", proc_root(), pid);
     fp = fopen(path, "r");
     if (fp != NULL) {
         uint64_t voluntary_ctxt_switches = 0;
@@ -122,11 +134,12 @@ int collect_cpu_metrics(pid_t pid, cpu_metrics_t *metrics) {
     struct timespec current_time;
     clock_gettime(CLOCK_MONOTONIC, &current_time);
 
-    if (cpu_state.initialized) {
-        double elapsed_time = (current_time.tv_sec - cpu_state.last_timestamp.tv_sec) +
-                             (current_time.tv_nsec - cpu_state.last_timestamp.tv_nsec) / 1e9;
+    // O estado de collect_cpu_metrics é único: outro PID recomeça a taxa
+    if (rate->initialized && rate->pid == pid && metrics->total_time >= rate->last_total_time) {
+        double elapsed_time = (current_time.tv_sec - rate->last_timestamp.tv_sec) +
+                             (current_time.tv_nsec - rate->last_timestamp.tv_nsec) / 1e9;
 
-        uint64_t delta_time = metrics->total_time - cpu_state.last_total_time;
+        uint64_t delta_time = metrics->total_time - rate->last_total_time;
         double delta_seconds = (double)delta_time / ticks_per_sec;
 
         if (elapsed_time > 0) {
@@ -138,11 +151,10 @@ int collect_cpu_metrics(pid_t pid, cpu_metrics_t *metrics) {
         metrics->cpu_percent = 0.0;
     }
 
-    cpu_state.last_utime = metrics->user_time;
-    cpu_state.last_stime = metrics->system_time;
-    cpu_state.last_total_time = metrics->total_time;
-    cpu_state.last_timestamp = current_time;
-    cpu_state.initialized = 1;
+    rate->pid = pid;
+    rate->last_total_time = metrics->total_time;
+    rate->last_timestamp = current_time;
+    rate->initialized = 1;
 
     return 0;
 }
@@ -0,0 +1,243 @@
+#define _GNU_SOURCE
+#include "event_loop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+
+int event_loop_init(event_loop_t *loop) {
+    memset(loop, 0, sizeof(*loop));
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    return loop->epoll_fd >= 0 ? 0 : -1;
+}
+
+static void collect_garbage(event_loop_t *loop) {
+    while (loop->garbage != NULL) {
+        event_source_t *source = loop->garbage;
+        loop->garbage = source->next_garbage;
+        free(source);
+    }
+}
+
+void event_loop_free(event_loop_t *loop) {
+    if (loop == NULL || loop->epoll_fd < 0) {
+        return;
+    }
+    collect_garbage(loop);
+    close(loop->epoll_fd);
+    loop->epoll_fd = -1;
+}
+
+/**
+ * Registra fd no epoll; em erro fecha fd se a fonte seria dona dele
+ */
+static event_source_t* add_source(event_loop_t *loop, event_source_kind_t kind, int fd,
+                                  uint32_t events, int owns_fd,
+                                  event_callback_t callback, void *data) {
+    if (fd < 0) {
+        return NULL;
+    }
+
+    event_source_t *source = calloc(1, sizeof(*source));
+    if (source == NULL) {
+        if (owns_fd) close(fd);
+        return NULL;
+    }
+    source->loop = loop;
+    source->kind = kind;
+    source->fd = fd;
+    source->owns_fd = owns_fd;
+    source->callback = callback;
+    source->data = data;
+
+    struct epoll_event ev = { .events = events, .data.ptr = source };
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        int saved = errno;
+        if (owns_fd) close(fd);
+        free(source);
+        errno = saved;
+        return NULL;
+    }
+    loop->source_count++;
+    return source;
+}
+
+event_source_t* event_loop_add_fd(event_loop_t *loop, int fd, uint32_t events, int owns_fd,
+                                  event_callback_t callback, void *data) {
+    return add_source(loop, EVENT_SOURCE_FD, fd, events, owns_fd, callback, data);
+}
+
+int event_loop_set_timer(event_source_t *timer, uint64_t first_ms, uint64_t interval_ms) {
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    // it_value zero desarmaria o timer; 1 ns dispara imediatamente
+    uint64_t first_ns = first_ms ? first_ms * 1000000ULL : 1;
+    spec.it_value.tv_sec = (time_t)(first_ns / 1000000000ULL);
+    spec.it_value.tv_nsec = (long)(first_ns % 1000000000ULL);
+    spec.it_interval.tv_sec = (time_t)(interval_ms / 1000);
+    spec.it_interval.tv_nsec = (long)(interval_ms % 1000) * 1000000L;
+    return timerfd_settime(timer->fd, 0, &spec, NULL);
+}
+
+event_source_t* event_loop_add_timer(event_loop_t *loop, uint64_t first_ms, uint64_t interval_ms,
+                                     event_callback_t callback, void *data) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    event_source_t *source = add_source(loop, EVENT_SOURCE_TIMER, fd, EPOLLIN, 1, callback, data);
+    if (source != NULL && event_loop_set_timer(source, first_ms, interval_ms) != 0) {
+        event_loop_remove(source);
+        return NULL;
+    }
+    return source;
+}
+
+event_source_t* event_loop_add_pidfd(event_loop_t *loop, pid_t pid,
+                                     event_callback_t callback, void *data) {
+#ifdef SYS_pidfd_open
+    int fd = (int)syscall(SYS_pidfd_open, pid, 0);
+    return add_source(loop, EVENT_SOURCE_PIDFD, fd, EPOLLIN, 1, callback, data);
+#else
+    (void)loop; (void)pid; (void)callback; (void)data;
+    errno = ENOSYS;
+    return NULL;
+#endif
+}
+
+event_source_t* event_loop_add_psi(event_loop_t *loop, const char *pressure_file, int full,
+                                   uint64_t stall_us, uint64_t window_us,
+                                   event_callback_t callback, void *data) {
+    int fd = open(pressure_file, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    // O gatilho vale enquanto o descritor estiver aberto
+    char trigger[64];
+    int len = snprintf(trigger, sizeof(trigger), "%s %lu %lu",
+                       full ? "full" : "some", stall_us, window_us);
+    if (write(fd, trigger, (size_t)len + 1) < 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return NULL;
+    }
+    return add_source(loop, EVENT_SOURCE_PSI, fd, EPOLLPRI, 1, callback, data);
+}
+
+event_source_t* event_loop_add_inotify(event_loop_t *loop, const char *path, uint32_t mask,
+                                       event_callback_t callback, void *data) {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (inotify_add_watch(fd, path, mask) < 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return NULL;
+    }
+    return add_source(loop, EVENT_SOURCE_INOTIFY, fd, EPOLLIN, 1, callback, data);
+}
+
+int event_loop_modify(event_source_t *source, uint32_t events) {
+    if (source == NULL || source->removed) {
+        errno = EINVAL;
+        return -1;
+    }
+    struct epoll_event ev = { .events = events, .data.ptr = source };
+    return epoll_ctl(source->loop->epoll_fd, EPOLL_CTL_MOD, source->fd, &ev);
+}
+
+void event_loop_remove(event_source_t *source) {
+    if (source == NULL || source->removed) {
+        return;
+    }
+    event_loop_t *loop = source->loop;
+
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+    if (source->owns_fd) {
+        close(source->fd);
+    }
+    source->fd = -1;
+    source->removed = 1;
+    source->next_garbage = loop->garbage;
+    loop->garbage = source;
+    loop->source_count--;
+}
+
+/**
+ * Consome o estado do descritor antes do callback, para que um callback
+ * que não leia nada não faça o epoll disparar de novo
+ */
+static void drain(event_source_t *source) {
+    switch (source->kind) {
+        case EVENT_SOURCE_TIMER: {
+            uint64_t expirations = 0;
+            source->expirations = read(source->fd, &expirations, sizeof(expirations)) ==
+                                  (ssize_t)sizeof(expirations) ? expirations : 0;
+            break;
+        }
+        case EVENT_SOURCE_INOTIFY: {
+            _Alignas(struct inotify_event) char buffer[4096];
+            while (read(source->fd, buffer, sizeof(buffer)) > 0) {
+                // Só interessa que o arquivo mudou
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int event_loop_run_once(event_loop_t *loop, int timeout_ms) {
+    struct epoll_event events[EVENT_LOOP_MAX_BATCH];
+
+    int n = epoll_wait(loop->epoll_fd, events, EVENT_LOOP_MAX_BATCH, timeout_ms);
+    if (n <= 0) {
+        return n;
+    }
+    loop->wakeups++;
+
+    for (int i = 0; i < n; i++) {
+        event_source_t *source = events[i].data.ptr;
+        if (source->removed) {
+            continue;           // Removida por um callback anterior do lote
+        }
+        drain(source);
+        if (source->kind == EVENT_SOURCE_TIMER && source->expirations == 0) {
+            continue;           // Reprogramado depois de disparar
+        }
+        source->callback(source, events[i].events, source->data);
+        loop->dispatched++;
+    }
+
+    collect_garbage(loop);
+    if (loop->batch_hook != NULL) {
+        loop->batch_hook(loop, loop->batch_data);
+    }
+    return n;
+}
+
+int event_loop_run(event_loop_t *loop, volatile int *keep_running) {
+    loop->stop = 0;
+    while (!loop->stop && (keep_running == NULL || *keep_running)) {
+        if (event_loop_run_once(loop, -1) < 0 && errno != EINTR) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void event_loop_stop(event_loop_t *loop) {
+    loop->stop = 1;
+}
+
+void event_loop_set_batch_hook(event_loop_t *loop, event_batch_hook_t hook, void *data) {
+    loop->batch_hook = hook;
+    loop->batch_data = data;
+}
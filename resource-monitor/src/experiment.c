@@ -0,0 +1,782 @@
+#define _GNU_SOURCE
+#include "experiment.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <math.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/sysmacros.h>
+#include <sys/resource.h>
+
+static const char *metric_names[EXP_METRIC_COUNT] = {
+    "wall_sec", "cpu_sec", "user_sec", "sys_sec", "cpu_percent",
+    "throttled_pct", "throttled_sec", "peak_mb", "maxrss_mb",
+    "read_mb", "write_mb", "read_mbps", "write_mbps", "monitor_cpu_sec"
+};
+
+const char* experiment_metric_name(experiment_metric_t metric) {
+    if (metric < 0 || metric >= EXP_METRIC_COUNT) {
+        return "unknown";
+    }
+    return metric_names[metric];
+}
+
+// ============================================================================
+// Estatística
+// ============================================================================
+
+/**
+ * Com t = sqrt(df) tan(θ) a densidade de t vira c cos^(df-1)(θ) em [0, π/2),
+ * suave o bastante para Simpson; a CDF é 1/2 + essa integral de 0 a θ
+ */
+static double t_cdf_theta(double theta, int df) {
+    const int steps = 400;
+    double c = exp(lgamma((df + 1) / 2.0) - lgamma(df / 2.0)) / sqrt(M_PI);
+    double h = theta / steps;
+    double sum = 1.0 + pow(cos(theta), df - 1);
+    for (int i = 1; i < steps; i++) {
+        sum += (i % 2 ? 4.0 : 2.0) * pow(cos(i * h), df - 1);
+    }
+    return 0.5 + c * sum * h / 3.0;
+}
+
+double student_t_quantile(double p, int df) {
+    if (df < 1 || p <= 0.5 || p >= 1.0) {
+        return df < 1 || p >= 1.0 ? INFINITY : 0.0;
+    }
+    double lo = 0.0, hi = M_PI / 2;
+    for (int i = 0; i < 60; i++) {
+        double mid = (lo + hi) / 2;
+        if (t_cdf_theta(mid, df) < p) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return sqrt((double)df) * tan((lo + hi) / 2);
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void summarize_samples(const double *values, int count, double confidence, sample_summary_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->mean = out->stddev = out->ci_low = out->ci_high = NAN;
+    out->min = out->median = out->max = NAN;
+
+    double *sorted = count > 0 ? malloc((size_t)count * sizeof(double)) : NULL;
+    if (sorted == NULL) {
+        return;
+    }
+    int n = 0;
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        if (isfinite(values[i])) {
+            sorted[n++] = values[i];
+            sum += values[i];
+        }
+    }
+    if (n == 0) {
+        free(sorted);
+        return;
+    }
+    qsort(sorted, (size_t)n, sizeof(double), compare_double);
+
+    out->n = n;
+    out->mean = sum / n;
+    out->min = sorted[0];
+    out->max = sorted[n - 1];
+    out->median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+    double ss = 0.0;
+    for (int i = 0; i < n; i++) {
+        ss += (sorted[i] - out->mean) * (sorted[i] - out->mean);
+    }
+    out->stddev = n > 1 ? sqrt(ss / (n - 1)) : 0.0;
+
+    double half = 0.0;
+    if (n > 1) {
+        double p = 0.5 + confidence / 200.0;
+        half = student_t_quantile(p, n - 1) * out->stddev / sqrt((double)n);
+    }
+    out->ci_low = out->mean - half;
+    out->ci_high = out->mean + half;
+    free(sorted);
+}
+
+// ============================================================================
+// Especificação
+// ============================================================================
+
+/**
+ * Dispositivo de bloco (disco inteiro: os limites de blkio/io.max não
+ * aceitam partições) do sistema de arquivos que contém path
+ */
+static int resolve_block_device(const char *path, char *out, size_t size) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return -1;
+    }
+    unsigned int major_id = major(st.st_dev), minor_id = minor(st.st_dev);
+
+    char sys_path[PATH_MAX];
+    snprintf(sys_path, sizeof(sys_path), "/sys/dev/block/%u:%u", major_id, minor_id);
+    if (access(sys_path, F_OK) != 0) {
+        errno = ENOTBLK;
+        return -1;
+    }
+    snprintf(sys_path, sizeof(sys_path), "/sys/dev/block/%u:%u/partition", major_id, minor_id);
+    if (access(sys_path, F_OK) == 0) {
+        snprintf(sys_path, sizeof(sys_path), "/sys/dev/block/%u:%u/../dev", major_id, minor_id);
+        FILE *fp = fopen(sys_path, "r");
+        if (fp != NULL) {
+            if (fscanf(fp, "%u:%u", &major_id, &minor_id) != 2) {
+                major_id = major(st.st_dev);
+                minor_id = minor(st.st_dev);
+            }
+            fclose(fp);
+        }
+    }
+    snprintf(out, size, "%u:%u", major_id, minor_id);
+    return 0;
+}
+
+static int parse_set_line(char *args, experiment_spec_t *spec, const char *path, int lineno) {
+    for (char *token = strtok(args, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n")) {
+        char *value = strchr(token, '=');
+        if (value == NULL) {
+            fprintf(stderr, "%s:%d: expected key=value, got '%s'\n", path, lineno, token);
+            return -1;
+        }
+        *value++ = '\0';
+        if (strcmp(token, "repetitions") == 0) {
+            spec->repetitions = atoi(value);
+        } else if (strcmp(token, "warmup") == 0) {
+            spec->warmup = atoi(value);
+        } else if (strcmp(token, "confidence") == 0) {
+            spec->confidence = atof(value);
+        } else if (strcmp(token, "timeout") == 0) {
+            spec->timeout_sec = atoi(value);
+        } else if (strcmp(token, "cpus") == 0) {
+            strncpy(spec->cpus, value, sizeof(spec->cpus) - 1);
+        } else {
+            fprintf(stderr, "%s:%d: unknown setting '%s'\n", path, lineno, token);
+            return -1;
+        }
+    }
+    if (spec->repetitions < 1 || spec->repetitions > EXPERIMENT_MAX_REPETITIONS ||
+        spec->warmup < 0 || spec->confidence <= 0 || spec->confidence >= 100 ||
+        spec->timeout_sec < 0) {
+        fprintf(stderr, "%s:%d: invalid setting (repetitions 1..%d, warmup >= 0, "
+                "0 < confidence < 100, timeout >= 0)\n", path, lineno, EXPERIMENT_MAX_REPETITIONS);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Interpreta uma condição: retira monitor= e resolve io=@caminho antes de
+ * repassar a linha, já na gramática do manifesto, a parse_workload_line
+ */
+static int parse_condition_line(char *line, experiment_condition_t *cond,
+                                const char *path, int lineno) {
+    // As opções vão até o "--"; o comando (com aspas) segue intacto
+    char *command = NULL;
+    for (char *p = strstr(line, "--"); p != NULL; p = strstr(p + 2, "--")) {
+        if ((p == line || p[-1] == ' ' || p[-1] == '\t') &&
+            (p[2] == '\0' || p[2] == ' ' || p[2] == '\t' || p[2] == '\r' || p[2] == '\n')) {
+            command = p;
+            break;
+        }
+    }
+
+    char rewritten[2048] = "";
+    size_t used = 0;
+    cond->monitor_interval = 0;
+    if (command != NULL) {
+        char *rest = command + 2;
+        *command = '\0';
+        for (char *token = strtok(line, " \t"); token != NULL; token = strtok(NULL, " \t")) {
+            char option[128];
+            if (strncmp(token, "monitor=", 8) == 0) {
+                cond->monitor_interval = atoi(token + 8);
+                if (cond->monitor_interval <= 0) {
+                    fprintf(stderr, "%s:%d: monitor interval must be a positive number of seconds\n",
+                            path, lineno);
+                    return -1;
+                }
+                continue;
+            }
+            if (strncmp(token, "io=@", 4) == 0) {
+                char *rates = strchr(token + 4, ':');
+                char device[32];
+                if (rates == NULL) {
+                    fprintf(stderr, "%s:%d: invalid io limit '%s' (expected @path:rbps:wbps)\n",
+                            path, lineno, token + 3);
+                    return -1;
+                }
+                *rates++ = '\0';
+                if (resolve_block_device(token + 4, device, sizeof(device)) != 0) {
+                    fprintf(stderr, "%s:%d: no block device for '%s': %s\n",
+                            path, lineno, token + 4, strerror(errno));
+                    return -1;
+                }
+                snprintf(option, sizeof(option), "io=%s:%s", device, rates);
+                token = option;
+            }
+            used += (size_t)snprintf(rewritten + used, sizeof(rewritten) - used, "%s ", token);
+            if (used >= sizeof(rewritten)) {
+                fprintf(stderr, "%s:%d: line too long\n", path, lineno);
+                return -1;
+            }
+        }
+        snprintf(rewritten + used, sizeof(rewritten) - used, "--%s", rest);
+    } else {
+        // Sem "--": parse_workload_line reporta o erro
+        strncpy(rewritten, line, sizeof(rewritten) - 1);
+    }
+
+    return parse_workload_line(rewritten, &cond->workload, path, lineno);
+}
+
+int load_experiment_spec(const char *path, experiment_spec_t *spec) {
+    if (path == NULL || spec == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error opening experiment %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    memset(spec, 0, sizeof(*spec));
+    strncpy(spec->path, path, sizeof(spec->path) - 1);
+    spec->repetitions = 5;
+    spec->warmup = 1;
+    spec->confidence = 95.0;
+
+    char line[2048];
+    int lineno = 0;
+    int ret = 0;
+
+    while (ret == 0 && fgets(line, sizeof(line), fp) != NULL) {
+        lineno++;
+        // '#' fora do comando ainda não foi removido em "set"
+        char keyword[16] = "";
+        if (sscanf(line, "%15s", keyword) != 1 || keyword[0] == '#') {
+            continue;
+        }
+
+        if (strcmp(keyword, "set") == 0) {
+            char *comment = strchr(line, '#');
+            if (comment != NULL) {
+                *comment = '\0';
+            }
+            ret = parse_set_line(strstr(line, "set") + 3, spec, path, lineno);
+        } else if (strcmp(keyword, "setup") == 0 || strcmp(keyword, "teardown") == 0) {
+            workload_t *w = keyword[0] == 's' ? &spec->setup : &spec->teardown;
+            if (parse_workload_line(line, w, path, lineno) < 0) {
+                ret = -1;
+            }
+        } else if (spec->condition_count >= MAX_WORKLOADS) {
+            fprintf(stderr, "%s:%d: too many conditions (max %d)\n", path, lineno, MAX_WORKLOADS);
+            ret = -1;
+        } else {
+            experiment_condition_t *cond = &spec->conditions[spec->condition_count];
+            int parsed = parse_condition_line(line, cond, path, lineno);
+            if (parsed < 0) {
+                ret = -1;
+            }
+            spec->condition_count += parsed > 0;
+        }
+    }
+    fclose(fp);
+
+    if (ret == 0 && spec->condition_count == 0) {
+        fprintf(stderr, "%s: no conditions defined\n", path);
+        ret = -1;
+    }
+    for (int i = 0; ret == 0 && i < spec->condition_count; i++) {
+        workload_t *w = &spec->conditions[i].workload;
+        for (int j = 0; j < i; j++) {
+            if (strcmp(spec->conditions[j].workload.name, w->name) == 0) {
+                fprintf(stderr, "%s: duplicate condition '%s'\n", path, w->name);
+                ret = -1;
+            }
+        }
+        if (w->cpus[0] == '\0') {
+            strncpy(w->cpus, spec->cpus, sizeof(w->cpus) - 1);
+        }
+    }
+    return ret;
+}
+
+void free_experiment_spec(experiment_spec_t *spec) {
+    if (spec == NULL) {
+        return;
+    }
+    for (int i = 0; i < spec->condition_count; i++) {
+        free(spec->conditions[i].trials);
+        spec->conditions[i].trials = NULL;
+        spec->conditions[i].trial_count = 0;
+    }
+}
+
+// ============================================================================
+// Execução
+// ============================================================================
+
+static double timespec_diff(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static double timeval_sec(const struct timeval *tv) {
+    return tv->tv_sec + tv->tv_usec / 1e6;
+}
+
+static int exit_code_of(int status) {
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    return WIFSIGNALED(status) ? 128 + WTERMSIG(status) : -1;
+}
+
+/**
+ * Roda setup/teardown fora de cgroups, com a saída descartada
+ */
+static int run_hook(const workload_t *hook, const char *label) {
+    if (hook->argv[0] == NULL) {
+        return 0;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            dup2(devnull, STDOUT_FILENO);
+            close(devnull);
+        }
+        execvp(hook->argv[0], hook->argv);
+        _exit(127);
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (exit_code_of(status) != 0) {
+        fprintf(stderr, "Error: %s '%s' exited with %d\n", label, hook->argv[0], exit_code_of(status));
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Acompanha a carga com o próprio monitor (saída descartada)
+ */
+static pid_t start_monitor(const char *monitor_bin, int interval, pid_t target) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    int devnull = open("/dev/null", O_RDWR);
+    if (devnull >= 0) {
+        dup2(devnull, STDIN_FILENO);
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(devnull);
+    }
+    char interval_arg[16], pid_arg[16];
+    snprintf(interval_arg, sizeof(interval_arg), "%d", interval);
+    snprintf(pid_arg, sizeof(pid_arg), "%d", (int)target);
+    execl(monitor_bin, monitor_bin, "-q", "-i", interval_arg, pid_arg, (char *)NULL);
+    _exit(127);
+}
+
+static void fill_trial(const workload_t *w, experiment_trial_t *trial) {
+    const cgroup_metrics_t *m = &w->final_metrics;
+    double *v = trial->values;
+    const double mib = 1024.0 * 1024.0;
+    double wall = w->elapsed_sec;
+
+    v[EXP_METRIC_WALL] = wall;
+    v[EXP_METRIC_USER] = timeval_sec(&w->rusage.ru_utime);
+    v[EXP_METRIC_SYS] = timeval_sec(&w->rusage.ru_stime);
+    v[EXP_METRIC_MAXRSS_MB] = w->rusage.ru_maxrss / 1024.0;
+    if (m->has_cpu) {
+        v[EXP_METRIC_CPU] = m->cpu.usage_usec / 1e6;
+        v[EXP_METRIC_CPU_PERCENT] = wall > 0 ? v[EXP_METRIC_CPU] * 100.0 / wall : NAN;
+        v[EXP_METRIC_THROTTLED_PCT] = m->cpu.nr_periods > 0
+                                          ? m->cpu.nr_throttled * 100.0 / m->cpu.nr_periods : 0.0;
+        v[EXP_METRIC_THROTTLED_SEC] = m->cpu.throttled_usec / 1e6;
+    }
+    if (m->has_memory) {
+        v[EXP_METRIC_PEAK_MB] = w->peak_memory / mib;
+    }
+    if (m->has_blkio) {
+        v[EXP_METRIC_READ_MB] = m->blkio.rbytes / mib;
+        v[EXP_METRIC_WRITE_MB] = m->blkio.wbytes / mib;
+        v[EXP_METRIC_READ_MBPS] = wall > 0 ? v[EXP_METRIC_READ_MB] / wall : NAN;
+        v[EXP_METRIC_WRITE_MBPS] = wall > 0 ? v[EXP_METRIC_WRITE_MB] / wall : NAN;
+    }
+}
+
+/**
+ * Uma tentativa: cgroup novo, lançamento, espera pelo pidfd, métricas finais
+ * @return 0 se a carga rodou (qualquer código de saída), -1 se não lançou
+ */
+static int run_trial(const experiment_spec_t *spec, const experiment_condition_t *cond,
+                     int version, const char *monitor_bin, experiment_trial_t *trial,
+                     volatile int *keep_running) {
+    workload_t w = cond->workload;
+    w.pid = 0;
+    w.pidfd = -1;
+    w.exited = 0;
+    w.status = 0;
+    w.peak_memory = 0;
+    w.elapsed_sec = 0;
+    memset(&w.rusage, 0, sizeof(w.rusage));
+    memset(&w.final_metrics, 0, sizeof(w.final_metrics));
+
+    for (int i = 0; i < EXP_METRIC_COUNT; i++) {
+        trial->values[i] = NAN;
+    }
+    trial->exit_code = -1;
+
+    if (setup_workload_cgroup(&w, version) != 0) {
+        return -1;
+    }
+
+    // A saída da carga não faz parte do resultado
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int launched = launch_workload(&w, version);
+    if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+    }
+    if (launched != 0) {
+        cleanup_workload_cgroup(&w, version);
+        return -1;
+    }
+
+    pid_t monitor_pid = -1;
+    if (cond->monitor_interval > 0 && monitor_bin != NULL) {
+        monitor_pid = start_monitor(monitor_bin, cond->monitor_interval, w.pid);
+    }
+
+    while (!reap_workload(&w, version, &start, 0)) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int expired = spec->timeout_sec > 0 && timespec_diff(&start, &now) >= spec->timeout_sec;
+        if (expired || (keep_running != NULL && !*keep_running)) {
+            kill(w.pid, SIGKILL);
+            reap_workload(&w, version, &start, 1);
+            break;
+        }
+        // Sem pidfd, verificar por wait4 periodicamente
+        struct pollfd pfd = { .fd = w.pidfd, .events = POLLIN };
+        poll(&pfd, w.pidfd >= 0 ? 1 : 0, 200);
+    }
+
+    if (monitor_pid > 0) {
+        struct rusage usage;
+        int status;
+        kill(monitor_pid, SIGINT);
+        if (wait4(monitor_pid, &status, 0, &usage) == monitor_pid) {
+            trial->values[EXP_METRIC_MONITOR_CPU] = timeval_sec(&usage.ru_utime) +
+                                                    timeval_sec(&usage.ru_stime);
+        }
+    }
+
+    fill_trial(&w, trial);
+    trial->exit_code = exit_code_of(w.status);
+    cleanup_workload_cgroup(&w, version);
+    return 0;
+}
+
+int run_experiment(experiment_spec_t *spec, const char *monitor_bin, int quiet,
+                   volatile int *keep_running) {
+    if (spec == NULL || spec->condition_count <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (geteuid() != 0) {
+        fprintf(stderr, "Error: Experiments require root privileges (sudo).\n");
+        return -1;
+    }
+    int version = detect_cgroup_version();
+    if (version < 0) {
+        fprintf(stderr, "Error: Could not detect cgroup version.\n");
+        return -1;
+    }
+
+    for (int i = 0; i < spec->condition_count; i++) {
+        experiment_condition_t *cond = &spec->conditions[i];
+        free(cond->trials);
+        cond->trials = calloc((size_t)spec->repetitions, sizeof(experiment_trial_t));
+        cond->trial_count = 0;
+        cond->failures = 0;
+        if (cond->trials == NULL) {
+            perror("calloc");
+            return -1;
+        }
+    }
+
+    if (run_hook(&spec->setup, "setup") != 0) {
+        return -1;
+    }
+
+    int ret = 0;
+    int rounds = spec->warmup + spec->repetitions;
+    for (int round = 0; round < rounds && ret == 0; round++) {
+        int warmup = round < spec->warmup;
+        for (int i = 0; i < spec->condition_count; i++) {
+            if (keep_running != NULL && !*keep_running) {
+                ret = -1;
+                break;
+            }
+            experiment_condition_t *cond = &spec->conditions[i];
+            experiment_trial_t trial;
+            if (run_trial(spec, cond, version, monitor_bin, &trial, keep_running) != 0) {
+                ret = -1;
+                break;
+            }
+            if (keep_running != NULL && !*keep_running) {
+                ret = -1; // tentativa interrompida: descartada
+                break;
+            }
+            if (!quiet) {
+                if (warmup) {
+                    printf("[warmup %d/%d] %-16s", round + 1, spec->warmup, cond->workload.name);
+                } else {
+                    printf("[%d/%d] %-16s", round - spec->warmup + 1, spec->repetitions,
+                           cond->workload.name);
+                }
+                printf(" %8.3fs  CPU %8.3fs  exit %d\n", trial.values[EXP_METRIC_WALL],
+                       trial.values[EXP_METRIC_CPU], trial.exit_code);
+                fflush(stdout);
+            }
+            if (!warmup) {
+                cond->trials[cond->trial_count++] = trial;
+                cond->failures += trial.exit_code != 0;
+            }
+        }
+    }
+
+    run_hook(&spec->teardown, "teardown");
+
+    // Resume também o que foi coletado antes de uma interrupção
+    double *values = malloc((size_t)spec->repetitions * sizeof(double));
+    if (values == NULL) {
+        perror("malloc");
+        return -1;
+    }
+    for (int i = 0; i < spec->condition_count; i++) {
+        experiment_condition_t *cond = &spec->conditions[i];
+        for (int metric = 0; metric < EXP_METRIC_COUNT; metric++) {
+            for (int t = 0; t < cond->trial_count; t++) {
+                values[t] = cond->trials[t].values[metric];
+            }
+            summarize_samples(values, cond->trial_count, spec->confidence, &cond->summary[metric]);
+        }
+    }
+    free(values);
+    return ret;
+}
+
+// ============================================================================
+// Relatório
+// ============================================================================
+
+void print_experiment_summary(const experiment_spec_t *spec) {
+    printf("\n=== Experiment %s: %d repetitions, %d warmup, %.0f%% CI ===\n",
+           spec->path, spec->repetitions, spec->warmup, spec->confidence);
+
+    const sample_summary_t *baseline = &spec->conditions[0].summary[EXP_METRIC_WALL];
+    for (int i = 0; i < spec->condition_count; i++) {
+        const experiment_condition_t *cond = &spec->conditions[i];
+        const workload_t *w = &cond->workload;
+
+        printf("\n%s (", w->name);
+        if (w->cpu_limit > 0) printf("cpu=%.2f ", w->cpu_limit);
+        if (w->mem_limit_mb > 0) printf("mem=%lluMB ", (unsigned long long)w->mem_limit_mb);
+        if (w->io_device[0] != '\0') printf("io=%s ", w->io_device);
+        if (w->cpus[0] != '\0') printf("cpus=%s ", w->cpus);
+        if (cond->monitor_interval > 0) printf("monitor=%ds ", cond->monitor_interval);
+        printf("n=%d, failures=%d)\n", cond->trial_count, cond->failures);
+
+        printf("  %-16s %12s %10s %10s %10s %10s %10s\n",
+               "metric", "mean", "± ci", "stddev", "min", "median", "max");
+        for (int metric = 0; metric < EXP_METRIC_COUNT; metric++) {
+            const sample_summary_t *s = &cond->summary[metric];
+            if (s->n == 0) {
+                continue;
+            }
+            printf("  %-16s %12.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+                   metric_names[metric], s->mean, s->ci_high - s->mean, s->stddev,
+                   s->min, s->median, s->max);
+        }
+        const sample_summary_t *wall = &cond->summary[EXP_METRIC_WALL];
+        if (i > 0 && wall->n > 0 && baseline->n > 0 && baseline->mean > 0) {
+            printf("  wall vs %s: %+.2f%%\n", spec->conditions[0].workload.name,
+                   (wall->mean - baseline->mean) * 100.0 / baseline->mean);
+        }
+    }
+}
+
+static void json_string(FILE *fp, const char *s) {
+    fputc('"', fp);
+    for (; *s != '\0'; s++) {
+        if (*s == '"' || *s == '\\') {
+            fprintf(fp, "\\%c", *s);
+        } else if ((unsigned char)*s < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char)*s);
+        } else {
+            fputc(*s, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+static void json_number(FILE *fp, double value) {
+    if (isfinite(value)) {
+        fprintf(fp, "%.6f", value);
+    } else {
+        fputs("null", fp);
+    }
+}
+
+static void format_command(const workload_t *w, char *out, size_t size) {
+    size_t used = 0;
+    out[0] = '\0';
+    for (int i = 0; w->argv[i] != NULL && used < size; i++) {
+        used += (size_t)snprintf(out + used, size - used, "%s%s", i > 0 ? " " : "", w->argv[i]);
+    }
+}
+
+static void write_results_csv(const experiment_spec_t *spec, FILE *fp) {
+    fprintf(fp, "condition,metric,n,mean,stddev,ci_low,ci_high,min,median,max,"
+                "confidence,failures,cpu_limit,mem_limit_mb,cpus,monitor\n");
+    for (int i = 0; i < spec->condition_count; i++) {
+        const experiment_condition_t *cond = &spec->conditions[i];
+        const workload_t *w = &cond->workload;
+        for (int metric = 0; metric < EXP_METRIC_COUNT; metric++) {
+            const sample_summary_t *s = &cond->summary[metric];
+            if (s->n == 0) {
+                continue;
+            }
+            fprintf(fp, "%s,%s,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.1f,%d,%.2f,%llu,%s,%d\n",
+                    w->name, metric_names[metric], s->n, s->mean, s->stddev, s->ci_low,
+                    s->ci_high, s->min, s->median, s->max, spec->confidence, cond->failures,
+                    w->cpu_limit, (unsigned long long)w->mem_limit_mb, w->cpus,
+                    cond->monitor_interval);
+        }
+    }
+}
+
+static void write_results_json(const experiment_spec_t *spec, FILE *fp) {
+    fprintf(fp, "{\n  \"experiment\": ");
+    json_string(fp, spec->path);
+    fprintf(fp, ",\n  \"repetitions\": %d,\n  \"warmup\": %d,\n  \"confidence\": %.1f,\n"
+                "  \"conditions\": [",
+            spec->repetitions, spec->warmup, spec->confidence);
+
+    for (int i = 0; i < spec->condition_count; i++) {
+        const experiment_condition_t *cond = &spec->conditions[i];
+        const workload_t *w = &cond->workload;
+        char command[1024];
+        format_command(w, command, sizeof(command));
+
+        fprintf(fp, "%s\n    {\n      \"name\": ", i > 0 ? "," : "");
+        json_string(fp, w->name);
+        fprintf(fp, ",\n      \"command\": ");
+        json_string(fp, command);
+        fprintf(fp, ",\n      \"cpu_limit\": %.2f,\n      \"mem_limit_mb\": %llu,\n      \"cpus\": ",
+                w->cpu_limit, (unsigned long long)w->mem_limit_mb);
+        json_string(fp, w->cpus);
+        fprintf(fp, ",\n      \"io_device\": ");
+        json_string(fp, w->io_device);
+        fprintf(fp, ",\n      \"io_rbps\": %llu,\n      \"io_wbps\": %llu,\n"
+                    "      \"monitor_interval\": %d,\n      \"failures\": %d,\n      \"summary\": {",
+                (unsigned long long)w->io_rbps, (unsigned long long)w->io_wbps,
+                cond->monitor_interval, cond->failures);
+
+        int first = 1;
+        for (int metric = 0; metric < EXP_METRIC_COUNT; metric++) {
+            const sample_summary_t *s = &cond->summary[metric];
+            if (s->n == 0) {
+                continue;
+            }
+            fprintf(fp, "%s\n        \"%s\": {\"n\": %d, \"mean\": ", first ? "" : ",",
+                    metric_names[metric], s->n);
+            json_number(fp, s->mean);
+            const double rest[] = { s->stddev, s->ci_low, s->ci_high, s->min, s->median, s->max };
+            const char *keys[] = { "stddev", "ci_low", "ci_high", "min", "median", "max" };
+            for (int k = 0; k < 6; k++) {
+                fprintf(fp, ", \"%s\": ", keys[k]);
+                json_number(fp, rest[k]);
+            }
+            fputc('}', fp);
+            first = 0;
+        }
+
+        fprintf(fp, "\n      },\n      \"trials\": [");
+        for (int t = 0; t < cond->trial_count; t++) {
+            const experiment_trial_t *trial = &cond->trials[t];
+            fprintf(fp, "%s\n        {\"exit_code\": %d", t > 0 ? "," : "", trial->exit_code);
+            for (int metric = 0; metric < EXP_METRIC_COUNT; metric++) {
+                fprintf(fp, ", \"%s\": ", metric_names[metric]);
+                json_number(fp, trial->values[metric]);
+            }
+            fputc('}', fp);
+        }
+        fprintf(fp, "\n      ]\n    }");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+}
+
+int write_experiment_results(const experiment_spec_t *spec, const char *path, const char *format) {
+    if (spec == NULL || path == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    int json = format != NULL && strcmp(format, "json") == 0;
+    if (format != NULL && !json && strcmp(format, "csv") != 0) {
+        fprintf(stderr, "Error: experiment results are written as csv or json.\n");
+        errno = EINVAL;
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "Error opening %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (json) {
+        write_results_json(spec, fp);
+    } else {
+        write_results_csv(spec, fp);
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
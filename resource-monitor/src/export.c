@@ -1,159 +1,797 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include "monitor.h"
+#include "capture.h"
+#include "export_delta.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+// Maior registro formatado (JSON com todos os campos) com folga
+#define EXPORT_MAX_RECORD 2048
+#define EXPORT_DEFAULT_BUFFER (64 * 1024)
+
+static const char *csv_header =
+    "timestamp,pid,"
+    "cpu_user_time,cpu_system_time,cpu_total_time,cpu_percent,num_threads,context_switches,"
+    "mem_rss,mem_vsz,mem_swap,mem_page_faults,"
+    "io_bytes_read,io_bytes_written,io_syscalls_read,io_syscalls_write,io_read_rate,io_write_rate,interval_ms\n";
+
+// Escritores abertos, descarregados por export_writer_flush_all()
+static export_writer_t *open_writers = NULL;
+static int atexit_registered = 0;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
 /**
- * Exporta métricas para arquivo CSV
+ * Antes de um fork: descarrega stdio para que um filho que termine com
+ * exit() não imprima de novo a saída ainda pendente do pai
  */
-int export_metrics_csv(const char *filename,
-                       pid_t pid,
-                       const cpu_metrics_t *cpu,
-                       const memory_metrics_t *mem,
-                       const io_metrics_t *io) {
-    if (filename == NULL) {
+static void export_before_fork(void) {
+    fflush(NULL);
+}
+
+/**
+ * No filho: os escritores abertos são do pai, e o atexit do filho não deve
+ * gravar outra vez as linhas que o pai ainda tem no buffer
+ */
+static void export_in_child(void) {
+    open_writers = NULL;
+}
+
+/**
+ * write() completo, repetindo em escrita parcial ou EINTR
+ */
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+void export_writer_config_default(export_writer_config_t *config) {
+    if (config == NULL) {
+        return;
+    }
+    memset(config, 0, sizeof(*config));
+    config->format = EXPORT_FORMAT_CSV;
+    config->buffer_size = EXPORT_DEFAULT_BUFFER;
+    config->flush_interval_ms = 1000;
+    config->sync = EXPORT_SYNC_NONE;
+    config->keep_files = 5;
+    config->heartbeat_ms = 60000;
+}
+
+int export_format_from_string(const char *name, export_format_t *format) {
+    if (name == NULL || format == NULL) return -1;
+    if (strcmp(name, "csv") == 0) {
+        *format = EXPORT_FORMAT_CSV;
+    } else if (strcmp(name, "json") == 0) {
+        *format = EXPORT_FORMAT_JSON;
+    } else if (strcmp(name, "ndjson") == 0) {
+        *format = EXPORT_FORMAT_NDJSON;
+    } else if (strcmp(name, "binary") == 0) {
+        *format = EXPORT_FORMAT_BINARY;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int export_sync_from_string(const char *name, export_sync_t *sync) {
+    if (name == NULL || sync == NULL) return -1;
+    if (strcmp(name, "none") == 0) {
+        *sync = EXPORT_SYNC_NONE;
+    } else if (strcmp(name, "flush") == 0) {
+        *sync = EXPORT_SYNC_FLUSH;
+    } else if (strcmp(name, "close") == 0) {
+        *sync = EXPORT_SYNC_CLOSE;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Abre o arquivo atual em modo append e escreve o header se estiver vazio
+ */
+static int open_export_file(export_writer_t *writer) {
+    writer->fd = open(writer->path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (writer->fd < 0) {
+        fprintf(stderr, "Error opening %s: %s\n", writer->path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    writer->file_bytes = (fstat(writer->fd, &st) == 0) ? (uint64_t)st.st_size : 0;
+    writer->opened_ns = monotonic_ns();
+    if (writer->delta != NULL) {
+        export_delta_new_file(writer->delta);
+    }
+
+    if (writer->file_bytes == 0 && writer->config.format == EXPORT_FORMAT_CSV) {
+        size_t len = strlen(csv_header);
+        memcpy(writer->buffer + writer->length, csv_header, len);
+        writer->length += len;
+        writer->file_bytes += len;
+    } else if (writer->file_bytes == 0 && writer->config.format == EXPORT_FORMAT_BINARY) {
+        size_t len = capture_format_header((uint8_t *)writer->buffer + writer->length,
+                                           writer->config.buffer_size - writer->length);
+        writer->length += len;
+        writer->file_bytes += len;
+    }
+    return 0;
+}
+
+/**
+ * Acrescenta bytes já formatados; blocos maiores que o buffer vão direto
+ * para o arquivo
+ */
+static int writer_append(export_writer_t *writer, const void *data, size_t len) {
+    int ret = 0;
+
+    if (writer->config.buffer_size - writer->length < len) {
+        ret = export_writer_flush(writer);
+    }
+    if (len > writer->config.buffer_size) {
+        if (write_all(writer->fd, data, len) != 0) {
+            fprintf(stderr, "Error writing %s: %s\n", writer->path, strerror(errno));
+            return -1;
+        }
+        writer->bytes_written += len;
+    } else {
+        memcpy(writer->buffer + writer->length, data, len);
+        writer->length += len;
+    }
+    writer->file_bytes += len;
+    return ret;
+}
+
+static int capture_emit(void *ctx, const void *data, size_t len) {
+    return writer_append((export_writer_t *)ctx, data, len);
+}
+
+int export_writer_open(export_writer_t *writer, const char *path,
+                       const export_writer_config_t *config) {
+    if (writer == NULL || path == NULL) {
         fprintf(stderr, "Error: filename is NULL\n");
         errno = EINVAL;
         return -1;
     }
 
-    FILE *fp = fopen(filename, "a");
-    if (fp == NULL) {
-        fprintf(stderr, "Error opening %s: %s\n", filename, strerror(errno));
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = -1;
+    if (config != NULL) {
+        writer->config = *config;
+    } else {
+        export_writer_config_default(&writer->config);
+    }
+    if (writer->config.buffer_size < EXPORT_MAX_RECORD * 2) {
+        writer->config.buffer_size = EXPORT_MAX_RECORD * 2;
+    }
+    if (writer->config.keep_files < 1) {
+        writer->config.keep_files = 1;
+    }
+
+    if (strlen(path) >= sizeof(writer->path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(writer->path, path);
+
+    writer->buffer = malloc(writer->config.buffer_size);
+    if (writer->buffer == NULL) {
+        return -1;
+    }
+
+    if (writer->config.format == EXPORT_FORMAT_BINARY) {
+        writer->capture = malloc(sizeof(capture_encoder_t));
+        if (writer->capture == NULL ||
+            capture_encoder_init(writer->capture, 0, capture_emit, writer) != 0) {
+            free(writer->capture);
+            writer->capture = NULL;
+            free(writer->buffer);
+            writer->buffer = NULL;
+            return -1;
+        }
+    }
+
+    if (writer->config.change_only || writer->config.sparse) {
+        writer->delta = malloc(sizeof(export_delta_t));
+        if (writer->delta == NULL ||
+            export_delta_init(writer->delta, writer->config.change_only,
+                              writer->config.change_epsilon, writer->config.heartbeat_ms) != 0) {
+            free(writer->delta);
+            writer->delta = NULL;
+            free(writer->capture);
+            writer->capture = NULL;
+            free(writer->buffer);
+            writer->buffer = NULL;
+            return -1;
+        }
+    }
+
+    if (open_export_file(writer) != 0) {
+        if (writer->delta != NULL) {
+            export_delta_free(writer->delta);
+            free(writer->delta);
+            writer->delta = NULL;
+        }
+        if (writer->capture != NULL) {
+            capture_encoder_free(writer->capture);
+            free(writer->capture);
+            writer->capture = NULL;
+        }
+        free(writer->buffer);
+        writer->buffer = NULL;
+        return -1;
+    }
+    writer->last_flush_ns = writer->opened_ns;
+
+    writer->next = open_writers;
+    open_writers = writer;
+    if (!atexit_registered) {
+        atexit(export_writer_flush_all);
+        pthread_atfork(export_before_fork, NULL, export_in_child);
+        atexit_registered = 1;
+    }
+    return 0;
+}
+
+int export_writer_flush(export_writer_t *writer) {
+    if (writer == NULL || writer->fd < 0) {
+        errno = EBADF;
         return -1;
     }
 
-    // Verificar se arquivo está vazio (para escrever header)
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
+    writer->last_flush_ns = monotonic_ns();
+    if (writer->length == 0) {
+        return 0;
+    }
+
+    int ret = write_all(writer->fd, writer->buffer, writer->length);
+    if (ret == 0) {
+        writer->bytes_written += writer->length;
+        writer->flushes++;
+        if (writer->config.sync == EXPORT_SYNC_FLUSH) {
+            fdatasync(writer->fd);
+        }
+    } else {
+        fprintf(stderr, "Error writing %s: %s\n", writer->path, strerror(errno));
+    }
+    // Em erro o conteúdo é descartado para não repetir a mesma falha
+    writer->length = 0;
+    return ret;
+}
+
+/**
+ * Fecha o arquivo atual e desloca <arquivo>.N-1 -> <arquivo>.N ... <arquivo> -> <arquivo>.1
+ */
+static int rotate_export_file(export_writer_t *writer) {
+    // Blocos parciais pertencem ao arquivo que está sendo fechado
+    capture_encoder_seal(writer->capture);
+    export_writer_flush(writer);
+    if (writer->config.sync != EXPORT_SYNC_NONE) {
+        fdatasync(writer->fd);
+    }
+    close(writer->fd);
+    writer->fd = -1;
 
-    if (size == 0) {
-        // Escrever header
-        fprintf(fp, "timestamp,pid,");
-        fprintf(fp, "cpu_user_time,cpu_system_time,cpu_total_time,cpu_percent,num_threads,context_switches,");
-        fprintf(fp, "mem_rss,mem_vsz,mem_swap,mem_page_faults,");
-        fprintf(fp, "io_bytes_read,io_bytes_written,io_syscalls_read,io_syscalls_write,io_read_rate,io_write_rate\n");
+    char from[sizeof(writer->path) + 16];
+    char to[sizeof(writer->path) + 16];
+    for (int i = writer->config.keep_files - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "%s.%d", writer->path, i);
+        snprintf(to, sizeof(to), "%s.%d", writer->path, i + 1);
+        rename(from, to);
+    }
+    snprintf(to, sizeof(to), "%s.1", writer->path);
+    if (rename(writer->path, to) != 0) {
+        fprintf(stderr, "Error rotating %s: %s\n", writer->path, strerror(errno));
     }
 
-    // Obter timestamp
-    time_t now = time(NULL);
-    char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    writer->rotations++;
+    return open_export_file(writer);
+}
+
+/**
+ * Timestamp local da amostra; strftime só roda quando o segundo muda
+ */
+static const char* export_timestamp(export_writer_t *writer, uint64_t realtime_ns) {
+    time_t now = (time_t)(realtime_ns / 1000000000ULL);
+    if (now != writer->cached_second || writer->cached_timestamp[0] == '\0') {
+        struct tm tm_now;
+        localtime_r(&now, &tm_now);
+        strftime(writer->cached_timestamp, sizeof(writer->cached_timestamp),
+                 "%Y-%m-%d %H:%M:%S", &tm_now);
+        writer->cached_second = now;
+    }
+    return writer->cached_timestamp;
+}
 
-    // Escrever dados
-    fprintf(fp, "%s,%d,", timestamp, pid);
+static int format_csv_record(char *out, size_t size, const char *timestamp,
+                             const export_record_t *r) {
+    int len = snprintf(out, size, "%s,%d,", timestamp, r->pid);
 
     // CPU
-    if (cpu != NULL) {
-        fprintf(fp, "%lu,%lu,%lu,%.2f,%u,%lu,",
-                cpu->user_time, cpu->system_time, cpu->total_time,
-                cpu->cpu_percent, cpu->num_threads, cpu->context_switches);
+    if (r->flags & EXPORT_HAS_CPU) {
+        len += snprintf(out + len, size - len, "%lu,%lu,%lu,%.2f,%u,%lu,",
+                        r->cpu.user_time, r->cpu.system_time, r->cpu.total_time,
+                        r->cpu.cpu_percent, r->cpu.num_threads, r->cpu.context_switches);
     } else {
-        fprintf(fp, ",,,,,,");
+        len += snprintf(out + len, size - len, ",,,,,,");
     }
 
     // Memory
-    if (mem != NULL) {
-        fprintf(fp, "%lu,%lu,%lu,%lu,",
-                mem->rss, mem->vsz, mem->swap, mem->page_faults);
+    if (r->flags & EXPORT_HAS_MEM) {
+        len += snprintf(out + len, size - len, "%lu,%lu,%lu,%lu,",
+                        r->mem.rss, r->mem.vsz, r->mem.swap, r->mem.page_faults);
     } else {
-        fprintf(fp, ",,,,");
+        len += snprintf(out + len, size - len, ",,,,");
     }
 
     // I/O
-    if (io != NULL) {
-        fprintf(fp, "%lu,%lu,%lu,%lu,%.2f,%.2f",
-                io->bytes_read, io->bytes_written,
-                io->syscalls_read, io->syscalls_write,
-                io->read_rate, io->write_rate);
+    if (r->flags & EXPORT_HAS_IO) {
+        len += snprintf(out + len, size - len, "%lu,%lu,%lu,%lu,%.2f,%.2f,",
+                        r->io.bytes_read, r->io.bytes_written,
+                        r->io.syscalls_read, r->io.syscalls_write,
+                        r->io.read_rate, r->io.write_rate);
     } else {
-        fprintf(fp, ",,,,,,");
+        len += snprintf(out + len, size - len, ",,,,,,");
     }
 
-    fprintf(fp, "\n");
-    fclose(fp);
+    // Intervalo em vigor (vazio em capturas antigas convertidas)
+    if (r->interval_ms) {
+        len += snprintf(out + len, size - len, "%u\n", r->interval_ms);
+    } else {
+        len += snprintf(out + len, size - len, "\n");
+    }
+    return len;
+}
 
-    return 0;
+static int format_json_record(char *out, size_t size, const char *timestamp,
+                              const export_record_t *r) {
+    int len = snprintf(out, size,
+                       "{\n"
+                       "  \"timestamp\": \"%s\",\n"
+                       "  \"pid\": %d,\n", timestamp, r->pid);
+    if (r->interval_ms) {
+        len += snprintf(out + len, size - len, "  \"interval_ms\": %u,\n", r->interval_ms);
+    }
+
+    // CPU
+    if (r->flags & EXPORT_HAS_CPU) {
+        len += snprintf(out + len, size - len,
+                        "  \"cpu\": {\n"
+                        "    \"user_time\": %lu,\n"
+                        "    \"system_time\": %lu,\n"
+                        "    \"total_time\": %lu,\n"
+                        "    \"cpu_percent\": %.2f,\n"
+                        "    \"num_threads\": %u,\n"
+                        "    \"context_switches\": %lu\n"
+                        "  },\n",
+                        r->cpu.user_time, r->cpu.system_time, r->cpu.total_time,
+                        r->cpu.cpu_percent, r->cpu.num_threads, r->cpu.context_switches);
+    } else {
+        len += snprintf(out + len, size - len,
+                        "  \"cpu\": {\n    \"error\": \"not collected\"\n  },\n");
+    }
+
+    // Memory
+    if (r->flags & EXPORT_HAS_MEM) {
+        len += snprintf(out + len, size - len,
+                        "  \"memory\": {\n"
+                        "    \"rss\": %lu,\n"
+                        "    \"vsz\": %lu,\n"
+                        "    \"swap\": %lu,\n"
+                        "    \"page_faults\": %lu\n"
+                        "  },\n",
+                        r->mem.rss, r->mem.vsz, r->mem.swap, r->mem.page_faults);
+    } else {
+        len += snprintf(out + len, size - len,
+                        "  \"memory\": {\n    \"error\": \"not collected\"\n  },\n");
+    }
+
+    // I/O
+    if (r->flags & EXPORT_HAS_IO) {
+        len += snprintf(out + len, size - len,
+                        "  \"io\": {\n"
+                        "    \"bytes_read\": %lu,\n"
+                        "    \"bytes_written\": %lu,\n"
+                        "    \"syscalls_read\": %lu,\n"
+                        "    \"syscalls_write\": %lu,\n"
+                        "    \"read_rate\": %.2f,\n"
+                        "    \"write_rate\": %.2f\n"
+                        "  }\n"
+                        "}\n",
+                        r->io.bytes_read, r->io.bytes_written,
+                        r->io.syscalls_read, r->io.syscalls_write,
+                        r->io.read_rate, r->io.write_rate);
+    } else {
+        len += snprintf(out + len, size - len,
+                        "  \"io\": {\n    \"error\": \"not collected\"\n  }\n}\n");
+    }
+    return len;
+}
+
+// ----------------------------------------------------------------------------
+// Emissor NDJSON: números escritos à mão direto no buffer, sem printf
+// ----------------------------------------------------------------------------
+
+static char* emit_str(char *p, const char *s) {
+    while (*s) {
+        *p++ = *s++;
+    }
+    return p;
+}
+
+static char* emit_u64(char *p, uint64_t v) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+static char* emit_i64(char *p, int64_t v) {
+    if (v < 0) {
+        *p++ = '-';
+        return emit_u64(p, (uint64_t)0 - (uint64_t)v);
+    }
+    return emit_u64(p, (uint64_t)v);
 }
 
 /**
- * Exporta métricas para arquivo JSON
+ * Número com duas casas decimais (arredondado); NaN/infinito viram null
  */
-int export_metrics_json(const char *filename,
-                        pid_t pid,
+static char* emit_fixed2(char *p, double v) {
+    if (v != v || v > 1e15 || v < -1e15) {
+        return emit_str(p, "null");
+    }
+    if (v < 0) {
+        *p++ = '-';
+        v = -v;
+    }
+    uint64_t cents = (uint64_t)(v * 100.0 + 0.5);
+    p = emit_u64(p, cents / 100);
+    *p++ = '.';
+    *p++ = (char)('0' + (cents / 10) % 10);
+    *p++ = (char)('0' + cents % 10);
+    return p;
+}
+
+/**
+ * Uma linha JSON compacta; seções não coletadas saem como null
+ * (EXPORT_MAX_RECORD cobre o pior caso: todos os campos com 20 dígitos)
+ */
+static int format_ndjson_record(char *out, const export_record_t *r) {
+    char *p = out;
+
+    p = emit_str(p, "{\"ts_ns\":");
+    p = emit_u64(p, r->realtime_ns);
+    p = emit_str(p, ",\"mono_ns\":");
+    p = emit_u64(p, r->monotonic_ns);
+    p = emit_str(p, ",\"pid\":");
+    p = emit_i64(p, r->pid);
+    if (r->interval_ms) {
+        p = emit_str(p, ",\"interval_ms\":");
+        p = emit_u64(p, r->interval_ms);
+    }
+
+    p = emit_str(p, ",\"cpu\":");
+    if (r->flags & EXPORT_HAS_CPU) {
+        p = emit_str(p, "{\"user_ticks\":");
+        p = emit_u64(p, r->cpu.user_time);
+        p = emit_str(p, ",\"system_ticks\":");
+        p = emit_u64(p, r->cpu.system_time);
+        p = emit_str(p, ",\"total_ticks\":");
+        p = emit_u64(p, r->cpu.total_time);
+        p = emit_str(p, ",\"percent\":");
+        p = emit_fixed2(p, r->cpu.cpu_percent);
+        p = emit_str(p, ",\"threads\":");
+        p = emit_u64(p, r->cpu.num_threads);
+        p = emit_str(p, ",\"context_switches\":");
+        p = emit_u64(p, r->cpu.context_switches);
+        *p++ = '}';
+    } else {
+        p = emit_str(p, "null");
+    }
+
+    p = emit_str(p, ",\"mem\":");
+    if (r->flags & EXPORT_HAS_MEM) {
+        p = emit_str(p, "{\"rss\":");
+        p = emit_u64(p, r->mem.rss);
+        p = emit_str(p, ",\"vsz\":");
+        p = emit_u64(p, r->mem.vsz);
+        p = emit_str(p, ",\"swap\":");
+        p = emit_u64(p, r->mem.swap);
+        p = emit_str(p, ",\"page_faults\":");
+        p = emit_u64(p, r->mem.page_faults);
+        *p++ = '}';
+    } else {
+        p = emit_str(p, "null");
+    }
+
+    p = emit_str(p, ",\"io\":");
+    if (r->flags & EXPORT_HAS_IO) {
+        p = emit_str(p, "{\"read_bytes\":");
+        p = emit_u64(p, r->io.bytes_read);
+        p = emit_str(p, ",\"write_bytes\":");
+        p = emit_u64(p, r->io.bytes_written);
+        p = emit_str(p, ",\"read_syscalls\":");
+        p = emit_u64(p, r->io.syscalls_read);
+        p = emit_str(p, ",\"write_syscalls\":");
+        p = emit_u64(p, r->io.syscalls_write);
+        p = emit_str(p, ",\"read_rate\":");
+        p = emit_fixed2(p, r->io.read_rate);
+        p = emit_str(p, ",\"write_rate\":");
+        p = emit_fixed2(p, r->io.write_rate);
+        *p++ = '}';
+    } else {
+        p = emit_str(p, "null");
+    }
+
+    p = emit_str(p, "}\n");
+    return (int)(p - out);
+}
+
+void export_record_fill(export_record_t *record, pid_t pid,
                         const cpu_metrics_t *cpu,
                         const memory_metrics_t *mem,
                         const io_metrics_t *io) {
-    if (filename == NULL) {
-        fprintf(stderr, "Error: filename is NULL\n");
-        errno = EINVAL;
+    struct timespec ts;
+
+    memset(record, 0, sizeof(*record));
+    clock_gettime(CLOCK_REALTIME, &ts);
+    record->realtime_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    record->monotonic_ns = monotonic_ns();
+    record->pid = pid;
+
+    if (cpu != NULL) {
+        record->cpu = *cpu;
+        record->flags |= EXPORT_HAS_CPU;
+    }
+    if (mem != NULL) {
+        record->mem = *mem;
+        record->flags |= EXPORT_HAS_MEM;
+    }
+    if (io != NULL) {
+        record->io = *io;
+        record->flags |= EXPORT_HAS_IO;
+    }
+}
+
+int export_writer_tick(export_writer_t *writer) {
+    if (writer == NULL || writer->fd < 0 || writer->config.flush_interval_ms <= 0) {
+        return 0;
+    }
+    if (monotonic_ns() - writer->last_flush_ns >= (uint64_t)writer->config.flush_interval_ms * 1000000ULL) {
+        return export_writer_flush(writer);
+    }
+    return 0;
+}
+
+/**
+ * Formata um registro de texto (CSV, JSON, NDJSON) no fim do buffer
+ */
+static int format_text_record(export_writer_t *writer, const export_record_t *record,
+                              const export_record_t *prev) {
+    char *out = writer->buffer + writer->length;
+    size_t room = writer->config.buffer_size - writer->length;
+    int len;
+    // JSON indentado fica sempre denso: a forma esparsa em JSON é o NDJSON
+    if (prev != NULL && writer->config.format == EXPORT_FORMAT_NDJSON) {
+        len = export_delta_format_ndjson(out, room, record, prev);
+    } else if (prev != NULL && writer->config.format == EXPORT_FORMAT_CSV) {
+        len = export_delta_format_csv(out, room, export_timestamp(writer, record->realtime_ns),
+                                      record, prev);
+    } else switch (writer->config.format) {
+        case EXPORT_FORMAT_NDJSON:
+            // Sem timestamp formatado: ts_ns/mono_ns vêm do próprio registro
+            len = format_ndjson_record(out, record);
+            break;
+        case EXPORT_FORMAT_JSON:
+            len = format_json_record(out, room, export_timestamp(writer, record->realtime_ns), record);
+            break;
+        case EXPORT_FORMAT_CSV:
+        default:
+            len = format_csv_record(out, room, export_timestamp(writer, record->realtime_ns), record);
+            break;
+    }
+    if (len < 0 || (size_t)len >= room) {
+        errno = EOVERFLOW;
         return -1;
     }
 
-    FILE *fp = fopen(filename, "a");
-    if (fp == NULL) {
-        fprintf(stderr, "Error opening %s: %s\n", filename, strerror(errno));
+    writer->length += (size_t)len;
+    writer->file_bytes += (uint64_t)len;
+    writer->records++;
+    return 0;
+}
+
+int export_writer_write_record(export_writer_t *writer, const export_record_t *record) {
+    if (writer == NULL || writer->fd < 0 || record == NULL) {
+        errno = EBADF;
         return -1;
     }
 
-    // Obter timestamp
-    time_t now = time(NULL);
-    char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    int ret = 0;
+    uint64_t now = monotonic_ns();
 
-    // Escrever JSON
-    fprintf(fp, "{\n");
-    fprintf(fp, "  \"timestamp\": \"%s\",\n", timestamp);
-    fprintf(fp, "  \"pid\": %d,\n", pid);
+    // Rotação antes do registro, para que ele abra o arquivo novo
+    if ((writer->config.rotate_bytes > 0 && writer->file_bytes >= writer->config.rotate_bytes) ||
+        (writer->config.rotate_seconds > 0 &&
+         now - writer->opened_ns >= (uint64_t)writer->config.rotate_seconds * 1000000000ULL)) {
+        if (rotate_export_file(writer) != 0) {
+            return -1;
+        }
+    }
 
-    // CPU
-    fprintf(fp, "  \"cpu\": {\n");
-    if (cpu != NULL) {
-        fprintf(fp, "    \"user_time\": %lu,\n", cpu->user_time);
-        fprintf(fp, "    \"system_time\": %lu,\n", cpu->system_time);
-        fprintf(fp, "    \"total_time\": %lu,\n", cpu->total_time);
-        fprintf(fp, "    \"cpu_percent\": %.2f,\n", cpu->cpu_percent);
-        fprintf(fp, "    \"num_threads\": %u,\n", cpu->num_threads);
-        fprintf(fp, "    \"context_switches\": %lu\n", cpu->context_switches);
-    } else {
-        fprintf(fp, "    \"error\": \"not collected\"\n");
+    // Só mudanças: amostras iguais à última emitida do PID não viram linha
+    export_record_t prev;
+    int have_prev = 0;
+    if (writer->delta != NULL) {
+        int admit = export_delta_admit(writer->delta, record, &prev, &have_prev);
+        if (admit <= 0) {
+            return admit;
+        }
     }
-    fprintf(fp, "  },\n");
 
-    // Memory
-    fprintf(fp, "  \"memory\": {\n");
-    if (mem != NULL) {
-        fprintf(fp, "    \"rss\": %lu,\n", mem->rss);
-        fprintf(fp, "    \"vsz\": %lu,\n", mem->vsz);
-        fprintf(fp, "    \"swap\": %lu,\n", mem->swap);
-        fprintf(fp, "    \"page_faults\": %lu\n", mem->page_faults);
+    if (writer->capture != NULL) {
+        // Binário: a amostra fica na série do PID até o bloco encher
+        if (capture_encoder_append(writer->capture, record) != 0) {
+            ret = -1;
+        }
+        writer->records++;
     } else {
-        fprintf(fp, "    \"error\": \"not collected\"\n");
+        if (writer->config.buffer_size - writer->length < EXPORT_MAX_RECORD) {
+            ret = export_writer_flush(writer);
+        }
+        if (format_text_record(writer, record,
+                               writer->config.sparse && have_prev ? &prev : NULL) != 0) {
+            return -1;
+        }
     }
-    fprintf(fp, "  },\n");
 
-    // I/O
-    fprintf(fp, "  \"io\": {\n");
-    if (io != NULL) {
-        fprintf(fp, "    \"bytes_read\": %lu,\n", io->bytes_read);
-        fprintf(fp, "    \"bytes_written\": %lu,\n", io->bytes_written);
-        fprintf(fp, "    \"syscalls_read\": %lu,\n", io->syscalls_read);
-        fprintf(fp, "    \"syscalls_write\": %lu,\n", io->syscalls_write);
-        fprintf(fp, "    \"read_rate\": %.2f,\n", io->read_rate);
-        fprintf(fp, "    \"write_rate\": %.2f\n", io->write_rate);
-    } else {
-        fprintf(fp, "    \"error\": \"not collected\"\n");
+    if (writer->config.flush_interval_ms > 0 &&
+        now - writer->last_flush_ns >= (uint64_t)writer->config.flush_interval_ms * 1000000ULL) {
+        if (export_writer_flush(writer) != 0) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+int export_writer_write(export_writer_t *writer,
+                        pid_t pid,
+                        const cpu_metrics_t *cpu,
+                        const memory_metrics_t *mem,
+                        const io_metrics_t *io) {
+    export_record_t record;
+    export_record_fill(&record, pid, cpu, mem, io);
+    return export_writer_write_record(writer, &record);
+}
+
+int export_writer_close(export_writer_t *writer) {
+    if (writer == NULL) {
+        return 0;
     }
-    fprintf(fp, "  }\n");
 
-    fprintf(fp, "}\n");
-    fclose(fp);
+    // Remove da lista de escritores abertos
+    for (export_writer_t **link = &open_writers; *link != NULL; link = &(*link)->next) {
+        if (*link == writer) {
+            *link = writer->next;
+            break;
+        }
+    }
 
-    return 0;
+    int ret = 0;
+    if (writer->fd >= 0) {
+        if (capture_encoder_seal(writer->capture) != 0) {
+            ret = -1;
+        }
+        if (export_writer_flush(writer) != 0) {
+            ret = -1;
+        }
+        if (writer->config.sync != EXPORT_SYNC_NONE) {
+            fdatasync(writer->fd);
+        }
+        close(writer->fd);
+        writer->fd = -1;
+    }
+    if (writer->capture != NULL) {
+        capture_encoder_free(writer->capture);
+        free(writer->capture);
+        writer->capture = NULL;
+    }
+    if (writer->delta != NULL) {
+        export_delta_free(writer->delta);
+        free(writer->delta);
+        writer->delta = NULL;
+    }
+    free(writer->buffer);
+    writer->buffer = NULL;
+    return ret;
+}
+
+void export_writer_flush_all(void) {
+    for (export_writer_t *w = open_writers; w != NULL; w = w->next) {
+        if (w->fd >= 0) {
+            capture_encoder_seal(w->capture);
+        }
+        if (w->fd >= 0 && w->length > 0) {
+            export_writer_flush(w);
+        }
+    }
+}
+
+/**
+ * Exporta uma amostra para arquivo CSV (abre, escreve e fecha; para
+ * amostragem contínua use export_writer_t)
+ */
+int export_metrics_csv(const char *filename,
+                       pid_t pid,
+                       const cpu_metrics_t *cpu,
+                       const memory_metrics_t *mem,
+                       const io_metrics_t *io) {
+    export_writer_t writer;
+    export_writer_config_t config;
+    export_writer_config_default(&config);
+    config.format = EXPORT_FORMAT_CSV;
+    config.buffer_size = EXPORT_MAX_RECORD * 2;
+
+    if (export_writer_open(&writer, filename, &config) != 0) {
+        return -1;
+    }
+    int ret = export_writer_write(&writer, pid, cpu, mem, io);
+    if (export_writer_close(&writer) != 0) {
+        ret = -1;
+    }
+    return ret;
+}
+
+/**
+ * Exporta uma amostra para arquivo JSON (abre, escreve e fecha)
+ */
+int export_metrics_json(const char *filename,
+                        pid_t pid,
+                        const cpu_metrics_t *cpu,
+                        const memory_metrics_t *mem,
+                        const io_metrics_t *io) {
+    export_writer_t writer;
+    export_writer_config_t config;
+    export_writer_config_default(&config);
+    config.format = EXPORT_FORMAT_JSON;
+    config.buffer_size = EXPORT_MAX_RECORD * 2;
+
+    if (export_writer_open(&writer, filename, &config) != 0) {
+        return -1;
+    }
+    int ret = export_writer_write(&writer, pid, cpu, mem, io);
+    if (export_writer_close(&writer) != 0) {
+        ret = -1;
+    }
+    return ret;
 }
 
 /**
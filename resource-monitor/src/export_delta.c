@@ -0,0 +1,593 @@
+#define _GNU_SOURCE
+#include "export_delta.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+/**
+ * Campo exportado: ordem das colunas CSV e chave NDJSON
+ */
+typedef struct {
+    const char *key;
+    uint32_t section;           // EXPORT_HAS_*
+    char type;                  // 'u' uint64, 'i' uint32, 'd' double
+    int counter;                // Acumulado desde o início do processo
+    size_t offset;
+} delta_field_t;
+
+#define DELTA_FIELD(key, section, type, counter, member) \
+    { key, EXPORT_HAS_##section, type, counter, offsetof(export_record_t, member) }
+
+static const delta_field_t fields[] = {
+    DELTA_FIELD("user_ticks",       CPU, 'u', 1, cpu.user_time),
+    DELTA_FIELD("system_ticks",     CPU, 'u', 1, cpu.system_time),
+    DELTA_FIELD("total_ticks",      CPU, 'u', 1, cpu.total_time),
+    DELTA_FIELD("percent",          CPU, 'd', 0, cpu.cpu_percent),
+    DELTA_FIELD("threads",          CPU, 'i', 0, cpu.num_threads),
+    DELTA_FIELD("context_switches", CPU, 'u', 1, cpu.context_switches),
+    DELTA_FIELD("rss",              MEM, 'u', 0, mem.rss),
+    DELTA_FIELD("vsz",              MEM, 'u', 0, mem.vsz),
+    DELTA_FIELD("swap",             MEM, 'u', 0, mem.swap),
+    DELTA_FIELD("page_faults",      MEM, 'u', 1, mem.page_faults),
+    DELTA_FIELD("read_bytes",       IO,  'u', 1, io.bytes_read),
+    DELTA_FIELD("write_bytes",      IO,  'u', 1, io.bytes_written),
+    DELTA_FIELD("read_syscalls",    IO,  'u', 1, io.syscalls_read),
+    DELTA_FIELD("write_syscalls",   IO,  'u', 1, io.syscalls_write),
+    DELTA_FIELD("read_rate",        IO,  'd', 0, io.read_rate),
+    DELTA_FIELD("write_rate",       IO,  'd', 0, io.write_rate),
+};
+
+#define FIELD_COUNT ((int)(sizeof(fields) / sizeof(fields[0])))
+
+_Static_assert(sizeof(fields) / sizeof(fields[0]) == EXPORT_DELTA_FIELDS,
+               "export_delta_entry_t.rates precisa de uma posição por campo");
+
+static const struct {
+    uint32_t section;
+    const char *key;
+} sections[] = {
+    { EXPORT_HAS_CPU, "cpu" },
+    { EXPORT_HAS_MEM, "mem" },
+    { EXPORT_HAS_IO,  "io" },
+};
+
+#define SECTION_COUNT 3
+
+static double field_value(const export_record_t *r, const delta_field_t *f) {
+    const char *p = (const char *)r + f->offset;
+    switch (f->type) {
+        case 'd': { double v; memcpy(&v, p, sizeof(v)); return v; }
+        case 'i': { uint32_t v; memcpy(&v, p, sizeof(v)); return (double)v; }
+        default:  { uint64_t v; memcpy(&v, p, sizeof(v)); return (double)v; }
+    }
+}
+
+static int field_equal(const export_record_t *a, const export_record_t *b, const delta_field_t *f) {
+    size_t size = f->type == 'i' ? sizeof(uint32_t) : sizeof(uint64_t);
+    return memcmp((const char *)a + f->offset, (const char *)b + f->offset, size) == 0;
+}
+
+/**
+ * Texto do valor: inteiros exatos, doubles com duas casas (como o CSV denso)
+ */
+static int field_format(char *out, size_t size, const export_record_t *r, const delta_field_t *f) {
+    const char *p = (const char *)r + f->offset;
+    switch (f->type) {
+        case 'd': { double v; memcpy(&v, p, sizeof(v)); return snprintf(out, size, "%.2f", v); }
+        case 'i': { uint32_t v; memcpy(&v, p, sizeof(v)); return snprintf(out, size, "%u", v); }
+        default:  { uint64_t v; memcpy(&v, p, sizeof(v)); return snprintf(out, size, "%lu", v); }
+    }
+}
+
+static int field_parse(export_record_t *r, const delta_field_t *f, const char *text) {
+    char *stop;
+    char *p = (char *)r + f->offset;
+    errno = 0;
+    if (f->type == 'd') {
+        double v = strtod(text, &stop);
+        if (stop == text && strncmp(text, "null", 4) == 0) {
+            v = 0;
+            stop = (char *)text + 4;
+        }
+        memcpy(p, &v, sizeof(v));
+    } else {
+        unsigned long long v = strtoull(text, &stop, 10);
+        if (f->type == 'i') {
+            uint32_t v32 = (uint32_t)v;
+            memcpy(p, &v32, sizeof(v32));
+        } else {
+            uint64_t v64 = (uint64_t)v;
+            memcpy(p, &v64, sizeof(v64));
+        }
+    }
+    return stop == text || errno == ERANGE ? -1 : 0;
+}
+
+// ----------------------------------------------------------------------------
+// Estado por PID
+// ----------------------------------------------------------------------------
+
+int export_delta_init(export_delta_t *delta, int change_only, double epsilon, int heartbeat_ms) {
+    memset(delta, 0, sizeof(*delta));
+    delta->capacity = 64;
+    delta->entries = calloc(delta->capacity, sizeof(*delta->entries));
+    if (delta->entries == NULL) {
+        return -1;
+    }
+    delta->change_only = change_only;
+    delta->epsilon = epsilon > 0 ? epsilon : 0;
+    delta->heartbeat_ns = heartbeat_ms > 0 ? (uint64_t)heartbeat_ms * 1000000ULL : 0;
+    delta->generation = 1;
+    return 0;
+}
+
+void export_delta_free(export_delta_t *delta) {
+    if (delta == NULL) return;
+    free(delta->entries);
+    delta->entries = NULL;
+    delta->capacity = delta->count = 0;
+}
+
+static size_t pid_slot(pid_t pid, size_t capacity) {
+    return ((uint32_t)pid * 2654435761u) & (capacity - 1);
+}
+
+static int grow_table(export_delta_t *delta) {
+    size_t capacity = delta->capacity * 2;
+    export_delta_entry_t *entries = calloc(capacity, sizeof(*entries));
+    if (entries == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < delta->capacity; i++) {
+        if (delta->entries[i].pid == 0) continue;
+        size_t slot = pid_slot(delta->entries[i].pid, capacity);
+        while (entries[slot].pid != 0) slot = (slot + 1) & (capacity - 1);
+        entries[slot] = delta->entries[i];
+    }
+    free(delta->entries);
+    delta->entries = entries;
+    delta->capacity = capacity;
+    return 0;
+}
+
+export_delta_entry_t* export_delta_lookup(export_delta_t *delta, pid_t pid, int create) {
+    if (pid == 0) {
+        return NULL;
+    }
+    size_t slot = pid_slot(pid, delta->capacity);
+    while (delta->entries[slot].pid != 0) {
+        if (delta->entries[slot].pid == pid) {
+            return &delta->entries[slot];
+        }
+        slot = (slot + 1) & (delta->capacity - 1);
+    }
+    if (!create) {
+        return NULL;
+    }
+
+    // Carga máxima de 1/2 mantém as sondagens curtas
+    if ((delta->count + 1) * 2 > delta->capacity) {
+        if (grow_table(delta) != 0) {
+            return NULL;
+        }
+        return export_delta_lookup(delta, pid, create);
+    }
+    delta->count++;
+    delta->entries[slot].pid = pid;
+    return &delta->entries[slot];
+}
+
+void export_delta_new_file(export_delta_t *delta) {
+    delta->generation++;
+}
+
+/**
+ * Taxa por segundo de um contador entre a última linha e r
+ * @return 0 em sucesso, -1 se não há taxa (contador voltou ou sem tempo decorrido)
+ */
+static int counter_rate(const export_record_t *last, const export_record_t *r,
+                        const delta_field_t *f, double *rate) {
+    double a = field_value(last, f), b = field_value(r, f);
+    if (b < a || r->monotonic_ns <= last->monotonic_ns) {
+        return -1;
+    }
+    *rate = (b - a) * 1e9 / (double)(r->monotonic_ns - last->monotonic_ns);
+    return 0;
+}
+
+/**
+ * @return Não zero se alguma seção apareceu ou sumiu, algum gauge variou além
+ *         de epsilon ou algum contador mudou de ritmo além de epsilon
+ */
+static int changed_beyond(const export_delta_t *delta, const export_delta_entry_t *entry,
+                          const export_record_t *r) {
+    const export_record_t *last = &entry->last;
+    if (r->flags != entry->flags) {
+        return 1;
+    }
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        const delta_field_t *f = &fields[i];
+        if (!(r->flags & f->section)) continue;
+        double a, b;
+        if (f->counter) {
+            a = entry->rates[i];
+            if (counter_rate(last, r, f, &b) != 0) {
+                if (!field_equal(last, r, f)) return 1;
+                continue;
+            }
+        } else {
+            a = field_value(last, f);
+            b = field_value(r, f);
+        }
+        double scale = fmax(fmax(fabs(a), fabs(b)), 1.0);
+        if (fabs(b - a) > delta->epsilon * scale) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Taxas de referência dos contadores para a linha r que vai ser emitida
+ */
+static void update_rates(export_delta_entry_t *entry, const export_record_t *r) {
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        const delta_field_t *f = &fields[i];
+        if (!f->counter || !(r->flags & f->section)) continue;
+        double rate;
+        if (!(entry->last.flags & f->section) || counter_rate(&entry->last, r, f, &rate) != 0) {
+            rate = 0;
+        }
+        entry->rates[i] = rate;
+    }
+}
+
+/**
+ * Incorpora as seções presentes em r ao acumulado do PID
+ */
+static void merge_record(export_record_t *last, const export_record_t *r) {
+    last->realtime_ns = r->realtime_ns;
+    last->monotonic_ns = r->monotonic_ns;
+    last->pid = r->pid;
+    last->interval_ms = r->interval_ms;
+    last->flags |= r->flags;
+    if (r->flags & EXPORT_HAS_CPU) last->cpu = r->cpu;
+    if (r->flags & EXPORT_HAS_MEM) last->mem = r->mem;
+    if (r->flags & EXPORT_HAS_IO) last->io = r->io;
+}
+
+int export_delta_admit(export_delta_t *delta, const export_record_t *record,
+                       export_record_t *prev, int *have_prev) {
+    export_delta_entry_t *entry = export_delta_lookup(delta, record->pid, 1);
+    if (entry == NULL) {
+        return -1;
+    }
+    int seen = entry->last.flags != 0 || entry->emitted_ns != 0;
+
+    if (delta->change_only && seen && !changed_beyond(delta, entry, record) &&
+        !(delta->heartbeat_ns && record->monotonic_ns - entry->emitted_ns >= delta->heartbeat_ns)) {
+        delta->suppressed++;
+        return 0;
+    }
+
+    int same_file = seen && entry->generation == delta->generation;
+    if (have_prev != NULL) *have_prev = same_file;
+    if (prev != NULL && same_file) *prev = entry->last;
+
+    update_rates(entry, record);
+    merge_record(&entry->last, record);
+    entry->flags = record->flags;
+    entry->emitted_ns = record->monotonic_ns ? record->monotonic_ns : 1;
+    entry->generation = delta->generation;
+    delta->emitted++;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------
+// Linhas esparsas
+// ----------------------------------------------------------------------------
+
+int export_delta_format_csv(char *out, size_t size, const char *timestamp,
+                            const export_record_t *r, const export_record_t *prev) {
+    int len = snprintf(out, size, "%s,%d", timestamp, r->pid);
+    for (int i = 0; i < FIELD_COUNT && (size_t)len < size; i++) {
+        const delta_field_t *f = &fields[i];
+        out[len++] = ',';
+        if (!(r->flags & f->section)) {
+            continue;
+        }
+        if ((prev->flags & f->section) && field_equal(r, prev, f)) {
+            len += snprintf(out + len, size - len, "=");
+        } else {
+            len += field_format(out + len, size - len, r, f);
+        }
+    }
+    if (r->interval_ms == 0) {
+        len += snprintf(out + len, size - len, ",\n");
+    } else if (r->interval_ms == prev->interval_ms) {
+        len += snprintf(out + len, size - len, ",=\n");
+    } else {
+        len += snprintf(out + len, size - len, ",%u\n", r->interval_ms);
+    }
+    return len;
+}
+
+int export_delta_format_ndjson(char *out, size_t size, const export_record_t *r,
+                               const export_record_t *prev) {
+    int len = snprintf(out, size, "{\"ts_ns\":%lu,\"mono_ns\":%lu,\"pid\":%d",
+                       r->realtime_ns, r->monotonic_ns, r->pid);
+    if (r->interval_ms != prev->interval_ms) {
+        len += snprintf(out + len, size - len, ",\"interval_ms\":%u", r->interval_ms);
+    }
+
+    for (int s = 0; s < SECTION_COUNT; s++) {
+        uint32_t section = sections[s].section;
+        if (!(r->flags & section)) {
+            // null só quando a linha anterior tinha a seção (ausente = igual)
+            if (prev->flags & section) {
+                len += snprintf(out + len, size - len, ",\"%s\":null", sections[s].key);
+            }
+            continue;
+        }
+        // Seção sem nenhuma mudança fica de fora
+        int changed = 0;
+        for (int i = 0; i < FIELD_COUNT && !changed; i++) {
+            changed = fields[i].section == section &&
+                      (!(prev->flags & section) || !field_equal(r, prev, &fields[i]));
+        }
+        if (!changed) {
+            continue;
+        }
+        len += snprintf(out + len, size - len, ",\"%s\":{", sections[s].key);
+        const char *sep = "";
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            const delta_field_t *f = &fields[i];
+            if (f->section != section) continue;
+            if ((prev->flags & section) && field_equal(r, prev, f)) continue;
+            len += snprintf(out + len, size - len, "%s\"%s\":", sep, f->key);
+            len += field_format(out + len, size - len, r, f);
+            sep = ",";
+        }
+        len += snprintf(out + len, size - len, "}");
+    }
+    len += snprintf(out + len, size - len, "}\n");
+    return len;
+}
+
+// ----------------------------------------------------------------------------
+// Leitura
+// ----------------------------------------------------------------------------
+
+int export_reader_open(export_reader_t *reader, const char *path) {
+    memset(reader, 0, sizeof(*reader));
+    reader->fp = fopen(path, "r");
+    if (reader->fp == NULL) {
+        return -1;
+    }
+
+    int c = fgetc(reader->fp);
+    if (c == '{') {
+        reader->ndjson = 1;
+        ungetc(c, reader->fp);
+    } else {
+        // CSV: descarta o cabeçalho
+        ssize_t n = getline(&reader->line, &reader->line_size, reader->fp);
+        if (c != 't' || n < 0 || strncmp(reader->line, "imestamp,pid,", 13) != 0) {
+            export_reader_close(reader);
+            errno = EINVAL;
+            return -1;
+        }
+        reader->line_number = 1;
+    }
+    if (export_delta_init(&reader->state, 0, 0, 0) != 0) {
+        export_reader_close(reader);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Linha CSV: "=" copia o campo da linha anterior do PID
+ */
+static int parse_csv_line(char *line, export_record_t *record, const export_record_t *prev) {
+    char *column[2 + FIELD_COUNT + 2] = { 0 };
+    int count = 0;
+
+    // strsep preserva colunas vazias
+    char *rest = line;
+    char *token;
+    while ((token = strsep(&rest, ",")) != NULL && count < (int)(sizeof(column) / sizeof(column[0]))) {
+        column[count++] = token;
+    }
+    if (count < 2 + FIELD_COUNT) {
+        return -1;
+    }
+
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    if (strptime(column[0], "%Y-%m-%d %H:%M:%S", &tm) == NULL) {
+        return -1;
+    }
+    tm.tm_isdst = -1;
+    record->realtime_ns = (uint64_t)mktime(&tm) * 1000000000ULL;
+    record->pid = (pid_t)atoi(column[1]);
+
+    for (int s = 0; s < SECTION_COUNT; s++) {
+        uint32_t section = sections[s].section;
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            const delta_field_t *f = &fields[i];
+            const char *text = column[2 + i];
+            if (f->section != section || text[0] == '\0') continue;
+            record->flags |= section;
+            if (strcmp(text, "=") == 0) {
+                if (!(prev->flags & section)) return -1;
+                memcpy((char *)record + f->offset, (const char *)prev + f->offset,
+                       f->type == 'i' ? sizeof(uint32_t) : sizeof(uint64_t));
+            } else if (field_parse(record, f, text) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    // Exportações anteriores ao intervalo não têm a última coluna
+    const char *interval = count > 2 + FIELD_COUNT ? column[2 + FIELD_COUNT] : "";
+    if (strcmp(interval, "=") == 0) {
+        record->interval_ms = prev->interval_ms;
+    } else if (interval[0] != '\0') {
+        record->interval_ms = (uint32_t)strtoul(interval, NULL, 10);
+    }
+    return 0;
+}
+
+/**
+ * @return Valor de "key": entre begin e end, ou NULL se ausente
+ */
+static const char* find_key(const char *begin, const char *end, const char *key) {
+    char pattern[64];
+    int n = snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    for (const char *p = begin; p && p + n <= end; p++) {
+        p = memchr(p, '"', (size_t)(end - p));
+        if (p == NULL || p + n > end) return NULL;
+        if (memcmp(p, pattern, (size_t)n) == 0) return p + n;
+    }
+    return NULL;
+}
+
+/**
+ * Linha NDJSON: chave ou seção ausente copia da linha anterior do PID
+ */
+static int parse_ndjson_line(const char *line, export_record_t *record, export_delta_t *state) {
+    const char *end = line + strlen(line);
+    const char *v;
+
+    if ((v = find_key(line, end, "pid")) == NULL) return -1;
+    record->pid = (pid_t)strtol(v, NULL, 10);
+    export_delta_entry_t *entry = export_delta_lookup(state, record->pid, 0);
+    const export_record_t *prev = entry ? &entry->last : NULL;
+
+    if ((v = find_key(line, end, "ts_ns")) != NULL) record->realtime_ns = strtoull(v, NULL, 10);
+    if ((v = find_key(line, end, "mono_ns")) != NULL) record->monotonic_ns = strtoull(v, NULL, 10);
+    if ((v = find_key(line, end, "interval_ms")) != NULL) {
+        record->interval_ms = (uint32_t)strtoul(v, NULL, 10);
+    } else if (prev != NULL) {
+        record->interval_ms = prev->interval_ms;
+    }
+
+    for (int s = 0; s < SECTION_COUNT; s++) {
+        uint32_t section = sections[s].section;
+        const char *body = find_key(line, end, sections[s].key);
+        if (body != NULL && strncmp(body, "null", 4) == 0) {
+            continue;
+        }
+        const char *close = body ? strchr(body, '}') : NULL;
+        if (body != NULL && (*body != '{' || close == NULL)) {
+            return -1;
+        }
+        if (body == NULL && (prev == NULL || !(prev->flags & section))) {
+            continue;
+        }
+        record->flags |= section;
+        for (int i = 0; i < FIELD_COUNT; i++) {
+            const delta_field_t *f = &fields[i];
+            if (f->section != section) continue;
+            const char *value = body ? find_key(body, close, f->key) : NULL;
+            if (value != NULL) {
+                if (field_parse(record, f, value) != 0) return -1;
+            } else if (prev != NULL && (prev->flags & section)) {
+                memcpy((char *)record + f->offset, (const char *)prev + f->offset,
+                       f->type == 'i' ? sizeof(uint32_t) : sizeof(uint64_t));
+            } else {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int export_reader_next(export_reader_t *reader, export_record_t *record) {
+    ssize_t n;
+    do {
+        n = getline(&reader->line, &reader->line_size, reader->fp);
+        if (n < 0) {
+            return 0;
+        }
+        reader->line_number++;
+        while (n > 0 && (reader->line[n - 1] == '\n' || reader->line[n - 1] == '\r')) {
+            reader->line[--n] = '\0';
+        }
+    } while (n == 0);
+
+    memset(record, 0, sizeof(*record));
+    int ret;
+    if (reader->ndjson) {
+        ret = parse_ndjson_line(reader->line, record, &reader->state);
+    } else {
+        // O PID vem antes de qualquer "=": a linha anterior é buscada pelo prefixo
+        export_record_t empty = { 0 };
+        const char *comma = strchr(reader->line, ',');
+        export_delta_entry_t *entry = comma ? export_delta_lookup(&reader->state,
+                                                                  (pid_t)atoi(comma + 1), 0) : NULL;
+        ret = parse_csv_line(reader->line, record, entry ? &entry->last : &empty);
+    }
+    if (ret != 0 || record->pid == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    export_delta_entry_t *entry = export_delta_lookup(&reader->state, record->pid, 1);
+    if (entry == NULL) {
+        return -1;
+    }
+    merge_record(&entry->last, record);
+    return 1;
+}
+
+void export_reader_close(export_reader_t *reader) {
+    if (reader->fp != NULL) {
+        fclose(reader->fp);
+        reader->fp = NULL;
+    }
+    free(reader->line);
+    reader->line = NULL;
+    export_delta_free(&reader->state);
+}
+
+long export_densify(const char *input, const char *output, export_format_t format) {
+    export_reader_t reader;
+    if (export_reader_open(&reader, input) != 0) {
+        fprintf(stderr, "Error opening export %s: %s\n", input, strerror(errno));
+        return -1;
+    }
+
+    export_writer_t writer;
+    export_writer_config_t config;
+    export_writer_config_default(&config);
+    config.format = format;
+    config.flush_interval_ms = 0;
+    if (export_writer_open(&writer, output, &config) != 0) {
+        export_reader_close(&reader);
+        return -1;
+    }
+
+    export_record_t record;
+    long converted = 0;
+    int ret;
+    while ((ret = export_reader_next(&reader, &record)) == 1) {
+        if (export_writer_write_record(&writer, &record) != 0) {
+            ret = -1;
+            break;
+        }
+        converted++;
+    }
+    if (ret < 0) {
+        fprintf(stderr, "Error: %s line %lu is not a valid export row\n", input, reader.line_number);
+    }
+
+    if (export_writer_close(&writer) != 0) {
+        ret = -1;
+    }
+    export_reader_close(&reader);
+    return ret < 0 ? -1 : converted;
+}
@@ -0,0 +1,258 @@
+#define _GNU_SOURCE
+#include "export_pipeline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+
+// Espera do produtor em BLOCK e teto de sono do consumidor ocioso
+#define PRODUCER_BACKOFF_NS 50000L
+#define CONSUMER_IDLE_MS 100
+
+int export_overflow_from_string(const char *name, export_overflow_t *overflow) {
+    if (name == NULL || overflow == NULL) return -1;
+    if (strcmp(name, "block") == 0) {
+        *overflow = EXPORT_OVERFLOW_BLOCK;
+    } else if (strcmp(name, "drop-oldest") == 0) {
+        *overflow = EXPORT_OVERFLOW_DROP_OLDEST;
+    } else if (strcmp(name, "drop-newest") == 0) {
+        *overflow = EXPORT_OVERFLOW_DROP_NEWEST;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+static int ring_init(export_ring_t *ring, size_t capacity) {
+    size_t size = 16;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    ring->slots = calloc(size, sizeof(export_ring_slot_t));
+    if (ring->slots == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&ring->slots[i].seq, i);
+    }
+    ring->mask = size - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return 0;
+}
+
+static int ring_empty(export_ring_t *ring) {
+    return atomic_load(&ring->tail) == atomic_load(&ring->head);
+}
+
+/**
+ * Retira um registro (consumidor)
+ *
+ * Em DROP_OLDEST o produtor também avança tail; por isso o slot é primeiro
+ * reservado com o CAS em tail e só então copiado. O produtor não reescreve
+ * o slot antes que seq seja liberado no fim da cópia
+ * @return 1 se leu um registro, 0 se a fila está vazia
+ */
+static int ring_pop(export_ring_t *ring, export_record_t *out) {
+    for (;;) {
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        export_ring_slot_t *slot = &ring->slots[tail & ring->mask];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - (tail + 1));
+        if (diff < 0) {
+            return 0; // posição ainda não publicada: fila vazia
+        }
+        if (diff > 0) {
+            continue; // o produtor descartou este registro; tail mudou
+        }
+
+        if (atomic_compare_exchange_strong_explicit(&ring->tail, &tail, tail + 1,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            *out = slot->record;
+            atomic_store_explicit(&slot->seq, tail + ring->mask + 1, memory_order_release);
+            return 1;
+        }
+    }
+}
+
+static void wake_consumer(export_pipeline_t *pipeline) {
+    if (atomic_load(&pipeline->consumer_waiting)) {
+        pthread_mutex_lock(&pipeline->lock);
+        pthread_cond_signal(&pipeline->wakeup);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+}
+
+int export_pipeline_push(export_pipeline_t *pipeline, const export_record_t *record) {
+    export_ring_t *ring = &pipeline->ring;
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail;
+    int dropped = 0;
+    int waited = 0;
+
+    for (;;) {
+        tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - tail <= ring->mask) {
+            break;
+        }
+
+        switch (pipeline->overflow) {
+            case EXPORT_OVERFLOW_DROP_NEWEST:
+                atomic_fetch_add(&pipeline->dropped, 1);
+                return 1;
+            case EXPORT_OVERFLOW_DROP_OLDEST:
+                // Reserva o slot mais antigo como o consumidor faria e o libera sem ler
+                if (atomic_compare_exchange_strong(&ring->tail, &tail, tail + 1)) {
+                    atomic_store_explicit(&ring->slots[tail & ring->mask].seq,
+                                          tail + ring->mask + 1, memory_order_release);
+                    atomic_fetch_add(&pipeline->dropped, 1);
+                    dropped = 1;
+                }
+                break;
+            case EXPORT_OVERFLOW_BLOCK:
+            default: {
+                if (!waited) {
+                    atomic_fetch_add(&pipeline->blocked, 1);
+                    waited = 1;
+                }
+                wake_consumer(pipeline);
+                struct timespec backoff = { 0, PRODUCER_BACKOFF_NS };
+                nanosleep(&backoff, NULL);
+                break;
+            }
+        }
+    }
+
+    // O consumidor pode ter reservado este slot e ainda estar copiando
+    export_ring_slot_t *slot = &ring->slots[head & ring->mask];
+    while (atomic_load_explicit(&slot->seq, memory_order_acquire) != head) {
+        sched_yield();
+    }
+    slot->record = *record;
+    atomic_store_explicit(&slot->seq, head + 1, memory_order_release);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    atomic_fetch_add_explicit(&pipeline->pushed, 1, memory_order_relaxed);
+
+    uint64_t depth = head + 1 - tail;
+    if (depth > pipeline->max_depth) {
+        pipeline->max_depth = depth;
+    }
+
+    wake_consumer(pipeline);
+    return dropped;
+}
+
+/**
+ * Thread escritora: formata e escreve enquanto há registros; ociosa, dorme
+ * até ser acordada ou até a próxima descarga por tempo
+ */
+static void* export_writer_thread(void *arg) {
+    export_pipeline_t *pipeline = arg;
+    export_record_t record;
+
+    for (;;) {
+        if (ring_pop(&pipeline->ring, &record)) {
+            export_writer_write_record(pipeline->writer, &record);
+            atomic_fetch_add_explicit(&pipeline->written, 1, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_load(&pipeline->stopping)) {
+            // O produtor já parou: o que restou foi esvaziado acima
+            break;
+        }
+
+        export_writer_tick(pipeline->writer);
+
+        atomic_store(&pipeline->consumer_waiting, 1);
+        pthread_mutex_lock(&pipeline->lock);
+        if (ring_empty(&pipeline->ring) && !atomic_load(&pipeline->stopping)) {
+            int wait_ms = pipeline->writer->config.flush_interval_ms;
+            if (wait_ms <= 0 || wait_ms > CONSUMER_IDLE_MS) {
+                wait_ms = CONSUMER_IDLE_MS;
+            }
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += (long)wait_ms * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+                deadline.tv_nsec %= 1000000000L;
+            }
+            pthread_cond_timedwait(&pipeline->wakeup, &pipeline->lock, &deadline);
+        }
+        pthread_mutex_unlock(&pipeline->lock);
+        atomic_store(&pipeline->consumer_waiting, 0);
+    }
+
+    export_writer_flush(pipeline->writer);
+    return NULL;
+}
+
+int export_pipeline_start(export_pipeline_t *pipeline, export_writer_t *writer,
+                          size_t capacity, export_overflow_t overflow) {
+    if (pipeline == NULL || writer == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->writer = writer;
+    pipeline->overflow = overflow;
+    atomic_init(&pipeline->consumer_waiting, 0);
+    atomic_init(&pipeline->stopping, 0);
+    atomic_init(&pipeline->pushed, 0);
+    atomic_init(&pipeline->written, 0);
+    atomic_init(&pipeline->dropped, 0);
+    atomic_init(&pipeline->blocked, 0);
+
+    if (ring_init(&pipeline->ring, capacity) != 0) {
+        return -1;
+    }
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->wakeup, NULL);
+
+    int err = pthread_create(&pipeline->thread, NULL, export_writer_thread, pipeline);
+    if (err != 0) {
+        pthread_mutex_destroy(&pipeline->lock);
+        pthread_cond_destroy(&pipeline->wakeup);
+        free(pipeline->ring.slots);
+        pipeline->ring.slots = NULL;
+        errno = err;
+        return -1;
+    }
+    pipeline->running = 1;
+    return 0;
+}
+
+void export_pipeline_stop(export_pipeline_t *pipeline) {
+    if (pipeline == NULL || !pipeline->running) {
+        return;
+    }
+
+    atomic_store(&pipeline->stopping, 1);
+    pthread_mutex_lock(&pipeline->lock);
+    pthread_cond_signal(&pipeline->wakeup);
+    pthread_mutex_unlock(&pipeline->lock);
+    pthread_join(pipeline->thread, NULL);
+    pipeline->running = 0;
+
+    pthread_mutex_destroy(&pipeline->lock);
+    pthread_cond_destroy(&pipeline->wakeup);
+    free(pipeline->ring.slots);
+    pipeline->ring.slots = NULL;
+}
+
+void export_pipeline_get_stats(const export_pipeline_t *pipeline, export_pipeline_stats_t *stats) {
+    if (pipeline == NULL || stats == NULL) {
+        return;
+    }
+    stats->pushed = atomic_load(&pipeline->pushed);
+    stats->written = atomic_load(&pipeline->written);
+    stats->dropped = atomic_load(&pipeline->dropped);
+    stats->blocked = atomic_load(&pipeline->blocked);
+    stats->max_depth = pipeline->max_depth;
+}
@@ -6,18 +6,11 @@
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <limits.h>
 #include <time.h>
 
-// Estrutura para armazenar estado anterior (para calcular taxas)
-typedef struct {
-    uint64_t last_bytes_read;
-    uint64_t last_bytes_written;
-    struct timespec last_timestamp;
-    int initialized;
-} io_state_t;
-
-// Estado global para cálculo de taxas
-static io_state_t io_state = {0};
+// Estado global para cálculo de taxas (modo de alvo único)
+static io_rate_state_t io_state = {0};
 
 /**
  * Lê o arquivo /proc/[pid]/io e extrai métricas de I/O
@@ -27,7 +20,14 @@ static io_state_t io_state = {0};
  * @return 0 em sucesso, -1 em erro
  */
 int collect_io_metrics(pid_t pid, io_metrics_t *metrics) {
-    if (metrics == NULL) {
+    return collect_io_metrics_r(pid, metrics, &io_state);
+}
+
+/**
+ * Como collect_io_metrics, com o estado das taxas fornecido por quem chama
+ */
+int collect_io_metrics_r(pid_t pid, io_metrics_t *metrics, io_rate_state_t *state) {
+    if (metrics == NULL || state == NULL) {
         fprintf(stderr, "Error: metrics pointer is NULL\n");
         errno = EINVAL;
         return -1;
@@ -37,8 +37,8 @@ int collect_io_metrics(pid_t pid, io_metrics_t *metrics) {
     memset(metrics, 0, sizeof(io_metrics_t));
 
     // Construir caminho do arquivo /proc/[pid]/io
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%d/io", pid);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%d/io", proc_root(), pid);
 
     // Abrir arquivo (requer permissões)
     FILE *fp = fopen(path, "r");
@@ -112,15 +112,15 @@ int collect_io_metrics(pid_t pid, io_metrics_t *metrics) {
     struct timespec current_time;
     clock_gettime(CLOCK_MONOTONIC, &current_time);
 
-    if (io_state.initialized) {
+    if (state->initialized) {
         // Calcular tempo decorrido em segundos
-        double elapsed_time = (current_time.tv_sec - io_state.last_timestamp.tv_sec) +
-                             (current_time.tv_nsec - io_state.last_timestamp.tv_nsec) / 1e9;
+        double elapsed_time = (current_time.tv_sec - state->last_timestamp.tv_sec) +
+                             (current_time.tv_nsec - state->last_timestamp.tv_nsec) / 1e9;
 
         if (elapsed_time > 0) {
             // Calcular deltas
-            uint64_t delta_read = metrics->bytes_read - io_state.last_bytes_read;
-            uint64_t delta_written = metrics->bytes_written - io_state.last_bytes_written;
+            uint64_t delta_read = metrics->bytes_read - state->last_bytes_read;
+            uint64_t delta_written = metrics->bytes_written - state->last_bytes_written;
 
             // Calcular taxas (bytes por segundo)
             metrics->read_rate = (double)delta_read / elapsed_time;
@@ -136,10 +136,10 @@ int collect_io_metrics(pid_t pid, io_metrics_t *metrics) {
     }
 
     // Atualizar estado para próxima leitura
-    io_state.last_bytes_read = metrics->bytes_read;
-    io_state.last_bytes_written = metrics->bytes_written;
-    io_state.last_timestamp = current_time;
-    io_state.initialized = 1;
+    state->last_bytes_read = metrics->bytes_read;
+    state->last_bytes_written = metrics->bytes_written;
+    state->last_timestamp = current_time;
+    state->initialized = 1;
 
     return 0;
 }
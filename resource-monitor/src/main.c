@@ -1,4 +1,4 @@
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -6,11 +6,27 @@
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <getopt.h>
 #include "monitor.h"
 #include "cgroup.h"
 #include "namespace.h"
+#include "container.h"
+#include "export_pipeline.h"
+#include "capture.h"
+#include "export_delta.h"
+#include "shm_metrics.h"
+#include "openmetrics.h"
+#include "monitor_daemon.h"
+#include "collector_sched.h"
+#include "adaptive_sampling.h"
+#include "self_stats.h"
+#include "experiment.h"
 
 static volatile int keep_running = 1;
 
@@ -27,24 +43,93 @@ void print_usage(const char *program_name) {
     printf("  %s [OPTIONS] <PID | self>\n\n", program_name);
     
     printf("Usage (Execution Mode):\n");
-    printf("  %s [CGROUP_OPTIONS] -- <command> [args...]\n\n", program_name);
+    printf("  %s [CGROUP_OPTIONS] [OPTIONS] -- <command> [args...]\n", program_name);
+    printf("  (the command is sampled live with -i/-m/-o/-f/-s/-q until it exits)\n\n");
+
+    printf("Usage (Parallel Workloads):\n");
+    printf("  %s --manifest <file> [-i <sec>] [-q] [-o <file>]\n\n", program_name);
+
+    printf("Usage (Experiment):\n");
+    printf("  %s --experiment <spec> [-q] [-o <file> [-f csv|json]]\n\n", program_name);
+
+    printf("Usage (Container View):\n");
+    printf("  %s --containers [-i <sec>] [-c <n>]\n\n", program_name);
+
+    printf("Usage (Daemon):\n");
+    printf("  %s --daemon <socket> [-i <sec>] [-o <file>] [--shm <name>] [--metrics-listen <addr>]\n", program_name);
+    printf("     [--workers <n>] [--adaptive <min>:<max>] [--adapt-on <list>] [PID...]\n");
+    printf("  %s --ctl <socket> <command>\n", program_name);
+    printf("  (commands: add pid <PID> | add cgroup <path> [mem=<path>] [stall=<ms>] [interval=<ms>]\n");
+    printf("   [cpu_interval=|mem_interval=|io_interval=<ms>] [collect=cpu,mem,io]\n");
+    printf("   [adaptive=<min>:<max> ms | 0], set <id> ...,\n");
+    printf("   remove <id>, get <id>, list, stats, shutdown)\n");
+    printf("  --workers <n> sets the collection threads (0 = collect in the event loop;\n");
+    printf("  default: one per online CPU, up to 8)\n\n");
+
+    printf("Usage (Capture Conversion):\n");
+    printf("  %s --convert <capture|export> -o <file> [-f csv|json|ndjson]\n", program_name);
+    printf("  (a CSV or NDJSON export, sparse or not, is rewritten as dense rows)\n\n");
     
     printf("Monitoring Options:\n");
     printf("  -i, --interval <sec>   Monitoring interval in seconds (default: 1)\n");
     printf("  -c, --count <n>        Number of samples to collect (default: infinite)\n");
     printf("  -m, --mode <mode>      Monitoring mode: all, cpu, mem, io (default: all)\n");
+    printf("      --collectors <list> Collector units and periods, replacing --mode:\n");
+    printf("                         name[=<sec>],... with stat, status, io, smaps, cgroup, ns\n");
+    printf("                         (e.g. stat,status,smaps=10,ns=60; default period: -i)\n");
+    printf("      --cpu-budget <pct> Cap the collectors' CPU at <pct>%% of one core by stretching\n");
+    printf("                         the periods of the most expensive units first\n");
+    printf("      --adaptive <min>:<max> Shrink the periods toward <min> seconds while CPU%%, RSS or\n");
+    printf("                         cgroup throttling change, grow them toward <max> while steady\n");
+    printf("      --adapt-on <list>  Adaptive thresholds: cpu=<points>,rss=<%%>,throttle=<periods>,\n");
+    printf("                         shrink=<factor>,grow=<factor>,steady=<samples>\n");
+    printf("                         (default: cpu=5,rss=5,throttle=1,shrink=0.25,grow=1.5,steady=3)\n");
     printf("  -o, --output <file>    Export data to file\n");
-    printf("  -f, --format <fmt>     Export format: csv, json (default: csv)\n");
+    printf("  -f, --format <fmt>     Export format: csv, json, ndjson, binary (default: csv)\n");
+    printf("      --flush-interval <ms> Write buffered rows at least this often (default: 1000)\n");
+    printf("      --rotate-size <MB>  Rotate the export file at this size (<file>.1 ... .5)\n");
+    printf("      --rotate-interval <sec> Rotate the export file at this age\n");
+    printf("      --fsync <policy>    fdatasync the export file: none, flush, close (default: none)\n");
+    printf("      --change-only <eps> Only export a sample when a metric moved by more than <eps>\n");
+    printf("                         (relative, e.g. 0.01 = 1%%; 0 = any change; cumulative\n");
+    printf("                         counters compare their rate, not their total)\n");
+    printf("      --heartbeat <sec>   With --change-only, export a sample at least this often\n");
+    printf("                         (default: 60; 0 = never)\n");
+    printf("      --sparse           CSV/NDJSON: write \"=\" (CSV) or omit the key (NDJSON) for\n");
+    printf("                         values equal to the PID's previous row\n");
+    printf("      --export-queue <n>  Samples queued for the export writer thread (default: 1024)\n");
+    printf("      --export-overflow <policy> When the queue is full: block, drop-oldest,\n");
+    printf("                         drop-newest (default: block)\n");
+    printf("      --shm <name>       Publish the latest sample in shared memory (/dev/shm/<name>)\n");
+    printf("                         for local readers (see include/shm_metrics.h)\n");
+    printf("      --metrics-listen <addr> Serve OpenMetrics at http://<addr>/metrics;\n");
+    printf("                         <addr> is PORT, HOST:PORT or unix:/path (localhost by default)\n");
+    printf("      --self-stats       Time every collector and tick (latency histograms, wakeup\n");
+    printf("                         jitter), add the monitor's own CPU, syscalls, faults and\n");
+    printf("                         heap to the summary, and export them as a row for its PID\n");
     printf("  -q, --quiet            Quiet mode (no terminal output)\n");
     printf("  -s, --summary          Show a compact summary instead of detailed reports\n");
     printf("  -N, --namespace        Show namespace information before monitoring\n");
     printf("  -C, --compare <pid2>   Compare namespaces with another PID and exit\n");
+    printf("      --containers       Group all processes into containers (docker, containerd,\n");
+    printf("                         cri-o, podman, systemd units) and show per-container usage\n");
+    printf("      --proc-root <dir>  Read process data from <dir> instead of /proc (e.g. a tree\n");
+    printf("                         recorded by experimentos/snapshot_host.sh)\n");
+    printf("      --cgroup-root <dir> Read cgroups from <dir> instead of /sys/fs/cgroup\n");
     printf("\n");
     
     printf("Cgroup Execution Options:\n");
     printf("      --cgroup-name <name> Name for the new cgroup (default: monitor_cgroup_XXXX)\n");
     printf("      --cpu-limit <cores>  CPU limit in cores (e.g., 0.5, 1.0)\n");
     printf("      --mem-limit <MB>     Memory limit in Megabytes (e.g., 512)\n");
+    printf("      --manifest <file>    Run every workload of the manifest concurrently, each in\n");
+    printf("                           its own cgroup, and compare them (one per line:\n");
+    printf("                           name [cpu=C] [mem=MB] [io=maj:min:rbps:wbps] [cpus=LIST] -- cmd)\n");
+    printf("      --experiment <spec>  Run the conditions of an experiment spec one at a time,\n");
+    printf("                           with warmup and repetitions, and summarize each metric\n");
+    printf("                           with a confidence interval (manifest lines plus\n");
+    printf("                           monitor=<sec>, io=@<path>:rbps:wbps and\n");
+    printf("                           set repetitions=|warmup=|cpus=|confidence=|timeout=)\n");
     printf("\n");
     
     printf("General Options:\n");
@@ -57,6 +142,18 @@ void print_usage(const char *program_name) {
     printf("  %s -C 5678 1234                      Compare namespaces of two processes\n", program_name);
     printf("  %s --cpu-limit 0.5 -- ./my_app        Run './my_app' with a 0.5 CPU core limit\n", program_name);
     printf("  %s --mem-limit 256 -- stress -m 1      Run 'stress' with a 256MB memory limit\n", program_name);
+    printf("  %s --manifest sweep.txt                Run a limit sweep side by side\n", program_name);
+    printf("  %s --experiment exp3.exp -o exp3.csv   Repeated throttling runs with 95%% CIs\n", program_name);
+    printf("  %s --containers -i 1                   Per-container usage every second\n", program_name);
+    printf("  %s -f binary -o run.rmcap 1234         Compact long-running capture\n", program_name);
+    printf("  %s --convert run.rmcap -o run.csv      Convert a capture back to CSV\n", program_name);
+    printf("  %s --change-only 0.01 --sparse -o run.csv 1234  Only rows that changed by 1%%\n", program_name);
+    printf("  %s --collectors stat,smaps=5 --cpu-budget 0.5 1234  PSS every 5s within 0.5%% CPU\n", program_name);
+    printf("  %s --adaptive 0.1:30 -o run.csv 1234   Fine samples only while the process changes\n", program_name);
+    printf("  %s --shm rm-live -q 1234               Serve live samples to local readers\n", program_name);
+    printf("  %s --metrics-listen 9105 -q 1234       Expose metrics to a Prometheus scraper\n", program_name);
+    printf("  %s --daemon /run/rm.sock --metrics-listen 9105  Resident monitor\n", program_name);
+    printf("  %s --ctl /run/rm.sock add pid 1234 interval=250  Start sampling a PID\n", program_name);
     printf("\n");
 }
 
@@ -66,7 +163,640 @@ void print_version(void) {
     printf("Compiled on %s %s\n", __DATE__, __TIME__);
 }
 
-int run_command_in_cgroup(int argc, char *argv[], const char* cgroup_name, double cpu_limit, uint64_t mem_limit_mb) {
+// Options of the sampling loop, shared by monitoring and execution modes
+typedef struct {
+    int interval;
+    int count;
+    int monitor_cpu;
+    int monitor_mem;
+    int monitor_io;
+    const char *output_file;
+    const char *format;
+    const export_writer_config_t *export_config;
+    size_t export_queue;        // Records buffered between the loop and the writer thread
+    export_overflow_t export_overflow;
+    const char *shm_name;       // Live metrics segment, NULL when disabled
+    const char *metrics_listen; // OpenMetrics endpoint, NULL when disabled
+    int workers;                // Daemon collection threads (-1 = one per online CPU, up to 8)
+    const char *collectors;     // --collectors unit list, NULL = stat/status/io from --mode
+    double cpu_budget;          // Collector CPU as a fraction of one core, 0 = unlimited
+    const adaptive_config_t *adaptive;  // Signal-driven intervals, NULL = fixed periods
+    const adaptive_config_t *adaptive_thresholds;   // --adapt-on, also for daemon targets
+    int self_stats;             // Time the collectors and export the monitor's own usage
+    int quiet;
+    int summary;
+} sampling_options_t;
+
+// Child launched by execution mode and the cgroup it runs in
+typedef struct {
+    pid_t pid;
+    int pidfd;                  // -1 when pidfd_open is not available
+    const char *cpu_cgroup_path;
+    const char *mem_cgroup_path;
+    int exited;
+    int status;
+    struct rusage usage;
+} exec_child_t;
+
+/**
+ * Reaps the child with wait4, capturing exit status and rusage
+ * @return 1 if the child has exited, 0 otherwise
+ */
+static int reap_child(exec_child_t *child, int block) {
+    if (child->exited) {
+        return 1;
+    }
+
+    pid_t ret;
+    do {
+        ret = wait4(child->pid, &child->status, block ? 0 : WNOHANG, &child->usage);
+    } while (ret == -1 && errno == EINTR && block);
+
+    if (ret == child->pid) {
+        child->exited = 1;
+    }
+    return child->exited;
+}
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int is_directory(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Sleeps until due_ms (monotonic); with a pidfd it wakes as soon as the child exits
+ */
+static void wait_until(uint64_t due_ms, const exec_child_t *child) {
+    uint64_t now = monotonic_ms();
+    int timeout = due_ms > now ? (int)(due_ms - now) : 0;
+    if (child != NULL && child->pidfd >= 0) {
+        struct pollfd pfd = { .fd = child->pidfd, .events = POLLIN };
+        poll(&pfd, 1, timeout);
+    } else {
+        poll(NULL, 0, timeout);
+    }
+}
+
+/**
+ * Builds the collector schedule: the units named by --collectors, or
+ * stat/status/io from --mode, all at -i unless a unit sets its own period
+ * @return 0 on success, -1 if the unit list is invalid or empty
+ */
+static int setup_collector_sched(collector_sched_t *sched, const sampling_options_t *opts) {
+    uint64_t interval_ms = (uint64_t)opts->interval * 1000;
+    collector_sched_init(sched, monotonic_ms());
+
+    if (opts->collectors != NULL) {
+        if (collector_sched_parse(sched, opts->collectors, interval_ms) != 0) {
+            return -1;
+        }
+    } else {
+        if (opts->monitor_cpu) collector_sched_set_interval(sched, COLLECTOR_UNIT_STAT, interval_ms);
+        if (opts->monitor_mem) collector_sched_set_interval(sched, COLLECTOR_UNIT_STATUS, interval_ms);
+        if (opts->monitor_io) collector_sched_set_interval(sched, COLLECTOR_UNIT_IO, interval_ms);
+    }
+    collector_sched_set_budget(sched, opts->cpu_budget);
+    return collector_sched_next_due(sched) == UINT64_MAX ? -1 : 0;
+}
+
+/**
+ * Interval recorded with an export record: the shortest effective period
+ * among the units that produced it
+ */
+static uint32_t record_interval_ms(const collector_sched_t *sched, uint32_t flags) {
+    static const struct { uint32_t flag; collector_unit_id_t unit; } sources[] = {
+        { EXPORT_HAS_CPU, COLLECTOR_UNIT_STAT },
+        { EXPORT_HAS_MEM, COLLECTOR_UNIT_STATUS },
+        { EXPORT_HAS_IO, COLLECTOR_UNIT_IO },
+    };
+    uint64_t interval = 0;
+    for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+        const collector_unit_t *u = &sched->units[sources[i].unit];
+        if ((flags & sources[i].flag) && (interval == 0 || u->interval_ms < interval)) {
+            interval = u->interval_ms;
+        }
+    }
+    return (uint32_t)interval;
+}
+
+/**
+ * Scales every enabled unit from its configured period by the adaptive
+ * interval relative to -i, keeping the ratios between units
+ */
+static void apply_adaptive_interval(collector_sched_t *sched, const uint64_t *base_ms,
+                                    uint64_t interval_ms, uint64_t adapted_ms) {
+    for (int unit = 0; unit < COLLECTOR_UNIT_COUNT; unit++) {
+        if (base_ms[unit] == 0) continue;
+        uint64_t scaled = base_ms[unit] * adapted_ms / interval_ms;
+        collector_sched_set_interval(sched, (collector_unit_id_t)unit, scaled ? scaled : 1);
+    }
+}
+
+/**
+ * Prints one compact line with the cgroup counters of the current sample
+ */
+static void print_cgroup_sample(const cgroup_metrics_t *metrics) {
+    printf("Cgroup: ");
+    if (metrics->has_cpu) {
+        printf("CPU %.2fs", metrics->cpu.usage_usec / 1000000.0);
+        if (metrics->cpu.nr_periods > 0) {
+            printf(" (throttled %lu/%lu)", metrics->cpu.nr_throttled, metrics->cpu.nr_periods);
+        }
+    }
+    if (metrics->has_memory) {
+        printf(" | MEM %.2f MB (peak %.2f MB)",
+               metrics->memory.current / (1024.0 * 1024.0),
+               metrics->memory.peak / (1024.0 * 1024.0));
+    }
+    printf("\n");
+}
+
+/**
+ * Prints exit status and resource usage reported by wait4
+ */
+static void print_child_rusage(const exec_child_t *child, double wall_seconds) {
+    printf("\n--- Command Resource Usage (wait4) ---\n");
+    if (WIFEXITED(child->status)) {
+        printf("Exit status:        %d\n", WEXITSTATUS(child->status));
+    } else if (WIFSIGNALED(child->status)) {
+        printf("Killed by signal:   %d (%s)\n", WTERMSIG(child->status), strsignal(WTERMSIG(child->status)));
+    }
+    printf("Wall time:          %.3f seconds\n", wall_seconds);
+    printf("User time:          %ld.%06ld seconds\n",
+           (long)child->usage.ru_utime.tv_sec, (long)child->usage.ru_utime.tv_usec);
+    printf("System time:        %ld.%06ld seconds\n",
+           (long)child->usage.ru_stime.tv_sec, (long)child->usage.ru_stime.tv_usec);
+    printf("Max RSS:            %.2f MB\n", child->usage.ru_maxrss / 1024.0);
+    printf("Page faults:        %ld minor, %ld major\n",
+           child->usage.ru_minflt, child->usage.ru_majflt);
+    printf("Context switches:   %ld voluntary, %ld involuntary\n",
+           child->usage.ru_nvcsw, child->usage.ru_nivcsw);
+}
+
+/**
+ * Sampling loop: collects, prints and exports metrics of pid every interval.
+ * In execution mode (child != NULL) it also samples the child's cgroup and
+ * stops the moment the child exits.
+ * @return number of samples collected
+ */
+static int run_sampling_loop(pid_t target_pid, const sampling_options_t *opts,
+                             exec_child_t *child, int *errors_out) {
+    cpu_metrics_t cpu_metrics;
+    memory_metrics_t mem_metrics;
+    io_metrics_t io_metrics;
+
+    const int count = opts->count;
+    const int quiet = opts->quiet;
+    const int summary = opts->summary;
+    const char *output_file = opts->output_file;
+    const char *format = opts->format;
+
+    int samples = 0;
+    int errors = 0;
+    int io_permission_warned = 0;
+
+    // The export file stays open for the whole loop. The loop only copies
+    // each sample into a ring; formatting and write() happen on the writer
+    // thread, so a slow disk or pipe does not stretch the sampling ticks
+    export_writer_t writer;
+    export_pipeline_t pipeline;
+    int exporting = 0;
+    if (strlen(output_file) > 0) {
+        export_writer_config_t config = *opts->export_config;
+        if (export_format_from_string(format, &config.format) == 0 &&
+            export_writer_open(&writer, output_file, &config) == 0) {
+            if (export_pipeline_start(&pipeline, &writer, opts->export_queue,
+                                      opts->export_overflow) == 0) {
+                exporting = 1;
+            } else {
+                perror("Error starting export writer thread");
+                export_writer_close(&writer);
+            }
+        }
+    }
+
+    // Readers map the segment and copy slots under a seqlock; publishing is
+    // a handful of stores, so it stays on the sampling thread
+    shm_metrics_t live;
+    int publishing = 0;
+    if (opts->shm_name != NULL) {
+        if (shm_metrics_create(&live, opts->shm_name, 0) == 0) {
+            publishing = 1;
+        } else {
+            fprintf(stderr, "Error creating shared memory segment %s: %s\n",
+                    opts->shm_name, strerror(errno));
+        }
+    }
+
+    // The page is rendered once per tick; the server thread only sends the
+    // latest page, so scrapers never trigger a collection
+    metrics_server_t server;
+    metrics_target_t *target = NULL;
+    size_t page_size = 0;
+    int serving = 0;
+    if (opts->metrics_listen != NULL) {
+        target = calloc(1, sizeof(*target));
+        if (target != NULL && metrics_server_start(&server, opts->metrics_listen) == 0) {
+            serving = 1;
+            if (!quiet) {
+                printf("Serving OpenMetrics on %s\n", opts->metrics_listen);
+            }
+        } else {
+            fprintf(stderr, "Error listening on %s: %s\n", opts->metrics_listen, strerror(errno));
+        }
+    }
+
+    // Each source runs on its own period; a tick is every wakeup where at
+    // least one unit was due, so -c counts ticks
+    collector_sched_t sched;
+    setup_collector_sched(&sched, opts);
+    char cgroup_mem_path[512] = "";
+    if (sched.units[COLLECTOR_UNIT_CGROUP].requested_ms != 0) {
+        if (child != NULL) {
+            snprintf(cgroup_mem_path, sizeof(cgroup_mem_path), "%s", child->mem_cgroup_path);
+        } else {
+            get_process_cgroup_path(target_pid, detect_cgroup_version() == 1 ? "memory" : NULL,
+                                    cgroup_mem_path, sizeof(cgroup_mem_path));
+        }
+    }
+    process_namespaces_t last_namespaces;
+    int have_namespaces = 0;
+
+    // Adaptive mode rescales the configured periods after every tick that
+    // carried a signal; the budget still applies on top of the result
+    adaptive_state_t adapt;
+    uint64_t base_ms[COLLECTOR_UNIT_COUNT];
+    uint64_t interval_ms = (uint64_t)opts->interval * 1000;
+    if (opts->adaptive != NULL) {
+        adaptive_init(&adapt, opts->adaptive, interval_ms);
+        for (int unit = 0; unit < COLLECTOR_UNIT_COUNT; unit++) {
+            base_ms[unit] = sched.units[unit].requested_ms;
+        }
+        apply_adaptive_interval(&sched, base_ms, interval_ms, adapt.interval_ms);
+        collector_sched_rebalance(&sched);
+    }
+
+    // Self-instrumentation: wall time of every collector and tick, how late
+    // each wakeup was, and the monitor's own usage between ticks
+    self_stats_t self;
+    uint64_t expected_ms = 0;
+    if (opts->self_stats) {
+        self_stats_init(&self);
+    }
+
+    while (keep_running && (count < 0 || samples < count)) {
+        int terminated = (child != NULL) ? reap_child(child, 0) : !process_exists(target_pid);
+        if (terminated) {
+            if (!quiet) {
+                printf("\n⚠️  Process terminated after %d samples.\n", samples);
+            }
+            break;
+        }
+
+        uint64_t now = monotonic_ms();
+        uint32_t due = collector_sched_due(&sched, now);
+        if (due == 0) {
+            expected_ms = collector_sched_next_due(&sched);
+            wait_until(expected_ms, child);
+            continue;
+        }
+        uint64_t tick_start_ns = monotonic_ns();
+        if (opts->self_stats && expected_ms != 0) {
+            uint64_t expected_ns = expected_ms * 1000000ULL;
+            latency_histogram_record(&self.jitter,
+                                     tick_start_ns > expected_ns ? tick_start_ns - expected_ns : 0);
+        }
+
+        cpu_metrics_t *cpu_ptr = NULL;
+        memory_metrics_t *mem_ptr = NULL;
+        io_metrics_t *io_ptr = NULL;
+        memory_smaps_t smaps;
+        cgroup_memory_metrics_t cg_memory;
+        process_namespaces_t namespaces;
+        int have_smaps = 0, have_cg_memory = 0, namespaces_changed = 0;
+
+        // Each unit is timed on the thread CPU clock: the budget is CPU, not wall time
+        for (int unit = 0; unit < COLLECTOR_UNIT_COUNT; unit++) {
+            if (!(due & COLLECTOR_UNIT_BIT(unit))) continue;
+            uint64_t cpu_start = thread_cpu_ns();
+            uint64_t wall_start = opts->self_stats ? monotonic_ns() : 0;
+            int ok = 0;
+            switch (unit) {
+                case COLLECTOR_UNIT_STAT:
+                    ok = collect_cpu_metrics(target_pid, &cpu_metrics) == 0;
+                    if (ok) cpu_ptr = &cpu_metrics;
+                    break;
+                case COLLECTOR_UNIT_STATUS:
+                    ok = collect_memory_metrics(target_pid, &mem_metrics) == 0;
+                    if (ok) mem_ptr = &mem_metrics;
+                    break;
+                case COLLECTOR_UNIT_IO:
+                    ok = collect_io_metrics(target_pid, &io_metrics) == 0;
+                    if (ok) {
+                        io_ptr = &io_metrics;
+                    } else if (!io_permission_warned && !quiet) {
+                        fprintf(stderr, "\n⚠️  Warning: I/O monitoring requires root permissions (sudo)\n");
+                        fprintf(stderr, "   I/O metrics will not be collected.\n\n");
+                        io_permission_warned = 1;
+                    }
+                    break;
+                case COLLECTOR_UNIT_SMAPS:
+                    ok = have_smaps = collect_smaps_rollup(target_pid, &smaps) == 0;
+                    break;
+                case COLLECTOR_UNIT_CGROUP:
+                    ok = have_cg_memory = cgroup_mem_path[0] != '\0' &&
+                         read_cgroup_memory_metrics(cgroup_mem_path, &cg_memory) == 0;
+                    break;
+                case COLLECTOR_UNIT_NAMESPACES:
+                    ok = list_process_namespaces(target_pid, &namespaces) == 0;
+                    if (ok) {
+                        namespaces_changed = !have_namespaces || namespaces.count != last_namespaces.count;
+                        for (int i = 0; i < namespaces.count && !namespaces_changed; i++) {
+                            namespaces_changed = namespaces.namespaces[i].inode !=
+                                                 last_namespaces.namespaces[i].inode;
+                        }
+                        last_namespaces = namespaces;
+                        have_namespaces = 1;
+                    }
+                    break;
+            }
+            collector_sched_record(&sched, (collector_unit_id_t)unit, now, thread_cpu_ns() - cpu_start);
+            if (opts->self_stats) {
+                latency_histogram_record(&self.collect[unit], monotonic_ns() - wall_start);
+            }
+            if (!ok) {
+                errors++;
+            }
+        }
+
+        // Recorded before adapting: the period that led to this sample
+        uint32_t flags = (cpu_ptr ? EXPORT_HAS_CPU : 0) | (mem_ptr ? EXPORT_HAS_MEM : 0) |
+                         (io_ptr ? EXPORT_HAS_IO : 0);
+        uint32_t sample_interval_ms = record_interval_ms(&sched, flags);
+
+        if (opts->adaptive != NULL) {
+            adaptive_signal_t signal = { 0 };
+            if (cpu_ptr) {
+                signal.have |= ADAPTIVE_TRIGGER_CPU;
+                signal.cpu_percent = cpu_ptr->cpu_percent;
+            }
+            if (mem_ptr) {
+                signal.have |= ADAPTIVE_TRIGGER_RSS;
+                signal.rss = mem_ptr->rss;
+            }
+            cgroup_cpu_metrics_t cg_cpu;
+            if (child != NULL && cpu_ptr &&
+                read_cgroup_cpu_metrics(child->cpu_cgroup_path, &cg_cpu) == 0) {
+                signal.have |= ADAPTIVE_TRIGGER_THROTTLE;
+                signal.nr_throttled = cg_cpu.nr_throttled;
+            }
+            uint64_t before = adapt.interval_ms;
+            if (adaptive_update(&adapt, &signal) != before) {
+                apply_adaptive_interval(&sched, base_ms, interval_ms, adapt.interval_ms);
+            }
+        }
+        collector_sched_rebalance(&sched);
+
+        if (!quiet && !summary) {
+            if (samples > 0) printf("\n");
+            printf("=== Sample %d ===\n", samples + 1);
+            int first = 1;
+            if (cpu_ptr) {
+                print_cpu_metrics(cpu_ptr);
+                first = 0;
+            }
+            if (mem_ptr) {
+                if (!first) printf("\n");
+                print_memory_metrics(mem_ptr);
+                double mem_percent = get_memory_usage_percent(mem_ptr);
+                if (mem_percent >= 0) {
+                    printf("  System Usage:     %.2f%%\n", mem_percent);
+                }
+                first = 0;
+            }
+            if (io_ptr) {
+                if (!first) printf("\n");
+                print_io_metrics(io_ptr);
+                first = 0;
+            }
+            if (have_smaps) {
+                if (!first) printf("\n");
+                print_smaps_rollup(&smaps);
+                first = 0;
+            }
+            if (have_cg_memory) {
+                if (!first) printf("\n");
+                printf("Cgroup memory.stat: anon %.2f MB | file %.2f MB | major faults %lu\n",
+                       cg_memory.anon / (1024.0 * 1024.0), cg_memory.file / (1024.0 * 1024.0),
+                       cg_memory.pgmajfault);
+                first = 0;
+            }
+            if (namespaces_changed) {
+                if (!first) printf("\n");
+                print_process_namespaces(&last_namespaces);
+            }
+        }
+
+        if (!quiet && summary && samples > 0 && (cpu_ptr || mem_ptr || io_ptr)) {
+            if (samples % 10 == 0) {
+                printf("\n");
+            }
+            print_metrics_summary(target_pid, cpu_ptr, mem_ptr, io_ptr);
+        }
+
+        if (child != NULL && !quiet) {
+            cgroup_metrics_t cg_metrics;
+            uint64_t cgroup_start = monotonic_ns();
+            int cgroup_ok = read_cgroup_metrics_from_path(child->cpu_cgroup_path, child->mem_cgroup_path,
+                                                          &cg_metrics) == 0;
+            if (opts->self_stats) {
+                latency_histogram_record(&self.collect[COLLECTOR_UNIT_CGROUP], monotonic_ns() - cgroup_start);
+            }
+            if (cgroup_ok) {
+                if (!summary) printf("\n");
+                print_cgroup_sample(&cg_metrics);
+            }
+        }
+
+        if (serving) {
+            memset(target, 0, sizeof(*target));
+            target->pid = target_pid;
+            target->flags = (cpu_ptr ? EXPORT_HAS_CPU : 0) | (mem_ptr ? EXPORT_HAS_MEM : 0) |
+                            (io_ptr ? EXPORT_HAS_IO : 0);
+            if (cpu_ptr) target->cpu = *cpu_ptr;
+            if (mem_ptr) target->mem = *mem_ptr;
+            if (io_ptr) target->io = *io_ptr;
+            metrics_target_collect(target, child ? child->cpu_cgroup_path : NULL,
+                                   child ? child->mem_cgroup_path : NULL);
+            metrics_page_t *page = openmetrics_render(target, 1, page_size);
+            if (page != NULL) {
+                page_size = page->length;
+                metrics_server_publish(&server, page);
+            }
+        }
+
+        if ((exporting || publishing) && (cpu_ptr || mem_ptr || io_ptr)) {
+            export_record_t record;
+            export_record_fill(&record, target_pid, cpu_ptr, mem_ptr, io_ptr);
+            record.interval_ms = sample_interval_ms;
+            if (publishing) {
+                shm_metrics_publish(&live, &record);
+            }
+            if (exporting) {
+                export_pipeline_push(&pipeline, &record);
+            }
+        }
+
+        // The monitor's own row follows the target's, with the usage up to this tick
+        if (opts->self_stats) {
+            self_stats_tick_end(&self, monotonic_ns() - tick_start_ns);
+            if (exporting) {
+                export_record_t record;
+                self_stats_fill_record(&self, &record);
+                record.interval_ms = sample_interval_ms;
+                export_pipeline_push(&pipeline, &record);
+            }
+        }
+
+        samples++;
+
+        if (count < 0 || samples < count) {
+            expected_ms = collector_sched_next_due(&sched);
+            wait_until(expected_ms, child);
+        }
+    }
+
+    if (!quiet && (opts->collectors != NULL || opts->cpu_budget > 0)) {
+        print_collector_sched_report(&sched, monotonic_ms());
+    }
+    if (!quiet && opts->adaptive != NULL) {
+        print_adaptive_report(&adapt);
+    }
+    if (!quiet && opts->self_stats) {
+        print_self_stats_report(&self, &sched);
+    }
+
+    if (publishing) {
+        shm_metrics_destroy(&live);
+    }
+    if (serving) {
+        metrics_server_stop(&server);
+    }
+    free(target);
+
+    if (exporting) {
+        export_pipeline_stats_t stats;
+        export_pipeline_stop(&pipeline);
+        export_pipeline_get_stats(&pipeline, &stats);
+        if (!quiet && writer.delta != NULL && writer.config.change_only) {
+            printf("\nChange-only export: %lu samples written, %lu unchanged samples skipped\n",
+                   writer.delta->emitted, writer.delta->suppressed);
+        }
+        export_writer_close(&writer);
+        if (!quiet && (stats.dropped > 0 || stats.blocked > 0)) {
+            printf("\nExport queue: %lu records written, %lu dropped, %lu blocked pushes (max depth %lu)\n",
+                   stats.written, stats.dropped, stats.blocked, stats.max_depth);
+        }
+    }
+
+    if (errors_out != NULL) {
+        *errors_out = errors;
+    }
+    return samples;
+}
+
+/**
+ * @brief Prints a process's namespaces and how many processes share each one.
+ *
+ * Membership comes from a single namespace index sweep; if the index cannot be
+ * built (or the PID is not in it) only the plain namespace list is printed.
+ * @return 0 on success, -1 if the namespaces could not be read
+ */
+static int show_process_namespaces(pid_t pid) {
+    namespace_index_t index;
+    int have_index = (namespace_index_init(&index, 0) == 0);
+
+    process_namespaces_t ns_info;
+    int result = -1;
+    if (have_index && namespace_index_lookup(&index, pid, &ns_info) == 0) {
+        print_process_namespaces(&ns_info);
+        print_namespace_membership(&index, pid);
+        result = 0;
+    } else if (list_process_namespaces(pid, &ns_info) == 0) {
+        print_process_namespaces(&ns_info);
+        result = 0;
+    }
+
+    if (have_index) {
+        namespace_index_free(&index);
+    }
+    return result;
+}
+
+/**
+ * @brief Container view mode: regroups every process into containers each
+ *        interval and prints per-container usage until interrupted or count
+ *        refreshes have been shown.
+ */
+static int run_container_view(int interval, int count) {
+    container_view_t view;
+    if (container_view_init(&view) != 0) {
+        perror("Error building container view");
+        return EXIT_FAILURE;
+    }
+
+    // First refresh only establishes the baseline for rates
+    if (container_view_refresh(&view) < 0) {
+        perror("Error refreshing container view");
+        container_view_free(&view);
+        return EXIT_FAILURE;
+    }
+
+    int shown = 0;
+    while (keep_running && (count < 0 || shown < count)) {
+        sleep(interval);
+        if (!keep_running) {
+            break;
+        }
+        if (container_view_refresh(&view) < 0) {
+            perror("Error refreshing container view");
+            break;
+        }
+
+        time_t now = time(NULL);
+        char timestamp[32];
+        strftime(timestamp, sizeof(timestamp), "%H:%M:%S", localtime(&now));
+        printf("\n[%s] Containers (%s)\n", timestamp,
+               view.index.events_fd >= 0 ? "process events" : "full rescans");
+        print_container_view(&view, 1);
+        fflush(stdout);
+        shown++;
+    }
+
+    container_view_free(&view);
+    return EXIT_SUCCESS;
+}
+
+int run_command_in_cgroup(int argc, char *argv[], const char* cgroup_name, double cpu_limit, uint64_t mem_limit_mb,
+                          const sampling_options_t *sampling) {
     if (geteuid() != 0) {
         fprintf(stderr, "Error: Cgroup execution mode requires root privileges (sudo).\n");
         return EXIT_FAILURE;
@@ -115,28 +845,46 @@ int run_command_in_cgroup(int argc, char *argv[], const char* cgroup_name, doubl
     for (int i = 0; i < argc; i++) printf("%s ", argv[i]);
     printf("---\n\n");
 
-    pid_t child_pid = fork();
+    // On v2 the child is created directly inside the cgroup (clone3),
+    // otherwise it forks and moves itself before exec
+    cgroup_spawn_method_t spawn_method;
+    pid_t child_pid = spawn_process_in_cgroup(argv, cpu_cgroup_path, mem_cgroup_path,
+                                              CGROUP_SPAWN_AUTO, &spawn_method);
     if (child_pid == -1) {
-        perror("fork");
+        perror("spawn");
+        cleanup_cgroup(final_cgroup_name);
         return EXIT_FAILURE;
     }
 
-    if (child_pid == 0) { // Child process
-        // Move self to the cgroup
-        if (move_process_to_cgroup(getpid(), cpu_cgroup_path) != 0 || move_process_to_cgroup(getpid(), mem_cgroup_path) != 0) {
-            perror("Failed to move child to cgroup");
-            exit(EXIT_FAILURE);
-        }
-        execvp(argv[0], argv);
-        // execvp only returns on error
-        fprintf(stderr, "Error executing command '%s': %s\n", argv[0], strerror(errno));
-        exit(EXIT_FAILURE);
+    // Parent process: sample the child and its cgroup until it exits
+    exec_child_t child = {
+        .pid = child_pid,
+        .pidfd = (int)syscall(SYS_pidfd_open, child_pid, 0),
+        .cpu_cgroup_path = cpu_cgroup_path,
+        .mem_cgroup_path = mem_cgroup_path
+    };
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    signal(SIGINT, sigint_handler);
+    signal(SIGTERM, sigint_handler);
+    int errors = 0;
+    int samples = run_sampling_loop(child_pid, sampling, &child, &errors);
+    reap_child(&child, 1);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    if (child.pidfd >= 0) {
+        close(child.pidfd);
     }
 
-    // Parent process
-    waitpid(child_pid, NULL, 0);
+    print_child_rusage(&child, (end_time.tv_sec - start_time.tv_sec) +
+                               (end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+    printf("Samples collected:  %d (errors: %d)\n", samples, errors);
+    if (strlen(sampling->output_file) > 0) {
+        printf("Data exported to:   %s\n", sampling->output_file);
+    }
 
     printf("\n--- Command Finished. Cgroup Usage Report ---\n");
+    printf("Launch method: %s\n", cgroup_spawn_method_to_string(spawn_method));
     cgroup_metrics_t final_metrics;
     if (read_cgroup_metrics_from_path(cpu_cgroup_path, mem_cgroup_path, &final_metrics) == 0) {
         print_cgroup_metrics(&final_metrics);
@@ -147,6 +895,119 @@ int run_command_in_cgroup(int argc, char *argv[], const char* cgroup_name, doubl
     return EXIT_SUCCESS;
 }
 
+// Resident mode: targets come and go through the control socket, each with
+// its own interval; the outputs are opened once and shared by all of them
+static int run_daemon(const char *socket_path, int pid_count, char **pids,
+                      const sampling_options_t *opts) {
+    // Each target holds a timerfd and a pidfd: on dense nodes the default
+    // soft limit (1024) runs out long before MONITOR_DAEMON_MAX_TARGETS.
+    // Privileged, raise the hard limit to fit them all; otherwise up to it
+    struct rlimit files;
+    rlim_t wanted = 2 * MONITOR_DAEMON_MAX_TARGETS + 256;
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur < wanted) {
+        struct rlimit raised = { wanted, files.rlim_max > wanted ? files.rlim_max : wanted };
+        if (setrlimit(RLIMIT_NOFILE, &raised) != 0 && files.rlim_cur < files.rlim_max) {
+            files.rlim_cur = files.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &files);
+        }
+    }
+
+    monitor_daemon_t monitor;
+    if (monitor_daemon_init(&monitor, socket_path) != 0) {
+        fprintf(stderr, "Error creating control socket %s: %s\n", socket_path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    // --adapt-on thresholds apply to every target that turns on adaptive=;
+    // with --adaptive the initial PIDs start adaptive too
+    const adaptive_config_t *adaptive = opts->adaptive_thresholds;
+    monitor.adaptive = *adaptive;
+
+    uint32_t collect = (opts->monitor_cpu ? EXPORT_HAS_CPU : 0) |
+                       (opts->monitor_mem ? EXPORT_HAS_MEM : 0) |
+                       (opts->monitor_io ? EXPORT_HAS_IO : 0);
+    for (int i = 0; i < pid_count; i++) {
+        pid_t pid = strcmp(pids[i], "self") == 0 ? getpid() : atoi(pids[i]);
+        int id = monitor_daemon_add_pid(&monitor, pid, opts->interval * 1000, collect);
+        if (id >= 0 && opts->adaptive != NULL &&
+            monitor_daemon_set_adaptive(&monitor, id, (int)adaptive->min_ms, (int)adaptive->max_ms) != 0) {
+            id = -1;
+        }
+        if (id < 0) {
+            fprintf(stderr, "Error adding PID '%s': %s\n", pids[i], strerror(errno));
+            monitor_daemon_free(&monitor);
+            return EXIT_FAILURE;
+        }
+    }
+
+    export_writer_t writer;
+    export_pipeline_t pipeline;
+    if (strlen(opts->output_file) > 0) {
+        export_writer_config_t config = *opts->export_config;
+        if (export_format_from_string(opts->format, &config.format) == 0 &&
+            export_writer_open(&writer, opts->output_file, &config) == 0) {
+            if (export_pipeline_start(&pipeline, &writer, opts->export_queue,
+                                      opts->export_overflow) == 0) {
+                monitor.pipeline = &pipeline;
+            } else {
+                perror("Error starting export writer thread");
+                export_writer_close(&writer);
+            }
+        }
+    }
+
+    shm_metrics_t live;
+    if (opts->shm_name != NULL) {
+        if (shm_metrics_create(&live, opts->shm_name, 0) == 0) {
+            monitor.live = &live;
+        } else {
+            fprintf(stderr, "Error creating shared memory segment %s: %s\n",
+                    opts->shm_name, strerror(errno));
+        }
+    }
+
+    metrics_server_t server;
+    if (opts->metrics_listen != NULL) {
+        if (metrics_server_start(&server, opts->metrics_listen) == 0) {
+            monitor.metrics = &server;
+        } else {
+            fprintf(stderr, "Error listening on %s: %s\n", opts->metrics_listen, strerror(errno));
+        }
+    }
+
+    // Slow /proc reads run on the worker threads, not in the event loop
+    int workers = opts->workers;
+    if (workers < 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus < 1 ? 1 : (cpus > 8 ? 8 : (int)cpus);
+    }
+    if (monitor_daemon_set_workers(&monitor, workers) != 0) {
+        fprintf(stderr, "Error starting %d collection thread(s): %s\n", workers, strerror(errno));
+    }
+
+    if (!opts->quiet) {
+        printf("Resource monitor daemon listening on %s (%d initial target(s), %d worker(s))\n",
+               socket_path, monitor.target_count, monitor.pool->worker_count);
+    }
+    signal(SIGINT, sigint_handler);
+    signal(SIGTERM, sigint_handler);
+    signal(SIGPIPE, SIG_IGN);
+    int ret = monitor_daemon_run(&monitor, &keep_running) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if (monitor.metrics != NULL) {
+        metrics_server_stop(&server);
+    }
+    if (monitor.live != NULL) {
+        shm_metrics_destroy(&live);
+    }
+    if (monitor.pipeline != NULL) {
+        export_pipeline_stop(&pipeline);
+        export_writer_close(&writer);
+    }
+    monitor_daemon_free(&monitor);
+    return ret;
+}
+
 int main(int argc, char *argv[]) {
     pid_t target_pid = 0;
     int interval = 1;
@@ -163,6 +1024,26 @@ int main(int argc, char *argv[]) {
     char *cgroup_name = NULL;
     double cpu_limit = 0.0;
     uint64_t mem_limit_mb = 0;
+    const char *manifest_file = NULL;
+    const char *experiment_file = NULL;
+    int container_mode = 0;
+    const char *convert_file = NULL;
+
+    export_writer_config_t export_config;
+    export_writer_config_default(&export_config);
+    long export_queue = 1024;
+    export_overflow_t export_overflow = EXPORT_OVERFLOW_BLOCK;
+    const char *shm_name = NULL;
+    const char *metrics_listen = NULL;
+    const char *daemon_socket = NULL;
+    const char *ctl_socket = NULL;
+    long workers = -1;
+    const char *collectors = NULL;
+    double cpu_budget = 0.0;
+    adaptive_config_t adaptive;
+    adaptive_config_default(&adaptive);
+    int adaptive_mode = 0;
+    int self_stats = 0;
 
     static struct option long_options[] = {
         {"interval",  required_argument, 0, 'i'},
@@ -180,6 +1061,32 @@ int main(int argc, char *argv[]) {
         {"cgroup-name", required_argument, 0, 256},
         {"cpu-limit",   required_argument, 0, 257},
         {"mem-limit",   required_argument, 0, 258},
+        {"manifest",    required_argument, 0, 259},
+        {"containers",  no_argument,       0, 260},
+        // Export options
+        {"flush-interval",  required_argument, 0, 261},
+        {"rotate-size",     required_argument, 0, 262},
+        {"rotate-interval", required_argument, 0, 263},
+        {"fsync",           required_argument, 0, 264},
+        {"export-queue",    required_argument, 0, 265},
+        {"export-overflow", required_argument, 0, 266},
+        {"convert",         required_argument, 0, 267},
+        {"shm",             required_argument, 0, 268},
+        {"metrics-listen",  required_argument, 0, 269},
+        {"daemon",          required_argument, 0, 270},
+        {"ctl",             required_argument, 0, 271},
+        {"workers",         required_argument, 0, 272},
+        {"collectors",      required_argument, 0, 273},
+        {"cpu-budget",      required_argument, 0, 274},
+        {"adaptive",        required_argument, 0, 275},
+        {"adapt-on",        required_argument, 0, 276},
+        {"change-only",     required_argument, 0, 277},
+        {"heartbeat",       required_argument, 0, 278},
+        {"sparse",          no_argument,       0, 279},
+        {"self-stats",      no_argument,       0, 280},
+        {"proc-root",       required_argument, 0, 281},
+        {"cgroup-root",     required_argument, 0, 282},
+        {"experiment",      required_argument, 0, 283},
         {0, 0, 0, 0}
     };
 
@@ -230,7 +1137,8 @@ int main(int argc, char *argv[]) {
             case 'f':
                 strncpy(format, optarg, sizeof(format) - 1);
                 format[sizeof(format) - 1] = '\0';
-                if (strcmp(format, "csv") != 0 && strcmp(format, "json") != 0) {
+                export_format_t parsed_format;
+                if (export_format_from_string(format, &parsed_format) != 0) {
                     fprintf(stderr, "Error: invalid format '%s'\n", format);
                     return EXIT_FAILURE;
                 }
@@ -266,6 +1174,140 @@ int main(int argc, char *argv[]) {
             case 258: // --mem-limit
                 mem_limit_mb = atoll(optarg);
                 break;
+            case 259: // --manifest
+                manifest_file = optarg;
+                break;
+            case 283: // --experiment
+                experiment_file = optarg;
+                break;
+            case 260: // --containers
+                container_mode = 1;
+                break;
+
+            // Export options (long only)
+            case 261: // --flush-interval
+                export_config.flush_interval_ms = atoi(optarg);
+                if (export_config.flush_interval_ms < 0) {
+                    fprintf(stderr, "Error: flush interval must not be negative.\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 262: // --rotate-size
+                export_config.rotate_bytes = (uint64_t)(atof(optarg) * 1024 * 1024);
+                break;
+            case 263: // --rotate-interval
+                export_config.rotate_seconds = atoi(optarg);
+                break;
+            case 264: // --fsync
+                if (export_sync_from_string(optarg, &export_config.sync) != 0) {
+                    fprintf(stderr, "Error: invalid fsync policy '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 265: // --export-queue
+                export_queue = atol(optarg);
+                if (export_queue <= 0) {
+                    fprintf(stderr, "Error: export queue size must be positive.\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 266: // --export-overflow
+                if (export_overflow_from_string(optarg, &export_overflow) != 0) {
+                    fprintf(stderr, "Error: invalid overflow policy '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 273: { // --collectors
+                collector_sched_t check;
+                collector_sched_init(&check, 0);
+                if (collector_sched_parse(&check, optarg, 1000) != 0) {
+                    fprintf(stderr, "Error: invalid collector list '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                collectors = optarg;
+                break;
+            }
+            case 274: { // --cpu-budget
+                char *end;
+                cpu_budget = strtod(optarg, &end);
+                if (end == optarg || (*end != '\0' && strcmp(end, "%") != 0) ||
+                    !(cpu_budget > 0) || cpu_budget > 100) {
+                    fprintf(stderr, "Error: CPU budget must be a percentage of one core (0-100].\n");
+                    return EXIT_FAILURE;
+                }
+                cpu_budget /= 100.0;
+                break;
+            }
+            case 275: // --adaptive
+                if (adaptive_parse_range(&adaptive, optarg) != 0) {
+                    fprintf(stderr, "Error: --adaptive takes <min>:<max> in seconds (min <= max).\n");
+                    return EXIT_FAILURE;
+                }
+                adaptive_mode = 1;
+                break;
+            case 276: // --adapt-on
+                if (adaptive_parse_thresholds(&adaptive, optarg) != 0) {
+                    fprintf(stderr, "Error: invalid adaptive thresholds '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 277: { // --change-only
+                char *end;
+                export_config.change_epsilon = strtod(optarg, &end);
+                if (*optarg == '\0' || *end != '\0' || !(export_config.change_epsilon >= 0)) {
+                    fprintf(stderr, "Error: --change-only takes a relative change >= 0 (e.g. 0.01).\n");
+                    return EXIT_FAILURE;
+                }
+                export_config.change_only = 1;
+                break;
+            }
+            case 278: // --heartbeat
+                if (atof(optarg) < 0) {
+                    fprintf(stderr, "Error: heartbeat must not be negative.\n");
+                    return EXIT_FAILURE;
+                }
+                export_config.heartbeat_ms = (int)(atof(optarg) * 1000);
+                break;
+            case 279: // --sparse
+                export_config.sparse = 1;
+                break;
+            case 280: // --self-stats
+                self_stats = 1;
+                break;
+            case 281: // --proc-root
+            case 282: // --cgroup-root
+                if (!is_directory(optarg) ||
+                    (opt == 281 ? set_proc_root(optarg) : set_cgroup_root(optarg)) != 0) {
+                    fprintf(stderr, "Error: %s is not a directory.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 268: // --shm
+                shm_name = optarg;
+                break;
+            case 269: // --metrics-listen
+                metrics_listen = optarg;
+                break;
+
+            // Daemon (long only)
+            case 270: // --daemon
+                daemon_socket = optarg;
+                break;
+            case 271: // --ctl
+                ctl_socket = optarg;
+                break;
+            case 272: // --workers
+                workers = atol(optarg);
+                if (workers < 0 || workers > 64) {
+                    fprintf(stderr, "Error: workers must be 0..64.\n");
+                    return EXIT_FAILURE;
+                }
+                break;
+
+            // Capture conversion (long only)
+            case 267: // --convert
+                convert_file = optarg;
+                break;
             case 'h':
                 print_usage(argv[0]);
                 return EXIT_SUCCESS;
@@ -280,8 +1322,146 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    sampling_options_t sampling = {
+        .interval = interval,
+        .count = count,
+        .monitor_cpu = (strcmp(mode, "all") == 0 || strcmp(mode, "cpu") == 0),
+        .monitor_mem = (strcmp(mode, "all") == 0 || strcmp(mode, "mem") == 0),
+        .monitor_io = (strcmp(mode, "all") == 0 || strcmp(mode, "io") == 0),
+        .output_file = output_file,
+        .format = format,
+        .export_config = &export_config,
+        .export_queue = (size_t)export_queue,
+        .export_overflow = export_overflow,
+        .shm_name = shm_name,
+        .metrics_listen = metrics_listen,
+        .workers = (int)workers,
+        .collectors = collectors,
+        .cpu_budget = cpu_budget,
+        .adaptive = adaptive_mode ? &adaptive : NULL,
+        .adaptive_thresholds = &adaptive,
+        .self_stats = self_stats,
+        .quiet = quiet,
+        .summary = summary
+    };
+
     // --- Mode Dispatch ---
-    if (double_dash_index != -1) {
+    if (ctl_socket != NULL) {
+        if (optind >= argc) {
+            fprintf(stderr, "Error: --ctl needs a command (try 'list').\n");
+            return EXIT_FAILURE;
+        }
+        char command[MONITOR_DAEMON_LINE_MAX] = "";
+        size_t used = 0;
+        for (int i = optind; i < argc && used < sizeof(command); i++) {
+            used += (size_t)snprintf(command + used, sizeof(command) - used, "%s%s",
+                                     i > optind ? " " : "", argv[i]);
+        }
+        int result = monitor_daemon_control(ctl_socket, command, stdout);
+        if (result < 0) {
+            fprintf(stderr, "Error talking to %s: %s\n", ctl_socket, strerror(errno));
+        }
+        return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else if (daemon_socket != NULL) {
+        if (manifest_file != NULL || container_mode || double_dash_index != -1) {
+            fprintf(stderr, "Error: --daemon cannot be combined with a command, --manifest or --containers.\n");
+            return EXIT_FAILURE;
+        }
+        return run_daemon(daemon_socket, argc - optind, &argv[optind], &sampling);
+    } else if (convert_file != NULL) {
+        export_format_t out_format;
+        if (strlen(output_file) == 0 || double_dash_index != -1 || optind < argc) {
+            fprintf(stderr, "Error: --convert needs -o <file> and no PID or command.\n");
+            return EXIT_FAILURE;
+        }
+        if (export_format_from_string(format, &out_format) != 0 || out_format == EXPORT_FORMAT_BINARY) {
+            fprintf(stderr, "Error: captures convert to csv, json or ndjson.\n");
+            return EXIT_FAILURE;
+        }
+        // Captures start with their magic; anything else is read as a text export
+        char magic[5] = {0};
+        FILE *probe = fopen(convert_file, "rb");
+        if (probe != NULL) {
+            if (fread(magic, 1, sizeof(magic), probe) != sizeof(magic)) {
+                magic[0] = '\0';
+            }
+            fclose(probe);
+        }
+        long converted = memcmp(magic, "RMCAP", sizeof(magic)) == 0 || probe == NULL
+                             ? capture_convert(convert_file, output_file, out_format)
+                             : export_densify(convert_file, output_file, out_format);
+        if (converted < 0) {
+            return EXIT_FAILURE;
+        }
+        printf("Converted %ld samples to %s (%s)\n", converted, output_file, format);
+        return EXIT_SUCCESS;
+    } else if (container_mode) {
+        if (manifest_file != NULL || double_dash_index != -1 || optind < argc) {
+            fprintf(stderr, "Error: --containers cannot be combined with a PID, a command or --manifest.\n");
+            return EXIT_FAILURE;
+        }
+        signal(SIGINT, sigint_handler);
+        return run_container_view(interval, count);
+    } else if (experiment_file != NULL) {
+        if (manifest_file != NULL || double_dash_index != -1 || optind < argc) {
+            fprintf(stderr, "Error: --experiment cannot be combined with a PID, a command or --manifest.\n");
+            return EXIT_FAILURE;
+        }
+        experiment_spec_t *spec = calloc(1, sizeof(experiment_spec_t));
+        if (spec == NULL) {
+            perror("calloc");
+            return EXIT_FAILURE;
+        }
+        // Conditions with monitor= are watched by this same binary
+        char self_exe[PATH_MAX];
+        ssize_t len = readlink("/proc/self/exe", self_exe, sizeof(self_exe) - 1);
+        if (len < 0) {
+            strncpy(self_exe, argv[0], sizeof(self_exe) - 1);
+            self_exe[sizeof(self_exe) - 1] = '\0';
+        } else {
+            self_exe[len] = '\0';
+        }
+        int ret = EXIT_FAILURE;
+        if (load_experiment_spec(experiment_file, spec) == 0) {
+            signal(SIGINT, sigint_handler);
+            int result = run_experiment(spec, self_exe, quiet, &keep_running);
+            if (result == 0 || !keep_running) {
+                print_experiment_summary(spec);
+                if (strlen(output_file) > 0 &&
+                    write_experiment_results(spec, output_file, format) == 0) {
+                    printf("\nResults written to %s\n", output_file);
+                }
+            }
+            if (result == 0) {
+                ret = EXIT_SUCCESS;
+            }
+        }
+        free_experiment_spec(spec);
+        free(spec);
+        return ret;
+    } else if (manifest_file != NULL) {
+        // Parallel workloads mode
+        if (double_dash_index != -1 || optind < argc) {
+            fprintf(stderr, "Error: --manifest cannot be combined with a PID or a command.\n");
+            return EXIT_FAILURE;
+        }
+        workload_t *workloads = calloc(MAX_WORKLOADS, sizeof(workload_t));
+        if (workloads == NULL) {
+            perror("calloc");
+            return EXIT_FAILURE;
+        }
+        int workload_count = 0;
+        int ret = EXIT_FAILURE;
+        if (load_workload_manifest(manifest_file, workloads, MAX_WORKLOADS, &workload_count) == 0) {
+            signal(SIGINT, sigint_handler);
+            if (run_workloads(workloads, workload_count, interval, quiet, output_file,
+                              &keep_running) == 0) {
+                ret = EXIT_SUCCESS;
+            }
+        }
+        free(workloads);
+        return ret;
+    } else if (double_dash_index != -1) {
         // Execution Mode
         // Check if monitoring-specific arguments were passed erroneously
         if (optind < double_dash_index) {
@@ -289,7 +1469,7 @@ int main(int argc, char *argv[]) {
             print_usage(argv[0]);
             return EXIT_FAILURE;
         }
-        return run_command_in_cgroup(argc - double_dash_index - 1, &argv[double_dash_index + 1], cgroup_name, cpu_limit, mem_limit_mb);
+        return run_command_in_cgroup(argc - double_dash_index - 1, &argv[double_dash_index + 1], cgroup_name, cpu_limit, mem_limit_mb, &sampling);
     } else {
         // Monitoring Mode
         if (optind >= argc) {
@@ -324,22 +1504,30 @@ int main(int argc, char *argv[]) {
             
             namespace_comparison_t comparisons[MAX_NAMESPACES];
             int comp_count;
-            
-            if (compare_process_namespaces(target_pid, compare_pid, comparisons, &comp_count) == 0) {
+            namespace_index_t index;
+            int have_index = (namespace_index_init(&index, 0) == 0);
+
+            // Index gives member counts too; fall back to direct stat() if
+            // either PID could not be indexed (e.g. permissions)
+            if (have_index &&
+                namespace_index_compare(&index, target_pid, compare_pid, comparisons, &comp_count) == 0) {
+                print_namespace_comparison(target_pid, compare_pid, comparisons, comp_count);
+                print_namespace_membership(&index, target_pid);
+                print_namespace_membership(&index, compare_pid);
+            } else if (compare_process_namespaces(target_pid, compare_pid, comparisons, &comp_count) == 0) {
                 print_namespace_comparison(target_pid, compare_pid, comparisons, comp_count);
             } else {
                 fprintf(stderr, "Error comparing namespaces\n");
+                if (have_index) namespace_index_free(&index);
                 return EXIT_FAILURE;
             }
+            if (have_index) namespace_index_free(&index);
             return EXIT_SUCCESS;
         }
 
         // Se só quer ver namespace, mostrar e sair
         if (show_namespace && count < 0) {
-            process_namespaces_t ns_info;
-            if (list_process_namespaces(target_pid, &ns_info) == 0) {
-                print_process_namespaces(&ns_info);
-            } else {
+            if (show_process_namespaces(target_pid) != 0) {
                 fprintf(stderr, "Error listing namespaces\n");
                 return EXIT_FAILURE;
             }
@@ -375,108 +1563,17 @@ int main(int argc, char *argv[]) {
             // Mostrar namespace info no início se solicitado
             if (show_namespace) {
                 printf("\n");
-                process_namespaces_t ns_info;
-                if (list_process_namespaces(target_pid, &ns_info) == 0) {
-                    print_process_namespaces(&ns_info);
-                }
+                show_process_namespaces(target_pid);
             }
             
             printf("\n");
         }
 
         signal(SIGINT, sigint_handler);
+        signal(SIGTERM, sigint_handler);
 
-        cpu_metrics_t cpu_metrics;
-        memory_metrics_t mem_metrics;
-        io_metrics_t io_metrics;
-
-        int monitor_cpu = (strcmp(mode, "all") == 0 || strcmp(mode, "cpu") == 0);
-        int monitor_mem = (strcmp(mode, "all") == 0 || strcmp(mode, "mem") == 0);
-        int monitor_io = (strcmp(mode, "all") == 0 || strcmp(mode, "io") == 0);
-
-        int samples = 0;
         int errors = 0;
-        int io_permission_warned = 0;
-
-        while (keep_running && (count < 0 || samples < count)) {
-            if (!process_exists(target_pid)) {
-                if (!quiet) {
-                    printf("\n⚠️  Process terminated after %d samples.\n", samples);
-                }
-                break;
-            }
-
-            cpu_metrics_t *cpu_ptr = NULL;
-            memory_metrics_t *mem_ptr = NULL;
-            io_metrics_t *io_ptr = NULL;
-
-            if (monitor_cpu) {
-                if (collect_cpu_metrics(target_pid, &cpu_metrics) == 0) {
-                    cpu_ptr = &cpu_metrics;
-                    if (!quiet && !summary) {
-                        if (samples > 0) printf("\n");
-                        printf("=== Sample %d ===\n", samples + 1);
-                        print_cpu_metrics(&cpu_metrics);
-                    }
-                } else {
-                    errors++;
-                }
-            }
-
-            if (monitor_mem) {
-                if (collect_memory_metrics(target_pid, &mem_metrics) == 0) {
-                    mem_ptr = &mem_metrics;
-                    if (!quiet && !summary) {
-                        printf("\n");
-                        print_memory_metrics(&mem_metrics);
-                        double mem_percent = get_memory_usage_percent(&mem_metrics);
-                        if (mem_percent >= 0) {
-                            printf("  System Usage:     %.2f%%\n", mem_percent);
-                        }
-                    }
-                } else {
-                    errors++;
-                }
-            }
-
-            if (monitor_io) {
-                if (collect_io_metrics(target_pid, &io_metrics) == 0) {
-                    io_ptr = &io_metrics;
-                    if (!quiet && !summary) {
-                        printf("\n");
-                        print_io_metrics(&io_metrics);
-                    }
-                } else {
-                    if (!io_permission_warned && !quiet) {
-                        fprintf(stderr, "\n⚠️  Warning: I/O monitoring requires root permissions (sudo)\n");
-                        fprintf(stderr, "   I/O metrics will not be collected.\n\n");
-                        io_permission_warned = 1;
-                    }
-                    errors++;
-                }
-            }
-
-            if (!quiet && summary && samples > 0) {
-                if (samples % 10 == 0) {
-                    printf("\n");
-                }
-                print_metrics_summary(target_pid, cpu_ptr, mem_ptr, io_ptr);
-            }
-
-            if (strlen(output_file) > 0) {
-                if (strcmp(format, "csv") == 0) {
-                    export_metrics_csv(output_file, target_pid, cpu_ptr, mem_ptr, io_ptr);
-                } else if (strcmp(format, "json") == 0) {
-                    export_metrics_json(output_file, target_pid, cpu_ptr, mem_ptr, io_ptr);
-                }
-            }
-
-            samples++;
-
-            if (count < 0 || samples < count) {
-                sleep(interval);
-            }
-        }
+        int samples = run_sampling_loop(target_pid, &sampling, NULL, &errors);
 
         if (!quiet) {
             printf("\n");
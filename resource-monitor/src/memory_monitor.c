@@ -5,6 +5,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <limits.h>
 #include <time.h>
 
 /**
@@ -25,8 +26,8 @@ int collect_memory_metrics(pid_t pid, memory_metrics_t *metrics) {
     memset(metrics, 0, sizeof(memory_metrics_t));
 
     // === Ler /proc/[pid]/status para informações detalhadas ===
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%d/status", proc_root(), pid);
 
     FILE *fp = fopen(path, "r");
     if (fp == NULL) {
@@ -59,7 +60,7 @@ int collect_memory_metrics(pid_t pid, memory_metrics_t *metrics) {
     fclose(fp);
 
     // === Ler /proc/[pid]/stat para page faults ===
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    snprintf(path, sizeof(path), "%s/%d/stat", proc_root(), pid);
     fp = fopen(path, "r");
     if (fp == NULL) {
         fprintf(stderr, "Error opening %s: %s\n", path, strerror(errno));
@@ -148,6 +149,65 @@ void print_memory_metrics(const memory_metrics_t *metrics) {
     printf("  Page Faults:      %lu\n", metrics->page_faults);
 }
 
+/**
+ * Lê os totais de /proc/[pid]/smaps_rollup (kernel 4.14+)
+ *
+ * @param pid Process ID a ser monitorado
+ * @param smaps Estrutura que receberá os totais em bytes
+ * @return 0 em sucesso, -1 em erro
+ */
+int collect_smaps_rollup(pid_t pid, memory_smaps_t *smaps) {
+    if (smaps == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    memset(smaps, 0, sizeof(*smaps));
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%d/smaps_rollup", proc_root(), pid);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char key[64];
+        unsigned long value;
+        if (sscanf(line, "%63[^:]: %lu kB", key, &value) != 2) {
+            continue;
+        }
+        uint64_t bytes = (uint64_t)value * 1024;
+        if (strcmp(key, "Rss") == 0) smaps->rss = bytes;
+        else if (strcmp(key, "Pss") == 0) smaps->pss = bytes;
+        else if (strcmp(key, "Shared_Clean") == 0 || strcmp(key, "Shared_Dirty") == 0) smaps->shared += bytes;
+        else if (strcmp(key, "Private_Clean") == 0 || strcmp(key, "Private_Dirty") == 0) smaps->private_bytes += bytes;
+        else if (strcmp(key, "Swap") == 0) smaps->swap = bytes;
+        else if (strcmp(key, "SwapPss") == 0) smaps->swap_pss = bytes;
+    }
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * Imprime os totais de smaps_rollup formatados
+ */
+void print_smaps_rollup(const memory_smaps_t *smaps) {
+    if (smaps == NULL) {
+        return;
+    }
+
+    char pss_str[64], uss_str[64], shared_str[64];
+    format_memory_size(smaps->pss, pss_str, sizeof(pss_str));
+    format_memory_size(smaps->private_bytes, uss_str, sizeof(uss_str));
+    format_memory_size(smaps->shared, shared_str, sizeof(shared_str));
+
+    printf("Memory Map (smaps_rollup):\n");
+    printf("  PSS:              %s (%lu bytes)\n", pss_str, smaps->pss);
+    printf("  USS (Private):    %s (%lu bytes)\n", uss_str, smaps->private_bytes);
+    printf("  Shared:           %s (%lu bytes)\n", shared_str, smaps->shared);
+}
+
 /**
  * Calcula percentual de memória usada em relação ao total do sistema
  */
@@ -157,7 +217,9 @@ double get_memory_usage_percent(const memory_metrics_t *metrics) {
     }
 
     // Ler memória total do sistema de /proc/meminfo
-    FILE *fp = fopen("/proc/meminfo", "r");
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/meminfo", proc_root());
+    FILE *fp = fopen(path, "r");
     if (fp == NULL) {
         return -1.0;
     }
@@ -0,0 +1,1630 @@
+#define _GNU_SOURCE
+#include "monitor_daemon.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define COLLECT_ALL (EXPORT_HAS_CPU | EXPORT_HAS_MEM | EXPORT_HAS_IO)
+
+static const char *const collector_names[DAEMON_COLLECTORS] = { "cpu", "mem", "io" };
+static const char *const pressure_files[DAEMON_COLLECTORS] = {
+    "cpu.pressure", "memory.pressure", "io.pressure"
+};
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int monitor_daemon_parse_collect(const char *list, uint32_t *collect) {
+    if (list == NULL || collect == NULL) {
+        return -1;
+    }
+
+    char copy[64];
+    snprintf(copy, sizeof(copy), "%s", list);
+    uint32_t mask = 0;
+    char *saveptr = NULL;
+    for (char *name = strtok_r(copy, ",", &saveptr); name != NULL;
+         name = strtok_r(NULL, ",", &saveptr)) {
+        if (strcmp(name, "cpu") == 0) {
+            mask |= EXPORT_HAS_CPU;
+        } else if (strcmp(name, "mem") == 0) {
+            mask |= EXPORT_HAS_MEM;
+        } else if (strcmp(name, "io") == 0) {
+            mask |= EXPORT_HAS_IO;
+        } else if (strcmp(name, "all") == 0) {
+            mask |= COLLECT_ALL;
+        } else {
+            return -1;
+        }
+    }
+    if (mask == 0) {
+        return -1;
+    }
+    *collect = mask;
+    return 0;
+}
+
+static void collect_to_string(uint32_t collect, char *out, size_t size) {
+    snprintf(out, size, "%s%s%s",
+             (collect & EXPORT_HAS_CPU) ? "cpu," : "",
+             (collect & EXPORT_HAS_MEM) ? "mem," : "",
+             (collect & EXPORT_HAS_IO) ? "io," : "");
+    size_t len = strlen(out);
+    if (len > 0) out[len - 1] = '\0';
+}
+
+static int collector_interval(const daemon_target_t *target, int collector) {
+    return target->collector_interval_ms[collector] ? target->collector_interval_ms[collector]
+                                                    : target->interval_ms;
+}
+
+/**
+ * Cadência efetiva: com amostragem adaptativa, base escalada pela razão
+ * entre o intervalo adaptado e o intervalo padrão do alvo
+ */
+static int scaled_interval(const daemon_target_t *target, int base_ms) {
+    if (!target->adaptive) {
+        return base_ms;
+    }
+    uint64_t scaled = (uint64_t)base_ms * target->adapt.interval_ms / (uint64_t)target->interval_ms;
+    if (scaled < MONITOR_DAEMON_MIN_INTERVAL_MS) return MONITOR_DAEMON_MIN_INTERVAL_MS;
+    if (scaled > 86400000) return 86400000;
+    return (int)scaled;
+}
+
+static int valid_interval(int interval_ms) {
+    return interval_ms >= MONITOR_DAEMON_MIN_INTERVAL_MS && interval_ms <= 86400000;
+}
+
+// ----------------------------------------------------------------------------
+// Coleta
+// ----------------------------------------------------------------------------
+
+static void remove_timers(daemon_target_t *target) {
+    for (int i = 0; i < target->timer_count; i++) {
+        event_loop_remove(target->timers[i].source);
+    }
+    target->timer_count = 0;
+}
+
+static void remove_psi(daemon_target_t *target) {
+    for (int i = 0; i < DAEMON_COLLECTORS; i++) {
+        event_loop_remove(target->psi_sources[i]);
+        target->psi_sources[i] = NULL;
+    }
+    target->stall_ms = 0;
+}
+
+static void unqueue(daemon_target_t *target) {
+    monitor_daemon_t *monitor = target->monitor;
+    if (target->queued_mask != 0 && !target->in_flight) {
+        for (int i = 0; i < monitor->pending_count; i++) {
+            if (monitor->pending[i] == target) {
+                monitor->pending[i] = monitor->pending[--monitor->pending_count];
+                break;
+            }
+        }
+    }
+    target->queued_mask = 0;
+}
+
+static void mark_exited(monitor_daemon_t *monitor, daemon_target_t *target) {
+    target->exited = 1;
+    remove_timers(target);
+    unqueue(target);
+    event_loop_remove(target->exit_source);
+    target->exit_source = NULL;
+    if (monitor->live != NULL) {
+        shm_metrics_remove(monitor->live, target->pid);
+    }
+}
+
+/**
+ * Worker: lê /proc/<pid> usando só o estado de taxas do alvo
+ */
+static void collect_pid(daemon_job_t *job, daemon_target_t *target) {
+    if (!process_exists(target->pid)) {
+        job->gone = 1;
+        return;
+    }
+
+    cpu_metrics_t cpu;
+    memory_metrics_t mem;
+    io_metrics_t io;
+    const cpu_metrics_t *cpu_ptr = NULL;
+    const memory_metrics_t *mem_ptr = NULL;
+    const io_metrics_t *io_ptr = NULL;
+
+    if (job->mask & EXPORT_HAS_CPU) {
+        if (collect_cpu_metrics_r(target->pid, &cpu, &target->cpu_rate) == 0) cpu_ptr = &cpu;
+        else job->errors++;
+    }
+    if (job->mask & EXPORT_HAS_MEM) {
+        if (collect_memory_metrics(target->pid, &mem) == 0) mem_ptr = &mem;
+        else job->errors++;
+    }
+    if (job->mask & EXPORT_HAS_IO) {
+        if (collect_io_metrics_r(target->pid, &io, &target->io_rate) == 0) io_ptr = &io;
+        else job->errors++;
+    }
+    export_record_fill(&job->fresh, target->pid, cpu_ptr, mem_ptr, io_ptr);
+
+    if (job->want_view && job->fresh.flags != 0) {
+        memset(&job->view, 0, sizeof(job->view));
+        job->view.pid = target->pid;
+        metrics_target_collect(&job->view, NULL, NULL);
+    }
+}
+
+/**
+ * Worker: lê os arquivos do cgroup dos grupos pedidos
+ */
+static void collect_cgroup(daemon_job_t *job, daemon_target_t *target) {
+    cgroup_metrics_t *cg = &job->cgroup;
+    cg->has_cpu = cg->has_pids = cg->has_memory = cg->has_blkio = 0;
+
+    if (job->mask & EXPORT_HAS_CPU) {
+        cg->has_cpu = read_cgroup_cpu_metrics(target->cpu_path, &cg->cpu) == 0;
+        cg->has_pids = read_cgroup_pids_metrics(target->cpu_path, &cg->pids) == 0;
+        if (!cg->has_cpu) job->errors++;
+    }
+    if (job->mask & EXPORT_HAS_MEM) {
+        cg->has_memory = read_cgroup_memory_metrics(target->mem_path, &cg->memory) == 0;
+        if (!cg->has_memory) job->errors++;
+    }
+    if (job->mask & EXPORT_HAS_IO) {
+        cg->has_blkio = read_cgroup_blkio_metrics(target->cpu_path, &cg->blkio) == 0;
+        if (!cg->has_blkio) job->errors++;
+    }
+}
+
+static void collect_job(void *data, collector_worker_t *worker) {
+    (void)worker;
+    daemon_job_t *job = data;
+    job->now_ns = monotonic_ns();
+    job->gone = 0;
+    job->errors = 0;
+
+    if (job->target->kind == DAEMON_TARGET_PID) {
+        collect_pid(job, job->target);
+    } else {
+        collect_cgroup(job, job->target);
+    }
+}
+
+/**
+ * Laço: incorpora a coleta de um PID em last e publica
+ */
+static void finish_pid(monitor_daemon_t *monitor, daemon_target_t *target, const daemon_job_t *job) {
+    if (job->gone) {
+        mark_exited(monitor, target);
+        return;
+    }
+
+    // A exportação recebe só o que foi coletado agora; last guarda o valor
+    // mais recente de cada coletor para get, shm e a página
+    const export_record_t *fresh = &job->fresh;
+    if (fresh->flags == 0) {
+        return;
+    }
+    export_record_t *last = &target->last;
+    last->realtime_ns = fresh->realtime_ns;
+    last->monotonic_ns = fresh->monotonic_ns;
+    last->pid = fresh->pid;
+    last->flags |= fresh->flags;
+    last->interval_ms = fresh->interval_ms;
+    if (fresh->flags & EXPORT_HAS_CPU) last->cpu = fresh->cpu;
+    if (fresh->flags & EXPORT_HAS_MEM) last->mem = fresh->mem;
+    if (fresh->flags & EXPORT_HAS_IO) last->io = fresh->io;
+
+    if (monitor->pipeline != NULL) {
+        export_pipeline_push(monitor->pipeline, fresh);
+    }
+    if (monitor->live != NULL) {
+        shm_metrics_publish(monitor->live, last);
+    }
+    if (monitor->metrics != NULL) {
+        metrics_target_t *view = &monitor->views[target->index];
+        *view = job->view;
+        view->flags = last->flags;
+        view->cpu = last->cpu;
+        view->mem = last->mem;
+        view->io = last->io;
+    }
+}
+
+static void finish_cgroup(monitor_daemon_t *monitor, daemon_target_t *target, const daemon_job_t *job) {
+    cgroup_metrics_t *cg = &target->cgroup;
+    const cgroup_metrics_t *fresh = &job->cgroup;
+    uint64_t now = job->now_ns;
+
+    if (job->mask & EXPORT_HAS_CPU) {
+        cg->has_cpu = fresh->has_cpu;
+        cg->has_pids = fresh->has_pids;
+        if (fresh->has_pids) cg->pids = fresh->pids;
+
+        // Uso de CPU do cgroup entre duas coletas de cpu, em % de um núcleo
+        if (fresh->has_cpu) {
+            cg->cpu = fresh->cpu;
+            if (target->cgroup_last_cpu_ns != 0 && now > target->cgroup_last_cpu_ns &&
+                cg->cpu.usage_usec >= target->cgroup_last_usage_usec) {
+                double elapsed_us = (now - target->cgroup_last_cpu_ns) / 1000.0;
+                target->cgroup_cpu_percent =
+                    (cg->cpu.usage_usec - target->cgroup_last_usage_usec) / elapsed_us * 100.0;
+            }
+            target->cgroup_last_usage_usec = cg->cpu.usage_usec;
+            target->cgroup_last_cpu_ns = now;
+        }
+    }
+    if (job->mask & EXPORT_HAS_MEM) {
+        cg->has_memory = fresh->has_memory;
+        if (fresh->has_memory) cg->memory = fresh->memory;
+    }
+    if (job->mask & EXPORT_HAS_IO) {
+        cg->has_blkio = fresh->has_blkio;
+        if (fresh->has_blkio) cg->blkio = fresh->blkio;
+    }
+
+    if (monitor->metrics != NULL) {
+        metrics_target_t *view = &monitor->views[target->index];
+        memset(view, 0, sizeof(*view));
+        view->has_cgroup = 1;
+        view->cgroup = *cg;
+    }
+}
+
+/**
+ * Menor cadência efetiva entre os coletores de mask (a registrada na exportação)
+ */
+static uint32_t mask_interval(const daemon_target_t *target, uint32_t mask) {
+    int interval = 0;
+    for (int i = 0; i < target->timer_count; i++) {
+        const daemon_timer_t *timer = &target->timers[i];
+        if ((timer->mask & mask) && (interval == 0 || timer->effective_ms < interval)) {
+            interval = timer->effective_ms;
+        }
+    }
+    return (uint32_t)interval;
+}
+
+/**
+ * Reprograma os timers com as cadências efetivas atuais
+ */
+static void retime_timers(daemon_target_t *target) {
+    for (int i = 0; i < target->timer_count; i++) {
+        daemon_timer_t *timer = &target->timers[i];
+        int effective = scaled_interval(target, timer->interval_ms);
+        if (effective == timer->effective_ms) continue;
+        if (event_loop_set_timer(timer->source, (uint64_t)effective, (uint64_t)effective) == 0) {
+            timer->effective_ms = effective;
+        }
+    }
+}
+
+/**
+ * Laço: alimenta o controle adaptativo com os sinais que a coleta trouxe
+ */
+static void adapt_target(daemon_target_t *target, const daemon_job_t *job) {
+    adaptive_signal_t signal = { 0 };
+    if (target->kind == DAEMON_TARGET_PID) {
+        const export_record_t *fresh = &job->fresh;
+        if (fresh->flags & EXPORT_HAS_CPU) {
+            signal.have |= ADAPTIVE_TRIGGER_CPU;
+            signal.cpu_percent = fresh->cpu.cpu_percent;
+        }
+        if (fresh->flags & EXPORT_HAS_MEM) {
+            signal.have |= ADAPTIVE_TRIGGER_RSS;
+            signal.rss = fresh->mem.rss;
+        }
+    } else {
+        const cgroup_metrics_t *cg = &target->cgroup;
+        if ((job->mask & EXPORT_HAS_CPU) && cg->has_cpu) {
+            signal.have |= ADAPTIVE_TRIGGER_CPU | ADAPTIVE_TRIGGER_THROTTLE;
+            signal.cpu_percent = target->cgroup_cpu_percent;
+            signal.nr_throttled = cg->cpu.nr_throttled;
+        }
+        if ((job->mask & EXPORT_HAS_MEM) && cg->has_memory) {
+            signal.have |= ADAPTIVE_TRIGGER_RSS;
+            signal.rss = cg->memory.current;
+        }
+    }
+
+    uint64_t before = target->adapt.interval_ms;
+    if (adaptive_update(&target->adapt, &signal) != before) {
+        retime_timers(target);
+    }
+}
+
+static void finish_job(monitor_daemon_t *monitor, daemon_job_t *job) {
+    daemon_target_t *target = job->target;
+    target->errors += job->errors;
+    if (target->exited) {
+        // O pidfd chegou antes do fim da rodada
+        return;
+    }
+
+    if (target->kind == DAEMON_TARGET_PID) {
+        job->fresh.interval_ms = mask_interval(target, job->mask);
+        finish_pid(monitor, target, job);
+        if (target->exited) return;
+    } else {
+        finish_cgroup(monitor, target, job);
+    }
+    if (target->adaptive) {
+        adapt_target(target, job);
+    }
+    target->samples++;
+    target->last_sample_ns = job->now_ns;
+    monitor->dirty = 1;
+}
+
+/**
+ * Aplica as coletas concluídas e reenfileira quem venceu de novo
+ */
+static void finish_jobs(monitor_daemon_t *monitor) {
+    int count = collector_pool_complete(monitor->pool, monitor->round, MONITOR_DAEMON_MAX_TARGETS);
+    for (int i = 0; i < count; i++) {
+        daemon_job_t *job = monitor->round[i];
+        daemon_target_t *target = job->target;
+        target->in_flight = 0;
+        if (target->detached) {
+            free(target);
+            continue;
+        }
+        finish_job(monitor, job);
+        if (target->queued_mask != 0 && !target->exited) {
+            monitor->pending[monitor->pending_count++] = target;
+        } else {
+            target->queued_mask = 0;
+        }
+    }
+}
+
+/**
+ * Fim de lote: tudo que venceu no lote vira uma rodada, mesmo com coletas
+ * anteriores ainda em voo (quem está em voo não entra em pending)
+ */
+static void dispatch_round(event_loop_t *loop, void *data) {
+    (void)loop;
+    monitor_daemon_t *monitor = data;
+    if (monitor->pending_count == 0) {
+        return;
+    }
+
+    int count = 0;
+    for (int i = 0; i < monitor->pending_count; i++) {
+        daemon_target_t *target = monitor->pending[i];
+        uint32_t mask = target->queued_mask;
+        target->queued_mask = 0;
+        if (target->exited) continue;
+        target->job.target = target;
+        target->job.mask = mask;
+        target->job.want_view = monitor->metrics != NULL;
+        target->in_flight = 1;
+        monitor->round[count++] = &target->job;
+    }
+    monitor->pending_count = 0;
+    if (count == 0) {
+        return;
+    }
+
+    // Cada alvo tem no máximo um job em voo, mas alvos removidos com a coleta
+    // presa ainda ocupam vagas: sem espaço a rodada volta para pending e sai
+    // no fim de um lote seguinte (o que colher os jobs presos, no máximo)
+    if (collector_pool_submit(monitor->pool, monitor->round, count) != 0) {
+        for (int i = 0; i < count; i++) {
+            daemon_job_t *job = monitor->round[i];
+            job->target->in_flight = 0;
+            job->target->queued_mask = job->mask;
+            monitor->pending[monitor->pending_count++] = job->target;
+        }
+        return;
+    }
+    if (monitor->pool->worker_count == 0) {
+        finish_jobs(monitor);
+    }
+}
+
+static void on_jobs_done(event_source_t *source, uint32_t events, void *data) {
+    (void)source;
+    (void)events;
+    finish_jobs(data);
+}
+
+/**
+ * Marca coletores vencidos; a coleta sai na rodada do fim do lote
+ */
+static void queue_sample(daemon_target_t *target, uint32_t mask) {
+    monitor_daemon_t *monitor = target->monitor;
+    if (mask == 0 || target->exited) {
+        return;
+    }
+    if (target->in_flight) {
+        monitor->overruns++;
+    } else if (target->queued_mask == 0) {
+        monitor->pending[monitor->pending_count++] = target;
+    }
+    target->queued_mask |= mask;
+}
+
+static void on_timer(event_source_t *source, uint32_t events, void *data) {
+    (void)source;
+    (void)events;
+    daemon_timer_t *timer = data;
+    queue_sample(timer->target, timer->mask);
+}
+
+static void on_target_exit(event_source_t *source, uint32_t events, void *data) {
+    (void)source;
+    (void)events;
+    daemon_target_t *target = data;
+    mark_exited(target->monitor, target);
+    target->monitor->dirty = 1;
+}
+
+/**
+ * Cria um timer por cadência distinta entre os coletores ativos
+ * @return 0 em sucesso, -1 em erro
+ */
+static int arm_timers(daemon_target_t *target) {
+    remove_timers(target);
+    if (target->exited) {
+        return 0;
+    }
+
+    for (int c = 0; c < DAEMON_COLLECTORS; c++) {
+        uint32_t bit = 1u << c;
+        if (!(target->collect & bit)) continue;
+
+        int interval = collector_interval(target, c);
+        int slot = 0;
+        while (slot < target->timer_count && target->timers[slot].interval_ms != interval) {
+            slot++;
+        }
+        if (slot == target->timer_count) {
+            target->timers[slot] = (daemon_timer_t){ NULL, 0, interval,
+                                                     scaled_interval(target, interval), target };
+            target->timer_count++;
+        }
+        target->timers[slot].mask |= bit;
+    }
+
+    // Alvo novo: primeira coleta imediata; reprogramado: um período depois
+    for (int i = 0; i < target->timer_count; i++) {
+        daemon_timer_t *timer = &target->timers[i];
+        uint64_t first = target->samples ? (uint64_t)timer->effective_ms : 0;
+        timer->source = event_loop_add_timer(&target->monitor->loop, first,
+                                             (uint64_t)timer->effective_ms, on_timer, timer);
+        if (timer->source == NULL) {
+            target->timer_count = i;
+            remove_timers(target);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Pressão (PSI) e OOM
+// ----------------------------------------------------------------------------
+
+static daemon_target_t* find_target(monitor_daemon_t *monitor, int id) {
+    for (int i = 0; i < monitor->target_count; i++) {
+        if (monitor->targets[i]->id == id) {
+            return monitor->targets[i];
+        }
+    }
+    return NULL;
+}
+
+static void on_stall(event_source_t *source, uint32_t events, void *data) {
+    daemon_target_t *target = data;
+    if (events & EPOLLERR) {
+        // O cgroup foi removido
+        for (int i = 0; i < DAEMON_COLLECTORS; i++) {
+            if (target->psi_sources[i] == source) target->psi_sources[i] = NULL;
+        }
+        event_loop_remove(source);
+        return;
+    }
+    target->stall_events++;
+    queue_sample(target, target->collect);
+}
+
+int monitor_daemon_watch_stall(monitor_daemon_t *monitor, int id, int stall_ms) {
+    daemon_target_t *target = find_target(monitor, id);
+    if (target == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (stall_ms < 0 || stall_ms > MONITOR_DAEMON_PSI_WINDOW_MS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    remove_psi(target);
+    if (stall_ms == 0) {
+        return 0;
+    }
+    if (target->kind != DAEMON_TARGET_CGROUP) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    for (int i = 0; i < DAEMON_COLLECTORS; i++) {
+        char path[600];
+        snprintf(path, sizeof(path), "%s/%s", target->cpu_path, pressure_files[i]);
+        if (access(path, F_OK) != 0) {
+            remove_psi(target);
+            errno = ENOTSUP;
+            return -1;
+        }
+        target->psi_sources[i] = event_loop_add_psi(&monitor->loop, path, 0,
+                                                    (uint64_t)stall_ms * 1000,
+                                                    MONITOR_DAEMON_PSI_WINDOW_MS * 1000ULL,
+                                                    on_stall, target);
+        if (target->psi_sources[i] == NULL) {
+            int saved = errno;
+            remove_psi(target);
+            errno = saved;
+            return -1;
+        }
+    }
+    target->stall_ms = stall_ms;
+    return 0;
+}
+
+/**
+ * v2: memory.events mudou; o campo "oom" é o total do cgroup
+ */
+static void on_memory_events(event_source_t *source, uint32_t events, void *data) {
+    (void)source;
+    (void)events;
+    daemon_target_t *target = data;
+    char path[600];
+    snprintf(path, sizeof(path), "%s/memory.events", target->mem_path);
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return;
+    }
+    char key[64];
+    unsigned long long value;
+    uint64_t oom = target->oom_events;
+    while (fscanf(fp, "%63s %llu", key, &value) == 2) {
+        if (strcmp(key, "oom") == 0) oom = value;
+    }
+    fclose(fp);
+
+    if (oom != target->oom_events) {
+        target->oom_events = oom;
+        queue_sample(target, target->collect & EXPORT_HAS_MEM);
+    }
+}
+
+/**
+ * v1: eventfd registrado em cgroup.event_control conta as notificações
+ */
+static void on_oom_eventfd(event_source_t *source, uint32_t events, void *data) {
+    daemon_target_t *target = data;
+    uint64_t count = 0;
+    if (events & EPOLLHUP) {
+        event_loop_remove(source);
+        target->oom_source = NULL;
+        return;
+    }
+    if (read(source->fd, &count, sizeof(count)) == (ssize_t)sizeof(count)) {
+        target->oom_events += count;
+        queue_sample(target, target->collect & EXPORT_HAS_MEM);
+    }
+}
+
+/**
+ * Observa OOM no cgroup de memória; sem suporte o alvo fica sem oom_events
+ */
+static void watch_oom(monitor_daemon_t *monitor, daemon_target_t *target) {
+    char path[600];
+    snprintf(path, sizeof(path), "%s/memory.events", target->mem_path);
+    if (access(path, R_OK) == 0) {
+        target->oom_source = event_loop_add_inotify(&monitor->loop, path, IN_MODIFY,
+                                                    on_memory_events, target);
+        return;
+    }
+
+    snprintf(path, sizeof(path), "%s/memory.oom_control", target->mem_path);
+    int oom_fd = open(path, O_RDONLY | O_CLOEXEC);
+    snprintf(path, sizeof(path), "%s/cgroup.event_control", target->mem_path);
+    int control_fd = open(path, O_WRONLY | O_CLOEXEC);
+    int event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (oom_fd >= 0 && control_fd >= 0 && event_fd >= 0) {
+        char line[32];
+        int len = snprintf(line, sizeof(line), "%d %d", event_fd, oom_fd);
+        if (write(control_fd, line, (size_t)len) == len) {
+            target->oom_source = event_loop_add_fd(&monitor->loop, event_fd, EPOLLIN, 1,
+                                                   on_oom_eventfd, target);
+            event_fd = -1;
+        }
+    }
+    if (event_fd >= 0) close(event_fd);
+    if (control_fd >= 0) close(control_fd);
+    if (oom_fd >= 0) close(oom_fd);
+}
+
+// ----------------------------------------------------------------------------
+// Alvos
+// ----------------------------------------------------------------------------
+
+static daemon_target_t* new_target(monitor_daemon_t *monitor, int interval_ms, uint32_t collect) {
+    if (monitor->target_count >= MONITOR_DAEMON_MAX_TARGETS) {
+        errno = ENOSPC;
+        return NULL;
+    }
+    if (interval_ms != 0 && !valid_interval(interval_ms)) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (monitor->target_count == monitor->target_capacity) {
+        int capacity = monitor->target_capacity ? monitor->target_capacity * 2 : 16;
+        daemon_target_t **targets = realloc(monitor->targets, (size_t)capacity * sizeof(*targets));
+        if (targets == NULL) return NULL;
+        monitor->targets = targets;
+        metrics_target_t *views = realloc(monitor->views, (size_t)capacity * sizeof(*views));
+        if (views == NULL) return NULL;
+        monitor->views = views;
+        monitor->target_capacity = capacity;
+    }
+
+    // Alvos têm endereço fixo: os callbacks do laço guardam ponteiros para eles
+    daemon_target_t *target = calloc(1, sizeof(*target));
+    if (target == NULL) {
+        return NULL;
+    }
+    target->id = monitor->next_id++;
+    target->monitor = monitor;
+    target->collect = collect ? collect : COLLECT_ALL;
+    target->interval_ms = interval_ms ? interval_ms : MONITOR_DAEMON_DEFAULT_INTERVAL_MS;
+    return target;
+}
+
+/**
+ * Insere o alvo e arma os timers
+ * @return id do alvo, ou -1 em erro (o alvo é liberado)
+ */
+static int insert_target(monitor_daemon_t *monitor, daemon_target_t *target) {
+    if (arm_timers(target) != 0) {
+        int saved = errno;
+        event_loop_remove(target->exit_source);
+        event_loop_remove(target->oom_source);
+        free(target);
+        errno = saved;
+        return -1;
+    }
+    target->index = monitor->target_count++;
+    monitor->targets[target->index] = target;
+    memset(&monitor->views[target->index], 0, sizeof(monitor->views[target->index]));
+    return target->id;
+}
+
+int monitor_daemon_add_pid(monitor_daemon_t *monitor, pid_t pid, int interval_ms, uint32_t collect) {
+    if (monitor == NULL || pid <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!process_exists(pid)) {
+        errno = ESRCH;
+        return -1;
+    }
+    for (int i = 0; i < monitor->target_count; i++) {
+        if (monitor->targets[i]->kind == DAEMON_TARGET_PID && monitor->targets[i]->pid == pid) {
+            errno = EEXIST;
+            return -1;
+        }
+    }
+
+    daemon_target_t *target = new_target(monitor, interval_ms, collect);
+    if (target == NULL) {
+        return -1;
+    }
+    target->kind = DAEMON_TARGET_PID;
+    target->pid = pid;
+
+    // Sem pidfd (kernel antigo) o fim do processo aparece na próxima coleta
+    target->exit_source = event_loop_add_pidfd(&monitor->loop, pid, on_target_exit, target);
+    return insert_target(monitor, target);
+}
+
+int monitor_daemon_add_cgroup(monitor_daemon_t *monitor, const char *cpu_path,
+                              const char *mem_path, int interval_ms, uint32_t collect) {
+    if (monitor == NULL || cpu_path == NULL || cpu_path[0] != '/') {
+        errno = EINVAL;
+        return -1;
+    }
+    if (access(cpu_path, R_OK) != 0 || (mem_path != NULL && access(mem_path, R_OK) != 0)) {
+        return -1;
+    }
+
+    daemon_target_t *target = new_target(monitor, interval_ms, collect);
+    if (target == NULL) {
+        return -1;
+    }
+    target->kind = DAEMON_TARGET_CGROUP;
+    snprintf(target->cpu_path, sizeof(target->cpu_path), "%s", cpu_path);
+    snprintf(target->mem_path, sizeof(target->mem_path), "%s", mem_path ? mem_path : cpu_path);
+    target->cgroup.info.version = detect_cgroup_version();
+    snprintf(target->cgroup.info.path, sizeof(target->cgroup.info.path), "%s", cpu_path);
+
+    watch_oom(monitor, target);
+    return insert_target(monitor, target);
+}
+
+static void release_target(monitor_daemon_t *monitor, daemon_target_t *target) {
+    remove_timers(target);
+    remove_psi(target);
+    event_loop_remove(target->exit_source);
+    event_loop_remove(target->oom_source);
+    if (monitor->live != NULL && target->kind == DAEMON_TARGET_PID && !target->exited) {
+        shm_metrics_remove(monitor->live, target->pid);
+    }
+    unqueue(target);
+    if (target->in_flight) {
+        // Um worker ainda usa o alvo: finish_jobs o libera
+        target->detached = 1;
+        return;
+    }
+    free(target);
+}
+
+int monitor_daemon_remove(monitor_daemon_t *monitor, int id) {
+    daemon_target_t *target = find_target(monitor, id);
+    if (target == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    int index = target->index;
+    int last = --monitor->target_count;
+    if (index != last) {
+        monitor->targets[index] = monitor->targets[last];
+        monitor->targets[index]->index = index;
+        monitor->views[index] = monitor->views[last];
+    }
+    release_target(monitor, target);
+    monitor->dirty = 1;
+    return 0;
+}
+
+int monitor_daemon_set_interval(monitor_daemon_t *monitor, int id, uint32_t collectors,
+                                int interval_ms) {
+    daemon_target_t *target = find_target(monitor, id);
+    if (target == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+    collectors &= COLLECT_ALL;
+    int all = collectors == COLLECT_ALL;
+    if (collectors == 0 || (!valid_interval(interval_ms) && (all || interval_ms != 0))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (all) {
+        target->interval_ms = interval_ms;
+    } else {
+        for (int c = 0; c < DAEMON_COLLECTORS; c++) {
+            if (collectors & (1u << c)) target->collector_interval_ms[c] = interval_ms;
+        }
+    }
+    // As taxas continuam do estado atual; só o agendamento muda
+    return arm_timers(target);
+}
+
+int monitor_daemon_set_adaptive(monitor_daemon_t *monitor, int id, int min_ms, int max_ms) {
+    daemon_target_t *target = find_target(monitor, id);
+    if (target == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (min_ms == 0) {
+        target->adaptive = 0;
+        return arm_timers(target);
+    }
+    if (!valid_interval(min_ms) || !valid_interval(max_ms) || min_ms > max_ms) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Começa do intervalo padrão (limitado à faixa) e se ajusta a partir daí
+    adaptive_config_t config = monitor->adaptive;
+    config.min_ms = (uint64_t)min_ms;
+    config.max_ms = (uint64_t)max_ms;
+    adaptive_init(&target->adapt, &config, (uint64_t)target->interval_ms);
+    target->adaptive = 1;
+    return arm_timers(target);
+}
+
+// ----------------------------------------------------------------------------
+// Comandos
+// ----------------------------------------------------------------------------
+
+/**
+ * Resposta que cresce conforme o comando escreve (list com milhares de alvos
+ * não cabe em um buffer fixo, e cortá-la perderia a linha OK/ERR final)
+ */
+typedef struct {
+    char *data;
+    size_t capacity;
+    size_t length;
+    int failed;                 // Faltou memória: o comando vira "ERR"
+} reply_t;
+
+static void reply_printf(reply_t *reply, const char *fmt, ...) {
+    if (reply->failed) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (n <= 0) return;
+
+    size_t needed = reply->length + (size_t)n + 1;
+    if (needed > reply->capacity) {
+        size_t capacity = reply->capacity ? reply->capacity : 1024;
+        while (capacity < needed) capacity *= 2;
+        char *data = realloc(reply->data, capacity);
+        if (data == NULL) {
+            reply->failed = 1;
+            return;
+        }
+        reply->data = data;
+        reply->capacity = capacity;
+    }
+    va_start(ap, fmt);
+    vsnprintf(reply->data + reply->length, reply->capacity - reply->length, fmt, ap);
+    va_end(ap);
+    reply->length += (size_t)n;
+}
+
+/**
+ * Opções de add e set (negativas ou zero = não informadas)
+ */
+typedef struct {
+    int interval_ms;
+    int collector_interval_ms[DAEMON_COLLECTORS];
+    uint32_t collect;
+    const char *mem_path;
+    int stall_ms;
+    int adaptive_min_ms;        // -1 = não informado, 0 = desliga
+    int adaptive_max_ms;
+} target_options_t;
+
+static int parse_int(const char *text, int min, int max, int *value) {
+    char *end;
+    long parsed = strtol(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || parsed < min || parsed > max) {
+        return -1;
+    }
+    *value = (int)parsed;
+    return 0;
+}
+
+/**
+ * Lê as opções chave=valor a partir do token atual
+ * @return 0 em sucesso, -1 com a mensagem de erro em reply
+ */
+static int parse_options(char **saveptr, target_options_t *opts, int allow_mem, reply_t *reply) {
+    memset(opts, 0, sizeof(*opts));
+    opts->stall_ms = -1;
+    opts->adaptive_min_ms = -1;
+    for (int c = 0; c < DAEMON_COLLECTORS; c++) {
+        opts->collector_interval_ms[c] = -1;
+    }
+
+    for (char *opt = strtok_r(NULL, " \t", saveptr); opt != NULL; opt = strtok_r(NULL, " \t", saveptr)) {
+        char *value = strchr(opt, '=');
+        if (value == NULL) {
+            reply_printf(reply, "ERR unknown option '%s'\n", opt);
+            return -1;
+        }
+        *value++ = '\0';
+
+        int collector = -1;
+        for (int c = 0; c < DAEMON_COLLECTORS; c++) {
+            size_t len = strlen(collector_names[c]);
+            if (strncmp(opt, collector_names[c], len) == 0 && strcmp(opt + len, "_interval") == 0) {
+                collector = c;
+            }
+        }
+
+        if (strcmp(opt, "interval") == 0) {
+            if (parse_int(value, 0, 86400000, &opts->interval_ms) != 0 ||
+                !valid_interval(opts->interval_ms)) {
+                reply_printf(reply, "ERR interval must be %d..86400000 ms\n", MONITOR_DAEMON_MIN_INTERVAL_MS);
+                return -1;
+            }
+        } else if (collector >= 0) {
+            int *interval = &opts->collector_interval_ms[collector];
+            if (parse_int(value, 0, 86400000, interval) != 0 ||
+                (*interval != 0 && !valid_interval(*interval))) {
+                reply_printf(reply, "ERR %s_interval must be 0 or %d..86400000 ms\n",
+                             collector_names[collector], MONITOR_DAEMON_MIN_INTERVAL_MS);
+                return -1;
+            }
+        } else if (strcmp(opt, "collect") == 0) {
+            if (monitor_daemon_parse_collect(value, &opts->collect) != 0) {
+                reply_printf(reply, "ERR collect takes cpu,mem,io\n");
+                return -1;
+            }
+        } else if (strcmp(opt, "stall") == 0) {
+            if (parse_int(value, 0, MONITOR_DAEMON_PSI_WINDOW_MS, &opts->stall_ms) != 0) {
+                reply_printf(reply, "ERR stall must be 0..%d ms\n", MONITOR_DAEMON_PSI_WINDOW_MS);
+                return -1;
+            }
+        } else if (strcmp(opt, "adaptive") == 0) {
+            char *max = strchr(value, ':');
+            if (max != NULL) *max++ = '\0';
+            if (parse_int(value, 0, 86400000, &opts->adaptive_min_ms) != 0 ||
+                (max == NULL && opts->adaptive_min_ms != 0) ||
+                (max != NULL && (parse_int(max, 0, 86400000, &opts->adaptive_max_ms) != 0 ||
+                                 !valid_interval(opts->adaptive_min_ms) ||
+                                 opts->adaptive_max_ms < opts->adaptive_min_ms))) {
+                reply_printf(reply, "ERR adaptive must be 0 or <min>:<max> ms (min >= %d)\n",
+                             MONITOR_DAEMON_MIN_INTERVAL_MS);
+                return -1;
+            }
+        } else if (allow_mem && strcmp(opt, "mem") == 0) {
+            opts->mem_path = value;
+        } else {
+            reply_printf(reply, "ERR unknown option '%s'\n", opt);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Aplica cadências, coletores e gatilhos PSI a um alvo existente
+ * @return 0 em sucesso, -1 com errno
+ */
+static int apply_options(monitor_daemon_t *monitor, daemon_target_t *target,
+                         const target_options_t *opts) {
+    if (opts->collect) {
+        target->collect = opts->collect;
+    }
+    if (opts->interval_ms) {
+        target->interval_ms = opts->interval_ms;
+    }
+    for (int c = 0; c < DAEMON_COLLECTORS; c++) {
+        if (opts->collector_interval_ms[c] >= 0) {
+            target->collector_interval_ms[c] = opts->collector_interval_ms[c];
+        }
+    }
+    if (opts->adaptive_min_ms >= 0) {
+        if (monitor_daemon_set_adaptive(monitor, target->id, opts->adaptive_min_ms,
+                                        opts->adaptive_max_ms) != 0) {
+            return -1;
+        }
+    } else if (arm_timers(target) != 0) {
+        return -1;
+    }
+    if (opts->stall_ms >= 0) {
+        return monitor_daemon_watch_stall(monitor, target->id, opts->stall_ms);
+    }
+    return 0;
+}
+
+static void describe_target(const daemon_target_t *target, reply_t *reply) {
+    char collect[16];
+    collect_to_string(target->collect, collect, sizeof(collect));
+    if (target->kind == DAEMON_TARGET_PID) {
+        reply_printf(reply, "%d pid %d", target->id, target->pid);
+    } else {
+        reply_printf(reply, "%d cgroup %s", target->id, target->cpu_path);
+    }
+    reply_printf(reply, " interval=%d collect=%s samples=%" PRIu64 " errors=%" PRIu64 " state=%s",
+                 target->interval_ms, collect, target->samples, target->errors,
+                 target->exited ? "exited" : "running");
+    for (int c = 0; c < DAEMON_COLLECTORS; c++) {
+        if (target->collector_interval_ms[c]) {
+            reply_printf(reply, " %s_interval=%d", collector_names[c], target->collector_interval_ms[c]);
+        }
+    }
+    if (target->stall_ms) {
+        reply_printf(reply, " stall=%d", target->stall_ms);
+    }
+    if (target->adaptive) {
+        reply_printf(reply, " adaptive=%" PRIu64 ":%" PRIu64 " effective=%" PRIu64, target->adapt.config.min_ms,
+                     target->adapt.config.max_ms, target->adapt.interval_ms);
+    }
+    reply_printf(reply, "\n");
+}
+
+static void report_values(const daemon_target_t *target, reply_t *reply) {
+    uint64_t now = monotonic_ns();
+    reply_printf(reply, "id=%d\n", target->id);
+    reply_printf(reply, "samples=%" PRIu64 "\n", target->samples);
+    if (target->samples > 0) {
+        reply_printf(reply, "age_ms=%" PRIu64 "\n", (now - target->last_sample_ns) / 1000000ULL);
+    }
+    if (target->adaptive) {
+        const adaptive_state_t *adapt = &target->adapt;
+        reply_printf(reply, "adaptive_interval_ms=%" PRIu64 "\nadaptive_shrinks=%" PRIu64 "\nadaptive_grows=%" PRIu64 "\n",
+                     adapt->interval_ms, adapt->shrinks, adapt->grows);
+    }
+
+    if (target->kind == DAEMON_TARGET_PID) {
+        const export_record_t *r = &target->last;
+        reply_printf(reply, "pid=%d\nstate=%s\n", target->pid, target->exited ? "exited" : "running");
+        if (r->flags & EXPORT_HAS_CPU) {
+            reply_printf(reply, "cpu_user_ticks=%" PRIu64 "\ncpu_system_ticks=%" PRIu64 "\ncpu_percent=%.2f\n"
+                         "threads=%u\ncontext_switches=%" PRIu64 "\n",
+                         r->cpu.user_time, r->cpu.system_time, r->cpu.cpu_percent,
+                         r->cpu.num_threads, r->cpu.context_switches);
+        }
+        if (r->flags & EXPORT_HAS_MEM) {
+            reply_printf(reply, "mem_rss=%" PRIu64 "\nmem_vsz=%" PRIu64 "\nmem_swap=%" PRIu64 "\npage_faults=%" PRIu64 "\n",
+                         r->mem.rss, r->mem.vsz, r->mem.swap, r->mem.page_faults);
+        }
+        if (r->flags & EXPORT_HAS_IO) {
+            reply_printf(reply, "io_read_bytes=%" PRIu64 "\nio_write_bytes=%" PRIu64 "\nio_read_rate=%.2f\nio_write_rate=%.2f\n",
+                         r->io.bytes_read, r->io.bytes_written, r->io.read_rate, r->io.write_rate);
+        }
+        return;
+    }
+
+    const cgroup_metrics_t *cg = &target->cgroup;
+    reply_printf(reply, "cgroup=%s\n", target->cpu_path);
+    if (cg->has_cpu) {
+        reply_printf(reply, "cpu_usage_usec=%" PRIu64 "\ncpu_percent=%.2f\ncpu_throttled_usec=%" PRIu64 "\ncpu_nr_throttled=%" PRIu64 "\n",
+                     cg->cpu.usage_usec, target->cgroup_cpu_percent,
+                     cg->cpu.throttled_usec, cg->cpu.nr_throttled);
+    }
+    if (cg->has_pids) {
+        reply_printf(reply, "pids_current=%" PRIu64 "\n", cg->pids.current);
+    }
+    if (cg->has_memory) {
+        reply_printf(reply, "mem_current=%" PRIu64 "\nmem_peak=%" PRIu64 "\nmem_limit=%" PRIu64 "\n",
+                     cg->memory.current, cg->memory.peak, cg->memory.limit);
+    }
+    if (cg->has_blkio) {
+        reply_printf(reply, "io_read_bytes=%" PRIu64 "\nio_write_bytes=%" PRIu64 "\n", cg->blkio.rbytes, cg->blkio.wbytes);
+    }
+    if (target->stall_ms) {
+        reply_printf(reply, "stall_events=%" PRIu64 "\n", target->stall_events);
+    }
+    if (target->oom_source != NULL) {
+        reply_printf(reply, "oom_events=%" PRIu64 "\n", target->oom_events);
+    }
+}
+
+static void report_stats(const monitor_daemon_t *monitor, reply_t *reply) {
+    collector_pool_stats_t stats;
+    collector_pool_get_stats(monitor->pool, &stats);
+    reply_printf(reply, "workers=%d\nrounds=%" PRIu64 "\njobs=%" PRIu64 "\nsteals=%" PRIu64 "\noverruns=%" PRIu64 "\n",
+                 monitor->pool->worker_count, stats.rounds, stats.jobs, stats.steals, monitor->overruns);
+    reply_printf(reply, "last_round_jobs=%d\nlast_round_ms=%.3f\nmax_round_ms=%.3f\navg_round_ms=%.3f\n",
+                 stats.last_round_jobs, stats.last_round_ns / 1e6, stats.max_round_ns / 1e6,
+                 stats.rounds ? stats.total_round_ns / 1e6 / (double)stats.rounds : 0.0);
+    for (int i = 0; i < monitor->pool->context_count; i++) {
+        const collector_worker_t *worker = &monitor->pool->workers[i];
+        reply_printf(reply, "worker%d_jobs=%" PRIu64 "\nworker%d_steals=%" PRIu64 "\nworker%d_busy_ms=%.3f\n",
+                     i, atomic_load(&worker->jobs), i, atomic_load(&worker->steals),
+                     i, atomic_load(&worker->busy_ns) / 1e6);
+    }
+}
+
+static int parse_id(const char *token, int *id) {
+    return token != NULL ? parse_int(token, 0, 0x7fffffff, id) : -1;
+}
+
+/**
+ * Executa uma linha e acrescenta a resposta a reply
+ */
+static void run_command(monitor_daemon_t *monitor, const char *line, reply_t *reply_out) {
+    reply_t reply = *reply_out;
+    size_t start = reply.length;
+    char copy[MONITOR_DAEMON_LINE_MAX];
+    char *saveptr = NULL;
+    target_options_t opts;
+
+    snprintf(copy, sizeof(copy), "%s", line);
+    copy[strcspn(copy, "\r\n")] = '\0';
+    char *verb = strtok_r(copy, " \t", &saveptr);
+
+    if (verb == NULL) {
+        reply_printf(&reply, "ERR empty command\n");
+    } else if (strcmp(verb, "add") == 0) {
+        char *kind = strtok_r(NULL, " \t", &saveptr);
+        char *what = strtok_r(NULL, " \t", &saveptr);
+        int is_cgroup = kind != NULL && strcmp(kind, "cgroup") == 0;
+
+        if (kind == NULL || what == NULL || (!is_cgroup && strcmp(kind, "pid") != 0)) {
+            reply_printf(&reply, "ERR usage: add pid <PID> | add cgroup <path> [options]\n");
+        } else if (parse_options(&saveptr, &opts, is_cgroup, &reply) == 0) {
+            int id = is_cgroup ? monitor_daemon_add_cgroup(monitor, what, opts.mem_path,
+                                                           opts.interval_ms, opts.collect)
+                               : monitor_daemon_add_pid(monitor, (pid_t)atoi(what),
+                                                        opts.interval_ms, opts.collect);
+            if (id >= 0 && apply_options(monitor, find_target(monitor, id), &opts) != 0) {
+                int saved = errno;
+                monitor_daemon_remove(monitor, id);
+                errno = saved;
+                id = -1;
+            }
+            if (id >= 0) {
+                reply_printf(&reply, "OK %d\n", id);
+            } else {
+                reply_printf(&reply, "ERR %s\n", strerror(errno));
+            }
+        }
+    } else if (strcmp(verb, "remove") == 0) {
+        int id;
+        if (parse_id(strtok_r(NULL, " \t", &saveptr), &id) != 0 || monitor_daemon_remove(monitor, id) != 0) {
+            reply_printf(&reply, "ERR no such target\n");
+        } else {
+            reply_printf(&reply, "OK\n");
+        }
+    } else if (strcmp(verb, "set") == 0) {
+        int id;
+        daemon_target_t *target = NULL;
+        if (parse_id(strtok_r(NULL, " \t", &saveptr), &id) == 0) {
+            target = find_target(monitor, id);
+        }
+        if (target == NULL) {
+            reply_printf(&reply, "ERR no such target\n");
+        } else if (parse_options(&saveptr, &opts, 0, &reply) == 0) {
+            if (apply_options(monitor, target, &opts) == 0) {
+                reply_printf(&reply, "OK\n");
+            } else {
+                reply_printf(&reply, "ERR %s\n", strerror(errno));
+            }
+        }
+    } else if (strcmp(verb, "get") == 0) {
+        int id;
+        daemon_target_t *target = NULL;
+        if (parse_id(strtok_r(NULL, " \t", &saveptr), &id) == 0) {
+            target = find_target(monitor, id);
+        }
+        if (target == NULL) {
+            reply_printf(&reply, "ERR no such target\n");
+        } else {
+            report_values(target, &reply);
+            reply_printf(&reply, "OK\n");
+        }
+    } else if (strcmp(verb, "list") == 0) {
+        for (int i = 0; i < monitor->target_count; i++) {
+            describe_target(monitor->targets[i], &reply);
+        }
+        reply_printf(&reply, "OK %d\n", monitor->target_count);
+    } else if (strcmp(verb, "stats") == 0) {
+        report_stats(monitor, &reply);
+        reply_printf(&reply, "OK\n");
+    } else if (strcmp(verb, "shutdown") == 0) {
+        monitor->stop_requested = 1;
+        event_loop_stop(&monitor->loop);
+        reply_printf(&reply, "OK\n");
+    } else {
+        reply_printf(&reply, "ERR unknown command '%s'\n", verb);
+    }
+
+    if (reply.failed) {
+        // Descarta a resposta parcial; a linha de erro cabe no que já foi alocado
+        static const char oom[] = "ERR out of memory\n";
+        reply.length = start;
+        if (reply.capacity - start >= sizeof(oom)) {
+            memcpy(reply.data + start, oom, sizeof(oom));
+            reply.length += sizeof(oom) - 1;
+            reply.failed = 0;
+        }
+    }
+    *reply_out = reply;
+}
+
+size_t monitor_daemon_command(monitor_daemon_t *monitor, const char *line, char *out, size_t size) {
+    reply_t reply = { NULL, 0, 0, 0 };
+    run_command(monitor, line, &reply);
+
+    static const char oom[] = "ERR out of memory\n";
+    const char *text = reply.failed || reply.data == NULL ? oom : reply.data;
+    size_t length = reply.failed || reply.data == NULL ? sizeof(oom) - 1 : reply.length;
+    if (size > 0) {
+        size_t copy = length < size ? length : size - 1;
+        memcpy(out, text, copy);
+        out[copy] = '\0';
+    }
+    free(reply.data);
+    return length;
+}
+
+// ----------------------------------------------------------------------------
+// Socket de controle
+// ----------------------------------------------------------------------------
+
+static void close_client(daemon_client_t *client) {
+    event_loop_remove(client->source);
+    client->source = NULL;
+    client->fd = -1;
+    client->length = 0;
+    free(client->out);
+    client->out = NULL;
+    client->out_capacity = 0;
+    client->out_length = 0;
+    client->out_sent = 0;
+}
+
+/**
+ * Envia o que couber no socket; com saída pendente o cliente passa a esperar
+ * EPOLLOUT e só volta a ser lido quando ela esvaziar (um cliente que não lê
+ * as respostas não faz o buffer crescer sem limite)
+ * @return 0 em sucesso, -1 se o cliente deve ser fechado
+ */
+static int flush_client(daemon_client_t *client) {
+    while (client->out_sent < client->out_length) {
+        ssize_t w = send(client->fd, client->out + client->out_sent,
+                         client->out_length - client->out_sent, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && errno == EAGAIN) {
+            return event_loop_modify(client->source, EPOLLOUT);
+        }
+        if (w <= 0) return -1;
+        client->out_sent += (size_t)w;
+    }
+    client->out_length = 0;
+    client->out_sent = 0;
+    return 0;
+}
+
+/**
+ * Lê do cliente e executa cada linha completa
+ */
+static void serve_client(event_source_t *source, uint32_t events, void *data) {
+    (void)source;
+    daemon_client_t *client = data;
+
+    if (client->out_sent < client->out_length) {
+        if ((events & (EPOLLERR | EPOLLHUP)) || flush_client(client) != 0) {
+            close_client(client);
+            return;
+        }
+        if (client->out_length == 0 && event_loop_modify(client->source, EPOLLIN) != 0) {
+            close_client(client);
+        }
+        return;
+    }
+
+    ssize_t n = read(client->fd, client->buffer + client->length,
+                     sizeof(client->buffer) - 1 - client->length);
+    if (n <= 0) {
+        if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+            close_client(client);
+        }
+        return;
+    }
+    client->length += (size_t)n;
+    client->buffer[client->length] = '\0';
+
+    reply_t reply = { client->out, client->out_capacity, client->out_length, 0 };
+    char *line = client->buffer;
+    char *newline;
+    while ((newline = strchr(line, '\n')) != NULL) {
+        *newline = '\0';
+        run_command(client->monitor, line, &reply);
+        if (reply.failed) break;
+        line = newline + 1;
+    }
+    client->out = reply.data;
+    client->out_capacity = reply.capacity;
+    client->out_length = reply.length;
+    if (reply.failed || flush_client(client) != 0) {
+        close_client(client);
+        return;
+    }
+
+    size_t rest = client->length - (size_t)(line - client->buffer);
+    if (rest == sizeof(client->buffer) - 1) {
+        // Linha maior que o buffer
+        close_client(client);
+        return;
+    }
+    memmove(client->buffer, line, rest);
+    client->length = rest;
+    client->buffer[rest] = '\0';
+}
+
+static void accept_clients(event_source_t *source, uint32_t events, void *data) {
+    (void)events;
+    monitor_daemon_t *monitor = data;
+
+    for (;;) {
+        int fd = accept4(source->fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0) {
+            return;
+        }
+        daemon_client_t *client = NULL;
+        for (int i = 0; i < MONITOR_DAEMON_MAX_CLIENTS && client == NULL; i++) {
+            if (monitor->clients[i].fd < 0) client = &monitor->clients[i];
+        }
+        if (client == NULL) {
+            const char *busy = "ERR too many clients\n";
+            ssize_t ignored = write(fd, busy, strlen(busy));
+            (void)ignored;
+            close(fd);
+            continue;
+        }
+        client->source = event_loop_add_fd(&monitor->loop, fd, EPOLLIN, 1, serve_client, client);
+        if (client->source != NULL) {
+            client->fd = fd;
+            client->length = 0;
+        }
+    }
+}
+
+static int start_pool(monitor_daemon_t *monitor, int workers) {
+    if (collector_pool_create(monitor->pool, workers, MONITOR_DAEMON_MAX_TARGETS, collect_job) != 0) {
+        return -1;
+    }
+    monitor->pool_source = event_loop_add_fd(&monitor->loop, monitor->pool->done_fd, EPOLLIN, 0,
+                                             on_jobs_done, monitor);
+    if (monitor->pool_source == NULL) {
+        int saved = errno;
+        collector_pool_destroy(monitor->pool);
+        errno = saved;
+        return -1;
+    }
+    return 0;
+}
+
+int monitor_daemon_set_workers(monitor_daemon_t *monitor, int workers) {
+    if (monitor == NULL || workers < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (monitor->pool->outstanding > 0) {
+        errno = EBUSY;
+        return -1;
+    }
+
+    // Os workers guardam o endereço do pool: troca no lugar
+    event_loop_remove(monitor->pool_source);
+    monitor->pool_source = NULL;
+    collector_pool_destroy(monitor->pool);
+    if (start_pool(monitor, workers) != 0) {
+        int saved = errno;
+        start_pool(monitor, 0);
+        errno = saved;
+        return -1;
+    }
+    return 0;
+}
+
+void monitor_daemon_get_pool_stats(const monitor_daemon_t *monitor, collector_pool_stats_t *stats) {
+    collector_pool_get_stats(monitor->pool, stats);
+}
+
+int monitor_daemon_init(monitor_daemon_t *monitor, const char *socket_path) {
+    if (monitor == NULL || socket_path == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(monitor, 0, sizeof(*monitor));
+    monitor->next_id = 1;
+    adaptive_config_default(&monitor->adaptive);
+    monitor->listen_fd = -1;
+    for (int i = 0; i < MONITOR_DAEMON_MAX_CLIENTS; i++) {
+        monitor->clients[i].fd = -1;
+        monitor->clients[i].monitor = monitor;
+    }
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr.sun_path, socket_path);
+    strcpy(monitor->socket_path, socket_path);
+
+    if (event_loop_init(&monitor->loop) != 0) {
+        return -1;
+    }
+    monitor->pending = calloc(MONITOR_DAEMON_MAX_TARGETS, sizeof(*monitor->pending));
+    monitor->round = calloc(MONITOR_DAEMON_MAX_TARGETS, sizeof(*monitor->round));
+    monitor->pool = calloc(1, sizeof(*monitor->pool));
+    if (monitor->pending == NULL || monitor->round == NULL || monitor->pool == NULL ||
+        start_pool(monitor, 0) != 0) {
+        int saved = errno;
+        free(monitor->pending);
+        free(monitor->round);
+        free(monitor->pool);
+        event_loop_free(&monitor->loop);
+        errno = saved;
+        return -1;
+    }
+    event_loop_set_batch_hook(&monitor->loop, dispatch_round, monitor);
+    monitor->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (monitor->listen_fd >= 0) {
+        unlink(socket_path);
+        if (bind(monitor->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+            listen(monitor->listen_fd, MONITOR_DAEMON_MAX_CLIENTS) == 0) {
+            monitor->listen_source = event_loop_add_fd(&monitor->loop, monitor->listen_fd,
+                                                       EPOLLIN, 0, accept_clients, monitor);
+        }
+    }
+    if (monitor->listen_source == NULL) {
+        int saved = errno;
+        if (monitor->listen_fd >= 0) close(monitor->listen_fd);
+        monitor->listen_fd = -1;
+        event_loop_remove(monitor->pool_source);
+        collector_pool_destroy(monitor->pool);
+        free(monitor->pool);
+        free(monitor->pending);
+        free(monitor->round);
+        event_loop_free(&monitor->loop);
+        errno = saved;
+        return -1;
+    }
+    return 0;
+}
+
+static void publish_page(monitor_daemon_t *monitor) {
+    monitor->dirty = 0;
+    if (monitor->metrics == NULL) {
+        return;
+    }
+    metrics_page_t *page = openmetrics_render(monitor->views, monitor->target_count,
+                                              monitor->page_size);
+    if (page != NULL) {
+        monitor->page_size = page->length;
+        metrics_server_publish(monitor->metrics, page);
+    }
+}
+
+int monitor_daemon_run(monitor_daemon_t *monitor, volatile int *keep_running) {
+    // Um lote de eventos pode coletar vários alvos; a página sai uma vez por lote
+    while ((keep_running == NULL || *keep_running) && !monitor->stop_requested) {
+        if (event_loop_run_once(&monitor->loop, -1) < 0 && errno != EINTR) {
+            return -1;
+        }
+        if (monitor->dirty) {
+            publish_page(monitor);
+        }
+    }
+    return 0;
+}
+
+void monitor_daemon_free(monitor_daemon_t *monitor) {
+    if (monitor == NULL) {
+        return;
+    }
+    for (int i = 0; i < MONITOR_DAEMON_MAX_CLIENTS; i++) {
+        if (monitor->clients[i].fd >= 0) {
+            close_client(&monitor->clients[i]);
+        }
+    }
+
+    // As coletas em voo terminam antes de os alvos serem liberados; uma presa
+    // (processo em estado D) não segura o encerramento além do prazo
+    int stuck = collector_pool_wait_timeout(monitor->pool, MONITOR_DAEMON_DRAIN_TIMEOUT_MS) != 0;
+    int count = collector_pool_complete(monitor->pool, monitor->round, MONITOR_DAEMON_MAX_TARGETS);
+    for (int i = 0; i < count; i++) {
+        daemon_target_t *target = ((daemon_job_t *)monitor->round[i])->target;
+        target->in_flight = 0;
+        if (target->detached) free(target);
+    }
+    event_loop_remove(monitor->pool_source);
+    monitor->pool_source = NULL;
+    if (stuck) {
+        // Alvos abandonados seguem com in_flight: release_target não os libera
+        count = collector_pool_abandon(monitor->pool, monitor->round, MONITOR_DAEMON_MAX_TARGETS);
+        for (int i = 0; i < count; i++) {
+            const daemon_target_t *target = ((daemon_job_t *)monitor->round[i])->target;
+            if (target->kind == DAEMON_TARGET_PID) {
+                fprintf(stderr, "monitor_daemon: abandoning stuck collection of target %d (pid %d)\n",
+                        target->id, target->pid);
+            } else {
+                fprintf(stderr, "monitor_daemon: abandoning stuck collection of target %d (cgroup %s)\n",
+                        target->id, target->cpu_path);
+            }
+        }
+    } else {
+        collector_pool_destroy(monitor->pool);
+        free(monitor->pool);
+    }
+    monitor->pool = NULL;
+    for (int i = 0; i < monitor->target_count; i++) {
+        release_target(monitor, monitor->targets[i]);
+    }
+    if (monitor->listen_fd >= 0) {
+        event_loop_remove(monitor->listen_source);
+        close(monitor->listen_fd);
+        unlink(monitor->socket_path);
+        monitor->listen_fd = -1;
+    }
+    event_loop_free(&monitor->loop);
+    free(monitor->targets);
+    free(monitor->views);
+    free(monitor->pending);
+    free(monitor->round);
+    monitor->targets = NULL;
+    monitor->views = NULL;
+    monitor->pending = NULL;
+    monitor->round = NULL;
+    monitor->target_count = 0;
+    monitor->target_capacity = 0;
+}
+
+// ----------------------------------------------------------------------------
+// Cliente
+// ----------------------------------------------------------------------------
+
+int monitor_daemon_control(const char *socket_path, const char *command, FILE *out) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (socket_path == NULL || command == NULL || strlen(socket_path) >= sizeof(addr.sun_path)) {
+        errno = EINVAL;
+        return -1;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    // Um daemon travado não pode prender o cliente para sempre em recv
+    struct timeval timeout = { .tv_sec = MONITOR_DAEMON_CONTROL_TIMEOUT_MS / 1000,
+                               .tv_usec = (MONITOR_DAEMON_CONTROL_TIMEOUT_MS % 1000) * 1000 };
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0 ||
+        connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        send(fd, command, strlen(command), MSG_NOSIGNAL) < 0 ||
+        send(fd, "\n", 1, MSG_NOSIGNAL) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    // A resposta termina na primeira linha que começa com OK ou ERR
+    char buffer[4096];
+    char line[MONITOR_DAEMON_LINE_MAX];
+    size_t line_len = 0;
+    int result = -1;
+    int saved = ECONNRESET;
+    ssize_t n;
+    while (result < 0) {
+        n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) saved = ETIMEDOUT;
+            break;
+        }
+        for (ssize_t i = 0; i < n && result < 0; i++) {
+            if (line_len < sizeof(line) - 1) {
+                line[line_len++] = buffer[i];
+            }
+            if (buffer[i] != '\n') continue;
+            line[line_len] = '\0';
+            if (out != NULL) fputs(line, out);
+            if (strncmp(line, "OK", 2) == 0) result = 0;
+            else if (strncmp(line, "ERR", 3) == 0) result = 1;
+            line_len = 0;
+        }
+    }
+    close(fd);
+    if (result < 0) {
+        errno = saved;
+    }
+    return result;
+}
@@ -7,11 +7,19 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <dirent.h>
+#include <limits.h>
 #include <time.h>
 #include <sched.h>
 #include <sys/wait.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "monitor.h"
 
+#ifndef CLONE_NEWTIME
+#define CLONE_NEWTIME 0x00000080
+#endif
+
 // Mapeamento de tipos de namespace para strings
 static const char* ns_type_names[MAX_NAMESPACES] = {
     "cgroup",
@@ -66,7 +74,7 @@ int list_process_namespaces(pid_t pid, process_namespaces_t *ns_info) {
         ns->type = (namespace_type_t)i;
         strncpy(ns->type_name, ns_type_names[i], sizeof(ns->type_name) - 1);
         
-        snprintf(ns->path, sizeof(ns->path), "/proc/%d/ns/%s", pid, ns_type_names[i]);
+        snprintf(ns->path, sizeof(ns->path), "%s/%d/ns/%s", proc_root(), pid, ns_type_names[i]);
         
         if (read_namespace_inode(ns->path, &ns->inode) == 0) {
             ns->available = 1;
@@ -135,7 +143,7 @@ int find_processes_in_namespace(ino_t ns_inode,
     
     *count = 0;
     
-    DIR *proc_dir = opendir("/proc");
+    DIR *proc_dir = opendir(proc_root());
     if (proc_dir == NULL) {
         return -1;
     }
@@ -152,9 +160,9 @@ int find_processes_in_namespace(ino_t ns_inode,
             continue;
         }
         
-        char ns_path[256];
-        snprintf(ns_path, sizeof(ns_path), "/proc/%ld/ns/%s",
-                pid, ns_type_names[ns_type]);
+        char ns_path[PATH_MAX];
+        snprintf(ns_path, sizeof(ns_path), "%s/%ld/ns/%s",
+                proc_root(), pid, ns_type_names[ns_type]);
         
         ino_t inode;
         if (read_namespace_inode(ns_path, &inode) == 0) {
@@ -173,15 +181,15 @@ int find_processes_in_namespace(ino_t ns_inode,
  * Verifica se processo está isolado do init
  */
 int is_process_isolated(pid_t pid, namespace_type_t ns_type) {
-    char path_init[256], path_pid[256];
+    char path_init[PATH_MAX], path_pid[PATH_MAX];
     ino_t inode_init, inode_pid;
     
-    snprintf(path_init, sizeof(path_init), "/proc/1/ns/%s", ns_type_names[ns_type]);
+    snprintf(path_init, sizeof(path_init), "%s/1/ns/%s", proc_root(), ns_type_names[ns_type]);
     if (read_namespace_inode(path_init, &inode_init) != 0) {
         return -1;
     }
     
-    snprintf(path_pid, sizeof(path_pid), "/proc/%d/ns/%s", pid, ns_type_names[ns_type]);
+    snprintf(path_pid, sizeof(path_pid), "%s/%d/ns/%s", proc_root(), pid, ns_type_names[ns_type]);
     if (read_namespace_inode(path_pid, &inode_pid) != 0) {
         return -1;
     }
@@ -189,94 +197,379 @@ int is_process_isolated(pid_t pid, namespace_type_t ns_type) {
     return (inode_init != inode_pid) ? 1 : 0;
 }
 
+// Capacidade inicial de cada conjunto de namespaces (potência de 2)
+#define NS_SET_INITIAL_CAPACITY 64
+// Limite de threads da varredura de /proc
+#define NS_SCAN_MAX_THREADS 8
+// PIDs reservados por vez por cada thread
+#define NS_SCAN_CHUNK 64
+
 /**
- * Obtém estatísticas de namespaces no sistema
+ * Hash de (dispositivo, inode) — finalizador do splitmix64
  */
-int get_namespace_statistics(namespace_statistics_t *stats) {
-    if (stats == NULL) {
-        errno = EINVAL;
+static uint64_t namespace_hash(dev_t dev, ino_t inode) {
+    uint64_t h = (uint64_t)inode ^ (((uint64_t)dev << 32) | ((uint64_t)dev >> 32));
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/**
+ * Dobra a capacidade do conjunto e reinsere as entradas
+ */
+static int namespace_set_grow(namespace_set_t *set) {
+    size_t new_capacity = set->capacity ? set->capacity * 2 : NS_SET_INITIAL_CAPACITY;
+    namespace_member_count_t *slots = calloc(new_capacity, sizeof(*slots));
+    if (slots == NULL) {
         return -1;
     }
-    
-    memset(stats, 0, sizeof(namespace_statistics_t));
-    
-    ino_t unique_inodes[MAX_NAMESPACES][1024];
-    int unique_counts[MAX_NAMESPACES] = {0};
-    
-    DIR *proc_dir = opendir("/proc");
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < set->capacity; i++) {
+        const namespace_member_count_t *entry = &set->slots[i];
+        if (entry->members == 0) {
+            continue;
+        }
+        size_t j = namespace_hash(entry->dev, entry->inode) & mask;
+        while (slots[j].members != 0) {
+            j = (j + 1) & mask;
+        }
+        slots[j] = *entry;
+    }
+
+    free(set->slots);
+    set->slots = slots;
+    set->capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * Soma membros a um namespace, inserindo-o se ainda não existir
+ */
+static int namespace_set_add(namespace_set_t *set, dev_t dev, ino_t inode, int members) {
+    // Mantém fator de carga <= 3/4
+    if ((set->count + 1) * 4 > set->capacity * 3 && namespace_set_grow(set) != 0) {
+        return -1;
+    }
+
+    size_t mask = set->capacity - 1;
+    size_t i = namespace_hash(dev, inode) & mask;
+    while (set->slots[i].members != 0) {
+        if (set->slots[i].inode == inode && set->slots[i].dev == dev) {
+            set->slots[i].members += members;
+            return 0;
+        }
+        i = (i + 1) & mask;
+    }
+
+    set->slots[i].dev = dev;
+    set->slots[i].inode = inode;
+    set->slots[i].members = members;
+    set->count++;
+    return 0;
+}
+
+int namespace_set_members(const namespace_set_t *set, dev_t dev, ino_t inode) {
+    if (set == NULL || set->capacity == 0) {
+        return 0;
+    }
+
+    size_t mask = set->capacity - 1;
+    size_t i = namespace_hash(dev, inode) & mask;
+    while (set->slots[i].members != 0) {
+        if (set->slots[i].inode == inode && set->slots[i].dev == dev) {
+            return set->slots[i].members;
+        }
+        i = (i + 1) & mask;
+    }
+    return 0;
+}
+
+void free_namespace_sets(namespace_set_t sets[MAX_NAMESPACES]) {
+    if (sets == NULL) {
+        return;
+    }
+    for (int i = 0; i < MAX_NAMESPACES; i++) {
+        free(sets[i].slots);
+        memset(&sets[i], 0, sizeof(sets[i]));
+    }
+}
+
+/**
+ * Lista os PIDs presentes em /proc
+ *
+ * @return Número de PIDs (vetor alocado em *pids_out), ou -1 em erro
+ */
+static long list_proc_pids(pid_t **pids_out) {
+    DIR *proc_dir = opendir(proc_root());
     if (proc_dir == NULL) {
         return -1;
     }
-    
+
+    size_t capacity = 1024, count = 0;
+    pid_t *pids = malloc(capacity * sizeof(pid_t));
+    if (pids == NULL) {
+        closedir(proc_dir);
+        return -1;
+    }
+
     struct dirent *entry;
     while ((entry = readdir(proc_dir)) != NULL) {
         if (entry->d_type != DT_DIR) {
             continue;
         }
-        
+
         char *endptr;
         long pid = strtol(entry->d_name, &endptr, 10);
         if (*endptr != '\0' || pid <= 0) {
             continue;
         }
-        
+
+        if (count == capacity) {
+            pid_t *grown = realloc(pids, capacity * 2 * sizeof(pid_t));
+            if (grown == NULL) {
+                free(pids);
+                closedir(proc_dir);
+                return -1;
+            }
+            pids = grown;
+            capacity *= 2;
+        }
+        pids[count++] = (pid_t)pid;
+    }
+
+    closedir(proc_dir);
+    *pids_out = pids;
+    return (long)count;
+}
+
+/**
+ * Lê os namespaces de um PID com fstatat relativo ao dirfd <pid>/ns
+ */
+static int read_namespace_record_at(int dir_fd, pid_t pid,
+                                    process_namespace_record_t *record) {
+    char ns_dir[PATH_MAX];
+
+    memset(record, 0, sizeof(*record));
+    record->pid = pid;
+
+    if (dir_fd == AT_FDCWD) {
+        snprintf(ns_dir, sizeof(ns_dir), "%s/%d/ns", proc_root(), pid);
+    } else {
+        snprintf(ns_dir, sizeof(ns_dir), "%d/ns", pid);
+    }
+    int ns_fd = openat(dir_fd, ns_dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (ns_fd < 0) {
+        // Processo terminou ou sem permissão
+        return -1;
+    }
+
+    for (int i = 0; i < MAX_NAMESPACES; i++) {
+        struct stat st;
+        if (fstatat(ns_fd, ns_type_names[i], &st, 0) == 0) {
+            record->dev[i] = st.st_dev;
+            record->inode[i] = st.st_ino;
+            record->present |= (uint8_t)(1u << i);
+        }
+    }
+
+    close(ns_fd);
+    return 0;
+}
+
+int read_process_namespace_record(pid_t pid, process_namespace_record_t *record) {
+    if (record == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    return read_namespace_record_at(AT_FDCWD, pid, record);
+}
+
+// Estado compartilhado pelas threads da varredura: cada PID tem seu próprio
+// registro, então as threads só disputam o contador de blocos
+typedef struct {
+    int proc_fd;
+    process_namespace_record_t *records;
+    size_t count;
+    atomic_size_t next;
+} namespace_scan_t;
+
+/**
+ * Consome blocos de PIDs até a varredura terminar
+ */
+static void *namespace_scan_worker(void *arg) {
+    namespace_scan_t *scan = arg;
+
+    for (;;) {
+        size_t begin = atomic_fetch_add(&scan->next, NS_SCAN_CHUNK);
+        if (begin >= scan->count) {
+            break;
+        }
+        size_t end = begin + NS_SCAN_CHUNK;
+        if (end > scan->count) {
+            end = scan->count;
+        }
+
+        for (size_t p = begin; p < end; p++) {
+            read_namespace_record_at(scan->proc_fd, scan->records[p].pid, &scan->records[p]);
+        }
+    }
+    return NULL;
+}
+
+long scan_process_namespaces(process_namespace_record_t **records_out, int threads) {
+    if (records_out == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    pid_t *pids = NULL;
+    long pid_count = list_proc_pids(&pids);
+    if (pid_count < 0) {
+        return -1;
+    }
+
+    namespace_scan_t scan;
+    scan.records = calloc(pid_count > 0 ? (size_t)pid_count : 1, sizeof(*scan.records));
+    if (scan.records == NULL) {
+        free(pids);
+        return -1;
+    }
+    for (long i = 0; i < pid_count; i++) {
+        scan.records[i].pid = pids[i];
+    }
+    free(pids);
+
+    scan.proc_fd = open(proc_root(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (scan.proc_fd < 0) {
+        free(scan.records);
+        return -1;
+    }
+    scan.count = (size_t)pid_count;
+    atomic_init(&scan.next, 0);
+
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (int)cpus : 1;
+    }
+    // Não vale a pena uma thread para menos de um bloco de PIDs
+    long max_useful = (pid_count + NS_SCAN_CHUNK - 1) / NS_SCAN_CHUNK;
+    if (threads > max_useful) threads = (int)(max_useful > 0 ? max_useful : 1);
+    if (threads > NS_SCAN_MAX_THREADS) threads = NS_SCAN_MAX_THREADS;
+
+    // A thread chamadora também trabalha; se alguma criação falhar,
+    // os blocos restantes são consumidos pelas demais
+    pthread_t tids[NS_SCAN_MAX_THREADS];
+    int started[NS_SCAN_MAX_THREADS] = {0};
+    for (int t = 1; t < threads; t++) {
+        started[t] = (pthread_create(&tids[t], NULL, namespace_scan_worker, &scan) == 0);
+    }
+    namespace_scan_worker(&scan);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(tids[t], NULL);
+        }
+    }
+
+    close(scan.proc_fd);
+    *records_out = scan.records;
+    return pid_count;
+}
+
+int get_namespace_statistics_detailed(namespace_statistics_t *stats,
+                                      namespace_set_t sets[MAX_NAMESPACES],
+                                      int threads) {
+    if (stats == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(namespace_statistics_t));
+
+    process_namespace_record_t *records = NULL;
+    long count = scan_process_namespaces(&records, threads);
+    if (count < 0) {
+        return -1;
+    }
+
+    namespace_set_t local[MAX_NAMESPACES];
+    memset(local, 0, sizeof(local));
+
+    for (long p = 0; p < count; p++) {
+        const process_namespace_record_t *record = &records[p];
+        if (record->present == 0) {
+            // Terminou entre a listagem e a leitura, ou sem permissão
+            stats->skipped_processes++;
+            continue;
+        }
         stats->total_processes_analyzed++;
-        
         for (int i = 0; i < MAX_NAMESPACES; i++) {
-            char ns_path[256];
-            snprintf(ns_path, sizeof(ns_path), "/proc/%ld/ns/%s",
-                    pid, ns_type_names[i]);
-            
-            ino_t inode;
-            if (read_namespace_inode(ns_path, &inode) == 0) {
-                int found = 0;
-                for (int j = 0; j < unique_counts[i]; j++) {
-                    if (unique_inodes[i][j] == inode) {
-                        found = 1;
-                        break;
-                    }
-                }
-                
-                if (!found && unique_counts[i] < 1024) {
-                    unique_inodes[i][unique_counts[i]++] = inode;
-                }
+            if ((record->present & (1u << i)) &&
+                namespace_set_add(&local[i], record->dev[i], record->inode[i], 1) != 0) {
+                free_namespace_sets(local);
+                free(records);
+                errno = ENOMEM;
+                return -1;
             }
         }
     }
-    
-    closedir(proc_dir);
-    
-    stats->unique_cgroup_namespaces = unique_counts[NS_CGROUP];
-    stats->unique_ipc_namespaces = unique_counts[NS_IPC];
-    stats->unique_mnt_namespaces = unique_counts[NS_MNT];
-    stats->unique_net_namespaces = unique_counts[NS_NET];
-    stats->unique_pid_namespaces = unique_counts[NS_PID];
-    stats->unique_time_namespaces = unique_counts[NS_TIME];
-    stats->unique_user_namespaces = unique_counts[NS_USER];
-    stats->unique_uts_namespaces = unique_counts[NS_UTS];
-    
+    free(records);
+
+    stats->unique_cgroup_namespaces = (int)local[NS_CGROUP].count;
+    stats->unique_ipc_namespaces = (int)local[NS_IPC].count;
+    stats->unique_mnt_namespaces = (int)local[NS_MNT].count;
+    stats->unique_net_namespaces = (int)local[NS_NET].count;
+    stats->unique_pid_namespaces = (int)local[NS_PID].count;
+    stats->unique_time_namespaces = (int)local[NS_TIME].count;
+    stats->unique_user_namespaces = (int)local[NS_USER].count;
+    stats->unique_uts_namespaces = (int)local[NS_UTS].count;
+
+    if (sets != NULL) {
+        memcpy(sets, local, sizeof(local));
+    } else {
+        free_namespace_sets(local);
+    }
     return 0;
 }
 
+/**
+ * Obtém estatísticas de namespaces no sistema
+ */
+int get_namespace_statistics(namespace_statistics_t *stats) {
+    return get_namespace_statistics_detailed(stats, NULL, 0);
+}
+
+/**
+ * Converte tipo de namespace para a flag CLONE_NEW* correspondente
+ */
+int namespace_type_to_clone_flag(namespace_type_t type) {
+    switch (type) {
+        case NS_CGROUP: return CLONE_NEWCGROUP;
+        case NS_IPC:    return CLONE_NEWIPC;
+        case NS_MNT:    return CLONE_NEWNS;
+        case NS_NET:    return CLONE_NEWNET;
+        case NS_PID:    return CLONE_NEWPID;
+        case NS_TIME:   return CLONE_NEWTIME;
+        case NS_USER:   return CLONE_NEWUSER;
+        case NS_UTS:    return CLONE_NEWUTS;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+}
+
 /**
  * Mede tempo de criação de namespace
  */
 long measure_namespace_creation_time(namespace_type_t ns_type) {
     struct timespec start, end;
     
-    int flags = 0;
-    switch (ns_type) {
-        case NS_CGROUP: flags = CLONE_NEWCGROUP; break;
-        case NS_IPC:    flags = CLONE_NEWIPC; break;
-        case NS_MNT:    flags = CLONE_NEWNS; break;
-        case NS_NET:    flags = CLONE_NEWNET; break;
-        case NS_PID:    flags = CLONE_NEWPID; break;
-        case NS_USER:   flags = CLONE_NEWUSER; break;
-        case NS_UTS:    flags = CLONE_NEWUTS; break;
-        case NS_TIME:   return -1;
-        default:
-            errno = EINVAL;
-            return -1;
+    int flags = namespace_type_to_clone_flag(ns_type);
+    if (flags < 0) {
+        return -1;
     }
     
     clock_gettime(CLOCK_MONOTONIC, &start);
@@ -378,7 +671,11 @@ void print_namespace_statistics(const namespace_statistics_t *stats) {
     
     printf("\nSystem Namespace Statistics\n");
     printf("═══════════════════════════════════════════════════════════\n");
-    printf("Total Processes Analyzed: %d\n\n", stats->total_processes_analyzed);
+    printf("Total Processes Analyzed: %d\n", stats->total_processes_analyzed);
+    if (stats->skipped_processes > 0) {
+        printf("Skipped (exited or no access): %d\n", stats->skipped_processes);
+    }
+    printf("\n");
     
     printf("Unique Namespaces per Type:\n");
     printf("  cgroup: %d\n", stats->unique_cgroup_namespaces);
@@ -391,6 +688,41 @@ void print_namespace_statistics(const namespace_statistics_t *stats) {
     printf("  uts:    %d\n", stats->unique_uts_namespaces);
 }
 
+static int compare_member_counts(const void *a, const void *b) {
+    const namespace_member_count_t *ma = a, *mb = b;
+    return (mb->members > ma->members) - (mb->members < ma->members);
+}
+
+void print_namespace_member_counts(const namespace_set_t *set,
+                                   namespace_type_t type, int limit) {
+    if (set == NULL) {
+        return;
+    }
+
+    namespace_member_count_t *entries = malloc((set->count ? set->count : 1) * sizeof(*entries));
+    if (entries == NULL) {
+        return;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (set->slots[i].members != 0) {
+            entries[n++] = set->slots[i];
+        }
+    }
+    qsort(entries, n, sizeof(*entries), compare_member_counts);
+
+    size_t shown = (limit > 0 && (size_t)limit < n) ? (size_t)limit : n;
+    printf("\n%s namespaces by member count (%zu of %zu):\n",
+           namespace_type_to_string(type), shown, n);
+    printf("  %-20s %-10s\n", "Inode", "Processes");
+    for (size_t i = 0; i < shown; i++) {
+        printf("  %-20lu %-10d\n", (unsigned long)entries[i].inode, entries[i].members);
+    }
+
+    free(entries);
+}
+
 // Note: As funções de relatório (generate_namespace_report, map_processes_by_namespace, 
 // generate_process_namespace_report) serão implementadas posteriormente se necessário
 // para evitar complexidade desnecessária neste momento.
@@ -0,0 +1,326 @@
+#define _GNU_SOURCE
+#include "namespace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sched.h>
+#include <time.h>
+#include <linux/sched.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+// Amostra descartada (operação falhou)
+#define SAMPLE_FAILED UINT64_MAX
+
+// Nomes dos métodos
+static const char* method_names[NS_BENCH_METHOD_COUNT] = {
+    "unshare",
+    "clone",
+    "setns",
+    "fork"
+};
+
+const char* namespace_bench_method_to_string(namespace_bench_method_t method) {
+    if (method >= 0 && method < NS_BENCH_METHOD_COUNT) {
+        return method_names[method];
+    }
+    return "unknown";
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Arquivo em /proc/<pid>/ns usado para entrar no namespace com setns
+ *
+ * Para pid e time o próprio processo continua no namespace antigo; só os
+ * filhos nascem no novo, então o alvo é o *_for_children
+ */
+static const char* setns_target_name(namespace_type_t type) {
+    switch (type) {
+        case NS_PID:  return "pid_for_children";
+        case NS_TIME: return "time_for_children";
+        default:      return namespace_type_to_string(type);
+    }
+}
+
+/**
+ * Cria um processo que mantém um namespace novo vivo para os testes de setns
+ * @return PID do processo, ou -1 em erro
+ */
+static pid_t start_namespace_holder(int flag) {
+    int ready[2];
+    if (pipe(ready) != 0) {
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(ready[0]);
+        close(ready[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        close(ready[0]);
+        char status = (unshare(flag) == 0) ? 'y' : 'n';
+
+        // O namespace de PID só passa a existir com o primeiro filho (init)
+        if (status == 'y' && flag == CLONE_NEWPID) {
+            pid_t init = fork();
+            if (init == 0) {
+                prctl(PR_SET_PDEATHSIG, SIGKILL);
+                pause();
+                _exit(0);
+            }
+            if (init < 0) {
+                status = 'n';
+            }
+        }
+
+        if (write(ready[1], &status, 1) != 1 || status != 'y') {
+            _exit(1);
+        }
+        close(ready[1]);
+        pause();
+        _exit(0);
+    }
+
+    close(ready[1]);
+    char status = 'n';
+    if (read(ready[0], &status, 1) != 1 || status != 'y') {
+        close(ready[0]);
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        errno = EPERM;
+        return -1;
+    }
+    close(ready[0]);
+    return pid;
+}
+
+/**
+ * Uma iteração: o tempo cobre apenas a operação medida
+ *
+ * unshare e setns rodam num filho recém-criado (o fork fica fora da medição
+ * e cada iteração parte de um processo limpo, o que é necessário para pid,
+ * user e time, que não podem ser repetidos no mesmo processo). clone mede a
+ * chamada clone3 no pai, que inclui a cópia do processo; o método fork é a
+ * linha de base desse custo.
+ */
+static uint64_t run_iteration(namespace_bench_method_t method, int flag, int ns_fd,
+                              volatile uint64_t *slot) {
+    if (method == NS_BENCH_CLONE || method == NS_BENCH_FORK) {
+        struct clone_args args;
+        memset(&args, 0, sizeof(args));
+        args.flags = (method == NS_BENCH_CLONE) ? (uint64_t)flag : 0;
+        args.exit_signal = SIGCHLD;
+
+        uint64_t start = now_ns();
+        long pid = syscall(SYS_clone3, &args, sizeof(args));
+        uint64_t end = now_ns();
+
+        if (pid == 0) {
+            _exit(0);
+        }
+        if (pid < 0) {
+            return SAMPLE_FAILED;
+        }
+        waitpid((pid_t)pid, NULL, 0);
+        return end - start;
+    }
+
+    *slot = SAMPLE_FAILED;
+    pid_t pid = fork();
+    if (pid < 0) {
+        return SAMPLE_FAILED;
+    }
+
+    if (pid == 0) {
+        uint64_t start = now_ns();
+        int ret = (method == NS_BENCH_UNSHARE) ? unshare(flag) : setns(ns_fd, flag);
+        uint64_t end = now_ns();
+        *slot = (ret == 0) ? end - start : SAMPLE_FAILED;
+        _exit(0);
+    }
+
+    waitpid(pid, NULL, 0);
+    return *slot;
+}
+
+static int compare_uint64(const void *a, const void *b) {
+    uint64_t ua = *(const uint64_t *)a, ub = *(const uint64_t *)b;
+    return (ua > ub) - (ua < ub);
+}
+
+static double percentile_us(const uint64_t *sorted, int n, double p) {
+    int idx = (int)(p / 100.0 * (n - 1) + 0.5);
+    return sorted[idx] / 1000.0;
+}
+
+int run_namespace_benchmark(namespace_type_t type, namespace_bench_method_t method,
+                            int iterations, int concurrency,
+                            namespace_bench_result_t *result) {
+    if (result == NULL || iterations <= 0 || concurrency <= 0 ||
+        method < 0 || method >= NS_BENCH_METHOD_COUNT ||
+        type < 0 || type >= MAX_NAMESPACES) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->type = type;
+    result->method = method;
+    result->concurrency = concurrency;
+
+    int flag = namespace_type_to_clone_flag(type);
+    if (flag < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    pid_t holder = -1;
+    int ns_fd = -1;
+    if (method == NS_BENCH_SETNS) {
+        holder = start_namespace_holder(flag);
+        if (holder < 0) {
+            return -1;
+        }
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%d/ns/%s", holder, setns_target_name(type));
+        ns_fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (ns_fd < 0) {
+            kill(holder, SIGKILL);
+            waitpid(holder, NULL, 0);
+            return -1;
+        }
+    }
+
+    // Amostras e slots de troca ficam em memória compartilhada com os
+    // processos trabalhadores e seus filhos
+    size_t samples_size = (size_t)iterations * sizeof(uint64_t);
+    size_t slots_size = (size_t)concurrency * sizeof(uint64_t);
+    uint64_t *shared = mmap(NULL, samples_size + slots_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        if (holder > 0) {
+            close(ns_fd);
+            kill(holder, SIGKILL);
+            waitpid(holder, NULL, 0);
+        }
+        return -1;
+    }
+    uint64_t *samples = shared;
+    volatile uint64_t *slots = shared + iterations;
+
+    // Barreira: todos os trabalhadores começam juntos quando o pipe fecha
+    int start_pipe[2];
+    if (pipe(start_pipe) != 0) {
+        munmap(shared, samples_size + slots_size);
+        if (holder > 0) {
+            close(ns_fd);
+            kill(holder, SIGKILL);
+            waitpid(holder, NULL, 0);
+        }
+        return -1;
+    }
+
+    pid_t *workers = calloc((size_t)concurrency, sizeof(pid_t));
+    int started = 0;
+    for (int w = 0; workers != NULL && w < concurrency; w++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            break;
+        }
+        if (pid == 0) {
+            close(start_pipe[1]);
+            char c;
+            while (read(start_pipe[0], &c, 1) < 0 && errno == EINTR) {
+            }
+            close(start_pipe[0]);
+
+            // Iterações distribuídas em faixa: w, w + concurrency, ...
+            for (int i = w; i < iterations; i += concurrency) {
+                samples[i] = run_iteration(method, flag, ns_fd, &slots[w]);
+            }
+            _exit(0);
+        }
+        workers[started++] = pid;
+    }
+
+    close(start_pipe[0]);
+    uint64_t wall_start = now_ns();
+    close(start_pipe[1]);
+
+    for (int w = 0; w < started; w++) {
+        waitpid(workers[w], NULL, 0);
+    }
+    uint64_t wall_end = now_ns();
+    free(workers);
+
+    if (holder > 0) {
+        close(ns_fd);
+        kill(holder, SIGKILL);
+        waitpid(holder, NULL, 0);
+    }
+
+    if (started < concurrency) {
+        munmap(shared, samples_size + slots_size);
+        errno = EAGAIN;
+        return -1;
+    }
+
+    // Compacta as amostras válidas no início do vetor
+    int ok = 0;
+    double sum = 0;
+    for (int i = 0; i < iterations; i++) {
+        if (samples[i] != SAMPLE_FAILED) {
+            samples[ok++] = samples[i];
+            sum += samples[i];
+        }
+    }
+
+    result->iterations = iterations;
+    result->failures = iterations - ok;
+    result->wall_seconds = (wall_end - wall_start) / 1e9;
+
+    if (ok > 0) {
+        qsort(samples, (size_t)ok, sizeof(uint64_t), compare_uint64);
+        result->mean_us = sum / ok / 1000.0;
+        result->p50_us = percentile_us(samples, ok, 50);
+        result->p90_us = percentile_us(samples, ok, 90);
+        result->p99_us = percentile_us(samples, ok, 99);
+        result->max_us = samples[ok - 1] / 1000.0;
+        result->ops_per_sec = result->wall_seconds > 0 ? ok / result->wall_seconds : 0;
+    }
+
+    munmap(shared, samples_size + slots_size);
+    if (ok == 0) {
+        errno = EPERM;
+        return -1;
+    }
+    return 0;
+}
+
+void print_namespace_bench_result(const namespace_bench_result_t *result) {
+    if (result == NULL) {
+        return;
+    }
+
+    printf("NSBENCH_RESULT:type=%s,method=%s,concurrency=%d,n=%d,failures=%d,"
+           "mean_us=%.2f,p50_us=%.2f,p90_us=%.2f,p99_us=%.2f,max_us=%.2f,ops_per_sec=%.1f\n",
+           result->method == NS_BENCH_FORK ? "none" : namespace_type_to_string(result->type),
+           namespace_bench_method_to_string(result->method),
+           result->concurrency, result->iterations, result->failures,
+           result->mean_us, result->p50_us, result->p90_us, result->p99_us,
+           result->max_us, result->ops_per_sec);
+}
@@ -0,0 +1,672 @@
+#define _GNU_SOURCE
+#include "namespace.h"
+#include "monitor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+// Capacidades iniciais (potências de 2)
+#define INDEX_INITIAL_PROCESSES 1024
+#define INDEX_INITIAL_NAMESPACES 64
+#define INDEX_INITIAL_MEMBERS 4
+
+/**
+ * Finalizador do splitmix64
+ */
+static uint64_t index_hash(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+/**
+ * Verifica se o slot j pode ocupar a lacuna i na remoção com deslocamento
+ * para trás (home é o slot ideal da entrada em j)
+ */
+static int can_fill_gap(size_t i, size_t j, size_t home) {
+    if (i <= j) {
+        return home <= i || home > j;
+    }
+    return home <= i && home > j;
+}
+
+// ============================================================================
+// Tabela PID -> namespaces
+// ============================================================================
+
+static long process_slot(const namespace_index_t *index, pid_t pid) {
+    if (index->process_capacity == 0) {
+        return -1;
+    }
+
+    size_t mask = index->process_capacity - 1;
+    size_t i = index_hash((uint64_t)pid) & mask;
+    while (index->processes[i].ns.pid != 0) {
+        if (index->processes[i].ns.pid == pid) {
+            return (long)i;
+        }
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
+
+static int process_table_grow(namespace_index_t *index) {
+    size_t new_capacity = index->process_capacity ? index->process_capacity * 2
+                                                  : INDEX_INITIAL_PROCESSES;
+    namespace_index_process_t *slots = calloc(new_capacity, sizeof(*slots));
+    if (slots == NULL) {
+        return -1;
+    }
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < index->process_capacity; i++) {
+        if (index->processes[i].ns.pid == 0) {
+            continue;
+        }
+        size_t j = index_hash((uint64_t)index->processes[i].ns.pid) & mask;
+        while (slots[j].ns.pid != 0) {
+            j = (j + 1) & mask;
+        }
+        slots[j] = index->processes[i];
+    }
+
+    free(index->processes);
+    index->processes = slots;
+    index->process_capacity = new_capacity;
+    return 0;
+}
+
+static void process_table_delete(namespace_index_t *index, size_t slot) {
+    size_t mask = index->process_capacity - 1;
+    size_t i = slot, j = slot;
+
+    for (;;) {
+        j = (j + 1) & mask;
+        if (index->processes[j].ns.pid == 0) {
+            break;
+        }
+        size_t home = index_hash((uint64_t)index->processes[j].ns.pid) & mask;
+        if (can_fill_gap(i, j, home)) {
+            index->processes[i] = index->processes[j];
+            i = j;
+        }
+    }
+
+    memset(&index->processes[i], 0, sizeof(index->processes[i]));
+    index->process_count--;
+}
+
+// ============================================================================
+// Tabelas (dev, inode) -> lista de PIDs, uma por tipo
+// ============================================================================
+
+static long namespace_slot(const namespace_index_t *index, namespace_type_t type,
+                           dev_t dev, ino_t inode, int match_dev) {
+    if (index->entry_capacity[type] == 0) {
+        return -1;
+    }
+
+    const namespace_index_entry_t *entries = index->entries[type];
+    size_t mask = index->entry_capacity[type] - 1;
+    size_t i = index_hash((uint64_t)inode) & mask;
+    while (entries[i].count != 0) {
+        if (entries[i].inode == inode && (!match_dev || entries[i].dev == dev)) {
+            return (long)i;
+        }
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
+
+static int namespace_table_grow(namespace_index_t *index, namespace_type_t type) {
+    size_t old_capacity = index->entry_capacity[type];
+    size_t new_capacity = old_capacity ? old_capacity * 2 : INDEX_INITIAL_NAMESPACES;
+    namespace_index_entry_t *slots = calloc(new_capacity, sizeof(*slots));
+    if (slots == NULL) {
+        return -1;
+    }
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        const namespace_index_entry_t *entry = &index->entries[type][i];
+        if (entry->count == 0) {
+            continue;
+        }
+        size_t j = index_hash((uint64_t)entry->inode) & mask;
+        while (slots[j].count != 0) {
+            j = (j + 1) & mask;
+        }
+        slots[j] = *entry;
+    }
+
+    free(index->entries[type]);
+    index->entries[type] = slots;
+    index->entry_capacity[type] = new_capacity;
+    return 0;
+}
+
+static void namespace_table_delete(namespace_index_t *index, namespace_type_t type, size_t slot) {
+    namespace_index_entry_t *entries = index->entries[type];
+    size_t mask = index->entry_capacity[type] - 1;
+    size_t i = slot, j = slot;
+
+    free(entries[slot].pids);
+    for (;;) {
+        j = (j + 1) & mask;
+        if (entries[j].count == 0) {
+            break;
+        }
+        size_t home = index_hash((uint64_t)entries[j].inode) & mask;
+        if (can_fill_gap(i, j, home)) {
+            entries[i] = entries[j];
+            i = j;
+        }
+    }
+
+    memset(&entries[i], 0, sizeof(entries[i]));
+    index->entry_count[type]--;
+}
+
+/**
+ * Acrescenta o PID à lista do namespace
+ * @return Posição do PID na lista, ou -1 em erro
+ */
+static int namespace_add_member(namespace_index_t *index, namespace_type_t type,
+                                dev_t dev, ino_t inode, pid_t pid) {
+    long slot = namespace_slot(index, type, dev, inode, 1);
+
+    if (slot < 0) {
+        if ((index->entry_count[type] + 1) * 4 > index->entry_capacity[type] * 3 &&
+            namespace_table_grow(index, type) != 0) {
+            return -1;
+        }
+        size_t mask = index->entry_capacity[type] - 1;
+        size_t i = index_hash((uint64_t)inode) & mask;
+        while (index->entries[type][i].count != 0) {
+            i = (i + 1) & mask;
+        }
+
+        namespace_index_entry_t *entry = &index->entries[type][i];
+        entry->pids = malloc(INDEX_INITIAL_MEMBERS * sizeof(pid_t));
+        if (entry->pids == NULL) {
+            return -1;
+        }
+        entry->dev = dev;
+        entry->inode = inode;
+        entry->capacity = INDEX_INITIAL_MEMBERS;
+        entry->count = 1;
+        entry->pids[0] = pid;
+        index->entry_count[type]++;
+        return 0;
+    }
+
+    namespace_index_entry_t *entry = &index->entries[type][slot];
+    if (entry->count == entry->capacity) {
+        pid_t *grown = realloc(entry->pids, (size_t)entry->capacity * 2 * sizeof(pid_t));
+        if (grown == NULL) {
+            return -1;
+        }
+        entry->pids = grown;
+        entry->capacity *= 2;
+    }
+    entry->pids[entry->count] = pid;
+    return entry->count++;
+}
+
+/**
+ * Remove o PID da lista do namespace trocando-o pelo último membro
+ */
+static void namespace_remove_member(namespace_index_t *index, namespace_type_t type,
+                                    dev_t dev, ino_t inode, int position) {
+    long slot = namespace_slot(index, type, dev, inode, 1);
+    if (slot < 0) {
+        return;
+    }
+
+    namespace_index_entry_t *entry = &index->entries[type][slot];
+    if (position < 0 || position >= entry->count) {
+        return;
+    }
+
+    int last = entry->count - 1;
+    if (position != last) {
+        pid_t moved = entry->pids[last];
+        entry->pids[position] = moved;
+        long moved_slot = process_slot(index, moved);
+        if (moved_slot >= 0) {
+            index->processes[moved_slot].position[type] = position;
+        }
+    }
+    entry->count--;
+
+    if (entry->count == 0) {
+        namespace_table_delete(index, type, (size_t)slot);
+    }
+}
+
+// ============================================================================
+// Inserção e remoção de processos
+// ============================================================================
+
+static void index_remove_process(namespace_index_t *index, pid_t pid) {
+    long slot = process_slot(index, pid);
+    if (slot < 0) {
+        return;
+    }
+
+    namespace_index_process_t process = index->processes[slot];
+    process_table_delete(index, (size_t)slot);
+
+    for (int i = 0; i < MAX_NAMESPACES; i++) {
+        if (process.ns.present & (1u << i)) {
+            namespace_remove_member(index, (namespace_type_t)i, process.ns.dev[i],
+                                    process.ns.inode[i], process.position[i]);
+        }
+    }
+}
+
+static int index_add_record(namespace_index_t *index, const process_namespace_record_t *record) {
+    if (record->pid <= 0 || record->present == 0) {
+        return 0;
+    }
+
+    index_remove_process(index, record->pid);
+
+    if ((index->process_count + 1) * 4 > index->process_capacity * 3 &&
+        process_table_grow(index) != 0) {
+        return -1;
+    }
+
+    namespace_index_process_t process;
+    memset(&process, 0, sizeof(process));
+    process.ns = *record;
+
+    for (int i = 0; i < MAX_NAMESPACES; i++) {
+        if (!(record->present & (1u << i))) {
+            continue;
+        }
+        process.position[i] = namespace_add_member(index, (namespace_type_t)i,
+                                                   record->dev[i], record->inode[i],
+                                                   record->pid);
+        if (process.position[i] < 0) {
+            return -1;
+        }
+    }
+
+    size_t mask = index->process_capacity - 1;
+    size_t i = index_hash((uint64_t)record->pid) & mask;
+    while (index->processes[i].ns.pid != 0) {
+        i = (i + 1) & mask;
+    }
+    index->processes[i] = process;
+    index->process_count++;
+    return 0;
+}
+
+static void index_clear(namespace_index_t *index) {
+    for (int t = 0; t < MAX_NAMESPACES; t++) {
+        for (size_t i = 0; i < index->entry_capacity[t]; i++) {
+            free(index->entries[t][i].pids);
+        }
+        free(index->entries[t]);
+        index->entries[t] = NULL;
+        index->entry_capacity[t] = 0;
+        index->entry_count[t] = 0;
+    }
+    free(index->processes);
+    index->processes = NULL;
+    index->process_capacity = 0;
+    index->process_count = 0;
+}
+
+// ============================================================================
+// Eventos de processo (netlink proc connector)
+// ============================================================================
+
+/**
+ * Assina eventos fork/exec/exit do kernel
+ *
+ * @return Socket não bloqueante, ou -1 (requer CAP_NET_ADMIN)
+ */
+static int open_process_events(void) {
+    int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    union {
+        struct nlmsghdr hdr;
+        char raw[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    } request;
+    memset(&request, 0, sizeof(request));
+
+    enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+    request.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+    request.hdr.nlmsg_type = NLMSG_DONE;
+    request.hdr.nlmsg_pid = (uint32_t)getpid();
+
+    struct cn_msg *msg = NLMSG_DATA(&request.hdr);
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(op);
+    memcpy(msg->data, &op, sizeof(op));
+
+    if (send(fd, &request, request.hdr.nlmsg_len, 0) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Relê os namespaces de um PID e atualiza o índice
+ */
+static void index_refresh_process(namespace_index_t *index, pid_t pid) {
+    process_namespace_record_t record;
+    if (read_process_namespace_record(pid, &record) == 0) {
+        if (index_add_record(index, &record) != 0) {
+            index->needs_rescan = 1;
+        }
+    } else {
+        index_remove_process(index, pid);
+    }
+}
+
+/**
+ * Aplica os eventos pendentes no socket
+ */
+static void index_drain_events(namespace_index_t *index) {
+    union {
+        struct nlmsghdr hdr;
+        char raw[8192];
+    } buf;
+
+    for (;;) {
+        ssize_t received = recv(index->events_fd, &buf, sizeof(buf), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            if (errno == ENOBUFS) {
+                // Eventos perdidos: o índice pode estar desatualizado
+                index->needs_rescan = 1;
+                continue;
+            }
+            close(index->events_fd);
+            index->events_fd = -1;
+            index->needs_rescan = 1;
+            break;
+        }
+
+        int len = (int)received;
+        for (struct nlmsghdr *nlh = &buf.hdr; NLMSG_OK(nlh, (unsigned int)len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_NOOP || nlh->nlmsg_type == NLMSG_ERROR) {
+                continue;
+            }
+
+            const struct cn_msg *msg = NLMSG_DATA(nlh);
+            if (msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC) {
+                continue;
+            }
+
+            const struct proc_event *event = (const struct proc_event *)msg->data;
+            switch (event->what) {
+                case PROC_EVENT_FORK:
+                    // Só líderes de grupo; threads compartilham os namespaces do processo
+                    if (event->event_data.fork.child_pid == event->event_data.fork.child_tgid) {
+                        index_refresh_process(index, event->event_data.fork.child_tgid);
+                        index->events_applied++;
+                    }
+                    break;
+                case PROC_EVENT_EXEC:
+                    // Runtimes de contêiner entram nos namespaces antes do exec
+                    index_refresh_process(index, event->event_data.exec.process_tgid);
+                    index->events_applied++;
+                    break;
+                case PROC_EVENT_EXIT:
+                    if (event->event_data.exit.process_pid == event->event_data.exit.process_tgid) {
+                        index_remove_process(index, event->event_data.exit.process_tgid);
+                        index->events_applied++;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// API pública
+// ============================================================================
+
+int namespace_index_rescan(namespace_index_t *index) {
+    if (index == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    process_namespace_record_t *records = NULL;
+    long count = scan_process_namespaces(&records, 0);
+    if (count < 0) {
+        return -1;
+    }
+
+    index_clear(index);
+    int result = 0;
+    for (long i = 0; i < count; i++) {
+        if (index_add_record(index, &records[i]) != 0) {
+            result = -1;
+            break;
+        }
+    }
+    free(records);
+
+    index->needs_rescan = (result != 0);
+    index->full_scans++;
+    return result;
+}
+
+int namespace_index_init(namespace_index_t *index, int follow_events) {
+    if (index == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(index, 0, sizeof(*index));
+    index->events_fd = -1;
+
+    // Assinar antes da varredura para não perder processos criados durante ela
+    if (follow_events) {
+        index->events_fd = open_process_events();
+    }
+
+    if (namespace_index_rescan(index) != 0) {
+        namespace_index_free(index);
+        return -1;
+    }
+    return 0;
+}
+
+int namespace_index_refresh(namespace_index_t *index) {
+    if (index == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (index->events_fd >= 0) {
+        index_drain_events(index);
+    }
+    if (index->events_fd < 0 || index->needs_rescan) {
+        return namespace_index_rescan(index);
+    }
+    return 0;
+}
+
+void namespace_index_free(namespace_index_t *index) {
+    if (index == NULL) {
+        return;
+    }
+    if (index->events_fd >= 0) {
+        close(index->events_fd);
+    }
+    index_clear(index);
+    index->events_fd = -1;
+}
+
+const pid_t* namespace_index_find(const namespace_index_t *index,
+                                  namespace_type_t ns_type, ino_t ns_inode,
+                                  int *count) {
+    if (count != NULL) {
+        *count = 0;
+    }
+    if (index == NULL || ns_type < 0 || ns_type >= MAX_NAMESPACES) {
+        return NULL;
+    }
+
+    long slot = namespace_slot(index, ns_type, 0, ns_inode, 0);
+    if (slot < 0) {
+        return NULL;
+    }
+    if (count != NULL) {
+        *count = index->entries[ns_type][slot].count;
+    }
+    return index->entries[ns_type][slot].pids;
+}
+
+int namespace_index_lookup(const namespace_index_t *index, pid_t pid,
+                           process_namespaces_t *ns_info) {
+    if (index == NULL || ns_info == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    long slot = process_slot(index, pid);
+    if (slot < 0) {
+        errno = ESRCH;
+        return -1;
+    }
+
+    const process_namespace_record_t *record = &index->processes[slot].ns;
+    memset(ns_info, 0, sizeof(*ns_info));
+    ns_info->pid = pid;
+
+    for (int i = 0; i < MAX_NAMESPACES; i++) {
+        namespace_info_t *ns = &ns_info->namespaces[i];
+        ns->type = (namespace_type_t)i;
+        const char *name = namespace_type_to_string(ns->type);
+        strncpy(ns->type_name, name, sizeof(ns->type_name) - 1);
+        snprintf(ns->path, sizeof(ns->path), "%s/%d/ns/%s", proc_root(), pid, name);
+        if (record->present & (1u << i)) {
+            ns->available = 1;
+            ns->inode = record->inode[i];
+            ns_info->count++;
+        }
+    }
+    return 0;
+}
+
+int namespace_index_is_isolated(const namespace_index_t *index, pid_t pid,
+                                namespace_type_t ns_type) {
+    if (index == NULL || ns_type < 0 || ns_type >= MAX_NAMESPACES) {
+        return -1;
+    }
+
+    long init_slot = process_slot(index, 1);
+    long slot = process_slot(index, pid);
+    if (init_slot < 0 || slot < 0) {
+        return -1;
+    }
+
+    const process_namespace_record_t *init = &index->processes[init_slot].ns;
+    const process_namespace_record_t *proc = &index->processes[slot].ns;
+    uint8_t bit = (uint8_t)(1u << ns_type);
+    if (!(init->present & bit) || !(proc->present & bit)) {
+        return -1;
+    }
+    return (init->inode[ns_type] != proc->inode[ns_type]) ? 1 : 0;
+}
+
+int namespace_index_compare(const namespace_index_t *index, pid_t pid1, pid_t pid2,
+                            namespace_comparison_t *comparisons, int *count) {
+    if (index == NULL || comparisons == NULL || count == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    long slot1 = process_slot(index, pid1);
+    long slot2 = process_slot(index, pid2);
+    if (slot1 < 0 || slot2 < 0) {
+        errno = ESRCH;
+        return -1;
+    }
+
+    const process_namespace_record_t *ns1 = &index->processes[slot1].ns;
+    const process_namespace_record_t *ns2 = &index->processes[slot2].ns;
+
+    *count = 0;
+    for (int i = 0; i < MAX_NAMESPACES; i++) {
+        uint8_t bit = (uint8_t)(1u << i);
+        if (!(ns1->present & bit) || !(ns2->present & bit)) {
+            continue;
+        }
+
+        namespace_comparison_t *comp = &comparisons[*count];
+        memset(comp, 0, sizeof(*comp));
+        comp->type = (namespace_type_t)i;
+        strncpy(comp->type_name, namespace_type_to_string(comp->type), sizeof(comp->type_name) - 1);
+        comp->inode_pid1 = ns1->inode[i];
+        comp->inode_pid2 = ns2->inode[i];
+        comp->shared = (ns1->dev[i] == ns2->dev[i] && comp->inode_pid1 == comp->inode_pid2) ? 1 : 0;
+        (*count)++;
+    }
+    return 0;
+}
+
+void print_namespace_membership(const namespace_index_t *index, pid_t pid) {
+    process_namespaces_t ns_info;
+    if (namespace_index_lookup(index, pid, &ns_info) != 0) {
+        return;
+    }
+
+    printf("\nNamespace membership for PID %d (%zu processes indexed):\n",
+           pid, index->process_count);
+    printf("%-10s %-20s %-10s %-10s\n", "Type", "Inode", "Members", "Isolated");
+    printf("───────────────────────────────────────────────────────────\n");
+
+    for (int i = 0; i < MAX_NAMESPACES; i++) {
+        const namespace_info_t *ns = &ns_info.namespaces[i];
+        if (!ns->available) {
+            continue;
+        }
+
+        int members = 0;
+        namespace_index_find(index, ns->type, ns->inode, &members);
+        int isolated = namespace_index_is_isolated(index, pid, ns->type);
+
+        printf("%-10s %-20lu %-10d %-10s\n",
+               ns->type_name, (unsigned long)ns->inode, members,
+               isolated < 0 ? "N/A" : (isolated ? "Yes" : "No"));
+    }
+}
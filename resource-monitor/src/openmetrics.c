@@ -0,0 +1,658 @@
+#define _GNU_SOURCE
+#include "openmetrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define REQUEST_MAX 4096
+// Prazo da conexão inteira (ler a requisição e enviar a página): um cliente
+// lento só perde a própria resposta
+#define CLIENT_DEADLINE_MS 2000
+// Conexões atendidas ao mesmo tempo; as demais esperam no backlog
+#define MAX_CLIENTS 32
+
+// ----------------------------------------------------------------------------
+// Famílias
+// ----------------------------------------------------------------------------
+
+typedef enum {
+    VALUE_U64,
+    VALUE_U32,
+    VALUE_F64,
+    VALUE_TICKS,                // Ticks de clock -> segundos
+    VALUE_USEC                  // Microssegundos -> segundos
+} value_kind_t;
+
+typedef enum {
+    SCOPE_PROCESS,              // Requer flags & need
+    SCOPE_CGROUP_CPU,
+    SCOPE_CGROUP_MEMORY,
+    SCOPE_CGROUP_BLKIO,
+    SCOPE_CGROUP_PIDS
+} family_scope_t;
+
+/**
+ * Família de métricas: nome, tipo, ajuda e onde o valor está em metrics_target_t
+ */
+typedef struct {
+    const char *name;
+    const char *type;           // "counter" ganha o sufixo _total na amostra
+    const char *unit;           // NULL = sem unidade
+    const char *help;
+    family_scope_t scope;
+    uint32_t need;              // EXPORT_HAS_* para SCOPE_PROCESS
+    value_kind_t kind;
+    size_t offset;
+} metric_family_t;
+
+#define TARGET(member) offsetof(metrics_target_t, member)
+
+static const metric_family_t families[] = {
+    { "resource_monitor_process_cpu_user_seconds", "counter", "seconds",
+      "CPU time spent in user mode.", SCOPE_PROCESS, EXPORT_HAS_CPU, VALUE_TICKS, TARGET(cpu.user_time) },
+    { "resource_monitor_process_cpu_system_seconds", "counter", "seconds",
+      "CPU time spent in kernel mode.", SCOPE_PROCESS, EXPORT_HAS_CPU, VALUE_TICKS, TARGET(cpu.system_time) },
+    { "resource_monitor_process_cpu_percent", "gauge", NULL,
+      "CPU usage over the last interval, in percent of one core.", SCOPE_PROCESS, EXPORT_HAS_CPU, VALUE_F64, TARGET(cpu.cpu_percent) },
+    { "resource_monitor_process_threads", "gauge", NULL,
+      "Number of threads.", SCOPE_PROCESS, EXPORT_HAS_CPU, VALUE_U32, TARGET(cpu.num_threads) },
+    { "resource_monitor_process_context_switches", "counter", NULL,
+      "Voluntary plus involuntary context switches.", SCOPE_PROCESS, EXPORT_HAS_CPU, VALUE_U64, TARGET(cpu.context_switches) },
+    { "resource_monitor_process_resident_memory_bytes", "gauge", "bytes",
+      "Resident set size.", SCOPE_PROCESS, EXPORT_HAS_MEM, VALUE_U64, TARGET(mem.rss) },
+    { "resource_monitor_process_virtual_memory_bytes", "gauge", "bytes",
+      "Virtual memory size.", SCOPE_PROCESS, EXPORT_HAS_MEM, VALUE_U64, TARGET(mem.vsz) },
+    { "resource_monitor_process_swap_bytes", "gauge", "bytes",
+      "Swapped-out memory.", SCOPE_PROCESS, EXPORT_HAS_MEM, VALUE_U64, TARGET(mem.swap) },
+    { "resource_monitor_process_page_faults", "counter", NULL,
+      "Page faults (minor plus major).", SCOPE_PROCESS, EXPORT_HAS_MEM, VALUE_U64, TARGET(mem.page_faults) },
+    { "resource_monitor_process_io_read_bytes", "counter", "bytes",
+      "Bytes read by the process.", SCOPE_PROCESS, EXPORT_HAS_IO, VALUE_U64, TARGET(io.bytes_read) },
+    { "resource_monitor_process_io_written_bytes", "counter", "bytes",
+      "Bytes written by the process.", SCOPE_PROCESS, EXPORT_HAS_IO, VALUE_U64, TARGET(io.bytes_written) },
+    { "resource_monitor_process_io_read_syscalls", "counter", NULL,
+      "Read system calls.", SCOPE_PROCESS, EXPORT_HAS_IO, VALUE_U64, TARGET(io.syscalls_read) },
+    { "resource_monitor_process_io_write_syscalls", "counter", NULL,
+      "Write system calls.", SCOPE_PROCESS, EXPORT_HAS_IO, VALUE_U64, TARGET(io.syscalls_write) },
+
+    { "resource_monitor_cgroup_cpu_usage_seconds", "counter", "seconds",
+      "CPU time consumed by the cgroup.", SCOPE_CGROUP_CPU, 0, VALUE_USEC, TARGET(cgroup.cpu.usage_usec) },
+    { "resource_monitor_cgroup_cpu_throttled_seconds", "counter", "seconds",
+      "Time the cgroup was throttled by its CPU quota.", SCOPE_CGROUP_CPU, 0, VALUE_USEC, TARGET(cgroup.cpu.throttled_usec) },
+    { "resource_monitor_cgroup_cpu_throttled_periods", "counter", NULL,
+      "Enforcement periods in which the cgroup was throttled.", SCOPE_CGROUP_CPU, 0, VALUE_U64, TARGET(cgroup.cpu.nr_throttled) },
+    { "resource_monitor_cgroup_memory_usage_bytes", "gauge", "bytes",
+      "Memory charged to the cgroup.", SCOPE_CGROUP_MEMORY, 0, VALUE_U64, TARGET(cgroup.memory.current) },
+    { "resource_monitor_cgroup_memory_peak_bytes", "gauge", "bytes",
+      "Highest memory usage recorded for the cgroup.", SCOPE_CGROUP_MEMORY, 0, VALUE_U64, TARGET(cgroup.memory.peak) },
+    { "resource_monitor_cgroup_memory_limit_bytes", "gauge", "bytes",
+      "Memory limit of the cgroup.", SCOPE_CGROUP_MEMORY, 0, VALUE_U64, TARGET(cgroup.memory.limit) },
+    { "resource_monitor_cgroup_io_read_bytes", "counter", "bytes",
+      "Bytes read from block devices by the cgroup.", SCOPE_CGROUP_BLKIO, 0, VALUE_U64, TARGET(cgroup.blkio.rbytes) },
+    { "resource_monitor_cgroup_io_written_bytes", "counter", "bytes",
+      "Bytes written to block devices by the cgroup.", SCOPE_CGROUP_BLKIO, 0, VALUE_U64, TARGET(cgroup.blkio.wbytes) },
+    { "resource_monitor_cgroup_pids", "gauge", NULL,
+      "Processes in the cgroup.", SCOPE_CGROUP_PIDS, 0, VALUE_U64, TARGET(cgroup.pids.current) },
+};
+
+#define FAMILY_COUNT ((int)(sizeof(families) / sizeof(families[0])))
+
+// ----------------------------------------------------------------------------
+// Renderização
+// ----------------------------------------------------------------------------
+
+/**
+ * Acrescenta texto à página, crescendo-a quando preciso
+ * @return 0 em sucesso, -1 sem memória (a página continua válida)
+ */
+static int page_printf(metrics_page_t **page, const char *fmt, ...) {
+    for (;;) {
+        metrics_page_t *p = *page;
+        size_t room = p->capacity - p->length;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(p->data + p->length, room, fmt, ap);
+        va_end(ap);
+        if (n < 0) return -1;
+        if ((size_t)n < room) {
+            p->length += (size_t)n;
+            return 0;
+        }
+
+        size_t capacity = p->capacity * 2 + (size_t)n;
+        metrics_page_t *grown = realloc(p, sizeof(*p) + capacity);
+        if (grown == NULL) return -1;
+        grown->capacity = capacity;
+        *page = grown;
+    }
+}
+
+/**
+ * Valor de label com \\, " e quebra de linha escapados
+ */
+static void escape_label(char *out, size_t size, const char *value) {
+    size_t o = 0;
+    for (const char *c = value; *c != '\0' && o + 3 < size; c++) {
+        if (*c == '\\' || *c == '"') {
+            out[o++] = '\\';
+            out[o++] = *c;
+        } else if (*c == '\n') {
+            out[o++] = '\\';
+            out[o++] = 'n';
+        } else {
+            out[o++] = *c;
+        }
+    }
+    out[o] = '\0';
+}
+
+static int family_applies(const metric_family_t *family, const metrics_target_t *target) {
+    switch (family->scope) {
+        case SCOPE_PROCESS:       return (target->flags & family->need) != 0;
+        case SCOPE_CGROUP_CPU:    return target->has_cgroup && target->cgroup.has_cpu;
+        case SCOPE_CGROUP_MEMORY: return target->has_cgroup && target->cgroup.has_memory;
+        case SCOPE_CGROUP_BLKIO:  return target->has_cgroup && target->cgroup.has_blkio;
+        case SCOPE_CGROUP_PIDS:   return target->has_cgroup && target->cgroup.has_pids;
+    }
+    return 0;
+}
+
+/**
+ * Vários alvos no mesmo cgroup: a série do cgroup sai uma vez só
+ */
+static int cgroup_seen_before(const metrics_target_t *targets, int index) {
+    for (int i = 0; i < index; i++) {
+        if (targets[i].has_cgroup &&
+            strcmp(targets[i].cgroup.info.path, targets[index].cgroup.info.path) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int render_value(metrics_page_t **page, const metric_family_t *family,
+                        const metrics_target_t *target) {
+    const char *p = (const char *)target + family->offset;
+    uint64_t u64;
+    uint32_t u32;
+    double f64;
+
+    switch (family->kind) {
+        case VALUE_U32:
+            memcpy(&u32, p, sizeof(u32));
+            return page_printf(page, "%u\n", u32);
+        case VALUE_F64:
+            memcpy(&f64, p, sizeof(f64));
+            return page_printf(page, "%.6g\n", f64);
+        case VALUE_TICKS:
+            memcpy(&u64, p, sizeof(u64));
+            return page_printf(page, "%.6f\n", ticks_to_microseconds(u64) / 1e6);
+        case VALUE_USEC:
+            memcpy(&u64, p, sizeof(u64));
+            return page_printf(page, "%.6f\n", u64 / 1e6);
+        default:
+            memcpy(&u64, p, sizeof(u64));
+            return page_printf(page, "%" PRIu64 "\n", u64);
+    }
+}
+
+metrics_page_t* openmetrics_render(const metrics_target_t *targets, int count,
+                                   size_t previous_size) {
+    size_t capacity = previous_size > 0 ? previous_size + previous_size / 4 : 4096;
+    metrics_page_t *page = malloc(sizeof(*page) + capacity);
+    if (page == NULL) {
+        return NULL;
+    }
+    atomic_init(&page->refs, 1);
+    page->length = 0;
+    page->capacity = capacity;
+
+    char label[256];
+    int ok = 1;
+
+    // Todas as amostras de uma família ficam juntas, sob um único # TYPE
+    for (int f = 0; f < FAMILY_COUNT && ok; f++) {
+        const metric_family_t *family = &families[f];
+        int header_done = 0;
+        int is_counter = strcmp(family->type, "counter") == 0;
+
+        for (int t = 0; t < count && ok; t++) {
+            const metrics_target_t *target = &targets[t];
+            if (!family_applies(family, target)) continue;
+            if (family->scope != SCOPE_PROCESS && cgroup_seen_before(targets, t)) continue;
+
+            if (!header_done) {
+                ok = page_printf(&page, "# TYPE %s %s\n", family->name, family->type) == 0;
+                if (ok && family->unit != NULL) {
+                    ok = page_printf(&page, "# UNIT %s %s\n", family->name, family->unit) == 0;
+                }
+                ok = ok && page_printf(&page, "# HELP %s %s\n", family->name, family->help) == 0;
+                header_done = 1;
+            }
+
+            if (family->scope == SCOPE_PROCESS) {
+                escape_label(label, sizeof(label), target->name);
+                ok = ok && page_printf(&page, "%s%s{pid=\"%d\",comm=\"%s\"} ", family->name,
+                                       is_counter ? "_total" : "", target->pid, label) == 0;
+            } else {
+                escape_label(label, sizeof(label), target->cgroup.info.path);
+                ok = ok && page_printf(&page, "%s%s{cgroup=\"%s\"} ", family->name,
+                                       is_counter ? "_total" : "", label) == 0;
+            }
+            ok = ok && render_value(&page, family, target) == 0;
+        }
+    }
+
+    // Namespaces: uma série info por (processo, tipo), com o inode como label
+    int header_done = 0;
+    for (int t = 0; t < count && ok; t++) {
+        const metrics_target_t *target = &targets[t];
+        if (!target->has_namespaces) continue;
+        for (int i = 0; i < target->namespaces.count && ok; i++) {
+            const namespace_info_t *ns = &target->namespaces.namespaces[i];
+            if (!ns->available) continue;
+            if (!header_done) {
+                ok = page_printf(&page,
+                                 "# TYPE resource_monitor_process_namespace info\n"
+                                 "# HELP resource_monitor_process_namespace Namespaces the process belongs to.\n") == 0;
+                header_done = 1;
+            }
+            ok = ok && page_printf(&page,
+                                   "resource_monitor_process_namespace_info{pid=\"%d\",type=\"%s\",inode=\"%lu\"} 1\n",
+                                   target->pid, ns->type_name, (unsigned long)ns->inode) == 0;
+        }
+    }
+
+    ok = ok && page_printf(&page, "# EOF\n") == 0;
+    if (!ok) {
+        free(page);
+        return NULL;
+    }
+    return page;
+}
+
+void metrics_page_release(metrics_page_t *page) {
+    if (page != NULL && atomic_fetch_sub(&page->refs, 1) == 1) {
+        free(page);
+    }
+}
+
+void metrics_target_collect(metrics_target_t *target, const char *cpu_cgroup,
+                            const char *mem_cgroup) {
+    if (get_process_name(target->pid, target->name, sizeof(target->name)) != 0) {
+        snprintf(target->name, sizeof(target->name), "unknown");
+    }
+
+    if (cpu_cgroup != NULL && mem_cgroup != NULL) {
+        target->has_cgroup = read_cgroup_metrics_from_path(cpu_cgroup, mem_cgroup, &target->cgroup) == 0;
+        if (target->has_cgroup && target->cgroup.info.path[0] == '\0') {
+            snprintf(target->cgroup.info.path, sizeof(target->cgroup.info.path), "%s", cpu_cgroup);
+        }
+    } else {
+        target->has_cgroup = read_cgroup_metrics(target->pid, &target->cgroup) == 0;
+    }
+    target->has_namespaces = list_process_namespaces(target->pid, &target->namespaces) == 0;
+}
+
+// ----------------------------------------------------------------------------
+// Servidor
+// ----------------------------------------------------------------------------
+
+static int open_listener(const char *listen_spec, char *unix_path, size_t unix_size) {
+    unix_path[0] = '\0';
+
+    if (strncmp(listen_spec, "unix:", 5) == 0) {
+        struct sockaddr_un addr = { .sun_family = AF_UNIX };
+        const char *path = listen_spec + 5;
+        if (path[0] == '\0' || strlen(path) >= sizeof(addr.sun_path) || strlen(path) >= unix_size) {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        strcpy(addr.sun_path, path);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd < 0) return -1;
+        unlink(path);
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+            close(fd);
+            return -1;
+        }
+        strcpy(unix_path, path);
+        return fd;
+    }
+
+    // [HOST:]PORTA, padrão 127.0.0.1: o endpoint é para agentes locais
+    char host[64] = "127.0.0.1";
+    const char *port_str = listen_spec;
+    const char *colon = strrchr(listen_spec, ':');
+    if (colon != NULL) {
+        size_t len = (size_t)(colon - listen_spec);
+        if (len == 0 || len >= sizeof(host)) {
+            errno = EINVAL;
+            return -1;
+        }
+        memcpy(host, listen_spec, len);
+        host[len] = '\0';
+        if (strcmp(host, "localhost") == 0) {
+            strcpy(host, "127.0.0.1");
+        }
+        port_str = colon + 1;
+    }
+
+    char *end;
+    long port = strtol(port_str, &end, 10);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port) };
+    if (*port_str == '\0' || *end != '\0' || port < 0 || port > 65535 ||
+        inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Conexão em andamento: acumula a requisição e depois envia cabeçalho e
+ * corpo conforme o socket aceita, sem bloquear as demais
+ */
+typedef struct {
+    int fd;                     // -1 = slot livre
+    uint64_t deadline_ms;
+    size_t length;              // Bytes da requisição
+    int responding;
+    char header[256];           // Resposta completa, se for só status
+    size_t header_length;
+    metrics_page_t *page;       // Corpo (NULL em status e HEAD)
+    size_t sent;                // Bytes de header + corpo já enviados
+    char request[REQUEST_MAX];
+} metrics_client_t;
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+static void client_close(metrics_client_t *client) {
+    close(client->fd);
+    client->fd = -1;
+    metrics_page_release(client->page);
+    client->page = NULL;
+}
+
+static void respond_status(metrics_client_t *client, const char *status) {
+    int n = snprintf(client->header, sizeof(client->header),
+                     "HTTP/1.1 %s\r\nContent-Type: text/plain\r\nContent-Length: %zu\r\n"
+                     "Connection: close\r\n\r\n%s\n", status, strlen(status) + 1, status);
+    client->header_length = (size_t)n;
+}
+
+/**
+ * Interpreta a requisição recebida e prepara a resposta
+ */
+static void client_respond(metrics_server_t *server, metrics_client_t *client) {
+    client->responding = 1;
+    client->request[client->length] = '\0';
+
+    char method[8] = "", path[256] = "";
+    if (sscanf(client->request, "%7s %255s", method, path) != 2) {
+        atomic_fetch_add(&server->errors, 1);
+        respond_status(client, "400 Bad Request");
+        return;
+    }
+    int head = strcmp(method, "HEAD") == 0;
+    if (strcmp(method, "GET") != 0 && !head) {
+        respond_status(client, "405 Method Not Allowed");
+        return;
+    }
+    path[strcspn(path, "?")] = '\0';
+    if (strcmp(path, "/metrics") != 0 && strcmp(path, "/") != 0) {
+        respond_status(client, "404 Not Found");
+        return;
+    }
+
+    pthread_mutex_lock(&server->lock);
+    metrics_page_t *page = server->page;
+    if (page != NULL) {
+        atomic_fetch_add(&page->refs, 1);
+    }
+    pthread_mutex_unlock(&server->lock);
+
+    if (page == NULL) {
+        respond_status(client, "503 Service Unavailable");
+        return;
+    }
+
+    int n = snprintf(client->header, sizeof(client->header),
+                     "HTTP/1.1 200 OK\r\nContent-Type: " OPENMETRICS_CONTENT_TYPE "\r\n"
+                     "Content-Length: %zu\r\nConnection: close\r\n\r\n", page->length);
+    client->header_length = (size_t)n;
+    if (head) {
+        metrics_page_release(page);
+    } else {
+        client->page = page;
+    }
+}
+
+/**
+ * Lê o que chegou; a requisição termina na linha em branco (ou no fim da conexão)
+ */
+static void client_read(metrics_server_t *server, metrics_client_t *client) {
+    for (;;) {
+        ssize_t n = recv(client->fd, client->request + client->length,
+                         sizeof(client->request) - 1 - client->length, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (n > 0) {
+            client->length += (size_t)n;
+            client->request[client->length] = '\0';
+            if (strstr(client->request, "\r\n\r\n") == NULL &&
+                strstr(client->request, "\n\n") == NULL &&
+                client->length < sizeof(client->request) - 1) {
+                continue;
+            }
+        }
+        client_respond(server, client);
+        return;
+    }
+}
+
+/**
+ * Envia o quanto o socket aceitar
+ * @return 1 quando a resposta terminou (ou falhou), 0 se ainda falta
+ */
+static int client_write(metrics_server_t *server, metrics_client_t *client) {
+    size_t body_length = client->page != NULL ? client->page->length : 0;
+    size_t total = client->header_length + body_length;
+
+    while (client->sent < total) {
+        const char *data;
+        size_t len;
+        if (client->sent < client->header_length) {
+            data = client->header + client->sent;
+            len = client->header_length - client->sent;
+        } else {
+            data = client->page->data + (client->sent - client->header_length);
+            len = total - client->sent;
+        }
+        ssize_t n = send(client->fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            atomic_fetch_add(&server->errors, 1);
+            return 1;
+        }
+        client->sent += (size_t)n;
+    }
+    if (strncmp(client->header, "HTTP/1.1 200", 12) == 0) {
+        atomic_fetch_add(&server->scrapes, 1);
+    }
+    return 1;
+}
+
+/**
+ * Thread do servidor: um poll sobre o socket de escuta, o pipe de parada e
+ * as conexões abertas, cada uma com seu prazo
+ */
+static void* metrics_server_thread(void *arg) {
+    metrics_server_t *server = arg;
+    metrics_client_t *clients = calloc(MAX_CLIENTS, sizeof(metrics_client_t));
+    if (clients == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+
+    struct pollfd fds[MAX_CLIENTS + 2];
+    int slot_of[MAX_CLIENTS + 2];
+    for (;;) {
+        uint64_t now = monotonic_ms();
+        int nfds = 2, active = 0;
+        int timeout = -1;
+        fds[0] = (struct pollfd){ .fd = server->stop_pipe[0], .events = POLLIN };
+        fds[1] = (struct pollfd){ .fd = server->listen_fd, .events = POLLIN };
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            metrics_client_t *client = &clients[i];
+            if (client->fd < 0) continue;
+            if (now >= client->deadline_ms) {
+                atomic_fetch_add(&server->errors, 1);
+                client_close(client);
+                continue;
+            }
+            int left = (int)(client->deadline_ms - now);
+            if (timeout < 0 || left < timeout) timeout = left;
+            fds[nfds] = (struct pollfd){ .fd = client->fd,
+                                         .events = client->responding ? POLLOUT : POLLIN };
+            slot_of[nfds++] = i;
+            active++;
+        }
+        if (active == MAX_CLIENTS) {
+            fds[1].fd = -1; // Sem slot livre: novas conexões esperam no backlog
+        }
+
+        if (poll(fds, (nfds_t)nfds, timeout) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents != 0) {
+            break;
+        }
+
+        for (int k = 2; k < nfds; k++) {
+            metrics_client_t *client = &clients[slot_of[k]];
+            if (fds[k].revents == 0) continue;
+            if (!client->responding) {
+                client_read(server, client);
+            }
+            if (client->responding && client_write(server, client)) {
+                client_close(client);
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd = accept4(server->listen_fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            for (int i = 0; fd >= 0 && i < MAX_CLIENTS; i++) {
+                if (clients[i].fd < 0) {
+                    memset(&clients[i], 0, offsetof(metrics_client_t, request));
+                    clients[i].fd = fd;
+                    clients[i].deadline_ms = monotonic_ms() + CLIENT_DEADLINE_MS;
+                    fd = -1;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) {
+            client_close(&clients[i]);
+        }
+    }
+    free(clients);
+    return NULL;
+}
+
+int metrics_server_start(metrics_server_t *server, const char *listen_spec) {
+    if (server == NULL || listen_spec == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(server, 0, sizeof(*server));
+    atomic_init(&server->scrapes, 0);
+    atomic_init(&server->errors, 0);
+    server->listen_fd = open_listener(listen_spec, server->unix_path, sizeof(server->unix_path));
+    if (server->listen_fd < 0) {
+        return -1;
+    }
+    if (pipe2(server->stop_pipe, O_CLOEXEC) != 0) {
+        close(server->listen_fd);
+        return -1;
+    }
+
+    pthread_mutex_init(&server->lock, NULL);
+    int err = pthread_create(&server->thread, NULL, metrics_server_thread, server);
+    if (err != 0) {
+        pthread_mutex_destroy(&server->lock);
+        close(server->stop_pipe[0]);
+        close(server->stop_pipe[1]);
+        close(server->listen_fd);
+        errno = err;
+        return -1;
+    }
+    server->running = 1;
+    return 0;
+}
+
+void metrics_server_publish(metrics_server_t *server, metrics_page_t *page) {
+    if (server == NULL || !server->running) {
+        metrics_page_release(page);
+        return;
+    }
+
+    pthread_mutex_lock(&server->lock);
+    metrics_page_t *old = server->page;
+    server->page = page;
+    pthread_mutex_unlock(&server->lock);
+    metrics_page_release(old);
+}
+
+void metrics_server_stop(metrics_server_t *server) {
+    if (server == NULL || !server->running) {
+        return;
+    }
+
+    // O pipe está vazio e aberto: esta escrita não falha nem bloqueia
+    ssize_t ignored = write(server->stop_pipe[1], "x", 1);
+    (void)ignored;
+    pthread_join(server->thread, NULL);
+    server->running = 0;
+
+    close(server->stop_pipe[0]);
+    close(server->stop_pipe[1]);
+    close(server->listen_fd);
+    if (server->unix_path[0] != '\0') {
+        unlink(server->unix_path);
+    }
+    pthread_mutex_destroy(&server->lock);
+    metrics_page_release(server->page);
+    server->page = NULL;
+}
@@ -6,13 +6,66 @@
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdatomic.h>
+
+// ----------------------------------------------------------------------------
+// Raízes de procfs/cgroupfs
+// ----------------------------------------------------------------------------
+
+static char proc_root_path[PATH_MAX] = "/proc";
+static char cgroup_root_path[PATH_MAX] = "/sys/fs/cgroup";
+static _Atomic unsigned root_generation = 0;
+
+/**
+ * Copia a raiz sem a barra final, para os chamadores montarem "%s/..."
+ */
+static int set_root(char *dest, const char *root, const char *fallback) {
+    if (root == NULL || root[0] == '\0') {
+        root = fallback;
+    }
+    size_t len = strlen(root);
+    while (len > 1 && root[len - 1] == '/') len--;
+    if (len >= PATH_MAX) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memcpy(dest, root, len);
+    dest[len] = '\0';
+    atomic_fetch_add_explicit(&root_generation, 1, memory_order_relaxed);
+    return 0;
+}
+
+int set_proc_root(const char *root) {
+    return set_root(proc_root_path, root, "/proc");
+}
+
+int set_cgroup_root(const char *root) {
+    return set_root(cgroup_root_path, root, "/sys/fs/cgroup");
+}
+
+const char* proc_root(void) {
+    return proc_root_path;
+}
+
+const char* cgroup_root(void) {
+    return cgroup_root_path;
+}
+
+unsigned host_root_generation(void) {
+    return atomic_load_explicit(&root_generation, memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+// Processos
+// ----------------------------------------------------------------------------
 
 /**
  * Verifica se um processo existe
  */
 int process_exists(pid_t pid) {
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%d", pid);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%d", proc_root(), pid);
     return (access(path, F_OK) == 0) ? 1 : 0;
 }
 
@@ -25,8 +78,8 @@ int get_process_name(pid_t pid, char *name, size_t size) {
         return -1;
     }
 
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%d/comm", proc_root(), pid);
 
     FILE *fp = fopen(path, "r");
     if (fp == NULL) {
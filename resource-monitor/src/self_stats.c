@@ -0,0 +1,250 @@
+#define _GNU_SOURCE
+#include "self_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <sys/resource.h>
+
+// ----------------------------------------------------------------------------
+// Histograma
+// ----------------------------------------------------------------------------
+
+void latency_histogram_init(latency_histogram_t *histogram) {
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min_ns = UINT64_MAX;
+}
+
+/**
+ * Abaixo de 2 * SUB_COUNT a faixa é o próprio valor; acima, expoente e
+ * os LATENCY_SUB_BITS bits seguintes ao mais significativo
+ */
+static int bucket_index(uint64_t ns) {
+    if (ns < 2 * LATENCY_SUB_COUNT) {
+        return (int)ns;
+    }
+    int exponent = 63;
+    while (!(ns >> exponent)) exponent--;
+    if (exponent > LATENCY_MAX_EXPONENT) {
+        return LATENCY_BUCKETS - 1;
+    }
+    int sub = (int)(ns >> (exponent - LATENCY_SUB_BITS)) - LATENCY_SUB_COUNT;
+    return 2 * LATENCY_SUB_COUNT + (exponent - LATENCY_SUB_BITS - 1) * LATENCY_SUB_COUNT + sub;
+}
+
+static uint64_t bucket_upper(int index) {
+    if (index < 2 * LATENCY_SUB_COUNT) {
+        return (uint64_t)index;
+    }
+    int k = index - 2 * LATENCY_SUB_COUNT;
+    int shift = 1 + k / LATENCY_SUB_COUNT;
+    uint64_t low = (uint64_t)(LATENCY_SUB_COUNT + k % LATENCY_SUB_COUNT) << shift;
+    return low + ((uint64_t)1 << shift) - 1;
+}
+
+void latency_histogram_record(latency_histogram_t *histogram, uint64_t ns) {
+    histogram->buckets[bucket_index(ns)]++;
+    histogram->count++;
+    histogram->sum_ns += ns;
+    if (ns < histogram->min_ns) histogram->min_ns = ns;
+    if (ns > histogram->max_ns) histogram->max_ns = ns;
+}
+
+uint64_t latency_histogram_percentile(const latency_histogram_t *histogram, double percentile) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    // Posição do percentil, arredondada para cima: p50 de 3 valores é o 2º
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->count) rank = histogram->count;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            // A última faixa também guarda os valores acima dela
+            uint64_t upper = i == LATENCY_BUCKETS - 1 ? histogram->max_ns : bucket_upper(i);
+            if (upper > histogram->max_ns) upper = histogram->max_ns;
+            if (upper < histogram->min_ns) upper = histogram->min_ns;
+            return upper;
+        }
+    }
+    return histogram->max_ns;
+}
+
+// ----------------------------------------------------------------------------
+// Consumo do processo
+// ----------------------------------------------------------------------------
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t timeval_us(struct timeval tv) {
+    return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+
+int self_usage_read(self_usage_t *usage) {
+    memset(usage, 0, sizeof(*usage));
+    usage->wall_ns = monotonic_ns();
+
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return -1;
+    }
+    usage->utime_us = timeval_us(ru.ru_utime);
+    usage->stime_us = timeval_us(ru.ru_stime);
+    usage->minflt = (uint64_t)ru.ru_minflt;
+    usage->majflt = (uint64_t)ru.ru_majflt;
+    usage->nvcsw = (uint64_t)ru.ru_nvcsw;
+    usage->nivcsw = (uint64_t)ru.ru_nivcsw;
+    usage->maxrss_kb = (uint64_t)ru.ru_maxrss;
+
+    // As próprias leituras entram nos contadores: custo constante por tick
+    FILE *fp = fopen("/proc/self/io", "r");
+    if (fp != NULL) {
+        char key[32];
+        unsigned long long value;
+        while (fscanf(fp, "%31[^:]: %llu\n", key, &value) == 2) {
+            if (strcmp(key, "rchar") == 0) usage->rchar = value;
+            else if (strcmp(key, "wchar") == 0) usage->wchar = value;
+            else if (strcmp(key, "syscr") == 0) usage->syscr = value;
+            else if (strcmp(key, "syscw") == 0) usage->syscw = value;
+        }
+        usage->has_io = 1;
+        fclose(fp);
+    }
+
+    fp = fopen("/proc/self/statm", "r");
+    if (fp != NULL) {
+        unsigned long long size, resident;
+        if (fscanf(fp, "%llu %llu", &size, &resident) == 2) {
+            uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+            usage->vsz_bytes = size * page;
+            usage->rss_bytes = resident * page;
+        }
+        fclose(fp);
+    }
+
+    struct mallinfo2 heap = mallinfo2();
+    usage->heap_bytes = (uint64_t)heap.uordblks + (uint64_t)heap.hblkhd;
+    return 0;
+}
+
+void self_stats_init(self_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        latency_histogram_init(&stats->collect[i]);
+    }
+    latency_histogram_init(&stats->tick);
+    latency_histogram_init(&stats->jitter);
+    self_usage_read(&stats->start);
+    stats->last = stats->start;
+    stats->previous = stats->start;
+    stats->heap_peak_bytes = stats->start.heap_bytes;
+}
+
+void self_stats_tick_end(self_stats_t *stats, uint64_t tick_ns) {
+    latency_histogram_record(&stats->tick, tick_ns);
+    stats->ticks++;
+
+    self_usage_t now;
+    if (self_usage_read(&now) != 0) {
+        return;
+    }
+    uint64_t syscalls = (now.syscr + now.syscw) - (stats->last.syscr + stats->last.syscw);
+    if (now.has_io && syscalls > stats->max_syscalls_tick) {
+        stats->max_syscalls_tick = syscalls;
+    }
+    if (now.heap_bytes > stats->heap_peak_bytes) {
+        stats->heap_peak_bytes = now.heap_bytes;
+    }
+    stats->previous = stats->last;
+    stats->last = now;
+}
+
+void self_stats_fill_record(const self_stats_t *stats, export_record_t *record) {
+    const self_usage_t *now = &stats->last;
+    const self_usage_t *before = &stats->previous;
+    uint64_t hz = (uint64_t)sysconf(_SC_CLK_TCK);
+    double elapsed_us = now->wall_ns > before->wall_ns ? (now->wall_ns - before->wall_ns) / 1000.0 : 0.0;
+    double elapsed_s = elapsed_us / 1e6;
+
+    export_record_fill(record, getpid(), NULL, NULL, NULL);
+    record->flags = EXPORT_HAS_CPU | EXPORT_HAS_MEM;
+
+    record->cpu.user_time = now->utime_us * hz / 1000000ULL;
+    record->cpu.system_time = now->stime_us * hz / 1000000ULL;
+    record->cpu.total_time = record->cpu.user_time + record->cpu.system_time;
+    uint64_t cpu_us = (now->utime_us + now->stime_us) - (before->utime_us + before->stime_us);
+    record->cpu.cpu_percent = elapsed_us > 0 ? cpu_us * 100.0 / elapsed_us : 0.0;
+    record->cpu.context_switches = now->nvcsw + now->nivcsw;
+
+    record->mem.rss = now->rss_bytes;
+    record->mem.vsz = now->vsz_bytes;
+    record->mem.page_faults = now->minflt + now->majflt;
+
+    if (now->has_io) {
+        record->flags |= EXPORT_HAS_IO;
+        record->io.bytes_read = now->rchar;
+        record->io.bytes_written = now->wchar;
+        record->io.syscalls_read = now->syscr;
+        record->io.syscalls_write = now->syscw;
+        if (elapsed_s > 0) {
+            record->io.read_rate = (now->rchar - before->rchar) / elapsed_s;
+            record->io.write_rate = (now->wchar - before->wchar) / elapsed_s;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Relatório
+// ----------------------------------------------------------------------------
+
+static void print_histogram_row(const char *name, const latency_histogram_t *h) {
+    printf("%-8s %8lu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name, h->count,
+           h->count ? h->sum_ns / 1e3 / h->count : 0.0,
+           latency_histogram_percentile(h, 50) / 1e3,
+           latency_histogram_percentile(h, 90) / 1e3,
+           latency_histogram_percentile(h, 99) / 1e3,
+           h->max_ns / 1e3);
+}
+
+void print_self_stats_report(const self_stats_t *stats, const collector_sched_t *sched) {
+    const self_usage_t *start = &stats->start;
+    const self_usage_t *end = &stats->last;
+    double elapsed_s = end->wall_ns > start->wall_ns ? (end->wall_ns - start->wall_ns) / 1e9 : 0.0;
+    double user_s = (end->utime_us - start->utime_us) / 1e6;
+    double sys_s = (end->stime_us - start->stime_us) / 1e6;
+    uint64_t ticks = stats->ticks ? stats->ticks : 1;
+
+    printf("\n--- Monitor Self-Instrumentation ---\n");
+    printf("%-8s %8s %10s %10s %10s %10s %10s\n",
+           "Latency", "Count", "Mean us", "p50 us", "p90 us", "p99 us", "Max us");
+    for (int i = 0; i < COLLECTOR_UNIT_COUNT; i++) {
+        if (stats->collect[i].count == 0) continue;
+        print_histogram_row(sched->units[i].name, &stats->collect[i]);
+    }
+    print_histogram_row("tick", &stats->tick);
+    print_histogram_row("jitter", &stats->jitter);
+
+    printf("Monitor CPU:        user %.3f s + sys %.3f s over %.3f s (%.4f%% of one core)\n",
+           user_s, sys_s, elapsed_s, elapsed_s > 0 ? (user_s + sys_s) * 100.0 / elapsed_s : 0.0);
+    printf("CPU per tick:       %.1f us over %lu ticks\n", (user_s + sys_s) * 1e6 / ticks, stats->ticks);
+    if (end->has_io) {
+        uint64_t syscalls = (end->syscr + end->syscw) - (start->syscr + start->syscw);
+        printf("Syscalls per tick:  %.1f read/write (max %lu)\n",
+               (double)syscalls / ticks, stats->max_syscalls_tick);
+    }
+    printf("Page faults:        %lu minor, %lu major\n",
+           end->minflt - start->minflt, end->majflt - start->majflt);
+    printf("Context switches:   %lu voluntary, %lu involuntary\n",
+           end->nvcsw - start->nvcsw, end->nivcsw - start->nivcsw);
+    printf("Heap in use:        %.1f KB at start, %.1f KB at end (peak %.1f KB); max RSS %.2f MB\n",
+           start->heap_bytes / 1024.0, end->heap_bytes / 1024.0,
+           stats->heap_peak_bytes / 1024.0, end->maxrss_kb / 1024.0);
+}
@@ -0,0 +1,412 @@
+#define _GNU_SOURCE
+#include "shm_metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SLOT_EMPTY 0
+#define SLOT_REMOVED -1
+// Reorganiza quando mais de 1/N dos slots estão marcados como removidos
+#define COMPACT_FRACTION 4
+
+static void segment_name(char *out, size_t size, const char *name) {
+    snprintf(out, size, "%s%s", name[0] == '/' ? "" : "/", name);
+}
+
+static uint32_t home_slot(pid_t pid, uint32_t slot_count) {
+    uint64_t h = (uint64_t)(uint32_t)pid * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)((h >> 32) % slot_count);
+}
+
+/**
+ * Sondagem linear: slot do PID, ou -1 ao encontrar um slot nunca usado
+ */
+static long find_slot(const shm_metrics_t *segment, pid_t pid) {
+    uint32_t count = segment->header->slot_count;
+    uint32_t slot = home_slot(pid, count);
+
+    for (uint32_t probe = 0; probe < count; probe++) {
+        int32_t owner = atomic_load_explicit(&segment->slots[slot].pid, memory_order_acquire);
+        if (owner == pid) {
+            return slot;
+        }
+        if (owner == SLOT_EMPTY) {
+            break;
+        }
+        slot = (slot + 1) % count;
+    }
+    return -1;
+}
+
+// ----------------------------------------------------------------------------
+// Escritor
+// ----------------------------------------------------------------------------
+
+/**
+ * Verifica se o monitor registrado em writer_pid de um segmento existente
+ * ainda roda (writer_pid ocupa a mesma posição em todas as versões)
+ */
+static int owner_alive(const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+
+    int alive = 0;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(shm_metrics_header_t)) {
+        void *map = mmap(NULL, sizeof(shm_metrics_header_t), PROT_READ, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED) {
+            shm_metrics_header_t *header = map;
+            int32_t pid = atomic_load(&header->writer_pid);
+            alive = pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+            munmap(map, sizeof(shm_metrics_header_t));
+        }
+    }
+    close(fd);
+    return alive;
+}
+
+int shm_metrics_create(shm_metrics_t *segment, const char *name, uint32_t slots) {
+    if (segment == NULL || name == NULL || name[0] == '\0') {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(segment, 0, sizeof(*segment));
+    segment_name(segment->name, sizeof(segment->name), name);
+    if (slots == 0) {
+        slots = SHM_METRICS_DEFAULT_SLOTS;
+    }
+
+    int fd = shm_open(segment->name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        if (owner_alive(segment->name)) {
+            errno = EEXIST;
+            return -1;
+        }
+        // Deixado por um monitor que terminou sem destruí-lo
+        shm_unlink(segment->name);
+        fd = shm_open(segment->name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        return -1;
+    }
+
+    segment->map_size = sizeof(shm_metrics_header_t) + (size_t)slots * sizeof(shm_metrics_slot_t);
+    if (ftruncate(fd, (off_t)segment->map_size) != 0) {
+        close(fd);
+        shm_unlink(segment->name);
+        return -1;
+    }
+
+    void *map = mmap(NULL, segment->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(segment->name);
+        return -1;
+    }
+
+    // ftruncate já zerou tudo: slots vazios, seq par
+    segment->header = map;
+    segment->slots = (shm_metrics_slot_t *)((char *)map + sizeof(shm_metrics_header_t));
+    segment->owner = 1;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    shm_metrics_header_t *header = segment->header;
+    header->version = SHM_METRICS_VERSION;
+    header->slot_count = slots;
+    header->slot_size = sizeof(shm_metrics_slot_t);
+    header->record_size = sizeof(export_record_t);
+    header->created_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    atomic_store(&header->writer_pid, (int32_t)getpid());
+    atomic_thread_fence(memory_order_release);
+    header->magic = SHM_METRICS_MAGIC;
+    return 0;
+}
+
+/**
+ * Copia o registro para o slot entre as duas metades do seqlock
+ */
+static void slot_store(shm_metrics_slot_t *slot, const export_record_t *record) {
+    uint64_t words[SHM_RECORD_WORDS] = {0};
+    memcpy(words, record, sizeof(*record));
+
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < SHM_RECORD_WORDS; i++) {
+        atomic_store_explicit(&slot->words[i], words[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+int shm_metrics_publish(shm_metrics_t *segment, const export_record_t *record) {
+    if (segment == NULL || segment->header == NULL || record == NULL || record->pid <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint32_t count = segment->header->slot_count;
+    uint32_t slot = home_slot(record->pid, count);
+    long reuse = -1;
+
+    // Só o escritor muda pid, então não há corrida entre a busca e a posse
+    for (uint32_t probe = 0; probe < count; probe++) {
+        int32_t owner = atomic_load_explicit(&segment->slots[slot].pid, memory_order_relaxed);
+        if (owner == record->pid) {
+            reuse = slot;
+            break;
+        }
+        if (owner == SLOT_REMOVED && reuse < 0) {
+            reuse = slot;
+        } else if (owner == SLOT_EMPTY) {
+            if (reuse < 0) reuse = slot;
+            break;
+        }
+        slot = (slot + 1) % count;
+    }
+    if (reuse < 0) {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    shm_metrics_slot_t *target = &segment->slots[reuse];
+    if (atomic_load_explicit(&target->pid, memory_order_relaxed) == SLOT_REMOVED) {
+        segment->removed--;
+    }
+    slot_store(target, record);
+    atomic_store_explicit(&target->pid, record->pid, memory_order_release);
+    atomic_fetch_add_explicit(&segment->header->generation, 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * Reinsere os alvos vivos a partir dos slots de origem, eliminando as marcas
+ * de remoção que alongam as sondagens. Leitores que atravessarem layout
+ * ímpar ou alterado repetem a busca
+ */
+static void compact_slots(shm_metrics_t *segment) {
+    shm_metrics_header_t *header = segment->header;
+    uint32_t count = header->slot_count;
+    export_record_t *live = malloc((size_t)count * sizeof(export_record_t));
+    if (live == NULL) {
+        return; // As marcas continuam válidas; tenta de novo na próxima remoção
+    }
+
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        shm_metrics_slot_t *slot = &segment->slots[i];
+        int32_t owner = atomic_load_explicit(&slot->pid, memory_order_relaxed);
+        if (owner > 0) {
+            uint64_t words[SHM_RECORD_WORDS];
+            for (size_t w = 0; w < SHM_RECORD_WORDS; w++) {
+                words[w] = atomic_load_explicit(&slot->words[w], memory_order_relaxed);
+            }
+            memcpy(&live[n++], words, sizeof(export_record_t));
+        }
+    }
+
+    uint32_t layout = atomic_load_explicit(&header->layout, memory_order_relaxed);
+    atomic_store_explicit(&header->layout, layout + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (uint32_t i = 0; i < count; i++) {
+        atomic_store_explicit(&segment->slots[i].pid, SLOT_EMPTY, memory_order_relaxed);
+    }
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t slot = home_slot(live[k].pid, count);
+        while (atomic_load_explicit(&segment->slots[slot].pid, memory_order_relaxed) != SLOT_EMPTY) {
+            slot = (slot + 1) % count;
+        }
+        slot_store(&segment->slots[slot], &live[k]);
+        atomic_store_explicit(&segment->slots[slot].pid, live[k].pid, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&header->layout, layout + 2, memory_order_release);
+    segment->removed = 0;
+    free(live);
+}
+
+int shm_metrics_remove(shm_metrics_t *segment, pid_t pid) {
+    if (segment == NULL || segment->header == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    long slot = find_slot(segment, pid);
+    if (slot < 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    atomic_store_explicit(&segment->slots[slot].pid, SLOT_REMOVED, memory_order_release);
+    segment->removed++;
+    if (segment->removed > segment->header->slot_count / COMPACT_FRACTION) {
+        compact_slots(segment);
+    }
+    atomic_fetch_add_explicit(&segment->header->generation, 1, memory_order_release);
+    return 0;
+}
+
+void shm_metrics_destroy(shm_metrics_t *segment) {
+    if (segment == NULL || segment->header == NULL) {
+        return;
+    }
+    if (segment->owner) {
+        atomic_store(&segment->header->writer_pid, 0);
+        shm_unlink(segment->name);
+    }
+    munmap(segment->header, segment->map_size);
+    segment->header = NULL;
+    segment->slots = NULL;
+}
+
+// ----------------------------------------------------------------------------
+// Leitor
+// ----------------------------------------------------------------------------
+
+int shm_metrics_open(shm_metrics_t *segment, const char *name) {
+    if (segment == NULL || name == NULL || name[0] == '\0') {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(segment, 0, sizeof(*segment));
+    segment_name(segment->name, sizeof(segment->name), name);
+    int fd = shm_open(segment->name, O_RDONLY, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(shm_metrics_header_t)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    const shm_metrics_header_t *header = map;
+    uint32_t magic = header->magic;
+    atomic_thread_fence(memory_order_acquire);
+    size_t expected = sizeof(shm_metrics_header_t) + (size_t)header->slot_count * sizeof(shm_metrics_slot_t);
+    if (magic != SHM_METRICS_MAGIC || header->version != SHM_METRICS_VERSION ||
+        header->slot_size != sizeof(shm_metrics_slot_t) ||
+        header->record_size != sizeof(export_record_t) ||
+        header->slot_count == 0 || expected > (size_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        errno = EPROTO;
+        return -1;
+    }
+
+    segment->header = map;
+    segment->slots = (shm_metrics_slot_t *)((char *)map + sizeof(shm_metrics_header_t));
+    segment->map_size = (size_t)st.st_size;
+    return 0;
+}
+
+/**
+ * Lê o slot até obter uma cópia que nenhuma escrita atravessou
+ * @return 1 com o registro, 0 se o slot não pertence a expected_pid
+ *         (ou está livre, quando expected_pid é 0), -1 se não estabilizou
+ */
+static int slot_load(const shm_metrics_slot_t *slot, pid_t expected_pid, export_record_t *record) {
+    // Os slots são mapeados só para leitura; os loads atômicos não escrevem
+    shm_metrics_slot_t *s = (shm_metrics_slot_t *)slot;
+    uint64_t words[SHM_RECORD_WORDS];
+
+    for (int attempt = 0; attempt < SHM_METRICS_READ_RETRIES; attempt++) {
+        uint32_t before = atomic_load_explicit(&s->seq, memory_order_acquire);
+        if (before & 1) {
+            sched_yield(); // escritor no meio da cópia, talvez sem CPU
+            continue;
+        }
+        int32_t owner = atomic_load_explicit(&s->pid, memory_order_acquire);
+        for (size_t i = 0; i < SHM_RECORD_WORDS; i++) {
+            words[i] = atomic_load_explicit(&s->words[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&s->seq, memory_order_relaxed) != before) {
+            continue;
+        }
+
+        if (owner <= 0 || (expected_pid != 0 && owner != expected_pid)) {
+            return 0;
+        }
+        memcpy(record, words, sizeof(*record));
+        // Slot reaproveitado entre a leitura de pid e a cópia
+        return record->pid == owner ? 1 : 0;
+    }
+    errno = EAGAIN;
+    return -1;
+}
+
+int shm_metrics_read(const shm_metrics_t *segment, pid_t pid, export_record_t *record) {
+    if (segment == NULL || segment->header == NULL || record == NULL || pid <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Mapeado só para leitura; o load atômico não escreve
+    _Atomic uint32_t *layout_seq = (_Atomic uint32_t *)&segment->header->layout;
+    for (int attempt = 0; attempt < SHM_METRICS_READ_RETRIES; attempt++) {
+        uint32_t layout = atomic_load_explicit(layout_seq, memory_order_acquire);
+        if (layout & 1) {
+            sched_yield(); // a reorganização percorre o segmento todo
+            continue;
+        }
+
+        long slot = find_slot(segment, pid);
+        int ret = (slot >= 0) ? slot_load(&segment->slots[slot], pid, record) : 0;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(layout_seq, memory_order_relaxed) != layout) {
+            continue; // Reorganizado durante a busca: o PID pode ter mudado de slot
+        }
+
+        if (ret == 1) return 0;
+        if (ret < 0) return -1;
+        errno = ENOENT;
+        return -1;
+    }
+    errno = EAGAIN;
+    return -1;
+}
+
+int shm_metrics_read_slot(const shm_metrics_t *segment, uint32_t index, export_record_t *record) {
+    if (segment == NULL || segment->header == NULL || record == NULL ||
+        index >= segment->header->slot_count) {
+        errno = EINVAL;
+        return -1;
+    }
+    return slot_load(&segment->slots[index], 0, record);
+}
+
+uint64_t shm_metrics_generation(const shm_metrics_t *segment) {
+    if (segment == NULL || segment->header == NULL) {
+        return 0;
+    }
+    return atomic_load_explicit(&segment->header->generation, memory_order_acquire);
+}
+
+void shm_metrics_close(shm_metrics_t *segment) {
+    if (segment == NULL || segment->header == NULL) {
+        return;
+    }
+    munmap(segment->header, segment->map_size);
+    segment->header = NULL;
+    segment->slots = NULL;
+}
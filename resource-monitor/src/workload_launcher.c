@@ -0,0 +1,612 @@
+#define _GNU_SOURCE
+#include "cgroup.h"
+#include "monitor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+/**
+ * Extrai o próximo token da linha, respeitando aspas simples e duplas
+ * @return Token (terminado em '\0' dentro da própria linha) ou NULL no fim
+ */
+static char *next_token(char **cursor) {
+    char *p = *cursor;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+        p++;
+    }
+    if (*p == '\0') {
+        *cursor = p;
+        return NULL;
+    }
+
+    char *token = p;
+    char *out = p;
+    char quote = 0;
+    for (; *p != '\0'; p++) {
+        if (quote) {
+            if (*p == quote) {
+                quote = 0;
+            } else {
+                *out++ = *p;
+            }
+        } else if (*p == '"' || *p == '\'') {
+            quote = *p;
+        } else if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            p++;
+            break;
+        } else {
+            *out++ = *p;
+        }
+    }
+    *out = '\0';
+    *cursor = p;
+    return token;
+}
+
+/**
+ * Interpreta uma linha do manifesto
+ * @return 1 se uma carga foi lida, 0 para linha vazia/comentário, -1 em erro
+ */
+int parse_workload_line(char *line, workload_t *w, const char *path, int lineno) {
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+
+    char *cursor = line;
+    char *token = next_token(&cursor);
+    if (token == NULL) {
+        return 0;
+    }
+
+    memset(w, 0, sizeof(workload_t));
+    w->pidfd = -1;
+    strncpy(w->name, token, sizeof(w->name) - 1);
+
+    // Opções até o "--"
+    int found_separator = 0;
+    while ((token = next_token(&cursor)) != NULL) {
+        if (strcmp(token, "--") == 0) {
+            found_separator = 1;
+            break;
+        }
+        if (strncmp(token, "cpu=", 4) == 0) {
+            w->cpu_limit = atof(token + 4);
+        } else if (strncmp(token, "mem=", 4) == 0) {
+            w->mem_limit_mb = strtoull(token + 4, NULL, 10);
+        } else if (strncmp(token, "cpus=", 5) == 0) {
+            strncpy(w->cpus, token + 5, sizeof(w->cpus) - 1);
+        } else if (strncmp(token, "io=", 3) == 0) {
+            unsigned int major, minor;
+            unsigned long long rbps, wbps;
+            if (sscanf(token + 3, "%u:%u:%llu:%llu", &major, &minor, &rbps, &wbps) != 4) {
+                fprintf(stderr, "%s:%d: invalid io limit '%s' (expected maj:min:rbps:wbps)\n",
+                        path, lineno, token + 3);
+                return -1;
+            }
+            snprintf(w->io_device, sizeof(w->io_device), "%u:%u", major, minor);
+            w->io_rbps = rbps;
+            w->io_wbps = wbps;
+        } else {
+            fprintf(stderr, "%s:%d: unknown option '%s'\n", path, lineno, token);
+            return -1;
+        }
+    }
+
+    if (!found_separator) {
+        fprintf(stderr, "%s:%d: missing '--' before the command\n", path, lineno);
+        return -1;
+    }
+
+    // Copiar o comando para o armazenamento da própria carga
+    size_t used = 0;
+    int argc = 0;
+    while ((token = next_token(&cursor)) != NULL) {
+        size_t len = strlen(token) + 1;
+        if (argc >= MAX_WORKLOAD_ARGS || used + len > sizeof(w->cmdline)) {
+            fprintf(stderr, "%s:%d: command too long\n", path, lineno);
+            return -1;
+        }
+        memcpy(w->cmdline + used, token, len);
+        w->argv[argc++] = w->cmdline + used;
+        used += len;
+    }
+    w->argv[argc] = NULL;
+
+    if (argc == 0) {
+        fprintf(stderr, "%s:%d: empty command\n", path, lineno);
+        return -1;
+    }
+
+    return 1;
+}
+
+/**
+ * Lê um manifesto de cargas
+ */
+int load_workload_manifest(const char *path, workload_t *workloads, int max, int *count) {
+    if (path == NULL || workloads == NULL || count == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error opening manifest %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    *count = 0;
+    char line[2048];
+    int lineno = 0;
+    int ret = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        lineno++;
+        if (*count >= max) {
+            fprintf(stderr, "%s:%d: too many workloads (max %d)\n", path, lineno, max);
+            ret = -1;
+            break;
+        }
+        int parsed = parse_workload_line(line, &workloads[*count], path, lineno);
+        if (parsed < 0) {
+            ret = -1;
+            break;
+        }
+        *count += parsed;
+    }
+    fclose(fp);
+
+    if (ret == 0 && *count == 0) {
+        fprintf(stderr, "%s: no workloads defined\n", path);
+        ret = -1;
+    }
+    return ret;
+}
+
+// Prazo entre o SIGTERM e o SIGKILL das cargas ainda ativas ao final
+#define WORKLOAD_TERM_GRACE_SEC 2
+
+static double timespec_diff(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Caminho de um controlador separado em cgroup v1 (blkio, cpuset)
+ */
+static void v1_controller_path(char *buf, size_t size, const char *controller, const char *name) {
+    snprintf(buf, size, "%s/%s/%s", cgroup_root(), controller, name);
+}
+
+/**
+ * Habilita cpuset e io para os filhos da raiz em cgroup v2 (melhor esforço)
+ */
+static void enable_v2_subtree_controllers(void) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/cgroup.subtree_control", cgroup_root());
+    FILE *fp = fopen(path, "w");
+    if (fp != NULL) {
+        fprintf(fp, "+cpuset +io");
+        fclose(fp);
+    }
+}
+
+/**
+ * Cria o cgroup da carga e aplica os limites
+ */
+int setup_workload_cgroup(workload_t *w, int version) {
+    snprintf(w->cgroup_name, sizeof(w->cgroup_name), "workload_%d_%s", getpid(), w->name);
+    if (version == 2) {
+        enable_v2_subtree_controllers();
+    }
+
+    if (create_cgroup_for_controllers(w->cgroup_name, w->cpu_path, sizeof(w->cpu_path),
+                                      w->mem_path, sizeof(w->mem_path)) != 0) {
+        fprintf(stderr, "[%s] Error creating cgroup: %s\n", w->name, strerror(errno));
+        return -1;
+    }
+
+    char io_path[PATH_MAX], cpuset_path[PATH_MAX];
+    if (version == 1) {
+        // Em v1 blkio e cpuset são hierarquias separadas; cpuacct também,
+        // quando não está montado junto com cpu (senão o mkdir é inócuo)
+        v1_controller_path(io_path, sizeof(io_path), "blkio", w->cgroup_name);
+        mkdir(io_path, 0755);
+        char acct_path[PATH_MAX];
+        v1_controller_path(acct_path, sizeof(acct_path), "cpuacct", w->cgroup_name);
+        mkdir(acct_path, 0755);
+        v1_controller_path(cpuset_path, sizeof(cpuset_path), "cpuset", w->cgroup_name);
+        if (w->cpus[0] != '\0') {
+            mkdir(cpuset_path, 0755);
+        }
+    } else {
+        strncpy(io_path, w->cpu_path, sizeof(io_path) - 1);
+        io_path[sizeof(io_path) - 1] = '\0';
+        strncpy(cpuset_path, w->cpu_path, sizeof(cpuset_path) - 1);
+        cpuset_path[sizeof(cpuset_path) - 1] = '\0';
+    }
+
+    if (w->cpu_limit > 0 && set_cgroup_cpu_limit(w->cpu_path, w->cpu_limit) != 0) {
+        fprintf(stderr, "[%s] Error setting CPU limit: %s\n", w->name, strerror(errno));
+    }
+    if (w->mem_limit_mb > 0 &&
+        set_cgroup_memory_limit(w->mem_path, w->mem_limit_mb * 1024 * 1024) != 0) {
+        fprintf(stderr, "[%s] Error setting memory limit: %s\n", w->name, strerror(errno));
+    }
+    if (w->io_device[0] != '\0' &&
+        set_cgroup_io_limit(io_path, w->io_device, w->io_rbps, w->io_wbps) != 0) {
+        fprintf(stderr, "[%s] Error setting I/O limit: %s\n", w->name, strerror(errno));
+    }
+    if (w->cpus[0] != '\0' && set_cgroup_cpuset(cpuset_path, w->cpus) != 0) {
+        fprintf(stderr, "[%s] Error setting cpuset '%s': %s\n", w->name, w->cpus, strerror(errno));
+    }
+
+    return 0;
+}
+
+/**
+ * Lança a carga em v1: o filho espera num pipe até o pai movê-lo para todas
+ * as hierarquias (cpu, memória, blkio, cpuacct, cpuset) e só então faz exec,
+ * para que nenhuma instrução da carga rode fora dos limites
+ */
+static pid_t spawn_v1_workload(workload_t *w) {
+    int sync_pipe[2];
+    if (pipe2(sync_pipe, O_CLOEXEC) != 0) {
+        return -1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        int saved_errno = errno;
+        close(sync_pipe[0]);
+        close(sync_pipe[1]);
+        errno = saved_errno;
+        return -1;
+    }
+    if (pid == 0) {
+        close(sync_pipe[1]);
+        char go = 0;
+        ssize_t n;
+        do {
+            n = read(sync_pipe[0], &go, 1);
+        } while (n < 0 && errno == EINTR);
+        if (n != 1 || go != 1) {
+            _exit(127); // o pai não conseguiu aplicar os cgroups
+        }
+        execvp(w->argv[0], w->argv);
+        fprintf(stderr, "Error executing command '%s': %s\n", w->argv[0], strerror(errno));
+        _exit(127);
+    }
+    close(sync_pipe[0]);
+
+    char path[PATH_MAX];
+    int ok = move_process_to_cgroup(pid, w->cpu_path) == 0;
+    if (ok && strcmp(w->cpu_path, w->mem_path) != 0) {
+        ok = move_process_to_cgroup(pid, w->mem_path) == 0;
+    }
+    if (ok && w->cpus[0] != '\0') {
+        v1_controller_path(path, sizeof(path), "cpuset", w->cgroup_name);
+        ok = move_process_to_cgroup(pid, path) == 0;
+    }
+    int saved_errno = errno;
+    if (ok) {
+        // blkio e cpuacct só contabilizam: melhor esforço, como na criação
+        v1_controller_path(path, sizeof(path), "blkio", w->cgroup_name);
+        move_process_to_cgroup(pid, path);
+        v1_controller_path(path, sizeof(path), "cpuacct", w->cgroup_name);
+        move_process_to_cgroup(pid, path);
+    }
+
+    char go = ok ? 1 : 0;
+    ssize_t n;
+    do {
+        n = write(sync_pipe[1], &go, 1);
+    } while (n < 0 && errno == EINTR);
+    close(sync_pipe[1]);
+    if (!ok) {
+        waitpid(pid, NULL, 0);
+        errno = saved_errno;
+        return -1;
+    }
+    return pid;
+}
+
+/**
+ * Lança a carga dentro do seu cgroup
+ */
+int launch_workload(workload_t *w, int version) {
+    if (version == 1) {
+        w->pid = spawn_v1_workload(w);
+    } else {
+        w->pid = spawn_process_in_cgroup(w->argv, w->cpu_path, w->mem_path, CGROUP_SPAWN_AUTO, NULL);
+    }
+    if (w->pid < 0) {
+        fprintf(stderr, "[%s] Error launching '%s': %s\n", w->name, w->argv[0], strerror(errno));
+        w->exited = 1;
+        return -1;
+    }
+
+    w->pidfd = (int)syscall(SYS_pidfd_open, w->pid, 0);
+    return 0;
+}
+
+/**
+ * Lê CPU, memória e I/O do cgroup da carga
+ */
+int read_workload_metrics(const workload_t *w, int version, cgroup_metrics_t *m) {
+    if (read_cgroup_metrics_from_path(w->cpu_path, w->mem_path, m) != 0) {
+        return -1;
+    }
+
+    char io_path[PATH_MAX];
+    if (version == 1) {
+        if (m->has_cpu && m->cpu.usage_usec == 0) {
+            // cpuacct em hierarquia própria: o uso não está no cgroup de cpu
+            char path[PATH_MAX];
+            unsigned long long usage_ns;
+            snprintf(path, sizeof(path), "%s/cpuacct/%s/cpuacct.usage", cgroup_root(), w->cgroup_name);
+            FILE *fp = fopen(path, "r");
+            if (fp != NULL) {
+                if (fscanf(fp, "%llu", &usage_ns) == 1) {
+                    m->cpu.usage_usec = usage_ns / 1000;
+                }
+                fclose(fp);
+            }
+        }
+        v1_controller_path(io_path, sizeof(io_path), "blkio", w->cgroup_name);
+    } else {
+        strncpy(io_path, w->cpu_path, sizeof(io_path) - 1);
+        io_path[sizeof(io_path) - 1] = '\0';
+    }
+    m->has_blkio = (read_cgroup_blkio_metrics(io_path, &m->blkio) == 0);
+    return 0;
+}
+
+static void update_peak(workload_t *w, const cgroup_metrics_t *m) {
+    if (!m->has_memory) {
+        return;
+    }
+    if (m->memory.peak > w->peak_memory) w->peak_memory = m->memory.peak;
+    if (m->memory.current > w->peak_memory) w->peak_memory = m->memory.current;
+}
+
+/**
+ * Coleta o status da carga se ela terminou e fixa suas métricas finais
+ */
+int reap_workload(workload_t *w, int version, const struct timespec *start, int block) {
+    if (w->exited) {
+        return 1;
+    }
+    // wait4: tempos user/sys e RSS máximo da carga (e dos filhos que ela esperou)
+    pid_t ret = wait4(w->pid, &w->status, block ? 0 : WNOHANG, &w->rusage);
+    if (ret != w->pid) {
+        return 0;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    w->elapsed_sec = timespec_diff(start, &now);
+    w->exited = 1;
+
+    if (read_workload_metrics(w, version, &w->final_metrics) == 0) {
+        update_peak(w, &w->final_metrics);
+    }
+    if (w->pidfd >= 0) {
+        close(w->pidfd);
+        w->pidfd = -1;
+    }
+    return 1;
+}
+
+void cleanup_workload_cgroup(const workload_t *w, int version) {
+    if (w->cgroup_name[0] == '\0') {
+        return;
+    }
+    cleanup_cgroup(w->cgroup_name);
+    if (version == 1) {
+        char path[PATH_MAX];
+        v1_controller_path(path, sizeof(path), "blkio", w->cgroup_name);
+        rmdir(path);
+        v1_controller_path(path, sizeof(path), "cpuacct", w->cgroup_name);
+        rmdir(path);
+        v1_controller_path(path, sizeof(path), "cpuset", w->cgroup_name);
+        rmdir(path);
+    }
+}
+
+/**
+ * Espera a carga sair após o SIGTERM até o prazo; quem ignora o sinal
+ * (ou demora demais) recebe SIGKILL, e só então a espera é bloqueante
+ */
+static void terminate_workload(workload_t *w, int version, const struct timespec *start,
+                               const struct timespec *deadline) {
+    if (w->pid <= 0) {
+        return;
+    }
+    while (!reap_workload(w, version, start, 0)) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double left = timespec_diff(&now, deadline);
+        if (left <= 0) {
+            fprintf(stderr, "[%s] Did not exit %ds after SIGTERM, sending SIGKILL\n",
+                    w->name, WORKLOAD_TERM_GRACE_SEC);
+            kill(w->pid, SIGKILL);
+            reap_workload(w, version, start, 1);
+            return;
+        }
+        int timeout_ms = (int)(left * 1000) + 1;
+        if (w->pidfd >= 0) {
+            struct pollfd pfd = { .fd = w->pidfd, .events = POLLIN };
+            poll(&pfd, 1, timeout_ms);
+        } else {
+            struct timespec pause = { 0, 50 * 1000000L };
+            nanosleep(&pause, NULL);
+        }
+    }
+}
+
+/**
+ * Lança todas as cargas e as amostra em um único timer
+ */
+int run_workloads(workload_t *workloads, int count, int interval, int quiet,
+                  const char *output_file, volatile int *keep_running) {
+    if (workloads == NULL || count <= 0 || interval <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (geteuid() != 0) {
+        fprintf(stderr, "Error: Cgroup execution mode requires root privileges (sudo).\n");
+        return -1;
+    }
+
+    int version = detect_cgroup_version();
+    if (version < 0) {
+        fprintf(stderr, "Error: Could not detect cgroup version.\n");
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (setup_workload_cgroup(&workloads[i], version) != 0) {
+            for (int j = 0; j <= i; j++) {
+                cleanup_workload_cgroup(&workloads[j], version);
+            }
+            return -1;
+        }
+    }
+
+    // Todas as cargas partem juntas; o mesmo relógio serve de referência
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++) {
+        if (launch_workload(&workloads[i], version) == 0 && !quiet) {
+            printf("✓ [%s] PID %d started (%s)\n", workloads[i].name, workloads[i].pid,
+                   workloads[i].argv[0]);
+        }
+    }
+
+    struct pollfd pfds[MAX_WORKLOADS];
+    int pfd_index[MAX_WORKLOADS];
+    struct timespec next_tick = start;
+    int tick = 0;
+
+    while (keep_running == NULL || *keep_running) {
+        int running = 0;
+        for (int i = 0; i < count; i++) {
+            if (!reap_workload(&workloads[i], version, &start, 0)) {
+                running++;
+            }
+        }
+        if (running == 0) {
+            break;
+        }
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double until_tick = timespec_diff(&now, &next_tick);
+
+        if (until_tick <= 0) {
+            // Amostra todos os cgroups ainda ativos no mesmo tick
+            if (!quiet) {
+                printf("\n[%4.0fs]\n", timespec_diff(&start, &now));
+            }
+            for (int i = 0; i < count; i++) {
+                workload_t *w = &workloads[i];
+                cgroup_metrics_t m;
+                if (w->exited || read_workload_metrics(w, version, &m) != 0) {
+                    continue;
+                }
+                update_peak(w, &m);
+                if (!quiet) {
+                    printf("  %-16s CPU %8.2fs", w->name, m.has_cpu ? m.cpu.usage_usec / 1e6 : 0.0);
+                    if (m.has_cpu && m.cpu.nr_periods > 0) {
+                        printf("  thr %5.1f%%", m.cpu.nr_throttled * 100.0 / m.cpu.nr_periods);
+                    }
+                    printf("  MEM %8.2f MB  I/O %8.2f MB\n",
+                           m.has_memory ? m.memory.current / (1024.0 * 1024.0) : 0.0,
+                           m.has_blkio ? (m.blkio.rbytes + m.blkio.wbytes) / (1024.0 * 1024.0) : 0.0);
+                }
+            }
+            tick++;
+            next_tick.tv_sec = start.tv_sec + (time_t)tick * interval;
+            continue;
+        }
+
+        // Espera o próximo tick ou o término de alguma carga
+        int nfds = 0;
+        for (int i = 0; i < count; i++) {
+            if (!workloads[i].exited && workloads[i].pidfd >= 0) {
+                pfds[nfds].fd = workloads[i].pidfd;
+                pfds[nfds].events = POLLIN;
+                pfd_index[nfds] = i;
+                nfds++;
+            }
+        }
+        int timeout_ms = (int)(until_tick * 1000) + 1;
+        if (nfds < running && timeout_ms > 100) {
+            timeout_ms = 100; // sem pidfd: verificar por waitpid periodicamente
+        }
+        if (poll(pfds, nfds, timeout_ms) > 0) {
+            for (int k = 0; k < nfds; k++) {
+                if (pfds[k].revents & POLLIN) {
+                    workload_t *w = &workloads[pfd_index[k]];
+                    if (reap_workload(w, version, &start, 0) && !quiet) {
+                        printf("✓ [%s] finished after %.2fs\n", w->name, w->elapsed_sec);
+                    }
+                }
+            }
+        }
+    }
+
+    // Interrompido: terminar as cargas restantes
+    for (int i = 0; i < count; i++) {
+        if (!workloads[i].exited && workloads[i].pid > 0) {
+            kill(workloads[i].pid, SIGTERM);
+        }
+    }
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += WORKLOAD_TERM_GRACE_SEC;
+    for (int i = 0; i < count; i++) {
+        terminate_workload(&workloads[i], version, &start, &deadline);
+    }
+
+    cgroup_utilization_row_t rows[MAX_WORKLOADS];
+    int nrows = 0;
+    for (int i = 0; i < count; i++) {
+        if (workloads[i].pid <= 0) {
+            continue;
+        }
+        cgroup_utilization_row_t *row = &rows[nrows++];
+        memset(row, 0, sizeof(*row));
+        strncpy(row->label, workloads[i].name, sizeof(row->label) - 1);
+        row->metrics = workloads[i].final_metrics;
+        row->peak_memory = workloads[i].peak_memory;
+        row->elapsed_sec = workloads[i].elapsed_sec;
+    }
+
+    if (!quiet) {
+        printf("\n");
+    }
+    print_cgroup_utilization_table(rows, nrows, NULL);
+    if (output_file != NULL && output_file[0] != '\0') {
+        print_cgroup_utilization_table(rows, nrows, output_file);
+    }
+
+    for (int i = 0; i < count; i++) {
+        cleanup_workload_cgroup(&workloads[i], version);
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/adaptive_sampling.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+static adaptive_signal_t sample(double cpu, uint64_t rss, uint64_t throttled) {
+    adaptive_signal_t signal = {
+        .have = ADAPTIVE_TRIGGER_CPU | ADAPTIVE_TRIGGER_RSS | ADAPTIVE_TRIGGER_THROTTLE,
+        .cpu_percent = cpu,
+        .rss = rss,
+        .nr_throttled = throttled
+    };
+    return signal;
+}
+
+void test_parse(void) {
+    adaptive_config_t config;
+    adaptive_config_default(&config);
+
+    print_test_result("adaptive_parse_range() reads seconds",
+                      adaptive_parse_range(&config, "0.25:30") == 0 &&
+                      config.min_ms == 250 && config.max_ms == 30000);
+    print_test_result("Inverted or malformed ranges are rejected",
+                      adaptive_parse_range(&config, "30:1") != 0 &&
+                      adaptive_parse_range(&config, "1") != 0 &&
+                      adaptive_parse_range(&config, "0:1") != 0 &&
+                      config.min_ms == 250);
+
+    int ok = adaptive_parse_thresholds(&config, "cpu=10,rss=20,throttle=3,shrink=0,grow=2,steady=5") == 0;
+    print_test_result("adaptive_parse_thresholds() sets every threshold",
+                      ok && config.cpu_delta == 10.0 && config.rss_growth == 0.2 &&
+                      config.throttle == 3 && config.shrink == 0.0 && config.grow == 2.0 &&
+                      config.steady_samples == 5);
+    print_test_result("An invalid list leaves the thresholds alone",
+                      adaptive_parse_thresholds(&config, "cpu=1,grow=0.5") != 0 &&
+                      adaptive_parse_thresholds(&config, "bogus=1") != 0 &&
+                      adaptive_parse_thresholds(&config, "steady=0") != 0 &&
+                      config.cpu_delta == 10.0);
+}
+
+void test_backoff(void) {
+    adaptive_config_t config;
+    adaptive_config_default(&config);
+    config.min_ms = 100;
+    config.max_ms = 2000;
+
+    adaptive_state_t state;
+    adaptive_init(&state, &config, 1000);
+    adaptive_signal_t idle = sample(0.5, 1 << 20, 0);
+
+    adaptive_update(&state, &idle);
+    print_test_result("The first sample is only a baseline",
+                      state.interval_ms == 1000 && state.samples == 0);
+
+    // Três amostras calmas por passo de 1.5x: 1000 -> 1500 -> 2000 (teto)
+    for (int i = 0; i < 3; i++) adaptive_update(&state, &idle);
+    int first_step = state.interval_ms == 1500;
+    for (int i = 0; i < 9; i++) adaptive_update(&state, &idle);
+    print_test_result("Steady samples grow the interval up to the ceiling",
+                      first_step && state.interval_ms == 2000 && state.grows == 2);
+
+    // Oscilações abaixo do limiar não contam como mudança
+    adaptive_signal_t jitter = sample(4.0, (1 << 20) + 4096, 0);
+    adaptive_update(&state, &jitter);
+    print_test_result("Changes below the thresholds are ignored",
+                      state.interval_ms == 2000 && state.last_trigger == 0);
+}
+
+void test_triggers(void) {
+    adaptive_config_t config;
+    adaptive_config_default(&config);
+    config.min_ms = 100;
+    config.max_ms = 60000;
+
+    adaptive_state_t state;
+    adaptive_init(&state, &config, 8000);
+    adaptive_signal_t s = sample(2.0, 100 << 20, 10);
+    adaptive_update(&state, &s);
+
+    s.cpu_percent = 40.0;
+    adaptive_update(&state, &s);
+    print_test_result("A CPU swing shrinks the interval 4x",
+                      state.interval_ms == 2000 && state.last_trigger == ADAPTIVE_TRIGGER_CPU);
+
+    s.rss = 110 << 20;
+    adaptive_update(&state, &s);
+    print_test_result("RSS growth shrinks the interval",
+                      state.interval_ms == 500 && state.last_trigger == ADAPTIVE_TRIGGER_RSS);
+
+    s.nr_throttled = 12;
+    adaptive_update(&state, &s);
+    int throttled = state.interval_ms == 125 && state.last_trigger == ADAPTIVE_TRIGGER_THROTTLE;
+    s.cpu_percent = 80.0;
+    adaptive_update(&state, &s);
+    print_test_result("Throttling onset shrinks the interval down to the floor",
+                      throttled && state.interval_ms == 100 && state.shrinks == 4);
+
+    // RSS caindo e contador reiniciado não são mudanças
+    s.rss = 50 << 20;
+    s.nr_throttled = 0;
+    adaptive_update(&state, &s);
+    print_test_result("RSS release and counter resets do not trigger", state.last_trigger == 0);
+
+    // shrink=0: direto ao piso
+    config.shrink = 0;
+    adaptive_init(&state, &config, 30000);
+    s = sample(0, 1 << 20, 0);
+    adaptive_update(&state, &s);
+    s.cpu_percent = 90.0;
+    adaptive_update(&state, &s);
+    print_test_result("shrink=0 jumps straight to the floor", state.interval_ms == 100);
+
+    // Só sinais presentes nas duas amostras são comparados
+    adaptive_signal_t cpu_only = { .have = ADAPTIVE_TRIGGER_CPU, .cpu_percent = 90.0 };
+    adaptive_init(&state, &config, 1000);
+    adaptive_update(&state, &cpu_only);
+    adaptive_signal_t rss_only = { .have = ADAPTIVE_TRIGGER_RSS, .rss = 1 };
+    adaptive_update(&state, &rss_only);
+    print_test_result("Signals are only compared with their own baseline",
+                      state.samples == 0 && state.interval_ms == 1000);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║     Resource Monitor - Adaptive Sampling Test Suite        ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_parse();
+    test_backoff();
+    test_triggers();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,256 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include "../include/collector_pool.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+#define JOB_COUNT 64
+
+typedef struct {
+    int index;
+    int sleep_ms;
+    _Atomic int *hold;              // Se não NULL, o job espera até zerar
+    _Atomic int runs;
+} test_job_t;
+
+static test_job_t jobs[JOB_COUNT];
+static void *job_ptrs[JOB_COUNT];
+
+static void run_test_job(void *data, collector_worker_t *worker) {
+    (void)worker;
+    test_job_t *job = data;
+    if (job->sleep_ms) {
+        usleep((useconds_t)job->sleep_ms * 1000);
+    }
+    while (job->hold != NULL && atomic_load(job->hold)) {
+        usleep(1000);
+    }
+    atomic_fetch_add(&job->runs, 1);
+}
+
+static void reset_jobs(int slow_every, int sleep_ms) {
+    for (int i = 0; i < JOB_COUNT; i++) {
+        jobs[i].index = i;
+        jobs[i].sleep_ms = (slow_every && i % slow_every == 0) ? sleep_ms : 0;
+        jobs[i].hold = NULL;
+        atomic_store(&jobs[i].runs, 0);
+        job_ptrs[i] = &jobs[i];
+    }
+}
+
+static int all_ran_once(void) {
+    for (int i = 0; i < JOB_COUNT; i++) {
+        if (atomic_load(&jobs[i].runs) != 1) return 0;
+    }
+    return 1;
+}
+
+void test_rounds(void) {
+    void *done[JOB_COUNT];
+    collector_pool_t pool;
+    int ok = collector_pool_create(&pool, 4, JOB_COUNT, run_test_job) == 0;
+    print_test_result("collector_pool_create() with 4 workers", ok && pool.worker_count == 4);
+    if (!ok) return;
+
+    int every_round = 1;
+    for (int round = 0; round < 50; round++) {
+        reset_jobs(0, 0);
+        if (collector_pool_submit(&pool, job_ptrs, JOB_COUNT) != 0) every_round = 0;
+        collector_pool_wait(&pool);
+        if (!all_ran_once() || collector_pool_complete(&pool, done, JOB_COUNT) != JOB_COUNT) every_round = 0;
+    }
+    print_test_result("Every job runs exactly once per round", every_round);
+
+    collector_pool_stats_t stats;
+    collector_pool_get_stats(&pool, &stats);
+    print_test_result("Rounds are counted and timed",
+                      stats.rounds == 50 && stats.jobs == 50 * JOB_COUNT &&
+                      stats.last_round_jobs == JOB_COUNT && stats.max_round_ns >= stats.last_round_ns &&
+                      stats.total_round_ns >= stats.max_round_ns);
+
+    reset_jobs(1, 20);
+    collector_pool_submit(&pool, job_ptrs, 8);
+    print_test_result("A second round can be submitted while one is in flight",
+                      collector_pool_submit(&pool, job_ptrs + 8, 8) == 0 && pool.outstanding == 16);
+
+    struct pollfd pfd = { .fd = pool.done_fd, .events = POLLIN };
+    int harvested = 0;
+    while (harvested < 16 && poll(&pfd, 1, 2000) == 1) {
+        harvested += collector_pool_complete(&pool, done + harvested, JOB_COUNT - harvested);
+    }
+    print_test_result("done_fd becomes readable as jobs finish",
+                      harvested == 16 && pool.outstanding == 0 && pool.stats.rounds == 52);
+
+    errno = 0;
+    collector_pool_submit(&pool, job_ptrs, JOB_COUNT - 4);
+    print_test_result("Jobs beyond the capacity in flight are rejected",
+                      collector_pool_submit(&pool, job_ptrs, 8) == -1 && errno == E2BIG);
+    collector_pool_wait(&pool);
+    collector_pool_complete(&pool, done, JOB_COUNT);
+    collector_pool_destroy(&pool);
+}
+
+void test_stealing(void) {
+    collector_pool_t pool;
+    collector_pool_create(&pool, 4, JOB_COUNT, run_test_job);
+
+    // O primeiro worker a acordar leva a fatia 0-15, com todos os jobs lentos
+    reset_jobs(0, 0);
+    for (int i = 0; i < 16; i++) jobs[i].sleep_ms = 50;
+    double start = now_ms();
+    collector_pool_submit(&pool, job_ptrs, JOB_COUNT);
+    collector_pool_wait(&pool);
+    double elapsed = now_ms() - start;
+
+    collector_pool_stats_t stats;
+    collector_pool_get_stats(&pool, &stats);
+    printf("  16 slow jobs in one slice: %.0f ms, %lu steals\n", elapsed, stats.steals);
+    print_test_result("Idle workers steal from a slow worker's deque",
+                      all_ran_once() && stats.steals > 0 && elapsed < 16 * 50);
+    collector_pool_destroy(&pool);
+}
+
+void test_straggler(void) {
+    void *done[JOB_COUNT];
+    collector_pool_t pool;
+    collector_pool_create(&pool, 2, JOB_COUNT, run_test_job);
+
+    // O job 0 fica preso (como um alvo em estado D) até hold zerar
+    _Atomic int hold = 1;
+    reset_jobs(0, 0);
+    jobs[0].hold = &hold;
+    collector_pool_submit(&pool, job_ptrs, 4);
+
+    int rounds_done = 0, stuck_done = 0;
+    struct pollfd pfd = { .fd = pool.done_fd, .events = POLLIN };
+    for (int round = 0; round < 10; round++) {
+        collector_pool_submit(&pool, job_ptrs + 4 + round * 4, 4);
+        int harvested = 0;
+        while (harvested < 4 && poll(&pfd, 1, 2000) == 1) {
+            int n = collector_pool_complete(&pool, done, JOB_COUNT);
+            for (int i = 0; i < n; i++) {
+                if (done[i] == &jobs[0]) stuck_done = 1;
+                else if (((test_job_t *)done[i])->index >= 4) harvested++;
+            }
+        }
+        if (harvested == 4) rounds_done++;
+    }
+    print_test_result("Later rounds finish while one job is stuck",
+                      rounds_done == 10 && !stuck_done && atomic_load(&jobs[0].runs) == 0 &&
+                      atomic_load(&jobs[1].runs) == 1 && atomic_load(&jobs[3].runs) == 1);
+
+    atomic_store(&hold, 0);
+    collector_pool_wait(&pool);
+    int n = collector_pool_complete(&pool, done, JOB_COUNT);
+    collector_pool_stats_t stats;
+    collector_pool_get_stats(&pool, &stats);
+    print_test_result("The stuck job completes its round once released",
+                      n >= 1 && pool.outstanding == 0 && stats.rounds == 11 &&
+                      stats.jobs == 44 && atomic_load(&jobs[0].runs) == 1);
+    collector_pool_destroy(&pool);
+}
+
+void test_abandon(void) {
+    void *done[JOB_COUNT];
+    // Abandonado, o pool vaza: os workers presos ainda escrevem nele
+    collector_pool_t *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL || collector_pool_create(pool, 2, JOB_COUNT, run_test_job) != 0) {
+        print_test_result("collector_pool_create() for abandon", 0);
+        return;
+    }
+
+    reset_jobs(0, 0);
+    collector_pool_submit(pool, job_ptrs, 4);
+    print_test_result("wait_timeout returns once every job finished",
+                      collector_pool_wait_timeout(pool, 1000) == 0 &&
+                      collector_pool_complete(pool, done, JOB_COUNT) == 4);
+
+    _Atomic int hold = 1;
+    reset_jobs(0, 0);
+    jobs[0].hold = &hold;
+    collector_pool_submit(pool, job_ptrs, 4);
+    double start = now_ms();
+    int result = collector_pool_wait_timeout(pool, 100);
+    int err = errno;
+    double elapsed = now_ms() - start;
+    print_test_result("wait_timeout gives up on a stuck job",
+                      result == -1 && err == ETIMEDOUT && elapsed >= 90 && elapsed < 1000);
+
+    int harvested = collector_pool_complete(pool, done, JOB_COUNT);
+    int abandoned = collector_pool_abandon(pool, done, JOB_COUNT);
+    print_test_result("abandon hands back only the stuck job",
+                      harvested == 3 && abandoned == 1 && done[0] == &jobs[0]);
+
+    atomic_store(&hold, 0);
+    for (int i = 0; i < 1000 && atomic_load(&jobs[0].runs) == 0; i++) {
+        usleep(1000);
+    }
+    print_test_result("The abandoned job still finishes", atomic_load(&jobs[0].runs) == 1);
+}
+
+void test_inline(void) {
+    collector_pool_t pool;
+    int ok = collector_pool_create(&pool, 0, JOB_COUNT, run_test_job) == 0;
+
+    reset_jobs(0, 0);
+    ok = ok && collector_pool_submit(&pool, job_ptrs, JOB_COUNT) == 0;
+    print_test_result("Without workers jobs run inside submit", ok && all_ran_once());
+    void *done[JOB_COUNT];
+    struct pollfd pfd = { .fd = pool.done_fd, .events = POLLIN };
+    print_test_result("Inline round still completes through done_fd",
+                      poll(&pfd, 1, 0) == 1 &&
+                      collector_pool_complete(&pool, done, JOB_COUNT) == JOB_COUNT &&
+                      done[0] == &jobs[0] && pool.stats.rounds == 1 &&
+                      atomic_load(&pool.workers[0].jobs) == JOB_COUNT);
+    collector_pool_destroy(&pool);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║        Resource Monitor - Collector Pool Test Suite        ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_rounds();
+    test_stealing();
+    test_straggler();
+    test_abandon();
+    test_inline();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
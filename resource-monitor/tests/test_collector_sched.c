@@ -0,0 +1,152 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include "../include/collector_sched.h"
+#include "../include/monitor.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+void test_parse(void) {
+    collector_sched_t sched;
+    collector_sched_init(&sched, 1000);
+
+    print_test_result("Unit names resolve",
+                      collector_sched_unit_from_name("smaps") == COLLECTOR_UNIT_SMAPS &&
+                      collector_sched_unit_from_name("ns") == COLLECTOR_UNIT_NAMESPACES &&
+                      collector_sched_unit_from_name("nope") == -1);
+
+    int ok = collector_sched_parse(&sched, "stat,status=0.5,smaps=10", 1000) == 0;
+    print_test_result("collector_sched_parse() sets per-unit periods",
+                      ok && sched.units[COLLECTOR_UNIT_STAT].requested_ms == 1000 &&
+                      sched.units[COLLECTOR_UNIT_STATUS].requested_ms == 500 &&
+                      sched.units[COLLECTOR_UNIT_SMAPS].requested_ms == 10000 &&
+                      sched.units[COLLECTOR_UNIT_IO].requested_ms == 0);
+
+    print_test_result("Invalid lists are rejected",
+                      collector_sched_parse(&sched, "stat,bogus", 1000) != 0 &&
+                      collector_sched_parse(&sched, "stat=0", 1000) != 0 &&
+                      collector_sched_parse(&sched, "stat=abc", 1000) != 0);
+}
+
+void test_schedule(void) {
+    collector_sched_t sched;
+    collector_sched_init(&sched, 0);
+    collector_sched_parse(&sched, "stat=0.1,smaps=1", 1000);
+
+    print_test_result("Every unit is due at start",
+                      collector_sched_due(&sched, 0) ==
+                      (COLLECTOR_UNIT_BIT(COLLECTOR_UNIT_STAT) | COLLECTOR_UNIT_BIT(COLLECTOR_UNIT_SMAPS)));
+
+    // Simula 2 s de ticks pontuais
+    for (uint64_t now = 0; now <= 2000; now = collector_sched_next_due(&sched)) {
+        uint32_t due = collector_sched_due(&sched, now);
+        for (int unit = 0; unit < COLLECTOR_UNIT_COUNT; unit++) {
+            if (due & COLLECTOR_UNIT_BIT(unit)) {
+                collector_sched_record(&sched, (collector_unit_id_t)unit, now, 10000);
+            }
+        }
+    }
+    const collector_unit_t *stat = &sched.units[COLLECTOR_UNIT_STAT];
+    const collector_unit_t *smaps = &sched.units[COLLECTOR_UNIT_SMAPS];
+    print_test_result("Units run on their own periods", stat->runs == 21 && smaps->runs == 3);
+    print_test_result("Achieved rate matches the requested rate",
+                      collector_unit_achieved_hz(stat) > 9.99 && collector_unit_achieved_hz(stat) < 10.01 &&
+                      collector_unit_achieved_hz(smaps) > 0.99 && collector_unit_achieved_hz(smaps) < 1.01);
+    print_test_result("Measured cost replaces the estimate", stat->cost_us > 9.9 && stat->cost_us < 10.1);
+
+    // Um tick atrasado não dispara uma rajada para recuperar
+    collector_sched_record(&sched, COLLECTOR_UNIT_STAT, 5000, 10000);
+    print_test_result("A late tick skips instead of bursting",
+                      stat->next_due_ms == 5100 && collector_sched_due(&sched, 5000) ==
+                      COLLECTOR_UNIT_BIT(COLLECTOR_UNIT_SMAPS));
+}
+
+void test_budget(void) {
+    collector_sched_t sched;
+    collector_sched_init(&sched, 0);
+    collector_sched_parse(&sched, "stat=0.1,status=0.1,smaps=0.1", 1000);
+    sched.units[COLLECTOR_UNIT_STAT].cost_us = 20;
+    sched.units[COLLECTOR_UNIT_STATUS].cost_us = 40;
+    sched.units[COLLECTOR_UNIT_SMAPS].cost_us = 500;
+
+    // 200 + 400 + 5000 µs/s: 1% (10000 µs/s) já cabe
+    collector_sched_set_budget(&sched, 0.01);
+    print_test_result("A budget that fits leaves the periods alone",
+                      sched.units[COLLECTOR_UNIT_SMAPS].interval_ms == 100 && !sched.over_budget);
+
+    // 0.2% = 2000 µs/s: só smaps precisa ceder 3600 µs/s
+    collector_sched_set_budget(&sched, 0.002);
+    print_test_result("The most expensive unit is slowed first",
+                      sched.units[COLLECTOR_UNIT_SMAPS].interval_ms == 358 &&
+                      sched.units[COLLECTOR_UNIT_STAT].interval_ms == 100 &&
+                      sched.units[COLLECTOR_UNIT_STATUS].interval_ms == 100 &&
+                      sched.planned_us_per_s <= 2000.5);
+
+    // 0.01% = 100 µs/s: smaps no limite de alongamento, depois status, depois stat
+    collector_sched_set_budget(&sched, 0.0001);
+    print_test_result("Cheaper units give way once expensive ones are at the limit",
+                      sched.units[COLLECTOR_UNIT_SMAPS].interval_ms == 100 * COLLECTOR_SCHED_MAX_STRETCH &&
+                      sched.units[COLLECTOR_UNIT_STATUS].interval_ms > 100 &&
+                      !sched.over_budget);
+
+    collector_sched_set_budget(&sched, 0.000001);
+    print_test_result("An impossible budget is reported", sched.over_budget);
+
+    collector_sched_set_budget(&sched, 0);
+    print_test_result("Removing the budget restores the requested periods",
+                      sched.units[COLLECTOR_UNIT_SMAPS].interval_ms == 100 &&
+                      sched.units[COLLECTOR_UNIT_STATUS].interval_ms == 100 && sched.rebalances == 4);
+}
+
+void test_smaps_rollup(void) {
+    if (access("/proc/self/smaps_rollup", R_OK) != 0) {
+        printf("[SKIP] smaps_rollup (kernel without /proc/<pid>/smaps_rollup)\n");
+        return;
+    }
+    memory_smaps_t smaps;
+    int ok = collect_smaps_rollup(getpid(), &smaps) == 0;
+    print_test_result("collect_smaps_rollup() reads PSS and USS",
+                      ok && smaps.rss > 0 && smaps.pss > 0 && smaps.pss <= smaps.rss &&
+                      smaps.private_bytes > 0 && smaps.private_bytes <= smaps.rss);
+    print_test_result("collect_smaps_rollup() fails for a missing PID",
+                      collect_smaps_rollup(999999, &smaps) == -1);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║     Resource Monitor - Collector Scheduler Test Suite      ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_parse();
+    test_schedule();
+    test_budget();
+    test_smaps_rollup();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
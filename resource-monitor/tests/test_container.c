@@ -0,0 +1,281 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "../include/container.h"
+#include "../include/monitor.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_YELLOW "\033[0;33m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+#define CID "4f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f0"
+
+static void check_layout(const char *name, const char *path,
+                         container_runtime_t expected, const char *expected_id,
+                         const char *expected_root) {
+    char id[72];
+    size_t root_len = 0;
+    container_runtime_t runtime = classify_container_cgroup(path, id, sizeof(id), &root_len);
+
+    print_test_result(name, runtime == expected &&
+                            strcmp(id, expected_id) == 0 &&
+                            strlen(expected_root) == root_len &&
+                            strncmp(path, expected_root, root_len) == 0);
+}
+
+void test_classification(void) {
+    check_layout("docker (systemd driver)",
+                 "/system.slice/docker-" CID ".scope",
+                 CONTAINER_RUNTIME_DOCKER, CID, "/system.slice/docker-" CID ".scope");
+    check_layout("docker (cgroupfs driver)",
+                 "/docker/" CID,
+                 CONTAINER_RUNTIME_DOCKER, CID, "/docker/" CID);
+    check_layout("docker with nested systemd",
+                 "/system.slice/docker-" CID ".scope/init.scope",
+                 CONTAINER_RUNTIME_DOCKER, CID, "/system.slice/docker-" CID ".scope");
+    check_layout("containerd under kubepods.slice",
+                 "/kubepods.slice/kubepods-burstable.slice/kubepods-burstable-pod1234.slice/cri-containerd-" CID ".scope",
+                 CONTAINER_RUNTIME_CONTAINERD, CID,
+                 "/kubepods.slice/kubepods-burstable.slice/kubepods-burstable-pod1234.slice/cri-containerd-" CID ".scope");
+    check_layout("kubepods (cgroupfs driver)",
+                 "/kubepods/burstable/pod1234/" CID,
+                 CONTAINER_RUNTIME_CONTAINERD, CID, "/kubepods/burstable/pod1234/" CID);
+    check_layout("cri-o",
+                 "/kubepods.slice/crio-" CID ".scope",
+                 CONTAINER_RUNTIME_CRIO, CID, "/kubepods.slice/crio-" CID ".scope");
+    check_layout("podman (rootless)",
+                 "/user.slice/user-1000.slice/user@1000.service/user.slice/libpod-" CID ".scope/container",
+                 CONTAINER_RUNTIME_PODMAN, CID,
+                 "/user.slice/user-1000.slice/user@1000.service/user.slice/libpod-" CID ".scope");
+    check_layout("podman (cgroupfs driver)",
+                 "/libpod_parent/libpod-" CID,
+                 CONTAINER_RUNTIME_PODMAN, CID, "/libpod_parent/libpod-" CID);
+    check_layout("systemd service",
+                 "/system.slice/nginx.service",
+                 CONTAINER_RUNTIME_SYSTEMD, "nginx.service", "/system.slice/nginx.service");
+    check_layout("host root",
+                 "/",
+                 CONTAINER_RUNTIME_HOST, "/", "/");
+}
+
+void test_view_refresh(void) {
+    container_view_t view;
+
+    if (container_view_init(&view) != 0) {
+        print_test_result("container_view_init()", 0);
+        return;
+    }
+    print_test_result("container_view_init()", 1);
+
+    int first = container_view_refresh(&view);
+    int second = container_view_refresh(&view);
+    print_test_result("container_view_refresh()", first > 0 && second > 0);
+
+    const container_t *own = container_view_find_pid(&view, getpid());
+    print_test_result("Own process is attributed to a group",
+                      own != NULL && own->process_count >= 1);
+
+    int total = 0;
+    for (size_t i = 0; i < view.count; i++) {
+        total += view.containers[i].process_count;
+    }
+    print_test_result("Every group has processes",
+                      total > 0 && (size_t)total <= view.index.process_count);
+
+    print_test_result("Cgroup resolution is cached", view.cache_hits > 0);
+
+    // Sem mudanças de cgroup, os caminhos de um PID conhecido não são reinterpretados
+    unsigned long resolves = view.pid_resolves;
+    unsigned long events = view.index.events_applied;
+    unsigned long scans = view.index.full_scans;
+    container_view_refresh(&view);
+    print_test_result("Container membership is cached per PID",
+                      view.index.full_scans != scans ||
+                      view.pid_resolves - resolves <= view.index.events_applied - events);
+
+    // Mover via cgroup.procs não gera fork/exec/exit: a pertinência deve mudar mesmo assim
+    char name[64], cpu_path[512], mem_path[512];
+    snprintf(name, sizeof(name), "test_container_move_%d", getpid());
+    if (view.index.events_fd < 0 || geteuid() != 0 ||
+        create_cgroup_for_controllers(name, cpu_path, sizeof(cpu_path),
+                                      mem_path, sizeof(mem_path)) != 0) {
+        printf("[%sSKIP%s] Moved process changes container - needs root and process events\n",
+               COLOR_YELLOW, COLOR_RESET);
+        container_view_free(&view);
+        return;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    container_view_refresh(&view);
+    int before = 0;
+    for (size_t i = 0; i < view.count; i++) {
+        before += strstr(view.containers[i].cgroup_path, name) != NULL;
+    }
+
+    int moved = child > 0 && move_process_to_cgroup(child, cpu_path) == 0 &&
+                (strcmp(cpu_path, mem_path) == 0 || move_process_to_cgroup(child, mem_path) == 0);
+    container_view_refresh(&view);
+    const container_t *target = NULL;
+    for (size_t i = 0; i < view.count; i++) {
+        if (strstr(view.containers[i].cgroup_path, name) != NULL) {
+            target = &view.containers[i];
+        }
+    }
+    print_test_result("Moved process changes container",
+                      moved && before == 0 && target != NULL && target->process_count == 1);
+
+    if (child > 0) {
+        kill(child, SIGKILL);
+        waitpid(child, NULL, 0);
+    }
+    cleanup_cgroup(name);
+    container_view_free(&view);
+}
+
+static void write_file(const char *dir, const char *name, const char *content) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *fp = fopen(path, "w");
+    if (fp) {
+        fputs(content, fp);
+        fclose(fp);
+    }
+}
+
+/**
+ * Processo gravado: stat, comm, cgroup e namespaces (links para nsfs/)
+ */
+static void fixture_process(const char *root, int pid, const char *comm, const char *cgroup,
+                            int ns_id) {
+    char dir[256], content[512];
+    snprintf(dir, sizeof(dir), "%s/proc/%d", root, pid);
+    mkdir(dir, 0755);
+    snprintf(content, sizeof(content),
+             "%d (%s) S 1 %d %d 0 -1 4194560 500 0 0 0 150 50 0 0 20 0 1 0 1000 "
+             "104857600 2560 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 0 0 0 0 0 0 "
+             "0 0 0 0 0 0 0\n", pid, comm, pid, pid);
+    write_file(dir, "stat", content);
+    snprintf(content, sizeof(content), "%s\n", comm);
+    write_file(dir, "comm", content);
+    snprintf(content, sizeof(content), "0::%s\n", cgroup);
+    write_file(dir, "cgroup", content);
+
+    static const char *types[] = { "pid", "mnt", "net" };
+    strcat(dir, "/ns");
+    mkdir(dir, 0755);
+    for (int i = 0; i < 3; i++) {
+        char target[256], link[512];
+        snprintf(target, sizeof(target), "%s/nsfs/%s:[%d]", root, types[i], ns_id);
+        write_file("/", target + 1, "");
+        snprintf(link, sizeof(link), "%s/%s", dir, types[i]);
+        if (symlink(target, link) != 0) perror("symlink");
+    }
+}
+
+void test_fixture_root(void) {
+    char root[128], dir[256];
+    snprintf(root, sizeof(root), "/tmp/test_container_root.%d", getpid());
+    const char *scope = "/system.slice/docker-"
+                        "4f1d2c3b4a5968778695a4b3c2d1e0f4f1d2c3b4a5968778695a4b3c2d1e0f00.scope";
+
+    // Árvore v2: dois processos no contêiner, um no host
+    mkdir(root, 0755);
+    snprintf(dir, sizeof(dir), "%s/proc", root); mkdir(dir, 0755);
+    snprintf(dir, sizeof(dir), "%s/nsfs", root); mkdir(dir, 0755);
+    snprintf(dir, sizeof(dir), "%s/cgroup", root); mkdir(dir, 0755);
+    write_file(dir, "cgroup.controllers", "cpu memory io pids\n");
+    snprintf(dir, sizeof(dir), "%s/cgroup/system.slice", root); mkdir(dir, 0755);
+    snprintf(dir, sizeof(dir), "%s/cgroup%s", root, scope); mkdir(dir, 0755);
+    write_file(dir, "cpu.stat", "usage_usec 5000000\nuser_usec 4000000\nsystem_usec 1000000\n");
+    write_file(dir, "memory.current", "209715200\n");
+    write_file(dir, "memory.max", "max\n");
+    fixture_process(root, 100, "app", scope, 1);
+    fixture_process(root, 101, "worker", scope, 1);
+    fixture_process(root, 200, "sshd", "/", 2);
+
+    int host_version = detect_cgroup_version();
+    snprintf(dir, sizeof(dir), "%s/proc/", root);
+    int ok = set_proc_root(dir) == 0;
+    snprintf(dir, sizeof(dir), "%s/cgroup", root);
+    ok = ok && set_cgroup_root(dir) == 0;
+
+    char name[32] = "";
+    cpu_metrics_t cpu;
+    snprintf(dir, sizeof(dir), "%s/proc", root);
+    print_test_result("Roots are configurable (trailing slash dropped)",
+                      ok && strcmp(proc_root(), dir) == 0);
+    print_test_result("Collectors read the recorded tree",
+                      process_exists(100) && !process_exists(getpid()) &&
+                      get_process_name(101, name, sizeof(name)) == 0 && strcmp(name, "worker") == 0 &&
+                      collect_cpu_metrics(100, &cpu) == 0 && cpu.user_time == 150);
+    print_test_result("The cgroup version follows the configured root",
+                      detect_cgroup_version() == 2);
+
+    container_view_t view;
+    const container_t *app = NULL;
+    if (container_view_init(&view) == 0) {
+        container_view_refresh(&view);
+        app = container_view_find_pid(&view, 101);
+        print_test_result("The container view groups the recorded processes",
+                          app != NULL && app->runtime == CONTAINER_RUNTIME_DOCKER &&
+                          app->process_count == 2 && strncmp(app->id, "4f1d2c3b", 8) == 0 &&
+                          view.index.events_fd < 0);
+        container_view_free(&view);
+    } else {
+        print_test_result("The container view groups the recorded processes", 0);
+    }
+
+    set_proc_root(NULL);
+    set_cgroup_root(NULL);
+    print_test_result("Default roots are restored",
+                      strcmp(proc_root(), "/proc") == 0 && process_exists(getpid()) &&
+                      detect_cgroup_version() == host_version);
+
+    char command[192];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    if (system(command) != 0) perror("rm");
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║          Resource Monitor - Container Test Suite           ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_classification();
+    test_view_refresh();
+    test_fixture_root();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,523 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "../include/monitor_daemon.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+#define SOCKET_PATH "/tmp/test_daemon.sock"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+static int ends_with_ok(const char *reply) {
+    size_t len = strlen(reply);
+    const char *last = reply;
+    for (const char *p = reply; p + 1 < reply + len; p++) {
+        if (*p == '\n') last = p + 1;
+    }
+    return strncmp(last, "OK", 2) == 0;
+}
+
+void test_parse_collect(void) {
+    uint32_t collect = 0;
+    print_test_result("Collect lists are parsed",
+                      monitor_daemon_parse_collect("cpu,io", &collect) == 0 &&
+                      collect == (EXPORT_HAS_CPU | EXPORT_HAS_IO) &&
+                      monitor_daemon_parse_collect("all", &collect) == 0 &&
+                      collect == (EXPORT_HAS_CPU | EXPORT_HAS_MEM | EXPORT_HAS_IO));
+    print_test_result("Unknown collectors are rejected",
+                      monitor_daemon_parse_collect("cpu,disk", &collect) == -1 &&
+                      monitor_daemon_parse_collect("", &collect) == -1);
+}
+
+void test_commands(void) {
+    monitor_daemon_t monitor;
+    char reply[8192];
+    char line[128];
+
+    int ok = monitor_daemon_init(&monitor, SOCKET_PATH) == 0;
+    print_test_result("monitor_daemon_init()", ok);
+    if (!ok) return;
+
+    snprintf(line, sizeof(line), "add pid %d interval=250 collect=cpu,mem", getpid());
+    monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    print_test_result("add pid returns the target id", strcmp(reply, "OK 1\n") == 0);
+
+    monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    print_test_result("Duplicate PID is rejected", strncmp(reply, "ERR", 3) == 0);
+
+    monitor_daemon_command(&monitor, "add pid 999999999", reply, sizeof(reply));
+    print_test_result("Missing PID is rejected", strncmp(reply, "ERR", 3) == 0);
+
+    monitor_daemon_command(&monitor, "add pid 1 interval=1", reply, sizeof(reply));
+    print_test_result("Interval below the minimum is rejected", strncmp(reply, "ERR interval", 12) == 0);
+
+    monitor_daemon_command(&monitor, "add cgroup relative/path", reply, sizeof(reply));
+    print_test_result("Relative cgroup path is rejected", strncmp(reply, "ERR", 3) == 0);
+
+    monitor_daemon_command(&monitor, "add pid 1 collect=io", reply, sizeof(reply));
+    print_test_result("Second target gets the next id", strcmp(reply, "OK 2\n") == 0);
+
+    monitor_daemon_command(&monitor, "list", reply, sizeof(reply));
+    snprintf(line, sizeof(line), "1 pid %d interval=250 collect=cpu,mem samples=0", getpid());
+    print_test_result("list shows every target",
+                      strstr(reply, line) != NULL &&
+                      strstr(reply, "2 pid 1 interval=1000 collect=io") != NULL &&
+                      strstr(reply, "OK 2\n") != NULL);
+
+    char small[16];
+    size_t full = monitor_daemon_command(&monitor, "list", small, sizeof(small));
+    print_test_result("A short buffer reports the full reply length",
+                      full == strlen(reply) && strlen(small) == sizeof(small) - 1);
+
+    monitor_daemon_command(&monitor, "set 1 interval=500 collect=cpu", reply, sizeof(reply));
+    print_test_result("set changes interval and collectors",
+                      strcmp(reply, "OK\n") == 0 && monitor.targets[0]->interval_ms == 500 &&
+                      monitor.targets[0]->collect == EXPORT_HAS_CPU);
+
+    monitor_daemon_command(&monitor, "set 1 bogus=1", reply, sizeof(reply));
+    print_test_result("set rejects unknown options", strncmp(reply, "ERR unknown option", 18) == 0);
+
+    monitor_daemon_command(&monitor, "remove 1", reply, sizeof(reply));
+    print_test_result("remove", strcmp(reply, "OK\n") == 0 && monitor.target_count == 1 &&
+                      monitor.targets[0]->id == 2);
+
+    monitor_daemon_command(&monitor, "get 1", reply, sizeof(reply));
+    print_test_result("Removed id is gone", strncmp(reply, "ERR", 3) == 0);
+
+    monitor_daemon_command(&monitor, "frobnicate", reply, sizeof(reply));
+    print_test_result("Unknown command", strncmp(reply, "ERR unknown command", 19) == 0);
+
+    monitor_daemon_command(&monitor, "shutdown", reply, sizeof(reply));
+    print_test_result("shutdown sets the stop flag", strcmp(reply, "OK\n") == 0 && monitor.stop_requested);
+
+    monitor_daemon_free(&monitor);
+    print_test_result("free removes the socket", access(SOCKET_PATH, F_OK) != 0);
+}
+
+/**
+ * Despacha os eventos do daemon por duration_ms
+ */
+static void run_for(monitor_daemon_t *monitor, int duration_ms) {
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        event_loop_run_once(&monitor->loop, 10);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 < duration_ms);
+}
+
+void test_events(void) {
+    monitor_daemon_t monitor;
+    char reply[8192];
+    char line[128];
+
+    if (monitor_daemon_init(&monitor, SOCKET_PATH) != 0) {
+        print_test_result("monitor_daemon_init()", 0);
+        return;
+    }
+
+    // cpu a cada 20 ms, mem e io no intervalo padrão de 1 s
+    snprintf(line, sizeof(line), "add pid %d cpu_interval=20", getpid());
+    monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    daemon_target_t *self = monitor.targets[0];
+    print_test_result("Collectors with different cadences get separate timers",
+                      strcmp(reply, "OK 1\n") == 0 && self->timer_count == 2 &&
+                      self->timers[0].mask == EXPORT_HAS_CPU &&
+                      self->timers[1].mask == (EXPORT_HAS_MEM | EXPORT_HAS_IO));
+
+    run_for(&monitor, 200);
+    print_test_result("Fast collector runs on its own cadence",
+                      self->samples >= 6 && self->samples <= 12 &&
+                      (self->last.flags & EXPORT_HAS_MEM));
+
+    monitor_daemon_command(&monitor, "set 1 cpu_interval=0", reply, sizeof(reply));
+    print_test_result("cpu_interval=0 merges back into one timer",
+                      strcmp(reply, "OK\n") == 0 && self->timer_count == 1);
+
+    monitor_daemon_command(&monitor, "set 1 stall=100", reply, sizeof(reply));
+    print_test_result("stall= needs a cgroup target", strncmp(reply, "ERR", 3) == 0);
+
+    // O pidfd avisa o fim do filho sem esperar pelo próximo timer
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    snprintf(line, sizeof(line), "add pid %d interval=60000", child);
+    monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    run_for(&monitor, 20);
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+    run_for(&monitor, 50);
+    daemon_target_t *gone = monitor.targets[1];
+    print_test_result("Exit is noticed through the pidfd",
+                      gone->exited && gone->timer_count == 0 && gone->samples == 1);
+
+    const char *unified = detect_cgroup_version() == 2 ? "/sys/fs/cgroup" : "/sys/fs/cgroup/unified";
+    snprintf(line, sizeof(line), "%s/cpu.pressure", unified);
+    if (access(line, W_OK) == 0) {
+        snprintf(line, sizeof(line), "add cgroup %s collect=cpu stall=100", unified);
+        monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+        print_test_result("stall= arms PSI triggers on a v2 cgroup",
+                          strcmp(reply, "OK 3\n") == 0 && monitor.targets[2]->psi_sources[0] != NULL &&
+                          monitor.targets[2]->psi_sources[2] != NULL);
+        monitor_daemon_command(&monitor, "list", reply, sizeof(reply));
+        print_test_result("list shows the stall threshold", strstr(reply, " stall=100\n") != NULL);
+    } else {
+        printf("[SKIP] PSI triggers (no cgroup v2 pressure files)\n");
+    }
+
+    monitor_daemon_free(&monitor);
+}
+
+void test_workers(void) {
+    monitor_daemon_t monitor;
+    char reply[8192];
+    char line[128];
+
+    if (monitor_daemon_init(&monitor, SOCKET_PATH) != 0) {
+        print_test_result("monitor_daemon_init()", 0);
+        return;
+    }
+    print_test_result("monitor_daemon_set_workers()",
+                      monitor_daemon_set_workers(&monitor, 3) == 0 && monitor.pool->worker_count == 3);
+
+    pid_t children[4];
+    for (int i = 0; i < 4; i++) {
+        children[i] = fork();
+        if (children[i] == 0) {
+            pause();
+            _exit(0);
+        }
+        snprintf(line, sizeof(line), "add pid %d interval=20", children[i]);
+        monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    }
+    snprintf(line, sizeof(line), "add pid %d interval=20", getpid());
+    monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+
+    run_for(&monitor, 200);
+    int sampled = 1;
+    for (int i = 0; i < monitor.target_count; i++) {
+        if (monitor.targets[i]->samples < 5 || !(monitor.targets[i]->last.flags & EXPORT_HAS_MEM)) {
+            sampled = 0;
+        }
+    }
+    print_test_result("Targets are sampled by the worker pool", sampled && monitor.target_count == 5);
+
+    // Remover com a coleta em voo adia a liberação para o fim dela
+    monitor_daemon_command(&monitor, "remove 1", reply, sizeof(reply));
+    monitor_daemon_command(&monitor, "remove 2", reply, sizeof(reply));
+    run_for(&monitor, 50);
+    print_test_result("Removal during a round is safe",
+                      strcmp(reply, "OK\n") == 0 && monitor.target_count == 3);
+
+    monitor_daemon_command(&monitor, "stats", reply, sizeof(reply));
+    const char *rounds = strstr(reply, "rounds=");
+    print_test_result("stats reports pool rounds",
+                      ends_with_ok(reply) && strstr(reply, "workers=3\n") != NULL &&
+                      rounds != NULL && atol(rounds + 7) >= 5 &&
+                      strstr(reply, "max_round_ms=") != NULL && strstr(reply, "worker2_jobs=") != NULL);
+
+    for (int i = 0; i < 4; i++) {
+        kill(children[i], SIGKILL);
+        waitpid(children[i], NULL, 0);
+    }
+    monitor_daemon_free(&monitor);
+}
+
+/**
+ * Troca o FIFO por um arquivo vazio e solta quem está preso no open() dele
+ *
+ * Abrir com O_RDWR conta como escritor (o open() preso retorna); fechar
+ * depois da troca entrega EOF, e as próximas coletas leem o arquivo
+ */
+static void release_fifo(const char *path) {
+    char regular[128];
+    snprintf(regular, sizeof(regular), "%s.new", path);
+    int fd = open(path, O_RDWR | O_NONBLOCK);
+    int tmp = open(regular, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (tmp >= 0) close(tmp);
+    rename(regular, path);
+    if (fd >= 0) close(fd);
+}
+
+void test_stuck_target(void) {
+    monitor_daemon_t monitor;
+    char reply[8192];
+    char line[128];
+    char dir[64], stat_fifo[96], usage_fifo[96];
+
+    // Um "cgroup" cujos arquivos são FIFOs: a coleta fica presa no open()
+    // como numa leitura de um processo em estado D
+    snprintf(dir, sizeof(dir), "/tmp/test_daemon_stuck.%d", getpid());
+    snprintf(stat_fifo, sizeof(stat_fifo), "%s/cpu.stat", dir);
+    snprintf(usage_fifo, sizeof(usage_fifo), "%s/cpuacct.usage", dir);
+    if (mkdir(dir, 0755) != 0 || mkfifo(stat_fifo, 0600) != 0 || mkfifo(usage_fifo, 0600) != 0 ||
+        monitor_daemon_init(&monitor, SOCKET_PATH) != 0) {
+        print_test_result("Stuck target setup", 0);
+        return;
+    }
+    monitor_daemon_set_workers(&monitor, 2);
+
+    int stuck = monitor_daemon_add_cgroup(&monitor, dir, NULL, 20, EXPORT_HAS_CPU);
+    pid_t children[3];
+    for (int i = 0; i < 3; i++) {
+        children[i] = fork();
+        if (children[i] == 0) {
+            pause();
+            _exit(0);
+        }
+        snprintf(line, sizeof(line), "add pid %d interval=20", children[i]);
+        monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    }
+
+    run_for(&monitor, 300);
+    int sampled = 1;
+    uint64_t stuck_samples = 0;
+    for (int i = 0; i < monitor.target_count; i++) {
+        if (monitor.targets[i]->id == stuck) {
+            stuck_samples = monitor.targets[i]->samples;
+        } else if (monitor.targets[i]->samples < 5) {
+            sampled = 0;
+        }
+    }
+    print_test_result("Other targets keep being sampled while one collection is stuck",
+                      stuck > 0 && monitor.target_count == 4 && sampled && stuck_samples == 0);
+    print_test_result("The stuck target counts overruns", monitor.overruns > 0);
+
+    // Remover com a coleta presa adia a liberação para quando ela terminar
+    snprintf(line, sizeof(line), "remove %d", stuck);
+    monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    int removed = strcmp(reply, "OK\n") == 0 && monitor.target_count == 3;
+    release_fifo(usage_fifo);
+    release_fifo(stat_fifo);
+    run_for(&monitor, 100);
+    print_test_result("A target removed while stuck is freed once its collection ends",
+                      removed && monitor.pool->outstanding <= 3);
+
+    for (int i = 0; i < 3; i++) {
+        kill(children[i], SIGKILL);
+        waitpid(children[i], NULL, 0);
+    }
+    // Um PID morto pode estar em coleta; monitor_daemon_free espera por ela
+    monitor_daemon_free(&monitor);
+    unlink(stat_fifo);
+    unlink(usage_fifo);
+
+    // Ainda preso no encerramento: free desiste no prazo e abandona o alvo
+    if (mkfifo(stat_fifo, 0600) != 0 || mkfifo(usage_fifo, 0600) != 0 ||
+        monitor_daemon_init(&monitor, SOCKET_PATH) != 0) {
+        print_test_result("Stuck target setup", 0);
+        rmdir(dir);
+        return;
+    }
+    monitor_daemon_set_workers(&monitor, 2);
+    monitor_daemon_add_cgroup(&monitor, dir, NULL, 20, EXPORT_HAS_CPU);
+    run_for(&monitor, 50);
+    struct timespec before, after;
+    clock_gettime(CLOCK_MONOTONIC, &before);
+    monitor_daemon_free(&monitor);
+    clock_gettime(CLOCK_MONOTONIC, &after);
+    double elapsed_ms = (after.tv_sec - before.tv_sec) * 1000.0 + (after.tv_nsec - before.tv_nsec) / 1e6;
+    print_test_result("free gives up on a collection stuck at shutdown",
+                      elapsed_ms >= MONITOR_DAEMON_DRAIN_TIMEOUT_MS - 10 &&
+                      elapsed_ms < MONITOR_DAEMON_DRAIN_TIMEOUT_MS + 1000 && monitor.pool == NULL);
+
+    // Solta o worker abandonado (o alvo e o pool vazaram, ele só termina)
+    release_fifo(usage_fifo);
+    release_fifo(stat_fifo);
+    usleep(50000);
+    unlink(stat_fifo);
+    unlink(usage_fifo);
+    rmdir(dir);
+}
+
+void test_adaptive(void) {
+    monitor_daemon_t monitor;
+    char reply[8192];
+    char line[128];
+
+    if (monitor_daemon_init(&monitor, SOCKET_PATH) != 0) {
+        print_test_result("monitor_daemon_init()", 0);
+        return;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+
+    snprintf(line, sizeof(line), "add pid %d interval=50 adaptive=50:2000", child);
+    monitor_daemon_command(&monitor, line, reply, sizeof(reply));
+    monitor_daemon_command(&monitor, "list", reply, sizeof(reply));
+    print_test_result("adaptive= is accepted and listed",
+                      strstr(reply, " adaptive=50:2000 effective=50") != NULL);
+
+    monitor_daemon_command(&monitor, "set 1 adaptive=500:100", reply, sizeof(reply));
+    int rejected = strncmp(reply, "ERR", 3) == 0;
+    monitor_daemon_command(&monitor, "set 1 adaptive=5:100", reply, sizeof(reply));
+    print_test_result("Invalid adaptive ranges are rejected",
+                      rejected && strncmp(reply, "ERR", 3) == 0);
+
+    // Um processo parado em pause() é o caso ocioso: o intervalo cresce
+    run_for(&monitor, 1000);
+    daemon_target_t *target = monitor.targets[0];
+    print_test_result("An idle target backs off toward the ceiling",
+                      target->adapt.interval_ms > 50 && target->adapt.grows > 0 &&
+                      target->timers[0].effective_ms == (int)target->adapt.interval_ms &&
+                      target->last.interval_ms > 50);
+
+    monitor_daemon_command(&monitor, "set 1 adaptive=0", reply, sizeof(reply));
+    monitor_daemon_command(&monitor, "list", reply, sizeof(reply));
+    print_test_result("adaptive=0 restores the fixed interval",
+                      strstr(reply, "adaptive=") == NULL && target->timers[0].effective_ms == 50);
+
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+    monitor_daemon_free(&monitor);
+}
+
+static void* run_thread(void *arg) {
+    monitor_daemon_t *monitor = arg;
+    monitor_daemon_run(monitor, NULL);
+    return NULL;
+}
+
+/**
+ * Envia um comando e guarda a resposta completa
+ */
+static int control(const char *command, char *reply, size_t size) {
+    FILE *out = fmemopen(reply, size, "w");
+    if (out == NULL) return -1;
+    int result = monitor_daemon_control(SOCKET_PATH, command, out);
+    fclose(out);
+    return result;
+}
+
+void test_socket(void) {
+    monitor_daemon_t monitor;
+    pthread_t thread;
+    char reply[8192];
+    char line[128];
+
+    if (monitor_daemon_init(&monitor, SOCKET_PATH) != 0) {
+        print_test_result("monitor_daemon_init()", 0);
+        return;
+    }
+    pthread_create(&thread, NULL, run_thread, &monitor);
+
+    snprintf(line, sizeof(line), "add pid %d interval=20", getpid());
+    print_test_result("add over the socket", control(line, reply, sizeof(reply)) == 0 &&
+                      strcmp(reply, "OK 1\n") == 0);
+
+    // Gasta CPU para que a segunda amostra tenha uma taxa
+    volatile unsigned long spin = 0;
+    for (unsigned long i = 0; i < 200000000UL; i++) spin += i;
+    usleep(100000);
+
+    control("get 1", reply, sizeof(reply));
+    const char *samples = strstr(reply, "samples=");
+    print_test_result("Target is sampled on its interval",
+                      samples != NULL && atol(samples + 8) >= 3);
+    print_test_result("get reports the latest values",
+                      ends_with_ok(reply) && strstr(reply, "mem_rss=") != NULL &&
+                      strstr(reply, "cpu_percent=") != NULL && strstr(reply, "threads=2\n") != NULL);
+
+    print_test_result("Errors are reported as ERR",
+                      control("get 42", reply, sizeof(reply)) == 1 &&
+                      strncmp(reply, "ERR", 3) == 0);
+
+    print_test_result("list over the socket", control("list", reply, sizeof(reply)) == 0 &&
+                      strstr(reply, "OK 1\n") != NULL);
+
+    // Mais alvos do que cabiam no antigo buffer de 64 KiB: a resposta sai
+    // inteira, terminada por OK
+    int added = 0;
+    for (int i = 0; i < 1000; i++) {
+        added += control("add cgroup /tmp interval=86400000 collect=cpu", reply, sizeof(reply)) == 0;
+    }
+    size_t big_size = 1 << 20;
+    char *big = calloc(1, big_size);
+    int listed = big != NULL && control("list", big, big_size) == 0;
+    size_t big_length = big != NULL ? strlen(big) : 0;
+    print_test_result("list of more targets than one buffer ends with OK",
+                      added == 1000 && listed && big_length > 65536 &&
+                      strcmp(big + big_length - strlen("OK 1001\n"), "OK 1001\n") == 0);
+    free(big);
+
+    print_test_result("shutdown stops the loop", control("shutdown", reply, sizeof(reply)) == 0);
+    pthread_join(thread, NULL);
+    monitor_daemon_free(&monitor);
+
+    print_test_result("Client reports a missing daemon",
+                      monitor_daemon_control(SOCKET_PATH, "list", NULL) == -1);
+
+    // Um daemon que aceita e nunca responde não prende o cliente
+    int silent = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, SOCKET_PATH);
+    unlink(SOCKET_PATH);
+    if (silent >= 0 && bind(silent, (struct sockaddr *)&addr, sizeof(addr)) == 0 && listen(silent, 1) == 0) {
+        time_t start = time(NULL);
+        int result = monitor_daemon_control(SOCKET_PATH, "list", NULL);
+        int err = errno;
+        time_t elapsed = time(NULL) - start;
+        print_test_result("Client gives up on a silent daemon",
+                          result == -1 && err == ETIMEDOUT &&
+                          elapsed <= MONITOR_DAEMON_CONTROL_TIMEOUT_MS / 1000 + 2);
+    } else {
+        print_test_result("Client gives up on a silent daemon", 0);
+    }
+    if (silent >= 0) close(silent);
+    unlink(SOCKET_PATH);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║            Resource Monitor - Daemon Test Suite            ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_parse_collect();
+    test_commands();
+    test_events();
+    test_workers();
+    test_stuck_target();
+    test_adaptive();
+    test_socket();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,207 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/wait.h>
+#include "../include/event_loop.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void count_callback(event_source_t *source, uint32_t events, void *data) {
+    (void)source;
+    (void)events;
+    (*(int *)data)++;
+}
+
+/**
+ * Despacha até *counter chegar a target ou o prazo acabar
+ */
+static void run_until(event_loop_t *loop, const int *counter, int target, int deadline_ms) {
+    double end = now_ms() + deadline_ms;
+    while (*counter < target && now_ms() < end) {
+        event_loop_run_once(loop, 10);
+    }
+}
+
+void test_timers(void) {
+    event_loop_t loop;
+    int ok = event_loop_init(&loop) == 0;
+    print_test_result("event_loop_init()", ok);
+    if (!ok) return;
+
+    int periodic = 0, once = 0;
+    double start = now_ms();
+    event_source_t *timer = event_loop_add_timer(&loop, 0, 10, count_callback, &periodic);
+    event_source_t *single = event_loop_add_timer(&loop, 30, 0, count_callback, &once);
+    run_until(&loop, &periodic, 5, 1000);
+    double elapsed = now_ms() - start;
+    print_test_result("Periodic timer fires on its period",
+                      timer != NULL && periodic == 5 && elapsed >= 35 && elapsed < 500);
+
+    run_until(&loop, &periodic, 10, 1000);
+    print_test_result("One-shot timer fires once", single != NULL && once == 1);
+
+    // Reprogramado para longe: nenhum disparo no meio tempo
+    event_loop_set_timer(timer, 60000, 60000);
+    int before = periodic;
+    event_loop_run_once(&loop, 50);
+    print_test_result("event_loop_set_timer() reprograms", periodic == before);
+
+    event_loop_remove(timer);
+    event_loop_remove(single);
+    uint64_t wakeups = loop.wakeups;
+    int ready = event_loop_run_once(&loop, 50);
+    print_test_result("Idle loop does not wake up", ready == 0 && loop.wakeups == wakeups &&
+                      loop.source_count == 0);
+    event_loop_free(&loop);
+}
+
+static event_source_t *pair[2];
+static int pair_calls = 0;
+
+static void remove_other(event_source_t *source, uint32_t events, void *data) {
+    (void)events;
+    (void)data;
+    pair_calls++;
+    event_loop_remove(source == pair[0] ? pair[1] : pair[0]);
+}
+
+void test_fd_sources(void) {
+    event_loop_t loop;
+    event_loop_init(&loop);
+    int a[2], b[2];
+    if (pipe(a) != 0 || pipe(b) != 0) {
+        print_test_result("pipe()", 0);
+        return;
+    }
+
+    // Os dois ficam prontos no mesmo lote e cada um remove o outro
+    pair[0] = event_loop_add_fd(&loop, a[0], EPOLLIN, 0, remove_other, NULL);
+    pair[1] = event_loop_add_fd(&loop, b[0], EPOLLIN, 0, remove_other, NULL);
+    ssize_t w = write(a[1], "x", 1) + write(b[1], "x", 1);
+    (void)w;
+    event_loop_run_once(&loop, 100);
+    print_test_result("Source removed in the same batch is not dispatched", pair_calls == 1);
+
+    event_loop_remove(pair[0]);
+    event_loop_remove(pair[1]);
+    print_test_result("Sources not owning the fd leave it open",
+                      fcntl(a[0], F_GETFD) != -1 && fcntl(b[0], F_GETFD) != -1);
+    close(a[0]); close(a[1]); close(b[0]); close(b[1]);
+    event_loop_free(&loop);
+}
+
+void test_pidfd(void) {
+    event_loop_t loop;
+    event_loop_init(&loop);
+
+    pid_t child = fork();
+    if (child == 0) {
+        usleep(50000);
+        _exit(0);
+    }
+
+    int exited = 0;
+    double start = now_ms();
+    event_source_t *source = event_loop_add_pidfd(&loop, child, count_callback, &exited);
+    run_until(&loop, &exited, 1, 2000);
+    double latency = now_ms() - start;
+    print_test_result("pidfd reports the exit without polling",
+                      source != NULL && exited == 1 && latency < 1000);
+
+    waitpid(child, NULL, 0);
+    event_loop_remove(source);
+    print_test_result("pidfd of a missing process fails",
+                      event_loop_add_pidfd(&loop, child, count_callback, &exited) == NULL);
+    event_loop_free(&loop);
+}
+
+void test_inotify(void) {
+    event_loop_t loop;
+    event_loop_init(&loop);
+    char path[] = "/tmp/test_event_loop_XXXXXX";
+    int fd = mkstemp(path);
+
+    int changes = 0;
+    event_source_t *source = event_loop_add_inotify(&loop, path, IN_MODIFY, count_callback, &changes);
+    ssize_t w = write(fd, "oom 1\n", 6);
+    (void)w;
+    run_until(&loop, &changes, 1, 1000);
+    print_test_result("inotify reports a modified file", source != NULL && changes == 1);
+
+    // Os eventos são consumidos antes do callback: nada mais fica pendente
+    event_loop_run_once(&loop, 50);
+    print_test_result("inotify events are drained", changes == 1);
+
+    event_loop_remove(source);
+    close(fd);
+    unlink(path);
+    event_loop_free(&loop);
+}
+
+void test_psi(void) {
+    if (access("/proc/pressure/cpu", W_OK) != 0) {
+        printf("[SKIP] PSI trigger (no writable /proc/pressure/cpu)\n");
+        return;
+    }
+    event_loop_t loop;
+    event_loop_init(&loop);
+    int stalls = 0;
+    event_source_t *source = event_loop_add_psi(&loop, "/proc/pressure/cpu", 0, 150000, 2000000,
+                                                count_callback, &stalls);
+    print_test_result("PSI trigger is registered", source != NULL);
+    print_test_result("Invalid PSI trigger is rejected",
+                      event_loop_add_psi(&loop, "/proc/pressure/cpu", 0, 3000000, 2000000,
+                                         count_callback, &stalls) == NULL);
+    event_loop_remove(source);
+    event_loop_free(&loop);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║          Resource Monitor - Event Loop Test Suite          ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_timers();
+    test_fd_sources();
+    test_pidfd();
+    test_inotify();
+    test_psi();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
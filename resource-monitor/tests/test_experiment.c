@@ -0,0 +1,210 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include "../include/experiment.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_YELLOW "\033[0;33m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+static int write_spec(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        return -1;
+    }
+    fputs(content, fp);
+    return fclose(fp);
+}
+
+void test_statistics(void) {
+    // Valores de tabela (bicaudal 95% e 99%)
+    print_test_result("t quantile df=1 p=0.975 is 12.706",
+                      fabs(student_t_quantile(0.975, 1) - 12.706) < 0.001);
+    print_test_result("t quantile df=9 p=0.975 is 2.262",
+                      fabs(student_t_quantile(0.975, 9) - 2.262) < 0.001);
+    print_test_result("t quantile df=30 p=0.995 is 2.750",
+                      fabs(student_t_quantile(0.995, 30) - 2.750) < 0.001);
+    print_test_result("t quantile approaches the normal for large df (1.962 at df=1000)",
+                      fabs(student_t_quantile(0.975, 1000) - 1.962) < 0.001);
+
+    // 2 4 4 4 5 5 7 9: média 5, desvio amostral sqrt(32/7)
+    double values[] = { 9, 2, 4, NAN, 4, 5, 4, 7, 5 };
+    sample_summary_t s;
+    summarize_samples(values, 9, 95.0, &s);
+    double half = 2.365 * sqrt(32.0 / 7.0) / sqrt(8.0);
+    print_test_result("Summary skips NaN and computes n, mean, min, median, max",
+                      s.n == 8 && fabs(s.mean - 5.0) < 1e-9 && s.min == 2 && s.max == 9 &&
+                      fabs(s.median - 4.5) < 1e-9);
+    print_test_result("Sample stddev and 95% interval of the mean",
+                      fabs(s.stddev - sqrt(32.0 / 7.0)) < 1e-9 &&
+                      fabs((s.ci_high - s.mean) - half) < 0.001 &&
+                      fabs((s.mean - s.ci_low) - half) < 0.001);
+
+    double one = 3.0;
+    summarize_samples(&one, 1, 95.0, &s);
+    print_test_result("A single sample has a degenerate interval",
+                      s.n == 1 && s.stddev == 0 && s.ci_low == 3.0 && s.ci_high == 3.0);
+
+    double none = NAN;
+    summarize_samples(&none, 1, 95.0, &s);
+    print_test_result("No finite samples gives n=0", s.n == 0 && isnan(s.mean));
+}
+
+void test_spec_parsing(void) {
+    char path[] = "/tmp/test_experiment_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        print_test_result("Create temporary spec", 0);
+        return;
+    }
+    close(fd);
+
+    experiment_spec_t *spec = calloc(1, sizeof(experiment_spec_t));
+    write_spec(path,
+               "# comentário\n"
+               "set repetitions=7 warmup=2 cpus=0 confidence=99 timeout=30  # fim\n"
+               "setup -- touch /tmp/x\n"
+               "base -- /bin/true\n"
+               "limited monitor=2 cpu=0.5 mem=64 cpus=0-1 -- sh -c 'exit 0'\n");
+    int ok = load_experiment_spec(path, spec) == 0;
+    print_test_result("Spec with set, setup and two conditions loads", ok && spec->condition_count == 2);
+    if (ok) {
+        print_test_result("set overrides repetitions, warmup, confidence, timeout",
+                          spec->repetitions == 7 && spec->warmup == 2 &&
+                          spec->confidence == 99 && spec->timeout_sec == 30);
+        print_test_result("Default cpus applies only to conditions without their own",
+                          strcmp(spec->conditions[0].workload.cpus, "0") == 0 &&
+                          strcmp(spec->conditions[1].workload.cpus, "0-1") == 0);
+        print_test_result("monitor= is taken out, manifest options remain",
+                          spec->conditions[1].monitor_interval == 2 &&
+                          spec->conditions[0].monitor_interval == 0 &&
+                          spec->conditions[1].workload.cpu_limit == 0.5 &&
+                          spec->conditions[1].workload.mem_limit_mb == 64 &&
+                          strcmp(spec->conditions[1].workload.argv[2], "exit 0") == 0);
+        print_test_result("setup command is kept apart from the conditions",
+                          spec->setup.argv[0] != NULL && strcmp(spec->setup.argv[0], "touch") == 0 &&
+                          spec->teardown.argv[0] == NULL);
+    }
+
+    // io=@ depende de /tmp estar num dispositivo de bloco (não tmpfs)
+    write_spec(path, "disk io=@/tmp:1048576:2097152 -- /bin/true\n");
+    if (load_experiment_spec(path, spec) == 0) {
+        const workload_t *disk = &spec->conditions[0].workload;
+        print_test_result("io=@path resolves to a major:minor device",
+                          strchr(disk->io_device, ':') != NULL &&
+                          disk->io_rbps == 1048576 && disk->io_wbps == 2097152);
+    } else {
+        printf("[%sSKIP%s] io=@path - /tmp is not on a block device\n", COLOR_YELLOW, COLOR_RESET);
+    }
+
+    write_spec(path, "set repetitions=0\nbase -- /bin/true\n");
+    print_test_result("repetitions=0 is rejected", load_experiment_spec(path, spec) != 0);
+    write_spec(path, "set foo=1\nbase -- /bin/true\n");
+    print_test_result("Unknown setting is rejected", load_experiment_spec(path, spec) != 0);
+    write_spec(path, "a -- /bin/true\na cpu=1 -- /bin/true\n");
+    print_test_result("Duplicate condition names are rejected", load_experiment_spec(path, spec) != 0);
+    write_spec(path, "a monitor=0 -- /bin/true\n");
+    print_test_result("monitor=0 is rejected", load_experiment_spec(path, spec) != 0);
+    write_spec(path, "set warmup=0\n");
+    print_test_result("Spec without conditions is rejected", load_experiment_spec(path, spec) != 0);
+
+    free(spec);
+    unlink(path);
+}
+
+void test_run(void) {
+    if (geteuid() != 0) {
+        printf("[%sSKIP%s] Experiment run - requires root\n", COLOR_YELLOW, COLOR_RESET);
+        return;
+    }
+
+    char path[] = "/tmp/test_experiment_XXXXXX";
+    char out[64];
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        print_test_result("Create temporary spec", 0);
+        return;
+    }
+    close(fd);
+    snprintf(out, sizeof(out), "%s.json", path);
+
+    experiment_spec_t *spec = calloc(1, sizeof(experiment_spec_t));
+    write_spec(path,
+               "set repetitions=3 warmup=1\n"
+               "ok -- sh -c 'i=0; while [ $i -lt 20000 ]; do i=$((i+1)); done'\n"
+               "fails -- sh -c 'exit 3'\n");
+    int ok = load_experiment_spec(path, spec) == 0 && run_experiment(spec, NULL, 1, NULL) == 0;
+    print_test_result("Experiment runs warmup and repetitions", ok);
+    if (ok) {
+        const experiment_condition_t *good = &spec->conditions[0];
+        const experiment_condition_t *bad = &spec->conditions[1];
+        print_test_result("Warmup is discarded (3 trials kept per condition)",
+                          good->trial_count == 3 && bad->trial_count == 3);
+        print_test_result("Wall time and wait4 user time are measured",
+                          good->summary[EXP_METRIC_WALL].n == 3 &&
+                          good->summary[EXP_METRIC_WALL].mean > 0 &&
+                          good->summary[EXP_METRIC_USER].mean + good->summary[EXP_METRIC_SYS].mean > 0);
+        print_test_result("Exit codes are recorded and counted as failures",
+                          good->failures == 0 && bad->failures == 3 && bad->trials[0].exit_code == 3);
+        print_test_result("Monitor CPU is absent without monitor=",
+                          good->summary[EXP_METRIC_MONITOR_CPU].n == 0);
+
+        print_test_result("Results are written as JSON",
+                          write_experiment_results(spec, out, "json") == 0);
+        FILE *fp = fopen(out, "r");
+        char buf[8192] = "";
+        if (fp != NULL) {
+            size_t n = fread(buf, 1, sizeof(buf) - 1, fp);
+            buf[n] = '\0';
+            fclose(fp);
+        }
+        print_test_result("JSON holds summaries and trials",
+                          strstr(buf, "\"wall_sec\": {\"n\": 3") != NULL &&
+                          strstr(buf, "\"exit_code\": 3") != NULL);
+        print_test_result("Unknown result format is rejected",
+                          write_experiment_results(spec, out, "xml") != 0);
+    }
+
+    free_experiment_spec(spec);
+    free(spec);
+    unlink(path);
+    unlink(out);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║       Resource Monitor - Experiment Runner Test Suite      ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_statistics();
+    test_spec_parsing();
+    test_run();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
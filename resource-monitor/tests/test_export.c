@@ -0,0 +1,312 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "../include/export_pipeline.h"
+#include "../include/capture.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+/**
+ * Lê o arquivo CSV e confere que os PIDs aparecem em ordem crescente
+ * @return Número de linhas de dados, ou -1 se a ordem foi violada
+ */
+static long read_sequence(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) return -1;
+
+    char line[512];
+    long rows = 0;
+    long last = -1;
+    int ordered = 1;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, "timestamp", 9) == 0) continue;
+        const char *comma = strchr(line, ',');
+        long pid = comma ? strtol(comma + 1, NULL, 10) : -1;
+        if (pid <= last) ordered = 0;
+        last = pid;
+        rows++;
+    }
+    fclose(fp);
+    return ordered ? rows : -1;
+}
+
+/**
+ * Empurra count registros (pid = 1..count) por uma fila pequena
+ */
+static int run_pipeline(const char *path, export_overflow_t overflow, int count,
+                        export_pipeline_stats_t *stats) {
+    export_writer_t writer;
+    export_pipeline_t pipeline;
+    export_writer_config_t config;
+
+    unlink(path);
+    export_writer_config_default(&config);
+    if (export_writer_open(&writer, path, &config) != 0) return -1;
+    if (export_pipeline_start(&pipeline, &writer, 16, overflow) != 0) {
+        export_writer_close(&writer);
+        return -1;
+    }
+
+    memory_metrics_t mem = { .rss = 4096, .vsz = 8192, .page_faults = 1, .swap = 0 };
+    for (int i = 1; i <= count; i++) {
+        export_record_t record;
+        export_record_fill(&record, (pid_t)i, NULL, &mem, NULL);
+        export_pipeline_push(&pipeline, &record);
+    }
+
+    export_pipeline_stop(&pipeline);
+    export_pipeline_get_stats(&pipeline, stats);
+    return export_writer_close(&writer);
+}
+
+void test_block_policy(void) {
+    const char *path = "/tmp/test_export_block.csv";
+    export_pipeline_stats_t stats;
+    const int count = 20000;
+
+    int ok = run_pipeline(path, EXPORT_OVERFLOW_BLOCK, count, &stats) == 0;
+    print_test_result("BLOCK delivers every record",
+                      ok && stats.written == (uint64_t)count && stats.dropped == 0);
+    print_test_result("BLOCK keeps records in order", read_sequence(path) == count);
+    print_test_result("Queue depth never exceeds capacity", stats.max_depth <= 16);
+    unlink(path);
+}
+
+void test_drop_policies(void) {
+    const char *path = "/tmp/test_export_drop.csv";
+    export_pipeline_stats_t stats;
+    const int count = 20000;
+
+    int ok = run_pipeline(path, EXPORT_OVERFLOW_DROP_NEWEST, count, &stats) == 0;
+    long rows = read_sequence(path);
+    print_test_result("DROP_NEWEST accounts for every record",
+                      ok && stats.written + stats.dropped == (uint64_t)count &&
+                      rows == (long)stats.written);
+
+    ok = run_pipeline(path, EXPORT_OVERFLOW_DROP_OLDEST, count, &stats) == 0;
+    rows = read_sequence(path);
+    print_test_result("DROP_OLDEST accounts for every record",
+                      ok && stats.pushed == (uint64_t)count &&
+                      stats.written + stats.dropped == (uint64_t)count &&
+                      rows == (long)stats.written);
+
+    // O último registro nunca é o descartado em DROP_OLDEST
+    FILE *fp = fopen(path, "r");
+    char line[512], last[512] = "";
+    while (fp != NULL && fgets(line, sizeof(line), fp) != NULL) {
+        strcpy(last, line);
+    }
+    if (fp != NULL) fclose(fp);
+    const char *comma = strchr(last, ',');
+    print_test_result("DROP_OLDEST keeps the newest record",
+                      comma != NULL && strtol(comma + 1, NULL, 10) == count);
+    unlink(path);
+}
+
+void test_ndjson_record(void) {
+    const char *path = "/tmp/test_export.ndjson";
+    export_writer_t writer;
+    export_writer_config_t config;
+
+    unlink(path);
+    export_writer_config_default(&config);
+    config.format = EXPORT_FORMAT_NDJSON;
+
+    cpu_metrics_t cpu = { .user_time = 7, .system_time = 3, .total_time = 10,
+                          .num_threads = 4, .context_switches = 18446744073709551615ULL,
+                          .cpu_percent = 12.125 };
+    io_metrics_t io = { .bytes_read = 1, .bytes_written = 2, .read_rate = 0.004,
+                        .write_rate = 1048576.5 };
+    export_record_t record;
+    export_record_fill(&record, 42, &cpu, NULL, &io);
+    record.realtime_ns = 1700000000123456789ULL;
+    record.monotonic_ns = 987654321;
+    record.interval_ms = 250;
+
+    int ok = export_writer_open(&writer, path, &config) == 0 &&
+             export_writer_write_record(&writer, &record) == 0 &&
+             export_writer_close(&writer) == 0;
+
+    char line[1024] = "";
+    FILE *fp = fopen(path, "r");
+    if (fp != NULL) {
+        if (fgets(line, sizeof(line), fp) == NULL) line[0] = '\0';
+        fclose(fp);
+    }
+
+    print_test_result("NDJSON record is one line",
+                      ok && line[0] == '{' && strchr(line, '\n') == line + strlen(line) - 1);
+    print_test_result("NDJSON nanosecond timestamps",
+                      strstr(line, "\"ts_ns\":1700000000123456789,\"mono_ns\":987654321,") != NULL);
+    print_test_result("NDJSON integer and fixed-point fields",
+                      strstr(line, "\"context_switches\":18446744073709551615}") != NULL &&
+                      strstr(line, "\"percent\":12.13,") != NULL);
+    print_test_result("NDJSON rates and missing sections",
+                      strstr(line, "\"read_rate\":0.00,\"write_rate\":1048576.50}") != NULL &&
+                      strstr(line, "\"mem\":null") != NULL);
+    print_test_result("NDJSON records the sampling interval",
+                      strstr(line, "\"pid\":42,\"interval_ms\":250,") != NULL);
+    unlink(path);
+}
+
+/**
+ * Série sintética de 1 Hz com jitter de dezenas de microssegundos. Como numa
+ * frota real, a maior parte dos alvos está ociosa; um em cada cinco consome
+ * CPU, faz I/O e varia o RSS a cada amostra
+ */
+static void synthetic_record(export_record_t *r, int target, int tick) {
+    uint64_t t = (uint64_t)tick;
+    uint64_t noise = (t * 2654435761ULL + (uint64_t)target * 40503ULL) >> 7;
+
+    memset(r, 0, sizeof(*r));
+    r->pid = 1000 + target;
+    r->flags = EXPORT_HAS_CPU | EXPORT_HAS_MEM | EXPORT_HAS_IO;
+    r->interval_ms = 1000;
+    r->monotonic_ns = 5000000000ULL + t * 1000000000ULL + noise % 80000;
+    r->realtime_ns = 1700000000000000000ULL + r->monotonic_ns;
+    r->cpu.num_threads = 4;
+    r->mem.vsz = 512ULL * 1024 * 1024;
+    r->mem.rss = 64ULL * 1024 * 1024;
+
+    if (target % 5 != 0) {
+        r->cpu.user_time = 1200 + (uint64_t)target;
+        r->cpu.system_time = 300;
+        r->cpu.total_time = r->cpu.user_time + r->cpu.system_time;
+        r->cpu.context_switches = 5000;
+        r->mem.page_faults = 900;
+        return;
+    }
+
+    r->cpu.user_time = t * 40 + (noise % 7);
+    r->cpu.system_time = t * 10 + (noise % 3);
+    r->cpu.total_time = r->cpu.user_time + r->cpu.system_time;
+    r->cpu.context_switches = t * 180 + (noise % 50);
+    r->cpu.cpu_percent = 50.0 + (double)(noise % 8) * 0.25;
+    r->mem.rss += (noise % 16) * 4096;
+    r->mem.page_faults = t * 3;
+    r->io.bytes_read = t * 65536;
+    r->io.bytes_written = t * 16384 + (noise % 4) * 4096;
+    r->io.syscalls_read = t * 16;
+    r->io.syscalls_write = t * 4 + (noise % 2);
+    r->io.read_rate = 65536.0;
+    r->io.write_rate = (double)((noise % 4) * 4096);
+}
+
+void test_binary_capture(void) {
+    const char *bin_path = "/tmp/test_export.rmcap";
+    const char *csv_path = "/tmp/test_export_capture.csv";
+    const int targets = 50, ticks = 600;
+    export_writer_config_t config;
+    export_writer_t bin_writer, csv_writer;
+
+    unlink(bin_path);
+    unlink(csv_path);
+    export_writer_config_default(&config);
+    config.format = EXPORT_FORMAT_BINARY;
+    int ok = export_writer_open(&bin_writer, bin_path, &config) == 0;
+    config.format = EXPORT_FORMAT_CSV;
+    ok = ok && export_writer_open(&csv_writer, csv_path, &config) == 0;
+
+    export_record_t record;
+    for (int t = 0; ok && t < ticks; t++) {
+        for (int target = 0; target < targets; target++) {
+            synthetic_record(&record, target, t);
+            ok = export_writer_write_record(&bin_writer, &record) == 0 &&
+                 export_writer_write_record(&csv_writer, &record) == 0;
+        }
+    }
+    ok = export_writer_close(&bin_writer) == 0 && ok;
+    ok = export_writer_close(&csv_writer) == 0 && ok;
+    print_test_result("Binary capture written", ok);
+
+    // Leitura: todos os campos voltam exatamente, série por série
+    capture_reader_t reader;
+    int seen[50] = {0};
+    int exact = 1;
+    long total = 0;
+    if (capture_reader_open(&reader, bin_path) == 0) {
+        export_record_t read_back, expected;
+        int ret;
+        while ((ret = capture_reader_next(&reader, &read_back)) == 1) {
+            int target = read_back.pid - 1000;
+            if (target < 0 || target >= targets) {
+                exact = 0;
+                break;
+            }
+            synthetic_record(&expected, target, seen[target]++);
+            if (memcmp(&read_back, &expected, sizeof(expected)) != 0) {
+                exact = 0;
+            }
+            total++;
+        }
+        if (ret < 0) exact = 0;
+        capture_reader_close(&reader);
+    } else {
+        exact = 0;
+    }
+    print_test_result("Binary capture round-trips every field",
+                      exact && total == (long)targets * ticks);
+
+    struct stat bin_st, csv_st;
+    int sized = stat(bin_path, &bin_st) == 0 && stat(csv_path, &csv_st) == 0;
+    double ratio = sized && bin_st.st_size > 0 ? (double)csv_st.st_size / bin_st.st_size : 0;
+    printf("       capture %ld bytes vs CSV %ld bytes (%.1fx)\n",
+           sized ? (long)bin_st.st_size : 0L, sized ? (long)csv_st.st_size : 0L, ratio);
+    print_test_result("Binary capture at least 10x smaller than CSV", ratio >= 10.0);
+
+    long converted = capture_convert(bin_path, "/tmp/test_export_converted.csv", EXPORT_FORMAT_CSV);
+    print_test_result("capture_convert() to CSV", converted == (long)targets * ticks);
+
+    unlink(bin_path);
+    unlink(csv_path);
+    unlink("/tmp/test_export_converted.csv");
+}
+
+void test_overflow_names(void) {
+    export_overflow_t overflow;
+    print_test_result("export_overflow_from_string()",
+                      export_overflow_from_string("drop-oldest", &overflow) == 0 &&
+                      overflow == EXPORT_OVERFLOW_DROP_OLDEST &&
+                      export_overflow_from_string("sometimes", &overflow) == -1);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║            Resource Monitor - Export Test Suite            ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_block_policy();
+    test_drop_policies();
+    test_ndjson_record();
+    test_binary_capture();
+    test_overflow_names();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,317 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/monitor.h"
+#include "../include/export_delta.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+/**
+ * Série com poucas mudanças: o alvo 0 muda a cada amostra, os outros a
+ * cada quatro; doubles com duas casas exatas para comparar texto
+ */
+static void series_record(export_record_t *r, int target, int tick) {
+    uint64_t t = (uint64_t)(target == 0 ? tick : tick / 4);
+
+    memset(r, 0, sizeof(*r));
+    r->pid = 2000 + target;
+    r->flags = EXPORT_HAS_CPU | EXPORT_HAS_MEM | (target == 2 ? 0 : EXPORT_HAS_IO);
+    r->interval_ms = tick < 6 ? 1000 : 500;
+    r->monotonic_ns = 9000000000ULL + (uint64_t)tick * 1000000000ULL;
+    r->realtime_ns = 1700000000000000000ULL + (uint64_t)tick * 1000000000ULL;
+    r->cpu.user_time = 100 + t * 40;
+    r->cpu.system_time = 30 + t * 10;
+    r->cpu.total_time = r->cpu.user_time + r->cpu.system_time;
+    r->cpu.cpu_percent = 12.5 + (double)(t % 3) * 0.25;
+    r->cpu.num_threads = 4;
+    r->cpu.context_switches = 700 + t * 9;
+    r->mem.rss = 64ULL * 1024 * 1024 + t * 4096;
+    r->mem.vsz = 512ULL * 1024 * 1024;
+    r->mem.page_faults = 90;
+    r->io.bytes_read = t * 65536;
+    r->io.read_rate = (double)t * 0.5;
+}
+
+static int records_equal(const export_record_t *a, const export_record_t *b) {
+    return a->pid == b->pid && a->flags == b->flags && a->interval_ms == b->interval_ms &&
+           memcmp(&a->cpu, &b->cpu, sizeof(a->cpu)) == 0 &&
+           ((a->flags & EXPORT_HAS_MEM) == 0 || memcmp(&a->mem, &b->mem, sizeof(a->mem)) == 0) &&
+           ((a->flags & EXPORT_HAS_IO) == 0 || memcmp(&a->io, &b->io, sizeof(a->io)) == 0);
+}
+
+void test_admit(void) {
+    export_delta_t delta;
+    export_delta_init(&delta, 1, 0.05, 10000);
+
+    export_record_t r, prev;
+    int have_prev = -1;
+    series_record(&r, 1, 0);
+    print_test_result("The first sample of a PID is emitted dense",
+                      export_delta_admit(&delta, &r, &prev, &have_prev) == 1 && have_prev == 0);
+
+    r.monotonic_ns += 1000000000ULL;
+    int same = export_delta_admit(&delta, &r, &prev, &have_prev);
+    r.monotonic_ns += 1000000000ULL;
+    r.mem.rss += r.mem.rss / 50;            // +2%: abaixo de epsilon
+    int small = export_delta_admit(&delta, &r, &prev, &have_prev);
+    print_test_result("Unchanged and sub-epsilon samples are suppressed",
+                      same == 0 && small == 0 && delta.suppressed == 2);
+
+    r.monotonic_ns += 1000000000ULL;
+    r.mem.rss += r.mem.rss / 25;            // acumulado > 5%
+    int grown = export_delta_admit(&delta, &r, &prev, &have_prev);
+    print_test_result("Drift accumulates until it crosses epsilon",
+                      grown == 1 && have_prev == 1 && prev.mem.rss == 64ULL * 1024 * 1024);
+
+    r.monotonic_ns += 10000000000ULL;
+    print_test_result("The heartbeat emits an unchanged sample",
+                      export_delta_admit(&delta, &r, &prev, &have_prev) == 1);
+
+    // Taxa perto de zero: o piso 1 evita que 0 -> 0.03 conte como mudança infinita
+    r.monotonic_ns += 1000000000ULL;
+    r.io.write_rate = 0.03;
+    int floor_ok = export_delta_admit(&delta, &r, &prev, &have_prev) == 0;
+    r.monotonic_ns += 1000000000ULL;
+    r.flags &= ~EXPORT_HAS_IO;
+    int gone = export_delta_admit(&delta, &r, &prev, &have_prev);
+    r.monotonic_ns += 1000000000ULL;
+    r.flags |= EXPORT_HAS_IO;
+    print_test_result("Values near zero use an absolute floor; sections coming and going are changes",
+                      floor_ok && gone == 1 && export_delta_admit(&delta, &r, &prev, &have_prev) == 1);
+
+    export_delta_new_file(&delta);
+    r.monotonic_ns += 1000000000ULL;
+    r.cpu.total_time += 1000;
+    print_test_result("The first row after a new file is dense",
+                      export_delta_admit(&delta, &r, &prev, &have_prev) == 1 && have_prev == 0);
+
+    // Muitos PIDs: a tabela cresce sem perder entradas
+    int found = 1;
+    for (int i = 0; i < 500; i++) {
+        series_record(&r, 10 + i, 0);
+        export_delta_admit(&delta, &r, NULL, NULL);
+    }
+    for (int i = 0; i < 500; i++) {
+        found = found && export_delta_lookup(&delta, 2010 + i, 0) != NULL;
+    }
+    print_test_result("The PID table grows past its initial capacity",
+                      found && delta.count == 501 && export_delta_lookup(&delta, 1, 0) == NULL);
+    export_delta_free(&delta);
+}
+
+void test_counter_rate(void) {
+    export_delta_t delta;
+    export_delta_init(&delta, 1, 0.05, 0);
+
+    // Contador em ritmo constante: perto do início cada amostra cresce mais
+    // de 5% do valor, mas a taxa não muda
+    export_record_t r, prev;
+    memset(&r, 0, sizeof(r));
+    r.pid = 3000;
+    r.flags = EXPORT_HAS_CPU;
+    r.monotonic_ns = 1000000000ULL;
+    r.cpu.user_time = 100;
+    r.cpu.total_time = 100;
+    int emitted = 0;
+    for (int i = 0; i < 20; i++) {
+        emitted += export_delta_admit(&delta, &r, &prev, NULL);
+        r.monotonic_ns += 1000000000ULL;
+        r.cpu.user_time += 100;
+        r.cpu.total_time = r.cpu.user_time;
+    }
+    // Primeira linha densa e a segunda, que estabelece a taxa
+    print_test_result("A steadily increasing counter is suppressed", emitted == 2);
+
+    // Mesmo com um acumulado enorme, dobrar o ritmo é mudança
+    r.cpu.user_time += 1000000000ULL;
+    r.cpu.total_time = r.cpu.user_time;
+    r.monotonic_ns += 1000000000ULL;
+    export_delta_admit(&delta, &r, &prev, NULL);
+    int steady = 0;
+    for (int i = 0; i < 5; i++) {
+        r.monotonic_ns += 1000000000ULL;
+        r.cpu.user_time += 100;
+        r.cpu.total_time = r.cpu.user_time;
+        steady += export_delta_admit(&delta, &r, &prev, NULL);
+    }
+    r.monotonic_ns += 1000000000ULL;
+    r.cpu.user_time += 200;
+    r.cpu.total_time = r.cpu.user_time;
+    int doubled = export_delta_admit(&delta, &r, &prev, NULL);
+    print_test_result("A counter changing pace is emitted whatever its total",
+                      steady == 1 && doubled == 1);
+
+    // Contador que volta (PID reaproveitado) também é mudança
+    r.monotonic_ns += 1000000000ULL;
+    r.cpu.user_time = 5;
+    r.cpu.total_time = 5;
+    print_test_result("A counter going backwards is a change",
+                      export_delta_admit(&delta, &r, &prev, NULL) == 1);
+    export_delta_free(&delta);
+}
+
+/**
+ * Escreve a série esparsa e densa; lê a esparsa de volta e a reescreve densa
+ */
+static void roundtrip(export_format_t format, const char *name) {
+    char sparse_path[64], dense_path[64], densified_path[64];
+    snprintf(sparse_path, sizeof(sparse_path), "/tmp/test_export_delta_sparse.%s", name);
+    snprintf(dense_path, sizeof(dense_path), "/tmp/test_export_delta_dense.%s", name);
+    snprintf(densified_path, sizeof(densified_path), "/tmp/test_export_delta_densified.%s", name);
+
+    export_writer_config_t config;
+    export_writer_config_default(&config);
+    config.format = format;
+    config.flush_interval_ms = 0;
+    export_writer_t dense, sparse;
+    int ok = export_writer_open(&dense, dense_path, &config) == 0;
+    config.sparse = 1;
+    ok = ok && export_writer_open(&sparse, sparse_path, &config) == 0;
+
+    export_record_t record;
+    for (int tick = 0; tick < 12 && ok; tick++) {
+        for (int target = 0; target < 3; target++) {
+            series_record(&record, target, tick);
+            ok = export_writer_write_record(&dense, &record) == 0 &&
+                 export_writer_write_record(&sparse, &record) == 0;
+        }
+    }
+    ok = export_writer_close(&dense) == 0 && ok;
+    ok = export_writer_close(&sparse) == 0 && ok;
+
+    char label[96];
+    long dense_size = 0, sparse_size = 0;
+    FILE *fp = fopen(dense_path, "r");
+    if (fp) { fseek(fp, 0, SEEK_END); dense_size = ftell(fp); fclose(fp); }
+    fp = fopen(sparse_path, "r");
+    if (fp) { fseek(fp, 0, SEEK_END); sparse_size = ftell(fp); fclose(fp); }
+    snprintf(label, sizeof(label), "Sparse %s is smaller than dense (%ld vs %ld bytes)",
+             name, sparse_size, dense_size);
+    print_test_result(label, ok && sparse_size > 0 && sparse_size < dense_size);
+
+    // Leitura: cada linha volta ao registro original
+    export_reader_t reader;
+    int exact = 0, total = 0, ret = -1;
+    if (export_reader_open(&reader, sparse_path) == 0) {
+        export_record_t expected;
+        while ((ret = export_reader_next(&reader, &record)) == 1) {
+            series_record(&expected, total % 3, total / 3);
+            exact += records_equal(&record, &expected);
+            total++;
+        }
+        export_reader_close(&reader);
+    }
+    snprintf(label, sizeof(label), "Sparse %s reads back dense (%d/%d rows exact)", name, exact, total);
+    print_test_result(label, ret == 0 && total == 36 && exact == total);
+
+    // Reescrita densa igual, byte a byte, à exportação densa original
+    long converted = export_densify(sparse_path, densified_path, format);
+    int same = converted == 36;
+    FILE *a = fopen(dense_path, "r"), *b = fopen(densified_path, "r");
+    if (a && b) {
+        int ca, cb;
+        do {
+            ca = fgetc(a);
+            cb = fgetc(b);
+        } while (ca == cb && ca != EOF);
+        same = same && ca == cb;
+    } else {
+        same = 0;
+    }
+    if (a) fclose(a);
+    if (b) fclose(b);
+    snprintf(label, sizeof(label), "export_densify() rebuilds the dense %s file", name);
+    print_test_result(label, same);
+
+    unlink(sparse_path);
+    unlink(dense_path);
+    unlink(densified_path);
+}
+
+void test_sparse_roundtrip(void) {
+    roundtrip(EXPORT_FORMAT_CSV, "csv");
+    roundtrip(EXPORT_FORMAT_NDJSON, "ndjson");
+}
+
+void test_writer_change_only(void) {
+    const char *path = "/tmp/test_export_delta_change.csv";
+    export_writer_config_t config;
+    export_writer_config_default(&config);
+    config.flush_interval_ms = 0;
+    config.change_only = 1;
+    config.heartbeat_ms = 0;
+
+    export_writer_t writer;
+    int ok = export_writer_open(&writer, path, &config) == 0;
+    export_record_t record;
+    for (int tick = 0; tick < 12 && ok; tick++) {
+        for (int target = 0; target < 3; target++) {
+            series_record(&record, target, tick);
+            ok = export_writer_write_record(&writer, &record) == 0;
+        }
+    }
+    // Alvos 1 e 2 só mudam a cada 4 amostras: os contadores deles alternam
+    // entre parado e um salto, e cada borda (ticks 0, 4, 5, 8, 9) vira
+    // linha: 12 + 5 + 5 linhas
+    uint64_t written = writer.records, suppressed = writer.delta ? writer.delta->suppressed : 0;
+    ok = export_writer_close(&writer) == 0 && ok;
+    print_test_result("Change-only writer skips unchanged samples",
+                      ok && written == 22 && suppressed == 14);
+
+    export_reader_t reader;
+    int rows = 0;
+    if (export_reader_open(&reader, path) == 0) {
+        while (export_reader_next(&reader, &record) == 1) rows++;
+        export_reader_close(&reader);
+    }
+    print_test_result("Change-only output stays a plain dense CSV", rows == 22);
+    unlink(path);
+
+    FILE *fp = fopen(path, "w");
+    if (fp) {
+        fputs("timestamp,pid,user_ticks\n2024-01-01 00:00:00,1,=\n", fp);
+        fclose(fp);
+    }
+    int bad = export_reader_open(&reader, path) == 0 && export_reader_next(&reader, &record) == -1;
+    if (bad) export_reader_close(&reader);
+    print_test_result("A row that cannot be reconstructed is rejected", bad);
+    unlink(path);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║     Resource Monitor - Delta Export Test Suite             ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_admit();
+    test_counter_rate();
+    test_sparse_roundtrip();
+    test_writer_change_only();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
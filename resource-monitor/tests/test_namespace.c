@@ -0,0 +1,299 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "../include/namespace.h"
+#include "../include/monitor.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_YELLOW "\033[0;33m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+void test_statistics_basic(void) {
+    namespace_statistics_t stats;
+
+    int result = get_namespace_statistics(&stats);
+    print_test_result("get_namespace_statistics()", result == 0);
+
+    if (result == 0) {
+        print_test_result("Processes analyzed > 0", stats.total_processes_analyzed > 0);
+        print_test_result("At least one namespace per type",
+                          stats.unique_net_namespaces >= 1 &&
+                          stats.unique_mnt_namespaces >= 1 &&
+                          stats.unique_pid_namespaces >= 1);
+        print_test_result("Unique namespaces <= processes",
+                          stats.unique_net_namespaces <= stats.total_processes_analyzed);
+    }
+
+    result = get_namespace_statistics(NULL);
+    print_test_result("get_namespace_statistics() with NULL stats", result != 0);
+}
+
+void test_member_counts(void) {
+    namespace_statistics_t stats;
+    namespace_set_t sets[MAX_NAMESPACES];
+
+    if (get_namespace_statistics_detailed(&stats, sets, 0) != 0) {
+        print_test_result("Member counts for own namespaces", 0);
+        return;
+    }
+
+    struct stat st;
+    int own_ok = (stat("/proc/self/ns/net", &st) == 0) &&
+                 namespace_set_members(&sets[NS_NET], st.st_dev, st.st_ino) >= 1;
+    print_test_result("Member counts for own namespaces", own_ok);
+
+    print_test_result("Set size matches unique count",
+                      (int)sets[NS_NET].count == stats.unique_net_namespaces);
+
+    long total = 0;
+    for (size_t i = 0; i < sets[NS_MNT].capacity; i++) {
+        total += sets[NS_MNT].slots[i].members;
+    }
+    print_test_result("Member counts never exceed processes",
+                      total > 0 && total <= stats.total_processes_analyzed);
+
+    print_test_result("Unknown namespace has no members",
+                      namespace_set_members(&sets[NS_NET], st.st_dev, 1) == 0);
+
+    free_namespace_sets(sets);
+}
+
+void test_single_vs_parallel(void) {
+    namespace_statistics_t serial, parallel;
+
+    int ok = get_namespace_statistics_detailed(&serial, NULL, 1) == 0 &&
+             get_namespace_statistics_detailed(&parallel, NULL, 4) == 0;
+
+    // Processos podem surgir entre as varreduras; os namespaces de mnt/user raramente mudam
+    print_test_result("Serial and parallel sweeps agree",
+                      ok && serial.unique_user_namespaces == parallel.unique_user_namespaces);
+}
+
+void test_skipped_processes(void) {
+    // /proc de mentira: o PID 1 não tem ns legível, o 2 aponta para o nosso
+    char root[64], path[128];
+    snprintf(root, sizeof(root), "/tmp/test_namespace_proc.%d", getpid());
+    mkdir(root, 0755);
+    snprintf(path, sizeof(path), "%s/1", root);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/2", root);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/2/ns", root);
+    int ok = symlink("/proc/self/ns", path) == 0 && set_proc_root(root) == 0;
+
+    namespace_statistics_t stats;
+    ok = ok && get_namespace_statistics(&stats) == 0;
+    set_proc_root(NULL);
+    print_test_result("Unreadable processes are skipped, not analyzed",
+                      ok && stats.total_processes_analyzed == 1 && stats.skipped_processes == 1 &&
+                      stats.unique_net_namespaces == 1);
+
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/2", root);
+    rmdir(path);
+    snprintf(path, sizeof(path), "%s/1", root);
+    rmdir(path);
+    rmdir(root);
+}
+
+void test_new_namespace_is_counted(void) {
+    if (geteuid() != 0) {
+        printf("[%sSKIP%s] New UTS namespace is counted - requires root\n",
+               COLOR_YELLOW, COLOR_RESET);
+        return;
+    }
+
+    int ready[2];
+    if (pipe(ready) != 0) {
+        print_test_result("New UTS namespace is counted", 0);
+        return;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(ready[0]);
+        char status = (unshare(CLONE_NEWUTS) == 0) ? 'y' : 'n';
+        if (write(ready[1], &status, 1) != 1) _exit(1);
+        pause();
+        _exit(0);
+    }
+
+    close(ready[1]);
+    char status = 'n';
+    if (child < 0 || read(ready[0], &status, 1) != 1 || status != 'y') {
+        close(ready[0]);
+        if (child > 0) {
+            kill(child, SIGKILL);
+            waitpid(child, NULL, 0);
+        }
+        print_test_result("New UTS namespace is counted", 0);
+        return;
+    }
+    close(ready[0]);
+
+    process_namespaces_t ns;
+    namespace_statistics_t stats;
+    namespace_set_t sets[MAX_NAMESPACES];
+    char path[64];
+    struct stat st;
+    snprintf(path, sizeof(path), "/proc/%d/ns/uts", child);
+
+    int ok = list_process_namespaces(child, &ns) == 0 &&
+             stat(path, &st) == 0 &&
+             get_namespace_statistics_detailed(&stats, sets, 0) == 0;
+    if (ok) {
+        ok = namespace_set_members(&sets[NS_UTS], st.st_dev, st.st_ino) == 1 &&
+             stats.unique_uts_namespaces >= 2;
+        free_namespace_sets(sets);
+    }
+
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+
+    print_test_result("New UTS namespace is counted", ok);
+}
+
+void test_index_queries(void) {
+    namespace_index_t index;
+
+    if (namespace_index_init(&index, 0) != 0) {
+        print_test_result("namespace_index_init()", 0);
+        return;
+    }
+    print_test_result("namespace_index_init()", index.process_count > 0);
+
+    process_namespaces_t indexed, direct;
+    int ok = namespace_index_lookup(&index, getpid(), &indexed) == 0 &&
+             list_process_namespaces(getpid(), &direct) == 0;
+    for (int i = 0; ok && i < MAX_NAMESPACES; i++) {
+        ok = indexed.namespaces[i].inode == direct.namespaces[i].inode;
+    }
+    print_test_result("Index lookup matches /proc", ok);
+
+    int count = 0;
+    const pid_t *pids = namespace_index_find(&index, NS_NET, direct.namespaces[NS_NET].inode, &count);
+    int found_self = 0;
+    for (int i = 0; pids != NULL && i < count; i++) {
+        if (pids[i] == getpid()) found_self = 1;
+    }
+    print_test_result("Index find contains own PID", found_self);
+
+    namespace_comparison_t comparisons[MAX_NAMESPACES];
+    int comp_count = 0;
+    ok = namespace_index_compare(&index, getpid(), getpid(), comparisons, &comp_count) == 0 &&
+         comp_count == direct.count;
+    for (int i = 0; ok && i < comp_count; i++) {
+        ok = comparisons[i].shared;
+    }
+    print_test_result("Index compare with itself is all shared", ok);
+
+    print_test_result("Index lookup of unknown PID fails",
+                      namespace_index_lookup(&index, 999999, &indexed) != 0);
+
+    namespace_index_free(&index);
+}
+
+void test_index_incremental(void) {
+    namespace_index_t index;
+
+    if (namespace_index_init(&index, 1) != 0) {
+        print_test_result("Index follows fork/exit", 0);
+        return;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+
+    process_namespaces_t ns;
+    int added = child > 0 && namespace_index_refresh(&index) == 0 &&
+                namespace_index_lookup(&index, child, &ns) == 0;
+
+    if (child > 0) {
+        kill(child, SIGKILL);
+        waitpid(child, NULL, 0);
+    }
+    int removed = namespace_index_refresh(&index) == 0 &&
+                  namespace_index_lookup(&index, child, &ns) != 0;
+
+    print_test_result("Index follows fork/exit", added && removed);
+
+    if (index.events_fd >= 0) {
+        print_test_result("Index updated from process events", index.full_scans == 1);
+    } else {
+        printf("[%sSKIP%s] Index updated from process events - proc connector unavailable\n",
+               COLOR_YELLOW, COLOR_RESET);
+    }
+
+    namespace_index_free(&index);
+}
+
+void test_benchmark(void) {
+    namespace_bench_result_t result;
+
+    if (geteuid() != 0) {
+        printf("[%sSKIP%s] Namespace benchmark - requires root\n", COLOR_YELLOW, COLOR_RESET);
+        return;
+    }
+
+    int ok = run_namespace_benchmark(NS_UTS, NS_BENCH_UNSHARE, 40, 2, &result) == 0;
+    print_test_result("run_namespace_benchmark() unshare",
+                      ok && result.failures == 0 &&
+                      result.p50_us > 0 && result.p50_us <= result.p90_us &&
+                      result.p90_us <= result.p99_us && result.p99_us <= result.max_us);
+
+    ok = run_namespace_benchmark(NS_PID, NS_BENCH_SETNS, 20, 1, &result) == 0;
+    print_test_result("run_namespace_benchmark() setns into PID namespace",
+                      ok && result.failures == 0 && result.ops_per_sec > 0);
+
+    print_test_result("Invalid benchmark arguments rejected",
+                      run_namespace_benchmark(NS_UTS, NS_BENCH_UNSHARE, 0, 1, &result) == -1);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║          Resource Monitor - Namespace Test Suite           ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_statistics_basic();
+    test_member_counts();
+    test_single_vs_parallel();
+    test_skipped_processes();
+    test_new_namespace_is_counted();
+    test_index_queries();
+    test_index_incremental();
+    test_benchmark();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,226 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "../include/openmetrics.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+#define SOCKET_PATH "/tmp/test_openmetrics.sock"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+static int count_occurrences(const char *text, const char *needle) {
+    int n = 0;
+    for (const char *p = strstr(text, needle); p != NULL; p = strstr(p + 1, needle)) {
+        n++;
+    }
+    return n;
+}
+
+static void make_target(metrics_target_t *target, pid_t pid, const char *name, uint32_t flags) {
+    memset(target, 0, sizeof(*target));
+    target->pid = pid;
+    snprintf(target->name, sizeof(target->name), "%s", name);
+    target->flags = flags;
+    target->cpu.user_time = 100;
+    target->cpu.num_threads = 3;
+    target->cpu.context_switches = 42;
+    target->mem.rss = 1048576;
+    target->io.bytes_written = 4096;
+}
+
+void test_render(void) {
+    metrics_target_t targets[2];
+    make_target(&targets[0], 10, "db", EXPORT_HAS_CPU | EXPORT_HAS_MEM | EXPORT_HAS_IO);
+    make_target(&targets[1], 11, "we\"ird\\name", EXPORT_HAS_CPU);
+
+    // Os dois no mesmo cgroup; só o primeiro com namespaces
+    for (int i = 0; i < 2; i++) {
+        targets[i].has_cgroup = 1;
+        targets[i].cgroup.has_memory = 1;
+        targets[i].cgroup.memory.current = 8388608;
+        snprintf(targets[i].cgroup.info.path, sizeof(targets[i].cgroup.info.path),
+                 "/sys/fs/cgroup/app.slice");
+    }
+    targets[0].has_namespaces = 1;
+    targets[0].namespaces.count = 1;
+    targets[0].namespaces.namespaces[0].available = 1;
+    targets[0].namespaces.namespaces[0].inode = 4026531836;
+    snprintf(targets[0].namespaces.namespaces[0].type_name,
+             sizeof(targets[0].namespaces.namespaces[0].type_name), "pid");
+
+    metrics_page_t *page = openmetrics_render(targets, 2, 0);
+    print_test_result("openmetrics_render()", page != NULL);
+    if (page == NULL) return;
+
+    char *text = strndup(page->data, page->length);
+    print_test_result("Page ends with # EOF",
+                      page->length >= 6 && strcmp(text + page->length - 6, "# EOF\n") == 0);
+    print_test_result("One TYPE line per family, samples of every target under it",
+                      count_occurrences(text, "# TYPE resource_monitor_process_threads gauge\n") == 1 &&
+                      strstr(text, "resource_monitor_process_threads{pid=\"10\",comm=\"db\"} 3\n") != NULL &&
+                      count_occurrences(text, "resource_monitor_process_threads{") == 2);
+    print_test_result("Counters get the _total suffix",
+                      strstr(text, "resource_monitor_process_context_switches_total{pid=\"10\",comm=\"db\"} 42\n") != NULL);
+    print_test_result("Label values are escaped",
+                      strstr(text, "comm=\"we\\\"ird\\\\name\"") != NULL);
+    print_test_result("Families not collected for a target are omitted",
+                      count_occurrences(text, "resource_monitor_process_resident_memory_bytes{") == 1 &&
+                      strstr(text, "resident_memory_bytes{pid=\"11\"") == NULL);
+    print_test_result("Shared cgroup is exported once",
+                      count_occurrences(text, "resource_monitor_cgroup_memory_usage_bytes{cgroup=\"/sys/fs/cgroup/app.slice\"} 8388608\n") == 1);
+    print_test_result("Namespace info series",
+                      strstr(text, "resource_monitor_process_namespace_info{pid=\"10\",type=\"pid\",inode=\"4026531836\"} 1\n") != NULL);
+
+    free(text);
+    metrics_page_release(page);
+}
+
+/**
+ * Requisição HTTP pelo socket Unix do servidor
+ * @return Bytes da resposta (cabeçalho + corpo), -1 em erro
+ */
+static long http_request(const char *request, char *response, size_t size) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, SOCKET_PATH);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        write(fd, request, strlen(request)) != (ssize_t)strlen(request)) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+
+    size_t length = 0;
+    ssize_t n;
+    while (length < size - 1 && (n = read(fd, response + length, size - 1 - length)) > 0) {
+        length += (size_t)n;
+    }
+    response[length] = '\0';
+    close(fd);
+    return (long)length;
+}
+
+void test_server(void) {
+    metrics_server_t server;
+    static char response[65536];
+
+    int ok = metrics_server_start(&server, "unix:" SOCKET_PATH) == 0;
+    print_test_result("metrics_server_start() on a Unix socket", ok);
+    if (!ok) return;
+
+    http_request("GET /metrics HTTP/1.1\r\n\r\n", response, sizeof(response));
+    print_test_result("503 before the first tick", strncmp(response, "HTTP/1.1 503", 12) == 0);
+
+    metrics_target_t target;
+    make_target(&target, 77, "svc", EXPORT_HAS_CPU);
+    metrics_page_t *page = openmetrics_render(&target, 1, 0);
+    size_t first_length = page->length;
+    char *first = strndup(page->data, page->length);
+    metrics_server_publish(&server, page);
+
+    http_request("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n", response, sizeof(response));
+    const char *body = strstr(response, "\r\n\r\n");
+    print_test_result("GET /metrics serves the published page",
+                      strncmp(response, "HTTP/1.1 200", 12) == 0 &&
+                      strstr(response, OPENMETRICS_CONTENT_TYPE) != NULL &&
+                      body != NULL && strlen(body + 4) == first_length &&
+                      memcmp(body + 4, first, first_length) == 0);
+
+    http_request("HEAD /metrics HTTP/1.1\r\n\r\n", response, sizeof(response));
+    body = strstr(response, "\r\n\r\n");
+    print_test_result("HEAD has no body", body != NULL && body[4] == '\0');
+
+    http_request("GET /other HTTP/1.1\r\n\r\n", response, sizeof(response));
+    print_test_result("Unknown path is 404", strncmp(response, "HTTP/1.1 404", 12) == 0);
+
+    // O próximo tick troca a página; scrapes seguintes veem a nova
+    target.cpu.num_threads = 9;
+    metrics_server_publish(&server, openmetrics_render(&target, 1, first_length));
+    int fresh = 1;
+    for (int i = 0; i < 50; i++) {
+        http_request("GET /metrics HTTP/1.1\r\n\r\n", response, sizeof(response));
+        if (strstr(response, "resource_monitor_process_threads{pid=\"77\",comm=\"svc\"} 9\n") == NULL) {
+            fresh = 0;
+        }
+    }
+    print_test_result("Scrapes see the latest tick", fresh);
+    print_test_result("Scrape counter", atomic_load(&server.scrapes) == 52);
+
+    // Um cliente que manda a requisição pela metade não atrasa os demais
+    int slow = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, SOCKET_PATH);
+    ok = slow >= 0 && connect(slow, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+         write(slow, "GET /met", 8) == 8;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    http_request("GET /metrics HTTP/1.1\r\n\r\n", response, sizeof(response));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double waited = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    print_test_result("A stalled client does not delay other scrapes",
+                      ok && strncmp(response, "HTTP/1.1 200", 12) == 0 && waited < 0.5);
+
+    // ... e é desconectado quando o prazo da conexão vence
+    struct timeval limit = { 5, 0 };
+    char byte;
+    setsockopt(slow, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ok = ok && read(slow, &byte, 1) == 0;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    waited = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    print_test_result("A stalled client is dropped at its deadline", ok && waited < 4.0);
+    if (slow >= 0) close(slow);
+
+    metrics_server_stop(&server);
+    print_test_result("Stopping removes the socket", access(SOCKET_PATH, F_OK) != 0);
+    free(first);
+}
+
+void test_listen_spec(void) {
+    metrics_server_t server;
+    print_test_result("Invalid listen addresses are rejected",
+                      metrics_server_start(&server, "notaport") == -1 &&
+                      metrics_server_start(&server, "1.2.3:80") == -1 &&
+                      metrics_server_start(&server, "127.0.0.1:70000") == -1 &&
+                      metrics_server_start(&server, "unix:") == -1);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║          Resource Monitor - OpenMetrics Test Suite         ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_render();
+    test_server();
+    test_listen_spec();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/self_stats.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+void test_histogram(void) {
+    latency_histogram_t h;
+    latency_histogram_init(&h);
+    print_test_result("An empty histogram reports 0", latency_histogram_percentile(&h, 99) == 0);
+
+    // Valores pequenos caem em faixas exatas
+    for (uint64_t v = 1; v <= 10; v++) latency_histogram_record(&h, v);
+    print_test_result("Small values are exact (p50 of 1..10 = 5, p100 = 10)",
+                      latency_histogram_percentile(&h, 50) == 5 &&
+                      latency_histogram_percentile(&h, 100) == 10 && h.min_ns == 1);
+
+    // 1..100000 us: cada percentil dentro de 12.5% do exato
+    latency_histogram_init(&h);
+    for (uint64_t us = 1; us <= 100000; us++) latency_histogram_record(&h, us * 1000);
+    int within = 1;
+    static const double percentiles[] = { 1, 10, 50, 90, 99, 99.9 };
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+        double exact = percentiles[i] * 1000.0 * 1000.0;
+        double got = (double)latency_histogram_percentile(&h, percentiles[i]);
+        within = within && got >= exact && got <= exact * 1.125;
+    }
+    print_test_result("Percentiles stay within one sub-bucket (12.5%) across scales", within);
+    print_test_result("Count, sum and max are exact",
+                      h.count == 100000 && h.max_ns == 100000000ULL &&
+                      h.sum_ns == 1000ULL * 100000ULL * 100001ULL / 2);
+
+    // Fora da faixa: última faixa, percentil limitado ao máximo visto
+    latency_histogram_init(&h);
+    latency_histogram_record(&h, UINT64_MAX / 2);
+    latency_histogram_record(&h, 3000);
+    print_test_result("Values past the top bucket are clamped, not lost",
+                      h.buckets[LATENCY_BUCKETS - 1] == 1 &&
+                      latency_histogram_percentile(&h, 100) == UINT64_MAX / 2 &&
+                      latency_histogram_percentile(&h, 50) >= 3000 &&
+                      latency_histogram_percentile(&h, 50) <= 3375);
+}
+
+void test_usage(void) {
+    self_usage_t before, after;
+    int ok = self_usage_read(&before) == 0;
+
+    // Trabalho medível: CPU, leituras e memória
+    volatile uint64_t sink = 0;
+    for (uint64_t i = 0; i < 20000000; i++) sink += i;
+    char *block = malloc(1 << 20);
+    if (block) memset(block, 1, 1 << 20);
+    for (int i = 0; i < 20; i++) {
+        FILE *fp = fopen("/proc/self/stat", "r");
+        if (fp) { char line[256]; if (fgets(line, sizeof(line), fp) == NULL) sink++; fclose(fp); }
+    }
+    ok = ok && self_usage_read(&after) == 0;
+
+    print_test_result("getrusage CPU time advances with work",
+                      ok && after.utime_us + after.stime_us > before.utime_us + before.stime_us);
+    print_test_result("Read syscalls are counted from /proc/self/io",
+                      !after.has_io || after.syscr >= before.syscr + 20);
+    print_test_result("Resident memory and page faults are read",
+                      after.rss_bytes > 0 && after.vsz_bytes >= after.rss_bytes &&
+                      after.minflt > before.minflt);
+    free(block);
+}
+
+void test_ticks(void) {
+    collector_sched_t sched;
+    collector_sched_init(&sched, 0);
+    self_stats_t stats;
+    self_stats_init(&stats);
+
+    for (int tick = 0; tick < 5; tick++) {
+        latency_histogram_record(&stats.collect[COLLECTOR_UNIT_STAT], 20000 + tick);
+        latency_histogram_record(&stats.jitter, 100000);
+        FILE *fp = fopen("/proc/self/statm", "r");
+        if (fp) fclose(fp);
+        self_stats_tick_end(&stats, 50000);
+    }
+    print_test_result("Ticks are counted with their duration",
+                      stats.ticks == 5 && stats.tick.count == 5 &&
+                      latency_histogram_percentile(&stats.tick, 50) == 50000);
+    print_test_result("Syscalls per tick include the monitor's own reads",
+                      !stats.last.has_io || stats.max_syscalls_tick > 0);
+
+    export_record_t record;
+    self_stats_fill_record(&stats, &record);
+    print_test_result("The exported row carries the monitor's PID and usage",
+                      record.pid == getpid() &&
+                      (record.flags & (EXPORT_HAS_CPU | EXPORT_HAS_MEM)) == (EXPORT_HAS_CPU | EXPORT_HAS_MEM) &&
+                      record.mem.rss == stats.last.rss_bytes &&
+                      record.cpu.context_switches == stats.last.nvcsw + stats.last.nivcsw &&
+                      (!stats.last.has_io || record.io.syscalls_read == stats.last.syscr));
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║     Resource Monitor - Self-Instrumentation Test Suite     ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_histogram();
+    test_usage();
+    test_ticks();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,315 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/wait.h>
+#include "../include/shm_metrics.h"
+
+#define COLOR_GREEN "\033[0;32m"
+#define COLOR_RED "\033[0;31m"
+#define COLOR_RESET "\033[0m"
+
+#define TARGETS 8
+#define READ_SECONDS 0.5
+
+int tests_passed = 0;
+int tests_failed = 0;
+
+void print_test_result(const char *test_name, int passed) {
+    if (passed) {
+        printf("[%sPASS%s] %s\n", COLOR_GREEN, COLOR_RESET, test_name);
+        tests_passed++;
+    } else {
+        printf("[%sFAIL%s] %s\n", COLOR_RED, COLOR_RESET, test_name);
+        tests_failed++;
+    }
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Todos os campos derivam de k: um registro rasgado (metade de uma escrita,
+ * metade de outra) quebra alguma das relações
+ */
+static void make_record(export_record_t *record, pid_t pid, uint64_t k) {
+    memset(record, 0, sizeof(*record));
+    record->pid = pid;
+    record->flags = EXPORT_HAS_CPU | EXPORT_HAS_MEM | EXPORT_HAS_IO;
+    record->realtime_ns = k;
+    record->monotonic_ns = k + (uint64_t)pid;
+    record->cpu.user_time = k;
+    record->cpu.system_time = k * 2;
+    record->cpu.cpu_percent = (double)(k % 1000);
+    record->mem.rss = k * 4096;
+    record->io.bytes_read = k * 3;
+    record->io.write_rate = (double)k;
+}
+
+static int record_consistent(const export_record_t *r) {
+    uint64_t k = r->realtime_ns;
+    return r->monotonic_ns == k + (uint64_t)r->pid &&
+           r->cpu.user_time == k && r->cpu.system_time == k * 2 &&
+           r->cpu.cpu_percent == (double)(k % 1000) &&
+           r->mem.rss == k * 4096 && r->io.bytes_read == k * 3 &&
+           r->io.write_rate == (double)k;
+}
+
+void test_publish_and_read(void) {
+    shm_metrics_t writer, reader;
+    export_record_t in, out;
+
+    int ok = shm_metrics_create(&writer, "test_shm_basic", 16) == 0;
+    print_test_result("shm_metrics_create()", ok);
+    if (!ok) return;
+
+    ok = shm_metrics_open(&reader, "/test_shm_basic") == 0;
+    print_test_result("shm_metrics_open() maps the segment read-only", ok);
+    if (!ok) {
+        shm_metrics_destroy(&writer);
+        return;
+    }
+
+    make_record(&in, 4242, 77);
+    ok = shm_metrics_publish(&writer, &in) == 0 && shm_metrics_read(&reader, 4242, &out) == 0;
+    print_test_result("Published sample reads back intact",
+                      ok && memcmp(&in, &out, sizeof(in)) == 0);
+    print_test_result("Generation counts publications", shm_metrics_generation(&reader) == 1);
+
+    errno = 0;
+    print_test_result("Unknown PID is ENOENT",
+                      shm_metrics_read(&reader, 4243, &out) == -1 && errno == ENOENT);
+
+    ok = shm_metrics_remove(&writer, 4242) == 0 &&
+         shm_metrics_read(&reader, 4242, &out) == -1;
+    make_record(&in, 4242, 78);
+    ok = ok && shm_metrics_publish(&writer, &in) == 0 &&
+         shm_metrics_read(&reader, 4242, &out) == 0 && out.cpu.user_time == 78;
+    print_test_result("Removed target disappears and can come back", ok);
+
+    int occupied = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        if (shm_metrics_read_slot(&reader, i, &out) == 1) occupied++;
+    }
+    print_test_result("shm_metrics_read_slot() sees one target", occupied == 1);
+
+    shm_metrics_close(&reader);
+    shm_metrics_destroy(&writer);
+    print_test_result("Destroy removes the name", shm_metrics_open(&reader, "test_shm_basic") == -1);
+}
+
+void test_segment_full(void) {
+    shm_metrics_t writer;
+    export_record_t record;
+
+    if (shm_metrics_create(&writer, "test_shm_full", 4) != 0) {
+        print_test_result("Full segment is ENOSPC", 0);
+        return;
+    }
+
+    int ok = 1;
+    for (pid_t pid = 100; pid < 104; pid++) {
+        make_record(&record, pid, 1);
+        ok = ok && shm_metrics_publish(&writer, &record) == 0;
+    }
+    make_record(&record, 200, 1);
+    errno = 0;
+    ok = ok && shm_metrics_publish(&writer, &record) == -1 && errno == ENOSPC;
+
+    // Quem já tem slot continua publicando
+    make_record(&record, 101, 2);
+    ok = ok && shm_metrics_publish(&writer, &record) == 0;
+    print_test_result("Full segment is ENOSPC", ok);
+    shm_metrics_destroy(&writer);
+}
+
+void test_owner_check(void) {
+    shm_metrics_t writer, second, reader;
+    export_record_t record;
+
+    if (shm_metrics_create(&writer, "test_shm_owner", 16) != 0) {
+        print_test_result("Live segment is not replaced", 0);
+        return;
+    }
+    make_record(&record, 31, 5);
+    shm_metrics_publish(&writer, &record);
+
+    errno = 0;
+    int ok = shm_metrics_create(&second, "test_shm_owner", 16) == -1 && errno == EEXIST &&
+             shm_metrics_open(&reader, "test_shm_owner") == 0;
+    if (ok) {
+        ok = shm_metrics_read(&reader, 31, &record) == 0 && record.realtime_ns == 5;
+        shm_metrics_close(&reader);
+    }
+    print_test_result("Live segment is not replaced", ok);
+    shm_metrics_destroy(&writer);
+
+    // Um monitor que morre sem destruir o segmento deixa o nome para trás
+    pid_t child = fork();
+    if (child == 0) {
+        shm_metrics_t orphan;
+        _exit(shm_metrics_create(&orphan, "test_shm_owner", 16) == 0 ? 0 : 1);
+    }
+    int status = 0;
+    ok = child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) &&
+         WEXITSTATUS(status) == 0 && shm_metrics_create(&second, "test_shm_owner", 16) == 0;
+    print_test_result("Segment of a dead monitor is replaced", ok);
+    if (ok) {
+        shm_metrics_destroy(&second);
+    }
+}
+
+void test_removed_slots_reclaimed(void) {
+    shm_metrics_t writer, reader;
+    export_record_t record;
+
+    if (shm_metrics_create(&writer, "test_shm_compact", 16) != 0 ||
+        shm_metrics_open(&reader, "test_shm_compact") != 0) {
+        print_test_result("Removed slots are reclaimed", 0);
+        return;
+    }
+
+    int ok = 1;
+    for (pid_t pid = 1; pid <= 12; pid++) {
+        make_record(&record, pid, (uint64_t)pid);
+        ok = ok && shm_metrics_publish(&writer, &record) == 0;
+    }
+    for (pid_t pid = 1; pid <= 10; pid++) {
+        ok = ok && shm_metrics_remove(&writer, pid) == 0;
+    }
+
+    int removed = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        if (atomic_load(&reader.slots[i].pid) == -1) removed++;
+    }
+    print_test_result("Removed slots are reclaimed", ok && removed <= 16 / 4);
+
+    errno = 0;
+    ok = shm_metrics_read(&reader, 3, &record) == -1 && errno == ENOENT;
+    for (pid_t pid = 11; pid <= 12; pid++) {
+        ok = ok && shm_metrics_read(&reader, pid, &record) == 0 &&
+             record_consistent(&record) && record.realtime_ns == (uint64_t)pid;
+    }
+    print_test_result("Live targets survive the compaction", ok);
+
+    shm_metrics_close(&reader);
+    shm_metrics_destroy(&writer);
+}
+
+/**
+ * Leitor em outro processo durante READ_SECONDS enquanto o pai publica sem
+ * pausa. Devolve pelo pipe: leituras, registros rasgados, regressões e
+ * buscas que não acharam um alvo sempre presente
+ */
+static void reader_process(int fd) {
+    shm_metrics_t reader;
+    uint64_t stats[4] = {0, 0, 0, 0};
+    uint64_t last[TARGETS] = {0};
+
+    if (shm_metrics_open(&reader, "test_shm_race") == 0) {
+        double end = now_seconds() + READ_SECONDS;
+        export_record_t record;
+        while (now_seconds() < end) {
+            for (int t = 0; t < TARGETS; t++) {
+                if (shm_metrics_read(&reader, 5000 + t, &record) != 0) {
+                    stats[3]++;
+                    continue;
+                }
+                stats[0]++;
+                if (!record_consistent(&record)) stats[1]++;
+                if (record.realtime_ns < last[t]) stats[2]++;
+                last[t] = record.realtime_ns;
+            }
+        }
+        shm_metrics_close(&reader);
+    }
+    if (write(fd, stats, sizeof(stats)) != (ssize_t)sizeof(stats)) {
+        _exit(1);
+    }
+    _exit(0);
+}
+
+void test_concurrent_reader(void) {
+    shm_metrics_t writer;
+    int fds[2];
+
+    if (shm_metrics_create(&writer, "test_shm_race", 64) != 0 || pipe(fds) != 0) {
+        print_test_result("Concurrent reader never sees a torn sample", 0);
+        return;
+    }
+
+    export_record_t record;
+    for (int t = 0; t < TARGETS; t++) {
+        make_record(&record, 5000 + t, 1);
+        shm_metrics_publish(&writer, &record);
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(fds[0]);
+        reader_process(fds[1]);
+    }
+    close(fds[1]);
+
+    uint64_t k = 1, published = 0;
+    int status = 0;
+    while (child > 0 && waitpid(child, &status, WNOHANG) == 0) {
+        k++;
+        for (int t = 0; t < TARGETS; t++) {
+            make_record(&record, 5000 + t, k);
+            shm_metrics_publish(&writer, &record);
+            published++;
+        }
+        // Alvos de vida curta acumulam remoções e forçam reorganizações
+        if (k % 16 == 0) {
+            for (pid_t pid = 7000; pid < 7020; pid++) {
+                make_record(&record, pid, k);
+                shm_metrics_publish(&writer, &record);
+            }
+            for (pid_t pid = 7000; pid < 7020; pid++) {
+                shm_metrics_remove(&writer, pid);
+            }
+        }
+    }
+
+    uint64_t stats[4] = {0, 0, 0, 0};
+    int got = read(fds[0], stats, sizeof(stats)) == (ssize_t)sizeof(stats);
+    close(fds[0]);
+    shm_metrics_destroy(&writer);
+
+    printf("       %lu publications, %lu concurrent reads\n", published, stats[0]);
+    print_test_result("Concurrent reader never sees a torn sample",
+                      got && stats[0] > 0 && stats[1] == 0);
+    print_test_result("Concurrent reader sees samples in order", got && stats[2] == 0);
+    print_test_result("Concurrent reader never misses a live target", got && stats[3] == 0);
+    print_test_result("Writer kept publishing while being read", published > (uint64_t)TARGETS * 1000);
+}
+
+int main(void) {
+    printf("\n");
+    printf("╔════════════════════════════════════════════════════════════╗\n");
+    printf("║         Resource Monitor - Shared Memory Test Suite        ║\n");
+    printf("╚════════════════════════════════════════════════════════════╝\n");
+    printf("\n");
+
+    test_publish_and_read();
+    test_segment_full();
+    test_owner_check();
+    test_removed_slots_reclaimed();
+    test_concurrent_reader();
+
+    printf("\n");
+    printf("Tests Passed: %s%d%s\n", COLOR_GREEN, tests_passed, COLOR_RESET);
+    printf("Tests Failed: %s%d%s\n", tests_failed > 0 ? COLOR_RED : COLOR_RESET,
+           tests_failed, COLOR_RESET);
+    printf("Total Tests:  %d\n", tests_passed + tests_failed);
+    printf("\n");
+
+    return tests_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}